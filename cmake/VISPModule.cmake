@@ -1028,6 +1028,19 @@ macro(vp_add_tests)
   endif()
 endmacro()
 
+# this is a command to run tests of the module with a given number of OpenMP threads,
+# so that the parallel code paths are also checked on a single core machine
+# vp_set_tests_omp_num_threads(<number of threads> <list of test names>)
+macro(vp_set_tests_omp_num_threads nb_threads)
+  if(BUILD_TESTS AND USE_OPENMP)
+    foreach(__test ${ARGN})
+      if(TARGET ${__test})
+        set_tests_properties(${__test} PROPERTIES ENVIRONMENT "OMP_NUM_THREADS=${nb_threads}")
+      endif()
+    endforeach()
+  endif()
+endmacro()
+
 # setup include paths for the list of passed modules
 macro(vp_include_modules)
   foreach(d ${ARGN})
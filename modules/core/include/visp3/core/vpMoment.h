@@ -153,6 +153,7 @@ public:
      \return vector of values
    */
   const std::vector<double> &get() const { return values; }
+  virtual std::vector<const char *> getDependencies() const;
   void linkTo(vpMomentDatabase &moments);
   virtual const char *name() const = 0;
   virtual void printDependencies(std::ostream &os) const;
@@ -252,6 +252,7 @@ public:
   }
 
   friend VISP_EXPORT std::ostream &operator<<(std::ostream &os, const vpMomentAlpha &v);
+  std::vector<const char *> getDependencies() const;
   void printDependencies(std::ostream &os) const;
 };
 
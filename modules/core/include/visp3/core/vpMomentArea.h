@@ -62,6 +62,7 @@ public:
   void compute();
   //! Moment name.
   const char *name() const { return "vpMomentArea"; }
+  std::vector<const char *> getDependencies() const;
   void printDependencies(std::ostream &os) const;
   //@}
   friend VISP_EXPORT std::ostream &operator<<(std::ostream &os, const vpMomentArea &m);
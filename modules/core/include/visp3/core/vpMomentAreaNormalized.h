@@ -174,6 +174,7 @@ public:
   */
   const char *name() const { return "vpMomentAreaNormalized"; }
   friend VISP_EXPORT std::ostream &operator<<(std::ostream &os, const vpMomentAreaNormalized &v);
+  std::vector<const char *> getDependencies() const;
   void printDependencies(std::ostream &os) const;
 };
 
@@ -230,6 +230,7 @@ public:
     Moment name.
     */
   const char *name() const { return "vpMomentCInvariant"; }
+  std::vector<const char *> getDependencies() const;
 
   /*!
     Print partial invariant.
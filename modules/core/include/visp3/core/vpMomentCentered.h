@@ -93,6 +93,7 @@ public:
 
   friend VISP_EXPORT std::ostream &operator<<(std::ostream &os, const vpMomentCentered &v);
   void printWithIndices(std::ostream &os) const;
+  std::vector<const char *> getDependencies() const;
   void printDependencies(std::ostream &os) const;
 
 protected:
@@ -47,6 +47,7 @@
 #include <cstring>
 #include <iostream>
 #include <map>
+#include <vector>
 
 class vpMoment;
 class vpMomentObject;
@@ -127,6 +128,17 @@ Centered moments:
 Consequently, a database can contain at most one moment of each type. Often it
 is useful to update all moments with the same object. Shortcuts
 (vpMomentDatabase::updateAll) are provided for that matter.
+
+Each moment declares the moments it depends on with vpMoment::getDependencies().
+vpMomentDatabase::compute() uses this information to update and compute only
+the requested moments and the moments they depend on, in the right order:
+\code
+  std::vector<const char *> names;
+  names.push_back("vpMomentCentered");
+  db.compute(obj, names); // computes g, then mc
+\endcode
+vpMomentDatabase::computeAll() does the same for all the moments of the
+database.
 */
 class VISP_EXPORT vpMomentDatabase
 {
@@ -138,6 +150,8 @@ private:
 #endif
   std::map<const char *, vpMoment *, cmp_str> moments;
   void add(vpMoment &moment, const char *name);
+  void sortByDependencies(vpMoment *moment, std::map<const vpMoment *, int> &states,
+                          std::vector<vpMoment *> &order) const;
 
 public:
   vpMomentDatabase() : moments() {}
@@ -145,6 +159,8 @@ public:
 
   /** @name Inherited functionalities from vpMomentDatabase */
   //@{
+  void compute(vpMomentObject &object, const std::vector<const char *> &names);
+  void computeAll(vpMomentObject &object);
   const vpMoment &get(const char *type, bool &found) const;
   /*!
     Get the first element in the database.
@@ -70,6 +70,7 @@ public:
   void compute();
   //! Moment name.
   const char *name() const { return "vpMomentGravityCenterNormalized"; }
+  std::vector<const char *> getDependencies() const;
   void printDependencies(std::ostream &os) const;
   friend VISP_EXPORT std::ostream &operator<<(std::ostream &os, const vpMomentGravityCenterNormalized &v);
 };
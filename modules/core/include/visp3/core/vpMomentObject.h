@@ -239,6 +239,16 @@ public:
     WHITE = 1, /*! No functionality as of now */
   } vpCameraImgBckGrndType;
 
+  /*!
+    Horizontal run of pixels of a dense object: the pixels of the row \e v
+    from the column \e u_min to the column \e u_max included.
+  */
+  struct vpPixelRun {
+    unsigned int v;     //!< Row of the run
+    unsigned int u_min; //!< First column of the run
+    unsigned int u_max; //!< Last column of the run
+  };
+
   bool flg_normalize_intensity; // To scale the intensity of each individual
                                 // pixel in the image by the maximum intensity
                                 // value present in it
@@ -260,6 +270,8 @@ public:
                  const vpCameraParameters &cam); // Binary version
   void fromImage(const vpImage<unsigned char> &image, const vpCameraParameters &cam, vpCameraImgBckGrndType bg_type,
                  bool normalize_with_pix_size = true); // Photometric version
+  void fromLabels(const vpImage<int> &labels, const int label, const vpCameraParameters &cam);
+  void fromRuns(const std::vector<vpPixelRun> &runs, const vpCameraParameters &cam);
 
   void fromVector(std::vector<vpPoint> &points);
   const std::vector<double> &get() const;
@@ -45,6 +45,7 @@
 */
 
 class vpHomogeneousMatrix;
+class vpCameraParameters;
 
 #include <visp3/core/vpColor.h>
 #include <visp3/core/vpForwardProjection.h>
@@ -110,6 +111,11 @@ public:
 
   void projection();
 
+  static void projectPoints(const vpHomogeneousMatrix &cMo, unsigned int n, const double *oX, const double *oY,
+                            const double *oZ, double *x, double *y, double *Z = NULL);
+  static void projectPoints(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam, unsigned int n,
+                            const double *oX, const double *oY, const double *oZ, double *u, double *v);
+
   // Set coordinates
   void set_X(const double X);
   void set_Y(const double Y);
@@ -50,6 +50,45 @@
 #include <visp3/core/vpHistogram.h>
 #include <visp3/core/vpImageConvert.h>
 
+namespace
+{
+/*
+  Add to the histogram the pixels in [ptrStart, ptrEnd). The pixels are read four at a time and
+  counted in four interleaved banks of counters, so that equal consecutive pixels do not wait for
+  the increment of the same counter, and the banks are mapped to the bins afterwards.
+*/
+void computeHistogramBanks(const unsigned char *ptrStart, const unsigned char *ptrEnd, const unsigned int *lut,
+                           unsigned int *histogram)
+{
+  unsigned int banks[4][256];
+  memset(banks, 0, sizeof(banks));
+
+  const unsigned char *ptrCurrent = ptrStart;
+  for (; ptrEnd - ptrCurrent >= 8; ptrCurrent += 8) {
+    unsigned int word1, word2;
+    memcpy(&word1, ptrCurrent, sizeof(word1));
+    memcpy(&word2, ptrCurrent + 4, sizeof(word2));
+
+    banks[0][word1 & 0xFF]++;
+    banks[1][(word1 >> 8) & 0xFF]++;
+    banks[2][(word1 >> 16) & 0xFF]++;
+    banks[3][word1 >> 24]++;
+    banks[0][word2 & 0xFF]++;
+    banks[1][(word2 >> 8) & 0xFF]++;
+    banks[2][(word2 >> 16) & 0xFF]++;
+    banks[3][word2 >> 24]++;
+  }
+
+  for (; ptrCurrent != ptrEnd; ++ptrCurrent) {
+    banks[0][*ptrCurrent]++;
+  }
+
+  for (unsigned int i = 0; i < 256; i++) {
+    histogram[lut[i]] += banks[0][i] + banks[1][i] + banks[2][i] + banks[3][i];
+  }
+}
+}
+
 #if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
 #include <visp3/core/vpThread.h>
 
@@ -86,48 +125,9 @@ vpThread::Return computeHistogramThread(vpThread::Args args)
 
   const vpImage<unsigned char> *I = histogram_param->m_I;
 
-  unsigned char *ptrStart = (unsigned char *)(I->bitmap) + start_index;
-  unsigned char *ptrEnd = (unsigned char *)(I->bitmap) + end_index;
-  unsigned char *ptrCurrent = ptrStart;
-
-  //    while(ptrCurrent != ptrEnd) {
-  //      histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ]
-  //      ] ++;
-  //      ++ptrCurrent;
-  //    }
-
-  if (end_index - start_index >= 8) {
-    // Unroll loop version
-    for (; ptrCurrent <= ptrEnd - 8;) {
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-
-      histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-    }
-  }
-
-  for (; ptrCurrent != ptrEnd; ++ptrCurrent) {
-    histogram_param->m_histogram[histogram_param->m_lut[*ptrCurrent]]++;
-  }
+  const unsigned char *ptrStart = I->bitmap + start_index;
+  const unsigned char *ptrEnd = I->bitmap + end_index;
+  computeHistogramBanks(ptrStart, ptrEnd, histogram_param->m_lut, histogram_param->m_histogram);
 
   return 0;
 }
@@ -271,15 +271,7 @@ void vpHistogram::calculate(const vpImage<unsigned char> &I, const unsigned int
   if (use_single_thread) {
     // Single thread
 
-    unsigned int size_ = I.getWidth() * I.getHeight();
-    unsigned char *ptrStart = (unsigned char *)I.bitmap;
-    unsigned char *ptrEnd = ptrStart + size_;
-    unsigned char *ptrCurrent = ptrStart;
-
-    while (ptrCurrent != ptrEnd) {
-      histogram[lut[*ptrCurrent]]++;
-      ++ptrCurrent;
-    }
+    computeHistogramBanks(I.bitmap, I.bitmap + I.getSize(), lut, histogram);
   } else {
 #if defined(VISP_HAVE_PTHREAD) || (defined(_WIN32) && !defined(WINRT_8_0))
     // Multi-threads
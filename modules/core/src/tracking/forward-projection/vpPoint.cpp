@@ -36,10 +36,17 @@
  *
  *****************************************************************************/
 
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpCameraParameters.h>
 #include <visp3/core/vpDebug.h>
 #include <visp3/core/vpFeatureDisplay.h>
 #include <visp3/core/vpPoint.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 /*!
   \file vpPoint.cpp
   \brief   class that defines what is a point
@@ -270,6 +277,132 @@ void vpPoint::changeFrame(const vpHomogeneousMatrix &cMo)
   cP[3] = 1;
 }
 
+/*!
+  Project a set of 3D points given by their coordinates in the object frame
+  onto the image plane. Coordinates are given as separate arrays (structure
+  of arrays) so that no vpPoint needs to be built and several points can be
+  processed at once using SSE2 when available.
+
+  \code
+  std::vector<double> oX, oY, oZ; // model points
+  std::vector<double> x(oX.size()), y(oX.size());
+  vpPoint::projectPoints(cMo, (unsigned int)oX.size(), oX.data(), oY.data(), oZ.data(), x.data(), y.data());
+  \endcode
+
+  \param cMo : Transformation from camera to object frame.
+  \param n : Number of points.
+  \param oX, oY, oZ : Arrays of size \e n with the 3D coordinates of the
+  points in the object frame.
+  \param x, y : Arrays of size \e n updated with the normalized coordinates
+  of the points in the image plane.
+  \param Z : If not NULL, array of size \e n updated with the depth of the
+  points in the camera frame.
+
+  \sa projectPoints(const vpHomogeneousMatrix &, const vpCameraParameters &,
+  unsigned int, const double *, const double *, const double *, double *,
+  double *)
+*/
+void vpPoint::projectPoints(const vpHomogeneousMatrix &cMo, unsigned int n, const double *oX, const double *oY,
+                            const double *oZ, double *x, double *y, double *Z)
+{
+  const double r00 = cMo[0][0], r01 = cMo[0][1], r02 = cMo[0][2], tx = cMo[0][3];
+  const double r10 = cMo[1][0], r11 = cMo[1][1], r12 = cMo[1][2], ty = cMo[1][3];
+  const double r20 = cMo[2][0], r21 = cMo[2][1], r22 = cMo[2][2], tz = cMo[2][3];
+
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && n >= 2) {
+    const __m128d v_r00 = _mm_set1_pd(r00), v_r01 = _mm_set1_pd(r01), v_r02 = _mm_set1_pd(r02);
+    const __m128d v_r10 = _mm_set1_pd(r10), v_r11 = _mm_set1_pd(r11), v_r12 = _mm_set1_pd(r12);
+    const __m128d v_r20 = _mm_set1_pd(r20), v_r21 = _mm_set1_pd(r21), v_r22 = _mm_set1_pd(r22);
+    const __m128d v_tx = _mm_set1_pd(tx), v_ty = _mm_set1_pd(ty), v_tz = _mm_set1_pd(tz);
+
+    for (; i <= n - 2; i += 2) {
+      __m128d v_oX = _mm_loadu_pd(oX + i);
+      __m128d v_oY = _mm_loadu_pd(oY + i);
+      __m128d v_oZ = _mm_loadu_pd(oZ + i);
+
+      __m128d v_X = _mm_add_pd(
+          _mm_add_pd(_mm_mul_pd(v_r00, v_oX), _mm_mul_pd(v_r01, v_oY)), _mm_add_pd(_mm_mul_pd(v_r02, v_oZ), v_tx));
+      __m128d v_Y = _mm_add_pd(
+          _mm_add_pd(_mm_mul_pd(v_r10, v_oX), _mm_mul_pd(v_r11, v_oY)), _mm_add_pd(_mm_mul_pd(v_r12, v_oZ), v_ty));
+      __m128d v_Z = _mm_add_pd(
+          _mm_add_pd(_mm_mul_pd(v_r20, v_oX), _mm_mul_pd(v_r21, v_oY)), _mm_add_pd(_mm_mul_pd(v_r22, v_oZ), v_tz));
+
+      _mm_storeu_pd(x + i, _mm_div_pd(v_X, v_Z));
+      _mm_storeu_pd(y + i, _mm_div_pd(v_Y, v_Z));
+      if (Z != NULL) {
+        _mm_storeu_pd(Z + i, v_Z);
+      }
+    }
+  }
+#endif
+
+  for (; i < n; i++) {
+    double X_ = r00 * oX[i] + r01 * oY[i] + r02 * oZ[i] + tx;
+    double Y_ = r10 * oX[i] + r11 * oY[i] + r12 * oZ[i] + ty;
+    double Z_ = r20 * oX[i] + r21 * oY[i] + r22 * oZ[i] + tz;
+    x[i] = X_ / Z_;
+    y[i] = Y_ / Z_;
+    if (Z != NULL) {
+      Z[i] = Z_;
+    }
+  }
+}
+
+/*!
+  Project a set of 3D points given by their coordinates in the object frame
+  into the image. The camera projection model (with or without distortion) is
+  taken into account like in vpMeterPixelConversion::convertPoint().
+
+  \param cMo : Transformation from camera to object frame.
+  \param cam : Camera parameters.
+  \param n : Number of points.
+  \param oX, oY, oZ : Arrays of size \e n with the 3D coordinates of the
+  points in the object frame.
+  \param u, v : Arrays of size \e n updated with the pixel coordinates of
+  the points.
+
+  \sa projectPoints(const vpHomogeneousMatrix &, unsigned int, const double
+  *, const double *, const double *, double *, double *, double *)
+*/
+void vpPoint::projectPoints(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam, unsigned int n,
+                            const double *oX, const double *oY, const double *oZ, double *u, double *v)
+{
+  projectPoints(cMo, n, oX, oY, oZ, u, v);
+
+  const double px = cam.get_px(), py = cam.get_py();
+  const double u0 = cam.get_u0(), v0 = cam.get_v0();
+  const bool withDistortion = (cam.get_projModel() == vpCameraParameters::perspectiveProjWithDistortion);
+  const double kud = withDistortion ? cam.get_kud() : 0.;
+
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && n >= 2) {
+    const __m128d v_px = _mm_set1_pd(px), v_py = _mm_set1_pd(py);
+    const __m128d v_u0 = _mm_set1_pd(u0), v_v0 = _mm_set1_pd(v0);
+    const __m128d v_kud = _mm_set1_pd(kud), v_one = _mm_set1_pd(1.);
+
+    for (; i <= n - 2; i += 2) {
+      __m128d v_x = _mm_loadu_pd(u + i);
+      __m128d v_y = _mm_loadu_pd(v + i);
+      __m128d v_r2 = _mm_add_pd(_mm_mul_pd(v_x, v_x), _mm_mul_pd(v_y, v_y));
+      __m128d v_scale = _mm_add_pd(v_one, _mm_mul_pd(v_kud, v_r2));
+
+      _mm_storeu_pd(u + i, _mm_add_pd(v_u0, _mm_mul_pd(_mm_mul_pd(v_px, v_x), v_scale)));
+      _mm_storeu_pd(v + i, _mm_add_pd(v_v0, _mm_mul_pd(_mm_mul_pd(v_py, v_y), v_scale)));
+    }
+  }
+#endif
+
+  for (; i < n; i++) {
+    double x = u[i], y = v[i];
+    double scale = 1. + kud * (x * x + y * y);
+    u[i] = u0 + px * x * scale;
+    v[i] = v0 + py * y * scale;
+  }
+}
+
 #if 0
 /*!
   From the coordinates of the point in camera frame b and the transformation between
@@ -127,6 +127,16 @@ VISP_EXPORT std::ostream &operator<<(std::ostream &os, const vpMoment &m)
   return os;
 }
 
+/*!
+  Returns the names of the moments that have to be computed before this one,
+  that is the moments read from the database in compute(). They are used by
+  vpMomentDatabase::compute() to order the computations.
+
+  The default implementation returns no dependency. Types inheriting from
+  vpMoment that access other moments of the database should implement it.
+*/
+std::vector<const char *> vpMoment::getDependencies() const { return std::vector<const char *>(); }
+
 /*!
 Prints values of all dependent moments required to calculate a specific
 vpMoment. Not made pure to maintain compatibility Recommended : Types
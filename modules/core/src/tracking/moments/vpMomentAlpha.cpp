@@ -160,6 +160,15 @@ VISP_EXPORT std::ostream &operator<<(std::ostream &os, const vpMomentAlpha &c)
   return os;
 }
 
+/*!
+  Names of the moments computed before vpMomentAlpha by vpMomentDatabase::compute():
+  vpMomentCentered.
+*/
+std::vector<const char *> vpMomentAlpha::getDependencies() const
+{
+  return std::vector<const char *>(1, "vpMomentCentered");
+}
+
 /*!
 Prints the dependencies of alpha, namely centered moments mu11, mu20 ad mu02
 */
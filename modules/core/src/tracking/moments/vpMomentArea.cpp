@@ -81,6 +81,15 @@ VISP_EXPORT std::ostream &operator<<(std::ostream &os, const vpMomentArea &m)
   return os;
 }
 
+/*!
+  Names of the moments computed before vpMomentArea by vpMomentDatabase::compute():
+  vpMomentCentered.
+*/
+std::vector<const char *> vpMomentArea::getDependencies() const
+{
+  return std::vector<const char *>(1, "vpMomentCentered");
+}
+
 /*!
 If the vpMomentObject type is
 1. DISCRETE(set of discrete points), uses mu20+mu02
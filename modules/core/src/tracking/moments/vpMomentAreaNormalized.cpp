@@ -91,6 +91,15 @@ VISP_EXPORT std::ostream &operator<<(std::ostream &os, const vpMomentAreaNormali
   return os;
 }
 
+/*!
+  Names of the moments computed before vpMomentAreaNormalized by vpMomentDatabase::compute():
+  vpMomentCentered.
+*/
+std::vector<const char *> vpMomentAreaNormalized::getDependencies() const
+{
+  return std::vector<const char *>(1, "vpMomentCentered");
+}
+
 /*!
 Prints dependencies namely,
 1. Depth at desired pose Z*
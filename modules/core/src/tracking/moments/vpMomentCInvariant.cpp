@@ -282,6 +282,15 @@ void vpMomentCInvariant::printInvariants(std::ostream &os) const
   os << std::endl;
 }
 
+/*!
+  Names of the moments computed before vpMomentCInvariant by vpMomentDatabase::compute():
+  vpMomentCentered.
+*/
+std::vector<const char *> vpMomentCInvariant::getDependencies() const
+{
+  return std::vector<const char *>(1, "vpMomentCentered");
+}
+
 /*!
   Outputs the moment's values to a stream.
 */
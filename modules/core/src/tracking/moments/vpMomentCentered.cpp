@@ -163,6 +163,15 @@ void vpMomentCentered::printWithIndices(std::ostream &os) const
   os << std::endl;
 }
 
+/*!
+  Names of the moments computed before vpMomentCentered by vpMomentDatabase::compute():
+  vpMomentGravityCenter.
+*/
+std::vector<const char *> vpMomentCentered::getDependencies() const
+{
+  return std::vector<const char *>(1, "vpMomentGravityCenter");
+}
+
 /*!
 Prints moments required for calculation of vpMomentCentered,
 which are
@@ -38,6 +38,7 @@
 
 #include <iostream>
 #include <typeinfo>
+#include <visp3/core/vpException.h>
 #include <visp3/core/vpMoment.h>
 #include <visp3/core/vpMomentDatabase.h>
 #include <visp3/core/vpMomentObject.h>
@@ -87,6 +88,94 @@ void vpMomentDatabase::updateAll(vpMomentObject &object)
   }
 }
 
+/*!
+  Appends \e moment to \e order after the moments of the database it depends
+  on (see vpMoment::getDependencies()). Dependencies that are not in the
+  database are ignored: the moment reports them itself when computed.
+
+  \param moment : Moment to add.
+  \param states : Traversal state of the moments already visited (1 while
+  visiting its dependencies, 2 once added to \e order).
+  \param order : Moments sorted so that each one follows its dependencies.
+*/
+void vpMomentDatabase::sortByDependencies(vpMoment *moment, std::map<const vpMoment *, int> &states,
+                                          std::vector<vpMoment *> &order) const
+{
+  int &state = states[moment];
+  if (state == 2) {
+    return;
+  }
+  if (state == 1) {
+    throw vpException(vpException::fatalError, "Cyclic dependency involving moment %s", moment->name());
+  }
+  state = 1;
+
+  std::vector<const char *> dependencies = moment->getDependencies();
+  for (size_t i = 0; i < dependencies.size(); i++) {
+    std::map<const char *, vpMoment *, vpMomentDatabase::cmp_str>::const_iterator it = moments.find(dependencies[i]);
+    if (it != moments.end()) {
+      sortByDependencies(it->second, states, order);
+    }
+  }
+
+  state = 2;
+  order.push_back(moment);
+}
+
+/*!
+  Updates the moment object and computes the moments \e names as well as all
+  the moments they depend on. Each moment is computed once, after its
+  dependencies. The other moments of the database are left untouched, which
+  saves the computation of the moments that are not used, for example by the
+  visual features of a servo task.
+
+  \param object : Moment object from which the moments are computed.
+  \param names : Names of the moments to compute.
+
+  \exception vpException::notInitialized : If one of the moments is not in the
+  database.
+*/
+void vpMomentDatabase::compute(vpMomentObject &object, const std::vector<const char *> &names)
+{
+  std::map<const vpMoment *, int> states;
+  std::vector<vpMoment *> order;
+  for (size_t i = 0; i < names.size(); i++) {
+    std::map<const char *, vpMoment *, vpMomentDatabase::cmp_str>::const_iterator it = moments.find(names[i]);
+    if (it == moments.end()) {
+      throw vpException(vpException::notInitialized, "Moment %s not found in the database", names[i]);
+    }
+    sortByDependencies(it->second, states, order);
+  }
+
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i]->update(object);
+    order[i]->compute();
+  }
+}
+
+/*!
+  Updates the moment object and computes all the moments in the database,
+  each one after the moments it depends on.
+
+  \param object : Moment object from which the moments are computed.
+
+  \sa compute()
+*/
+void vpMomentDatabase::computeAll(vpMomentObject &object)
+{
+  std::map<const vpMoment *, int> states;
+  std::vector<vpMoment *> order;
+  std::map<const char *, vpMoment *, vpMomentDatabase::cmp_str>::const_iterator itr;
+  for (itr = moments.begin(); itr != moments.end(); ++itr) {
+    sortByDependencies(itr->second, states, order);
+  }
+
+  for (size_t i = 0; i < order.size(); i++) {
+    order[i]->update(object);
+    order[i]->compute();
+  }
+}
+
 /*!
         Outputs all the moments values in the database to a stream.
 */
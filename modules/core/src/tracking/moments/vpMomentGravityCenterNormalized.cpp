@@ -83,6 +83,18 @@ VISP_EXPORT std::ostream &operator<<(std::ostream &os, const vpMomentGravityCent
   return os;
 }
 
+/*!
+  Names of the moments computed before vpMomentGravityCenterNormalized by vpMomentDatabase::compute():
+  vpMomentGravityCenter and vpMomentAreaNormalized.
+*/
+std::vector<const char *> vpMomentGravityCenterNormalized::getDependencies() const
+{
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentGravityCenter");
+  dependencies.push_back("vpMomentAreaNormalized");
+  return dependencies;
+}
+
 /*!
 Prints the dependent moments,
 1. centre of gravity
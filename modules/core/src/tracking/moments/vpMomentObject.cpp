@@ -43,14 +43,198 @@
 #include <visp3/core/vpMomentObject.h>
 #include <visp3/core/vpPixelMeterConversion.h>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
+#include <visp3/core/vpCPUFeatures.h>
+
 #ifdef VISP_HAVE_OPENMP
 #include <omp.h>
 #endif
 #include <cassert>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+namespace
+{
+/*
+  Accumulate the moments of horizontal runs of pixels. Without distortion the abscissa of a pixel
+  only depends on its column and its ordinate on its row, so that the moments are separable:
+  m_pq = sum_v y_v^q sum_u x_u^p. The sums of the powers of the abscissas of a run are given by
+  prefix sums over the columns, and are combined with the powers of the ordinate once per row.
+*/
+class vpRunMoments
+{
+public:
+  vpRunMoments(const vpCameraParameters &cam, const unsigned int cols, const unsigned int order)
+    : m_moments(order * order, 0.), m_cam(cam), m_order(order), m_cols(cols), m_prefix(), m_sums(order, 0.),
+      m_v(0), m_nbRuns(0),
+      m_separable(cam.get_projModel() == vpCameraParameters::perspectiveProjWithoutDistortion)
+  {
+    if (m_separable) {
+      m_prefix.resize((size_t)order * (cols + 1));
+      for (unsigned int u = 0; u < cols; u++) {
+        double x = (u - cam.get_u0()) * cam.get_px_inverse();
+        double xval = 1.;
+        for (unsigned int p = 0; p < order; p++) {
+          m_prefix[p * (cols + 1) + u + 1] = m_prefix[p * (cols + 1) + u] + xval;
+          xval *= x;
+        }
+      }
+    }
+  }
+
+  void add(const unsigned int v, const unsigned int u_min, const unsigned int u_max)
+  {
+    if (!m_separable) {
+      for (unsigned int u = u_min; u <= u_max; u++) {
+        double x = 0, y = 0;
+        vpPixelMeterConversion::convertPoint(m_cam, u, v, x, y);
+        double yval = 1.;
+        for (unsigned int k = 0; k < m_order; k++) {
+          double xval = 1.;
+          for (unsigned int l = 0; l < m_order - k; l++) {
+            m_moments[k * m_order + l] += xval * yval;
+            xval *= x;
+          }
+          yval *= y;
+        }
+      }
+      return;
+    }
+
+    if (m_nbRuns > 0 && v != m_v) {
+      flush();
+    }
+
+    m_v = v;
+    m_nbRuns++;
+    for (unsigned int p = 0; p < m_order; p++) {
+      const double *prefix = &m_prefix[p * (m_cols + 1)];
+      m_sums[p] += prefix[u_max + 1] - prefix[u_min];
+    }
+  }
+
+  // Add the moments of the runs of the current row
+  void flush()
+  {
+    if (m_nbRuns == 0) {
+      return;
+    }
+
+    double y = (m_v - m_cam.get_v0()) * m_cam.get_py_inverse();
+    double yval = 1.;
+    for (unsigned int k = 0; k < m_order; k++) {
+      for (unsigned int l = 0; l < m_order - k; l++) {
+        m_moments[k * m_order + l] += yval * m_sums[l];
+      }
+      yval *= y;
+    }
+
+    std::fill(m_sums.begin(), m_sums.end(), 0.);
+    m_nbRuns = 0;
+  }
+
+  std::vector<double> m_moments;
+
+private:
+  vpCameraParameters m_cam;
+  unsigned int m_order;
+  unsigned int m_cols;
+  std::vector<double> m_prefix;
+  std::vector<double> m_sums;
+  unsigned int m_v;
+  unsigned int m_nbRuns;
+  bool m_separable;
+};
+
+// Moments of the runs of the pixels selected by a predicate, the rows being processed in parallel
+template <class Type, class Predicate>
+void computeRunMoments(const vpImage<Type> &image, const Predicate &selected, const vpCameraParameters &cam,
+                       const unsigned int order, std::vector<double> &values)
+{
+  values.assign(order * order, 0.);
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel
+#endif
+  {
+    vpRunMoments runMoments(cam, image.getCols(), order);
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp for nowait
+#endif
+    for (int v = 0; v < (int)image.getRows(); v++) {
+      const Type *row = image[v];
+      unsigned int u = 0;
+      while (u < image.getCols()) {
+        for (; u < image.getCols() && !selected(row[u]); u++) {
+        }
+        if (u == image.getCols()) {
+          break;
+        }
+
+        unsigned int u_min = u;
+        for (; u < image.getCols() && selected(row[u]); u++) {
+        }
+        runMoments.add((unsigned int)v, u_min, u - 1);
+      }
+    }
+    runMoments.flush();
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp critical
+#endif
+    for (size_t k = 0; k < values.size(); k++) {
+      values[k] += runMoments.m_moments[k];
+    }
+  }
+}
+
+struct vpThresholdPredicate {
+  unsigned char m_threshold;
+  explicit vpThresholdPredicate(const unsigned char threshold) : m_threshold(threshold) {}
+  bool operator()(const unsigned char value) const { return value > m_threshold; }
+};
+
+struct vpLabelPredicate {
+  int m_label;
+  explicit vpLabelPredicate(const int label) : m_label(label) {}
+  bool operator()(const int value) const { return value == m_label; }
+};
+
+// Dot product of two arrays of doubles
+double dotProduct(const double *a, const double *b, const unsigned int n)
+{
+  double sum = 0.;
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && n >= 4) {
+    __m128d sum0 = _mm_setzero_pd(), sum1 = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+      sum0 = _mm_add_pd(sum0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+      sum1 = _mm_add_pd(sum1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+    }
+
+    double sums[2];
+    _mm_storeu_pd(sums, _mm_add_pd(sum0, sum1));
+    sum = sums[0] + sums[1];
+  }
+#endif
+
+  for (; i < n; i++) {
+    sum += a[i] * b[i];
+  }
+
+  return sum;
+}
+} // namespace
+
 /*!
   Computes moments from a vector of points describing a polygon.
   The points must be stored in a clockwise order. Used internally.
@@ -257,6 +441,9 @@ void vpMomentObject::fromVector(std::vector<vpPoint> &points)
   There is no assumption made about whether the input is dense or discrete but
 it's more common to use vpMomentObject::DENSE_FULL_OBJECT with this method.
 
+  Without distortion the moments are separable and are computed from the
+horizontal runs of the object pixels, see fromRuns().
+
   \param image : Image to consider.
   \param threshold : Pixels with a luminance lower than this threshold will be
 considered. \param cam : Camera parameters used to convert pixels coordinates
@@ -289,67 +476,7 @@ image
 void vpMomentObject::fromImage(const vpImage<unsigned char> &image, unsigned char threshold,
                                const vpCameraParameters &cam)
 {
-#ifdef VISP_HAVE_OPENMP
-#pragma omp parallel shared(threshold)
-  {
-    std::vector<double> curvals(order * order);
-    curvals.assign(order * order, 0.);
-
-#pragma omp for nowait // automatically organize loop counter between threads
-    for (int i = 0; i < (int)image.getCols(); i++) {
-      for (int j = 0; j < (int)image.getRows(); j++) {
-        unsigned int i_ = static_cast<unsigned int>(i);
-        unsigned int j_ = static_cast<unsigned int>(j);
-        if (image[j_][i_] > threshold) {
-          double x = 0;
-          double y = 0;
-          vpPixelMeterConversion::convertPoint(cam, i_, j_, x, y);
-
-          double yval = 1.;
-          for (unsigned int k = 0; k < order; k++) {
-            double xval = 1.;
-            for (unsigned int l = 0; l < order - k; l++) {
-              curvals[(k * order + l)] += (xval * yval);
-              xval *= x;
-            }
-            yval *= y;
-          }
-        }
-      }
-    }
-
-#pragma omp master // only set this variable in master thread
-    {
-      values.assign(order * order, 0.);
-    }
-
-#pragma omp barrier
-    for (unsigned int k = 0; k < order; k++) {
-      for (unsigned int l = 0; l < order - k; l++) {
-#pragma omp atomic
-        values[k * order + l] += curvals[k * order + l];
-      }
-    }
-  }
-#else
-  std::vector<double> cache(order * order, 0.);
-  values.assign(order * order, 0);
-  for (unsigned int i = 0; i < image.getCols(); i++) {
-    for (unsigned int j = 0; j < image.getRows(); j++) {
-      if (image[j][i] > threshold) {
-        double x = 0;
-        double y = 0;
-        vpPixelMeterConversion::convertPoint(cam, i, j, x, y);
-        cacheValues(cache, x, y);
-        for (unsigned int k = 0; k < order; k++) {
-          for (unsigned int l = 0; l < order - k; l++) {
-            values[k * order + l] += cache[k * order + l];
-          }
-        }
-      }
-    }
-  }
-#endif
+  computeRunMoments(image, vpThresholdPredicate(threshold), cam, order, values);
 
   // Normalisation equivalent to sampling interval/pixel size delX x delY
   double norm_factor = 1. / (cam.get_px() * cam.get_py());
@@ -394,7 +521,57 @@ void vpMomentObject::fromImage(const vpImage<unsigned char> &image, const vpCame
     iscale = 1.0 / Imax;
   }
 
-  if (bg_type == vpMomentObject::WHITE) {
+  if (cam.get_projModel() == vpCameraParameters::perspectiveProjWithoutDistortion) {
+    // Separable computation: the sums of the powers of the abscissas of each row weighted by the
+    // intensities are dot products with the powers of the abscissas of the columns
+    const unsigned int cols = image.getCols();
+    std::vector<double> xPowers((size_t)order * cols);
+    for (unsigned int i = 0; i < cols; i++) {
+      x = (i - cam.get_u0()) * cam.get_px_inverse();
+      double xval = 1.;
+      for (unsigned int l = 0; l < order; l++) {
+        xPowers[l * cols + i] = xval;
+        xval *= x;
+      }
+    }
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel
+#endif
+    {
+      std::vector<double> curvals(order * order, 0.), weights(cols), sums(order);
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp for nowait
+#endif
+      for (int j = 0; j < (int)image.getRows(); j++) {
+        for (unsigned int i = 0; i < cols; i++) {
+          double intensity_ = (double)(image[j][i]) * iscale;
+          weights[i] = bg_type == vpMomentObject::WHITE ? 1. - intensity_ : intensity_;
+        }
+
+        for (unsigned int l = 0; l < order; l++) {
+          sums[l] = dotProduct(&weights[0], &xPowers[l * cols], cols);
+        }
+
+        double yval = 1.;
+        double y_ = (j - cam.get_v0()) * cam.get_py_inverse();
+        for (unsigned int k = 0; k < order; k++) {
+          for (unsigned int l = 0; l < order - k; l++) {
+            curvals[k * order + l] += yval * sums[l];
+          }
+          yval *= y_;
+        }
+      }
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp critical
+#endif
+      for (unsigned int k = 0; k < order * order; k++) {
+        values[k] += curvals[k];
+      }
+    }
+  } else if (bg_type == vpMomentObject::WHITE) {
     /////////// WHITE BACKGROUND ///////////
     for (unsigned int j = 0; j < image.getRows(); j++) {
       for (unsigned int i = 0; i < image.getCols(); i++) {
@@ -452,6 +629,66 @@ void vpMomentObject::fromImage(const vpImage<unsigned char> &image, const vpCame
   }
 }
 
+/*!
+  Computes basic moments of a dense object given by a connected component
+  label, for instance from the label image computed by
+  vp::connectedComponents(). The moments are computed as with
+  fromImage(const vpImage<unsigned char> &, unsigned char, const vpCameraParameters &),
+  the object being the pixels equal to \e label.
+
+  \param labels : Label image.
+  \param label : Label of the object.
+  \param cam : Camera parameters used to convert pixels coordinates in meters
+  in the image plane.
+*/
+void vpMomentObject::fromLabels(const vpImage<int> &labels, const int label, const vpCameraParameters &cam)
+{
+  computeRunMoments(labels, vpLabelPredicate(label), cam, order, values);
+
+  // Normalisation equivalent to sampling interval/pixel size delX x delY
+  double norm_factor = 1. / (cam.get_px() * cam.get_py());
+  for (std::vector<double>::iterator it = values.begin(); it != values.end(); ++it) {
+    *it = (*it) * norm_factor;
+  }
+}
+
+/*!
+  Computes basic moments of a dense object given by horizontal runs of
+  pixels, for instance the runs of a blob found by a tracker. Without
+  distortion, the cost is proportional to the number of runs and not to the
+  number of pixels. The moments are normalized as with
+  fromImage(const vpImage<unsigned char> &, unsigned char, const vpCameraParameters &).
+
+  \param runs : Runs of the object, preferably sorted by row. The runs must
+  not overlap.
+  \param cam : Camera parameters used to convert pixels coordinates in meters
+  in the image plane.
+*/
+void vpMomentObject::fromRuns(const std::vector<vpPixelRun> &runs, const vpCameraParameters &cam)
+{
+  unsigned int cols = 0;
+  for (std::vector<vpPixelRun>::const_iterator it = runs.begin(); it != runs.end(); ++it) {
+    if (it->u_min > it->u_max) {
+      throw vpException(vpException::badValue, "Bad run on row %d: first column %d after last column %d", it->v,
+                        it->u_min, it->u_max);
+    }
+    cols = (std::max)(cols, it->u_max + 1);
+  }
+
+  vpRunMoments runMoments(cam, cols, order);
+  for (std::vector<vpPixelRun>::const_iterator it = runs.begin(); it != runs.end(); ++it) {
+    runMoments.add(it->v, it->u_min, it->u_max);
+  }
+  runMoments.flush();
+  values = runMoments.m_moments;
+
+  // Normalisation equivalent to sampling interval/pixel size delX x delY
+  double norm_factor = 1. / (cam.get_px() * cam.get_py());
+  for (std::vector<double>::iterator it = values.begin(); it != values.end(); ++it) {
+    *it = (*it) * norm_factor;
+  }
+}
+
 /*!
   Does exactly the work of the default constructor as it existed in the very
   first version of vpMomentObject
@@ -0,0 +1,97 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test batch point projection.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPointProjection.cpp
+
+  Compare vpPoint::projectPoints() with the projection of each vpPoint.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpMeterPixelConversion.h>
+#include <visp3/core/vpPoint.h>
+#include <visp3/core/vpUniRand.h>
+
+int main()
+{
+  try {
+    const unsigned int n = 101;
+    vpUniRand rng;
+    std::vector<double> oX(n), oY(n), oZ(n);
+    for (unsigned int i = 0; i < n; i++) {
+      oX[i] = rng() - 0.5;
+      oY[i] = rng() - 0.5;
+      oZ[i] = 0.4 * rng() - 0.2;
+    }
+
+    vpHomogeneousMatrix cMo(0.1, -0.05, 1.5, vpMath::rad(10), vpMath::rad(-20), vpMath::rad(30));
+    vpCameraParameters cam;
+    cam.initPersProjWithDistortion(600, 610, 320, 240, -0.1, 0.1);
+
+    std::vector<double> x(n), y(n), Z(n), u(n), v(n);
+    vpPoint::projectPoints(cMo, n, oX.data(), oY.data(), oZ.data(), x.data(), y.data(), Z.data());
+    vpPoint::projectPoints(cMo, cam, n, oX.data(), oY.data(), oZ.data(), u.data(), v.data());
+
+    for (unsigned int i = 0; i < n; i++) {
+      vpPoint P(oX[i], oY[i], oZ[i]);
+      P.track(cMo);
+      double u_ref = 0, v_ref = 0;
+      vpMeterPixelConversion::convertPoint(cam, P.get_x(), P.get_y(), u_ref, v_ref);
+
+      if (!vpMath::equal(P.get_x(), x[i], 1e-12) || !vpMath::equal(P.get_y(), y[i], 1e-12) ||
+          !vpMath::equal(P.get_Z(), Z[i], 1e-12)) {
+        std::cerr << "Bad normalized coordinates for point " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (!vpMath::equal(u_ref, u[i], 1e-9) || !vpMath::equal(v_ref, v[i], 1e-9)) {
+        std::cerr << "Bad pixel coordinates for point " << i << ": (" << u[i] << ", " << v[i] << ") instead of ("
+                  << u_ref << ", " << v_ref << ")" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    std::cout << "testPointProjection is ok" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,213 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test writing images in background threads.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testAsyncImageWriter.cpp
+
+  Write images with vpAsyncImageWriter and vpVideoWriter using the different
+  queue policies, then read them back.
+*/
+
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/io/vpAsyncImageWriter.h>
+#include <visp3/io/vpImageIo.h>
+#include <visp3/io/vpVideoWriter.h>
+
+namespace
+{
+// Pseudo random pixels, slow to compress
+void buildImage(vpImage<unsigned char> &I, unsigned int index)
+{
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      unsigned int h = (index * 7919u + i * 104729u + j) * 2654435761u;
+      I[i][j] = static_cast<unsigned char>(h >> 24);
+    }
+  }
+}
+
+std::string getFileName(const std::string &opath, const char *format, unsigned int index)
+{
+  char name[FILENAME_MAX];
+  sprintf(name, format, index);
+  return vpIoTools::createFilePath(opath, name);
+}
+
+// Checks the written images and removes them
+bool checkImages(const std::string &opath, const char *format, const std::vector<bool> &written,
+                 unsigned int height = 60, unsigned int width = 80)
+{
+  vpImage<unsigned char> I, I_ref(height, width);
+  for (unsigned int k = 0; k < written.size(); k++) {
+    std::string filename = getFileName(opath, format, k);
+    if (vpIoTools::checkFilename(filename) != written[k]) {
+      std::cerr << "Image " << filename << (written[k] ? " is missing" : " should be dropped") << std::endl;
+      return false;
+    }
+    if (written[k]) {
+      vpImageIo::read(I, filename);
+      buildImage(I_ref, k);
+      if (!(I_ref == I)) {
+        std::cerr << "Wrong content for image " << filename << std::endl;
+        return false;
+      }
+      vpIoTools::remove(filename);
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+#if defined(_WIN32)
+    std::string opath = "C:/temp";
+#else
+    std::string opath = "/tmp";
+#endif
+    std::string username;
+    vpIoTools::getUserName(username);
+    opath = vpIoTools::createFilePath(vpIoTools::createFilePath(opath, username), "testAsyncImageWriter");
+    vpIoTools::makeDirectory(opath);
+
+    const unsigned int nbImages = 40;
+    vpImage<unsigned char> I(60, 80);
+    {
+      vpAsyncImageWriter writer(2, 2, vpAsyncImageWriter::BLOCK);
+      for (unsigned int k = 0; k < nbImages; k++) {
+        buildImage(I, k);
+        writer.write(I, getFileName(opath, "image%04u.pgm", k));
+      }
+      writer.flush();
+      if (writer.getWrittenCount() != nbImages || writer.getDroppedCount() != 0) {
+        std::cerr << "No image should be dropped when blocking" << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (!checkImages(opath, "image%04u.pgm", std::vector<bool>(nbImages, true))) {
+        return EXIT_FAILURE;
+      }
+    }
+
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY) && defined(VISP_HAVE_PNG)
+    // Large PNG images written by a single thread do not keep up with images that are already built
+    const unsigned int nbLargeImages = 12;
+    std::vector<vpImage<unsigned char> > images(nbLargeImages, vpImage<unsigned char>(1000, 1000));
+    for (unsigned int k = 0; k < nbLargeImages; k++) {
+      buildImage(images[k], k);
+    }
+    vpAsyncImageWriter::vpQueuePolicy policies[2] = {vpAsyncImageWriter::DROP_OLDEST,
+                                                     vpAsyncImageWriter::DROP_NEWEST};
+    for (unsigned int p = 0; p < 2; p++) {
+      vpAsyncImageWriter writer(2, 1, policies[p]);
+      std::vector<bool> written(nbLargeImages);
+      for (unsigned int k = 0; k < nbLargeImages; k++) {
+        written[k] = writer.write(images[k], getFileName(opath, "image%04u.png", k));
+      }
+      writer.flush();
+
+      unsigned int nbWritten = 0;
+      for (unsigned int k = 0; k < nbLargeImages; k++) {
+        const bool exists = vpIoTools::checkFilename(getFileName(opath, "image%04u.png", k));
+        if (policies[p] == vpAsyncImageWriter::DROP_OLDEST) {
+          // Dropped images are only known once written
+          if (!written[k]) {
+            std::cerr << "Image " << k << " refused with the DROP_OLDEST policy" << std::endl;
+            return EXIT_FAILURE;
+          }
+          written[k] = exists;
+        }
+        nbWritten += written[k] ? 1 : 0;
+      }
+
+      if (writer.getDroppedCount() == 0 || writer.getWrittenCount() != nbWritten ||
+          writer.getWrittenCount() + writer.getDroppedCount() != nbLargeImages) {
+        std::cerr << "Policy " << policies[p] << ": " << writer.getWrittenCount() << " images written and "
+                  << writer.getDroppedCount() << " dropped out of " << nbLargeImages << std::endl;
+        return EXIT_FAILURE;
+      }
+      // The newest image is never dropped with DROP_OLDEST, the first ones fill the queue with DROP_NEWEST
+      if ((policies[p] == vpAsyncImageWriter::DROP_OLDEST && !written[nbLargeImages - 1]) ||
+          (policies[p] == vpAsyncImageWriter::DROP_NEWEST && (!written[0] || !written[1]))) {
+        std::cerr << "Policy " << policies[p] << ": wrong images dropped" << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (!checkImages(opath, "image%04u.png", written, 1000, 1000)) {
+        return EXIT_FAILURE;
+      }
+      std::cout << "Policy " << policies[p] << ": " << writer.getDroppedCount() << " images dropped" << std::endl;
+    }
+#endif
+
+    // Write errors are reported by flush()
+    {
+      vpAsyncImageWriter writer;
+      writer.write(I, vpIoTools::createFilePath(opath, "missing-directory/image.pgm"));
+      bool reported = false;
+      try {
+        writer.flush();
+      } catch (const vpException &) {
+        reported = true;
+      }
+      if (!reported || writer.getWrittenCount() != 0) {
+        std::cerr << "Write error not reported" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Image sequence written asynchronously by vpVideoWriter
+    vpVideoWriter videoWriter;
+    videoWriter.setAsynchronous(4, 2);
+    videoWriter.setFileName(vpIoTools::createFilePath(opath, "video%04d.pgm"));
+    videoWriter.open(I);
+    for (unsigned int k = 0; k < nbImages; k++) {
+      buildImage(I, k);
+      videoWriter.saveFrame(I);
+    }
+    videoWriter.close();
+    if (!checkImages(opath, "video%04u.pgm", std::vector<bool>(nbImages, true))) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testAsyncImageWriter is ok" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
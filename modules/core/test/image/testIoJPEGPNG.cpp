@@ -0,0 +1,232 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test reading and writing JPEG and PNG images with libjpeg and libpng.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testIoJPEGPNG.cpp
+
+  Write JPEG and PNG images, read them back in gray level and color images,
+  with JPEG reduced size decoding and different PNG compression levels.
+*/
+
+#include <cmath>
+#include <iostream>
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/io/vpImageIo.h>
+
+#if defined(VISP_HAVE_JPEG) && defined(VISP_HAVE_PNG)
+namespace
+{
+// Smooth color image with odd size to deal with the DCT scaling rounding
+void buildImage(vpImage<vpRGBa> &I)
+{
+  I.resize(123, 157);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I[i][j] = vpRGBa(static_cast<unsigned char>(2 * i), static_cast<unsigned char>(j + 40),
+                       static_cast<unsigned char>((i + j) / 2), static_cast<unsigned char>(i + j));
+    }
+  }
+}
+
+// Mean absolute difference between the reduced image and the average of the
+// corresponding blocks of the full size image
+double blockDifference(const vpImage<unsigned char> &I_full, const vpImage<unsigned char> &I_reduced,
+                       unsigned int downscale)
+{
+  double diff = 0;
+  for (unsigned int i = 0; i < I_reduced.getHeight(); i++) {
+    for (unsigned int j = 0; j < I_reduced.getWidth(); j++) {
+      double sum = 0;
+      unsigned int nb = 0;
+      for (unsigned int k = i * downscale; k < std::min((i + 1) * downscale, I_full.getHeight()); k++) {
+        for (unsigned int l = j * downscale; l < std::min((j + 1) * downscale, I_full.getWidth()); l++, nb++) {
+          sum += I_full[k][l];
+        }
+      }
+      diff += std::fabs(sum / nb - I_reduced[i][j]);
+    }
+  }
+  return diff / I_reduced.getSize();
+}
+
+// Maximal absolute difference between two gray level images
+int maxDifference(const vpImage<unsigned char> &I1, const vpImage<unsigned char> &I2)
+{
+  int diff = 0;
+  for (unsigned int i = 0; i < I1.getSize(); i++) {
+    diff = std::max(diff, std::abs(static_cast<int>(I1.bitmap[i]) - static_cast<int>(I2.bitmap[i])));
+  }
+  return diff;
+}
+}
+#endif
+
+int main()
+{
+#if defined(VISP_HAVE_JPEG) && defined(VISP_HAVE_PNG)
+  try {
+#if defined(_WIN32)
+    std::string opath = "C:/temp";
+#else
+    std::string opath = "/tmp";
+#endif
+    std::string username;
+    vpIoTools::getUserName(username);
+    opath = vpIoTools::createFilePath(vpIoTools::createFilePath(opath, username), "testIoJPEGPNG");
+    vpIoTools::makeDirectory(opath);
+
+    vpImage<vpRGBa> C_ref, C;
+    vpImage<unsigned char> G_ref, G;
+    buildImage(C_ref);
+    vpImageConvert::convert(C_ref, G_ref);
+
+    // PNG is lossless whatever the compression level. The alpha channel is
+    // not written.
+    vpImage<vpRGBa> C_opaque = C_ref;
+    for (unsigned int i = 0; i < C_opaque.getSize(); i++) {
+      C_opaque.bitmap[i].A = vpRGBa::alpha_default;
+    }
+    int levels[4] = {-1, 0, 1, 9};
+    for (unsigned int k = 0; k < 4; k++) {
+      std::string filename_color = vpIoTools::createFilePath(opath, "color.png");
+      std::string filename_grey = vpIoTools::createFilePath(opath, "grey.png");
+      vpImageIo::writePNG(C_ref, filename_color, levels[k]);
+      vpImageIo::writePNG(G_ref, filename_grey, levels[k]);
+
+      // Rows are converted in gray level one by one: the SSE and scalar
+      // conversions may round differently
+      vpImageIo::readPNG(C, filename_color);
+      vpImageIo::readPNG(G, filename_color);
+      if (!(C == C_opaque) || maxDifference(G, G_ref) > 1) {
+        std::cerr << "Wrong content for color PNG image written with level " << levels[k] << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      vpImage<vpRGBa> C_grey;
+      vpImageConvert::convert(G_ref, C_grey);
+      vpImageIo::readPNG(C, filename_grey);
+      vpImageIo::readPNG(G, filename_grey);
+      if (!(C == C_grey) || !(G == G_ref)) {
+        std::cerr << "Wrong content for gray level PNG image written with level " << levels[k] << std::endl;
+        return EXIT_FAILURE;
+      }
+      std::cout << "PNG with compression level " << levels[k] << " is ok" << std::endl;
+    }
+
+    // JPEG gray level decoding only keeps the luminance of color images
+    std::string filename = vpIoTools::createFilePath(opath, "color.jpg");
+    vpImageIo::writeJPEG(C_ref, filename);
+    vpImageIo::readJPEG(C, filename);
+    vpImageIo::readJPEG(G, filename);
+    vpImage<unsigned char> G_luma(C.getHeight(), C.getWidth());
+    for (unsigned int i = 0; i < C.getSize(); i++) {
+      if (C.bitmap[i].A != vpRGBa::alpha_default) {
+        std::cerr << "Wrong alpha channel for JPEG color image" << std::endl;
+        return EXIT_FAILURE;
+      }
+      G_luma.bitmap[i] = static_cast<unsigned char>(
+          vpMath::round(0.299 * C.bitmap[i].R + 0.587 * C.bitmap[i].G + 0.114 * C.bitmap[i].B));
+    }
+    if (C.getHeight() != C_ref.getHeight() || C.getWidth() != C_ref.getWidth() || maxDifference(G, G_luma) > 2) {
+      std::cerr << "Wrong content for JPEG color image" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    filename = vpIoTools::createFilePath(opath, "grey.jpg");
+    vpImageIo::writeJPEG(G_ref, filename);
+    vpImage<vpRGBa> C_grey;
+    vpImageIo::readJPEG(G, filename);
+    vpImageIo::readJPEG(C, filename);
+    vpImageConvert::convert(G, C_grey);
+    if (!(C == C_grey) || maxDifference(G, G_ref) > 8) {
+      std::cerr << "Wrong content for JPEG gray level image" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Reduced size decoding
+    vpImage<unsigned char> G_color;
+    filename = vpIoTools::createFilePath(opath, "color.jpg");
+    vpImageIo::readJPEG(G_color, filename);
+    unsigned int downscales[3] = {2, 4, 8};
+    for (unsigned int k = 0; k < 3; k++) {
+      unsigned int d = downscales[k];
+      vpImageIo::readJPEG(G, filename, d);
+      vpImageIo::readJPEG(C, filename, d);
+      unsigned int h = (C_ref.getHeight() + d - 1) / d, w = (C_ref.getWidth() + d - 1) / d;
+      if (G.getHeight() != h || G.getWidth() != w || C.getHeight() != h || C.getWidth() != w) {
+        std::cerr << "Wrong size " << G.getWidth() << "x" << G.getHeight() << " for JPEG image reduced by " << d
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      double diff = blockDifference(G_color, G, d);
+      if (diff > 2) {
+        std::cerr << "Wrong content for JPEG image reduced by " << d << ": mean difference " << diff << std::endl;
+        return EXIT_FAILURE;
+      }
+      std::cout << "JPEG reduced by " << d << " is ok: mean difference " << diff << std::endl;
+    }
+
+    // Invalid parameters
+    bool thrown = false;
+    try {
+      vpImageIo::readJPEG(G, filename, 3);
+    } catch (const vpException &) {
+      thrown = true;
+    }
+    try {
+      vpImageIo::writePNG(G, vpIoTools::createFilePath(opath, "grey.png"), 10);
+      thrown = false;
+    } catch (const vpException &) {
+    }
+    if (!thrown) {
+      std::cerr << "Invalid parameters not detected" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpIoTools::remove(opath);
+    std::cout << "testIoJPEGPNG is ok" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+#else
+  std::cout << "This test needs libjpeg and libpng" << std::endl;
+  return EXIT_SUCCESS;
+#endif
+}
@@ -0,0 +1,249 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test writing and reading sequences of raw images.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testRawImageFile.cpp
+
+  Write images of different pixel types with their timestamp and camera
+  parameters in a raw image file, append images to it, then read them back
+  from the memory mapped file.
+*/
+
+#include <fstream>
+#include <iostream>
+#include <string.h>
+#include <vector>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/io/vpImageIo.h>
+#include <visp3/io/vpRawImageReader.h>
+#include <visp3/io/vpRawImageWriter.h>
+
+namespace
+{
+// Pixel type unknown by vpRawImageFormat
+struct vpPoint3f {
+  float x, y, z;
+};
+
+template <class Type> void buildImage(vpImage<Type> &I, unsigned int index)
+{
+  I.resize(30 + index, 40 + 3 * index);
+  unsigned char *data = reinterpret_cast<unsigned char *>(I.bitmap);
+  for (unsigned int i = 0; i < I.getSize() * sizeof(Type); i++) {
+    data[i] = static_cast<unsigned char>((index * 7 + i) % 251);
+  }
+}
+
+template <class Type> bool isEqual(const vpImage<Type> &I1, const vpImage<Type> &I2)
+{
+  return I1.getHeight() == I2.getHeight() && I1.getWidth() == I2.getWidth() &&
+         memcmp(I1.bitmap, I2.bitmap, I1.getSize() * sizeof(Type)) == 0;
+}
+
+template <class Type> bool checkImage(const vpRawImageReader &reader, unsigned int index, unsigned int image_index)
+{
+  vpImage<Type> I, I_ref;
+  buildImage(I_ref, image_index);
+  reader.read(I, index);
+  if (!isEqual(I, I_ref) || reader.getWidth(index) != I_ref.getWidth() ||
+      reader.getHeight(index) != I_ref.getHeight()) {
+    std::cerr << "Wrong content for image " << index << std::endl;
+    return false;
+  }
+
+  // Pixels in the memory mapped file
+  const Type *pixels = reader.getPixels<Type>(index);
+  if (reinterpret_cast<size_t>(pixels) % vpRawImageFormat::alignment != 0 ||
+      memcmp(pixels, I_ref.bitmap, I_ref.getSize() * sizeof(Type)) != 0) {
+    std::cerr << "Wrong pixels for image " << index << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Writes 4 images of different types for each index
+void writeImages(vpRawImageWriter &writer, unsigned int first, unsigned int last, const vpCameraParameters &cam)
+{
+  vpImage<unsigned char> I_grey;
+  vpImage<unsigned short> I_depth;
+  vpImage<vpRGBa> I_color;
+  vpImage<vpPoint3f> I_points;
+  for (unsigned int k = first; k < last; k++) {
+    buildImage(I_grey, k);
+    buildImage(I_depth, k);
+    buildImage(I_color, k);
+    buildImage(I_points, k);
+    writer.write(I_grey, 0.1 * k, cam);
+    writer.write(I_depth, 0.1 * k);
+    writer.write(I_color, 0.1 * k, cam);
+    writer.write(I_points, 0.1 * k);
+  }
+}
+
+bool checkImages(const vpRawImageReader &reader, unsigned int nb_images, const vpCameraParameters &cam)
+{
+  if (reader.getFrameCount() != 4 * nb_images) {
+    std::cerr << "Read " << reader.getFrameCount() << " images instead of " << 4 * nb_images << std::endl;
+    return false;
+  }
+
+  for (unsigned int k = 0; k < nb_images; k++) {
+    unsigned int index = 4 * k;
+    if (!checkImage<unsigned char>(reader, index, k) || !checkImage<unsigned short>(reader, index + 1, k) ||
+        !checkImage<vpRGBa>(reader, index + 2, k) || !checkImage<vpPoint3f>(reader, index + 3, k)) {
+      return false;
+    }
+
+    vpCameraParameters cam_read;
+    if (reader.getPixelType(index) != vpRawImageFormat::PIXEL_UCHAR ||
+        reader.getPixelType(index + 1) != vpRawImageFormat::PIXEL_USHORT ||
+        reader.getPixelType(index + 2) != vpRawImageFormat::PIXEL_RGBA ||
+        reader.getPixelType(index + 3) != vpRawImageFormat::PIXEL_USER ||
+        !vpMath::equal(reader.getTimestamp(index + 1), 0.1 * k) ||
+        !reader.getCameraParameters(index + 2, cam_read) || reader.getCameraParameters(index + 3, cam_read) ||
+        cam_read.get_projModel() != cam.get_projModel() || !vpMath::equal(cam_read.get_px(), cam.get_px()) ||
+        !vpMath::equal(cam_read.get_v0(), cam.get_v0()) || !vpMath::equal(cam_read.get_kdu(), cam.get_kdu())) {
+      std::cerr << "Wrong metadata for images " << index << " to " << index + 3 << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+#if defined(_WIN32)
+    std::string opath = "C:/temp";
+#else
+    std::string opath = "/tmp";
+#endif
+    std::string username;
+    vpIoTools::getUserName(username);
+    opath = vpIoTools::createFilePath(vpIoTools::createFilePath(opath, username), "testRawImageFile");
+    vpIoTools::makeDirectory(opath);
+    std::string filename = vpIoTools::createFilePath(opath, "sequence.raw");
+
+    // Sequence written in two times
+    vpCameraParameters cam(600.5, 601.5, 320.25, 240.75, -0.1, 0.1);
+    {
+      vpRawImageWriter writer(filename);
+      writeImages(writer, 0, 3, cam);
+    }
+    {
+      vpRawImageWriter writer(filename, true);
+      writeImages(writer, 3, 5, cam);
+    }
+
+    vpRawImageReader reader(filename);
+    if (!checkImages(reader, 5, cam)) {
+      return EXIT_FAILURE;
+    }
+
+    // Wrong pixel type and index
+    vpImage<float> I_float;
+    unsigned int nb_errors = 0;
+    try {
+      reader.read(I_float, 0);
+    } catch (const vpException &) {
+      nb_errors++;
+    }
+    try {
+      reader.getPixels<unsigned char>(reader.getFrameCount());
+    } catch (const vpException &) {
+      nb_errors++;
+    }
+    if (nb_errors != 2) {
+      std::cerr << "Wrong pixel type or index not detected" << std::endl;
+      return EXIT_FAILURE;
+    }
+    reader.close();
+
+    // Interrupted recording: the incomplete last image is ignored and no image
+    // can be appended, even when the file is cut on the alignment of the images
+    std::string filename_truncated = vpIoTools::createFilePath(opath, "truncated.raw");
+    std::vector<char> data;
+    {
+      std::ifstream file(filename.c_str(), std::ios::binary);
+      data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    const size_t cuts[2] = {10, vpRawImageFormat::alignment};
+    for (unsigned int c = 0; c < 2; c++) {
+      {
+        std::ofstream file_truncated(filename_truncated.c_str(), std::ios::binary);
+        file_truncated.write(&data[0], static_cast<std::streamsize>(data.size() - cuts[c]));
+      }
+      reader.open(filename_truncated);
+      if (reader.getFrameCount() != 4 * 5 - 1 || !checkImage<vpRGBa>(reader, 4 * 4 + 2, 4)) {
+        std::cerr << "Wrong truncated file reading" << std::endl;
+        return EXIT_FAILURE;
+      }
+      reader.close();
+      bool thrown = false;
+      try {
+        vpRawImageWriter writer(filename_truncated, true);
+      } catch (const vpException &) {
+        thrown = true;
+      }
+      if (!thrown) {
+        std::cerr << "Append to a file truncated by " << cuts[c] << " bytes not detected" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Single image read and written with vpImageIo, including an empty image
+    vpImage<float> I_float_ref;
+    buildImage(I_float_ref, 1);
+    std::string filename_float = vpIoTools::createFilePath(opath, "image.raw");
+    vpImageIo::writeRAW(I_float_ref, filename_float);
+    vpImageIo::readRAW(I_float, filename_float);
+    vpImage<double> I_empty(2, 2), I_empty_ref;
+    vpImageIo::writeRAW(I_empty_ref, filename_float);
+    vpImageIo::readRAW(I_empty, filename_float);
+    if (!isEqual(I_float, I_float_ref) || !isEqual(I_empty, I_empty_ref)) {
+      std::cerr << "Wrong content for image written with vpImageIo" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpIoTools::remove(opath);
+    std::cout << "testRawImageFile is ok" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
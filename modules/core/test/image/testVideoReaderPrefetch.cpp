@@ -0,0 +1,184 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the background decoding of image sequences by vpVideoReader.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testVideoReaderPrefetch.cpp
+
+  Write a sequence of images, then check that vpVideoReader returns the same
+  images and frame indexes with and without prefetching, with a frame step and
+  after seeking with getFrame().
+*/
+
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/io/vpImageIo.h>
+#include <visp3/io/vpVideoReader.h>
+
+namespace
+{
+const unsigned int nbImages = 12;
+
+void buildImage(vpImage<unsigned char> &I, long index)
+{
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I[i][j] = static_cast<unsigned char>((index * 7 + i + 3 * j) % 256);
+    }
+  }
+}
+
+bool checkImage(const vpImage<unsigned char> &I, long index)
+{
+  vpImage<unsigned char> I_ref(30, 40);
+  buildImage(I_ref, index);
+  if (!(I_ref == I)) {
+    std::cerr << "Wrong image content for frame " << index << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Reads the whole sequence and returns the frame indexes
+bool readSequence(const std::string &filename, unsigned int prefetch, long step, std::vector<long> &indexes)
+{
+  vpVideoReader reader;
+  reader.setFileName(filename);
+  reader.setFrameStep(step);
+  reader.setPrefetch(prefetch);
+
+  vpImage<unsigned char> I;
+  reader.open(I);
+  indexes.clear();
+  while (!reader.end()) {
+    reader.acquire(I);
+    indexes.push_back(reader.getFrameIndex());
+    if (!checkImage(I, reader.getFrameIndex())) {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+#if defined(_WIN32)
+    std::string opath = "C:/temp";
+#else
+    std::string opath = "/tmp";
+#endif
+    std::string username;
+    vpIoTools::getUserName(username);
+    opath = vpIoTools::createFilePath(vpIoTools::createFilePath(opath, username), "testVideoReaderPrefetch");
+    vpIoTools::makeDirectory(opath);
+
+    vpImage<unsigned char> I(30, 40);
+    for (unsigned int k = 1; k <= nbImages; k++) {
+      buildImage(I, k);
+      char name[FILENAME_MAX];
+      sprintf(name, "image%04u.pgm", k);
+      vpImageIo::write(I, vpIoTools::createFilePath(opath, name));
+    }
+    const std::string filename = vpIoTools::createFilePath(opath, "image%04d.pgm");
+
+    long steps[2] = {1, 3};
+    unsigned int prefetches[3] = {1, 2, 8};
+    for (unsigned int s = 0; s < 2; s++) {
+      std::vector<long> indexes_ref;
+      if (!readSequence(filename, 0, steps[s], indexes_ref)) {
+        return EXIT_FAILURE;
+      }
+      for (unsigned int p = 0; p < 3; p++) {
+        std::vector<long> indexes;
+        if (!readSequence(filename, prefetches[p], steps[s], indexes)) {
+          return EXIT_FAILURE;
+        }
+        if (indexes != indexes_ref) {
+          std::cerr << "Frame indexes mismatch with step " << steps[s] << " and prefetch " << prefetches[p]
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      std::cout << "Step " << steps[s] << ": " << indexes_ref.size() << " frames read" << std::endl;
+    }
+
+    // Seek backward and forward while reading, each reader having its own image
+    vpVideoReader reader, reader_ref;
+    vpImage<unsigned char> I_ref;
+    reader.setFileName(filename);
+    reader.setPrefetch(4);
+    reader_ref.setFileName(filename);
+    reader.open(I);
+    reader_ref.open(I_ref);
+    long seeks[4] = {9, 2, 2, 11};
+    for (unsigned int k = 0; k < 4; k++) {
+      if (!reader.getFrame(I, seeks[k]) || !checkImage(I, seeks[k]) || !reader_ref.getFrame(I_ref, seeks[k]) ||
+          !checkImage(I_ref, seeks[k])) {
+        std::cerr << "Cannot seek to frame " << seeks[k] << std::endl;
+        return EXIT_FAILURE;
+      }
+      for (unsigned int n = 0; n < 3; n++) {
+        reader.acquire(I);
+        reader_ref.acquire(I_ref);
+        if (reader.getFrameIndex() != reader_ref.getFrameIndex() || !checkImage(I, reader.getFrameIndex()) ||
+            !checkImage(I_ref, reader_ref.getFrameIndex()) || reader.end() != reader_ref.end()) {
+          std::cerr << "Mismatch after seeking to frame " << seeks[k] << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // A missing image is reported
+    if (reader.getFrame(I, nbImages + 5)) {
+      std::cerr << "Reading a missing frame should fail" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    for (unsigned int k = 1; k <= nbImages; k++) {
+      char name[FILENAME_MAX];
+      sprintf(name, "image%04u.pgm", k);
+      vpIoTools::remove(vpIoTools::createFilePath(opath, name));
+    }
+
+    std::cout << "testVideoReaderPrefetch is ok" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,172 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the moments computed by vpMomentObject against brute force.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMomentObject.cpp
+
+  Compare the basic moments computed by vpMomentObject from a binary image, a
+  label image, runs of pixels and a grayscale image with a brute force
+  implementation, with and without distortion.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpMomentObject.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpUniRand.h>
+
+namespace
+{
+// Moments of the pixels weighted by the weights image
+std::vector<double> computeReference(const vpImage<double> &weights, const vpCameraParameters &cam, unsigned int order)
+{
+  std::vector<double> moments((order + 1) * (order + 1), 0.);
+  for (unsigned int v = 0; v < weights.getHeight(); v++) {
+    for (unsigned int u = 0; u < weights.getWidth(); u++) {
+      double x = 0, y = 0;
+      vpPixelMeterConversion::convertPoint(cam, u, v, x, y);
+      for (unsigned int q = 0; q <= order; q++) {
+        for (unsigned int p = 0; p <= order - q; p++) {
+          moments[q * (order + 1) + p] += weights[v][u] * std::pow(x, (int)p) * std::pow(y, (int)q);
+        }
+      }
+    }
+  }
+
+  for (size_t k = 0; k < moments.size(); k++) {
+    moments[k] /= cam.get_px() * cam.get_py();
+  }
+  return moments;
+}
+
+bool compare(const std::vector<double> &moments, const std::vector<double> &reference, const std::string &name)
+{
+  double scale = 0.;
+  for (size_t k = 0; k < reference.size(); k++) {
+    scale = std::max(scale, std::fabs(reference[k]));
+  }
+
+  for (size_t k = 0; k < reference.size(); k++) {
+    if (std::fabs(moments[k] - reference[k]) > 1e-9 * scale) {
+      std::cerr << name << ": moment " << k << " is " << moments[k] << " instead of " << reference[k] << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  vpUniRand random(1);
+  const unsigned int height = 96, width = 128;
+
+  // Two overlapping ellipses with noisy borders
+  vpImage<unsigned char> I(height, width);
+  vpImage<int> labels(height, width);
+  for (unsigned int v = 0; v < height; v++) {
+    for (unsigned int u = 0; u < width; u++) {
+      double d1 = vpMath::sqr((u - 40.) / 30.) + vpMath::sqr((v - 50.) / 20.);
+      double d2 = vpMath::sqr((u - 85.) / 25.) + vpMath::sqr((v - 40.) / 35.);
+      labels[v][u] = d1 < 1. + 0.1 * random() ? 1 : (d2 < 1. + 0.1 * random() ? 2 : 0);
+      I[v][u] = (unsigned char)(labels[v][u] == 0 ? 60 * random() : 100 + 155 * random());
+    }
+  }
+
+  vpCameraParameters cams[2];
+  cams[0].initPersProjWithoutDistortion(600, 620, 64, 47);
+  cams[1].initPersProjWithDistortion(600, 620, 64, 47, -0.2, 0.2);
+
+  const unsigned int orders[] = {1, 3, 5};
+  for (unsigned int c = 0; c < 2; c++) {
+    const vpCameraParameters &cam = cams[c];
+    for (unsigned int o = 0; o < sizeof(orders) / sizeof(orders[0]); o++) {
+      const unsigned int order = orders[o];
+      vpImage<double> binary(height, width), label2(height, width), black(height, width), white(height, width);
+      std::vector<vpMomentObject::vpPixelRun> runs;
+      for (unsigned int v = 0; v < height; v++) {
+        for (unsigned int u = 0; u < width; u++) {
+          binary[v][u] = I[v][u] > 80 ? 1. : 0.;
+          label2[v][u] = labels[v][u] == 2 ? 1. : 0.;
+          black[v][u] = I[v][u] / 255.;
+          white[v][u] = 1. - I[v][u] / 255.;
+
+          if (labels[v][u] == 2 && (u == 0 || labels[v][u - 1] != 2)) {
+            vpMomentObject::vpPixelRun run;
+            run.v = v;
+            run.u_min = run.u_max = u;
+            runs.push_back(run);
+          } else if (labels[v][u] == 2) {
+            runs.back().u_max = u;
+          }
+        }
+      }
+
+      vpMomentObject obj(order);
+      obj.setType(vpMomentObject::DENSE_FULL_OBJECT);
+      obj.fromImage(I, 80, cam);
+      if (!compare(obj.get(), computeReference(binary, cam, order), "fromImage() with a threshold")) {
+        return EXIT_FAILURE;
+      }
+
+      const std::vector<double> reference = computeReference(label2, cam, order);
+      obj.fromLabels(labels, 2, cam);
+      if (!compare(obj.get(), reference, "fromLabels()")) {
+        return EXIT_FAILURE;
+      }
+
+      obj.fromRuns(runs, cam);
+      if (!compare(obj.get(), reference, "fromRuns()")) {
+        return EXIT_FAILURE;
+      }
+
+      obj.fromImage(I, cam, vpMomentObject::BLACK);
+      if (!compare(obj.get(), computeReference(black, cam, order), "fromImage() with a black background")) {
+        return EXIT_FAILURE;
+      }
+
+      obj.fromImage(I, cam, vpMomentObject::WHITE);
+      if (!compare(obj.get(), computeReference(white, cam, order), "fromImage() with a white background")) {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::cout << "testMomentObject is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
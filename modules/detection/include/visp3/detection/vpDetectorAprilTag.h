@@ -42,6 +42,7 @@
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpColor.h>
+#include <visp3/core/vpRect.h>
 #include <visp3/detection/vpDetectorBase.h>
 
 /*!
@@ -250,6 +251,14 @@ public:
   bool detect(const vpImage<unsigned char> &I, const double tagSize, const vpCameraParameters &cam,
               std::vector<vpHomogeneousMatrix> &cMo_vec, std::vector<vpHomogeneousMatrix> *cMo_vec2=NULL,
               std::vector<double> *projErrors=NULL, std::vector<double> *projErrors2=NULL);
+  bool detect(const std::vector<const vpImage<unsigned char> *> &images,
+              std::vector<std::vector<std::vector<vpImagePoint> > > &polygons,
+              std::vector<std::vector<std::string> > &messages);
+  bool detect(const std::vector<const vpImage<unsigned char> *> &images, const double tagSize,
+              const std::vector<vpCameraParameters> &cams,
+              std::vector<std::vector<std::vector<vpImagePoint> > > &polygons,
+              std::vector<std::vector<std::string> > &messages,
+              std::vector<std::vector<vpHomogeneousMatrix> > *cMo_vecs = NULL);
 
   bool getPose(size_t tagIndex, const double tagSize, const vpCameraParameters &cam,
                vpHomogeneousMatrix &cMo, vpHomogeneousMatrix *cMo2=NULL,
@@ -261,6 +270,7 @@ public:
   inline vpPoseEstimationMethod getPoseEstimationMethod() const { return m_poseEstimationMethod; }
 
   void setAprilTagDecodeSharpening(const double decodeSharpening);
+  void setAprilTagFullDetectionPeriod(const unsigned int period);
   void setAprilTagNbThreads(const int nThreads);
   void setAprilTagPoseEstimationMethod(const vpPoseEstimationMethod &poseEstimationMethod);
   void setAprilTagQuadDecimate(const float quadDecimate);
@@ -268,6 +278,8 @@ public:
   void setAprilTagRefineDecode(const bool refineDecode);
   void setAprilTagRefineEdges(const bool refineEdges);
   void setAprilTagRefinePose(const bool refinePose);
+  void setAprilTagRegionsOfInterest(const std::vector<vpRect> &rois);
+  void setAprilTagTracking(const bool tracking, const double roiMargin = 0.5);
 
   /*! Allow to enable the display of overlay tag information in the windows
    * (vpDisplay) associated to the input image. */
@@ -35,6 +35,7 @@
 #include <visp3/core/vpConfig.h>
 
 #ifdef VISP_HAVE_APRILTAG
+#include <algorithm>
 #include <map>
 
 #include <apriltag.h>
@@ -65,7 +66,9 @@ class vpDetectorAprilTag::Impl
 public:
   Impl(const vpAprilTagFamily &tagFamily, const vpPoseEstimationMethod &method)
     : m_cam(), m_poseEstimationMethod(method), m_tagFamily(tagFamily), m_tagSize(1.0), m_td(NULL),
-      m_tf(NULL), m_detections(NULL), m_zAlignedWithCameraFrame(false)
+      m_tf(NULL), m_detections(NULL), m_zAlignedWithCameraFrame(false), m_batch(false), m_currentPoses(),
+      m_fullDetectionPeriod(10), m_nbRoiDetections(0), m_previousBBoxes(), m_previousPoses(), m_roiMargin(0.5),
+      m_rois(), m_tracking(false)
   {
     switch (m_tagFamily) {
     case TAG_36h11:
@@ -207,7 +210,7 @@ public:
               std::vector<std::string> &messages, const bool displayTag, const vpColor color,
               const unsigned int thickness, std::vector<vpHomogeneousMatrix> *cMo_vec,
               std::vector<vpHomogeneousMatrix> *cMo_vec2, std::vector<double> *projErrors,
-              std::vector<double> *projErrors2)
+              std::vector<double> *projErrors2, const bool batch = false)
   {
     if (m_tagFamily == TAG_36ARTOOLKIT) {
       //TAG_36ARTOOLKIT is not available anymore
@@ -224,22 +227,61 @@ public:
 
     const bool computePose = (cMo_vec != NULL);
 
-    image_u8_t im = {/*.width =*/(int32_t)I.getWidth(),
-                     /*.height =*/(int32_t)I.getHeight(),
-                     /*.stride =*/(int32_t)I.getWidth(),
-                     /*.buf =*/I.bitmap};
-
     if (m_detections) {
       apriltag_detections_destroy(m_detections);
       m_detections = NULL;
     }
 
-    m_detections = apriltag_detector_detect(m_td, &im);
+    // The regions of interest and the previous poses are not used when the images come from different cameras
+    m_batch = batch;
+    std::vector<vpRect> rois;
+    if (!m_batch) {
+      // The poses of the previous image are used to initialize the pose estimation
+      m_previousPoses.swap(m_currentPoses);
+      m_currentPoses.clear();
+      getRegionsOfInterest(I, rois);
+    }
+
+    if (rois.empty()) {
+      image_u8_t im = {/*.width =*/(int32_t)I.getWidth(),
+                       /*.height =*/(int32_t)I.getHeight(),
+                       /*.stride =*/(int32_t)I.getWidth(),
+                       /*.buf =*/I.bitmap};
+
+      m_detections = apriltag_detector_detect(m_td, &im);
+      if (!m_batch) {
+        m_nbRoiDetections = 0;
+      }
+    } else {
+      m_detections = zarray_create(sizeof(apriltag_detection_t *));
+      for (size_t i = 0; i < rois.size(); i++) {
+        // The region of interest shares the image buffer
+        const int left = (int)rois[i].getLeft(), top = (int)rois[i].getTop();
+        image_u8_t im = {/*.width =*/(int32_t)rois[i].getWidth(),
+                         /*.height =*/(int32_t)rois[i].getHeight(),
+                         /*.stride =*/(int32_t)I.getWidth(),
+                         /*.buf =*/I.bitmap + (size_t)top * I.getWidth() + (size_t)left};
+
+        zarray_t *roi_detections = apriltag_detector_detect(m_td, &im);
+        for (int j = 0; j < zarray_size(roi_detections); j++) {
+          apriltag_detection_t *det;
+          zarray_get(roi_detections, j, &det);
+          translateDetection(det, left, top);
+          zarray_add(m_detections, &det);
+        }
+        zarray_destroy(roi_detections);
+      }
+      m_nbRoiDetections++;
+    }
+
     int nb_detections = zarray_size(m_detections);
     bool detected = nb_detections > 0;
 
     polygons.resize((size_t)nb_detections);
     messages.resize((size_t)nb_detections);
+    if (!m_batch) {
+      m_previousBBoxes.resize((size_t)nb_detections);
+    }
 
     for (int i = 0; i < zarray_size(m_detections); i++) {
       apriltag_detection_t *det;
@@ -250,6 +292,9 @@ public:
         polygon.push_back(vpImagePoint(det->p[j][1], det->p[j][0]));
       }
       polygons[static_cast<size_t>(i)] = polygon;
+      if (!m_batch) {
+        m_previousBBoxes[static_cast<size_t>(i)] = vpRect(polygon);
+      }
       std::stringstream ss;
       ss << m_tagFamily << " id: " << det->id;
       messages[static_cast<size_t>(i)] = ss.str();
@@ -325,6 +370,13 @@ public:
     //To keep compatibility, we maintain the same convention than before and there is setZAlignedWithCameraAxis().
     //Under the hood, we use aligned frames everywhere and transform the pose according to the option.
 
+    // With tracking, the virtual visual servoing is initialized with the pose of the tag in the previous image
+    std::map<int, vpHomogeneousMatrix>::const_iterator it_prior = m_previousPoses.find(det->id);
+    const bool usePrior = m_tracking && !m_batch && it_prior != m_previousPoses.end() &&
+                          (m_poseEstimationMethod == HOMOGRAPHY_VIRTUAL_VS ||
+                           m_poseEstimationMethod == DEMENTHON_VIRTUAL_VS ||
+                           m_poseEstimationMethod == LAGRANGE_VIRTUAL_VS);
+
     vpHomogeneousMatrix cMo_homography_ortho_iter;
     if (m_poseEstimationMethod == HOMOGRAPHY_ORTHOGONAL_ITERATION ||
         m_poseEstimationMethod == BEST_RESIDUAL_VIRTUAL_VS) {
@@ -345,8 +397,8 @@ public:
     }
 
     vpHomogeneousMatrix cMo_homography;
-    if (m_poseEstimationMethod == HOMOGRAPHY || m_poseEstimationMethod == HOMOGRAPHY_VIRTUAL_VS ||
-        m_poseEstimationMethod == BEST_RESIDUAL_VIRTUAL_VS) {
+    if (!usePrior && (m_poseEstimationMethod == HOMOGRAPHY || m_poseEstimationMethod == HOMOGRAPHY_VIRTUAL_VS ||
+                      m_poseEstimationMethod == BEST_RESIDUAL_VIRTUAL_VS)) {
       double fx = cam.get_px(), fy = cam.get_py();
       double cx = cam.get_u0(), cy = cam.get_v0();
 
@@ -405,8 +457,10 @@ public:
 
     pose.addPoints(pts);
 
-    if (m_poseEstimationMethod != HOMOGRAPHY && m_poseEstimationMethod != HOMOGRAPHY_VIRTUAL_VS &&
-        m_poseEstimationMethod != HOMOGRAPHY_ORTHOGONAL_ITERATION) {
+    if (usePrior) {
+      cMo = it_prior->second;
+    } else if (m_poseEstimationMethod != HOMOGRAPHY && m_poseEstimationMethod != HOMOGRAPHY_VIRTUAL_VS &&
+               m_poseEstimationMethod != HOMOGRAPHY_ORTHOGONAL_ITERATION) {
       if (m_poseEstimationMethod == BEST_RESIDUAL_VIRTUAL_VS) {
         vpHomogeneousMatrix cMo_dementhon, cMo_lagrange;
 
@@ -498,6 +552,10 @@ public:
       *projErrors2 = pose.computeResidual(*cMo2);
     }
 
+    if (!m_batch) {
+      m_currentPoses[det->id] = cMo;
+    }
+
     if (!m_zAlignedWithCameraFrame) {
       vpHomogeneousMatrix oMo;
       // Apply a rotation of 180deg around x axis
@@ -547,8 +605,110 @@ public:
       *err2 = err_2;
   }
 
+  /*
+    Regions where the tags are searched: the user regions and, with tracking,
+    the enlarged bounding boxes of the tags detected in the previous image.
+    Overlapping regions are merged. An empty list means a detection on the
+    whole image, which is done periodically.
+  */
+  void getRegionsOfInterest(const vpImage<unsigned char> &I, std::vector<vpRect> &rois) const
+  {
+    rois = m_rois;
+    if (m_tracking) {
+      for (size_t i = 0; i < m_previousBBoxes.size(); i++) {
+        const vpRect &bbox = m_previousBBoxes[i];
+        double margin = m_roiMargin * (std::max)(bbox.getWidth(), bbox.getHeight());
+        rois.push_back(vpRect(bbox.getLeft() - margin, bbox.getTop() - margin, bbox.getWidth() + 2 * margin,
+                              bbox.getHeight() + 2 * margin));
+      }
+    }
+
+    if (rois.empty() || (m_fullDetectionPeriod > 0 && m_nbRoiDetections >= m_fullDetectionPeriod)) {
+      rois.clear();
+      return;
+    }
+
+    // Integer regions inside the image, with a minimal size for the AprilTag thresholding
+    const int minSize = 16, width = (int)I.getWidth(), height = (int)I.getHeight();
+    std::vector<int> bounds; // left, top, right, bottom
+    for (size_t i = 0; i < rois.size(); i++) {
+      int left = (std::max)(0, (int)std::floor(rois[i].getLeft()));
+      int top = (std::max)(0, (int)std::floor(rois[i].getTop()));
+      int right = (std::min)(width, (int)std::ceil(rois[i].getRight()) + 1);
+      int bottom = (std::min)(height, (int)std::ceil(rois[i].getBottom()) + 1);
+      if (right - left < minSize) {
+        left = (std::max)(0, (std::min)(left, width - minSize));
+        right = (std::min)(width, left + minSize);
+      }
+      if (bottom - top < minSize) {
+        top = (std::max)(0, (std::min)(top, height - minSize));
+        bottom = (std::min)(height, top + minSize);
+      }
+      if (right > left && bottom > top) {
+        bounds.push_back(left);
+        bounds.push_back(top);
+        bounds.push_back(right);
+        bounds.push_back(bottom);
+      }
+    }
+
+    // Merge the overlapping regions, a tag is then detected only once
+    bool merged = true;
+    while (merged) {
+      merged = false;
+      for (size_t i = 0; i < bounds.size() && !merged; i += 4) {
+        for (size_t j = i + 4; j < bounds.size() && !merged; j += 4) {
+          if (bounds[i] < bounds[j + 2] && bounds[j] < bounds[i + 2] && bounds[i + 1] < bounds[j + 3] &&
+              bounds[j + 1] < bounds[i + 3]) {
+            bounds[i] = (std::min)(bounds[i], bounds[j]);
+            bounds[i + 1] = (std::min)(bounds[i + 1], bounds[j + 1]);
+            bounds[i + 2] = (std::max)(bounds[i + 2], bounds[j + 2]);
+            bounds[i + 3] = (std::max)(bounds[i + 3], bounds[j + 3]);
+            bounds.erase(bounds.begin() + (std::ptrdiff_t)j, bounds.begin() + (std::ptrdiff_t)j + 4);
+            merged = true;
+          }
+        }
+      }
+    }
+
+    rois.clear();
+    for (size_t i = 0; i < bounds.size(); i += 4) {
+      rois.push_back(vpRect(bounds[i], bounds[i + 1], bounds[i + 2] - bounds[i], bounds[i + 3] - bounds[i + 1]));
+    }
+  }
+
+  // Express a detection done in a region of interest in the image frame
+  void translateDetection(apriltag_detection_t *det, int left, int top)
+  {
+    for (int j = 0; j < 4; j++) {
+      det->p[j][0] += left;
+      det->p[j][1] += top;
+    }
+    det->c[0] += left;
+    det->c[1] += top;
+    for (int j = 0; j < 3; j++) {
+      MATD_EL(det->H, 0, j) += left * MATD_EL(det->H, 2, j);
+      MATD_EL(det->H, 1, j) += top * MATD_EL(det->H, 2, j);
+    }
+  }
+
   void setCameraParameters(const vpCameraParameters &cam) { m_cam = cam; }
 
+  void setFullDetectionPeriod(const unsigned int period) { m_fullDetectionPeriod = period; }
+
+  void setRegionsOfInterest(const std::vector<vpRect> &rois) { m_rois = rois; }
+
+  void setTracking(const bool tracking, const double roiMargin)
+  {
+    m_tracking = tracking;
+    m_roiMargin = roiMargin;
+    if (!tracking) {
+      m_previousBBoxes.clear();
+      m_previousPoses.clear();
+      m_currentPoses.clear();
+    }
+  }
+
   void setAprilTagDecodeSharpening(const double decodeSharpening) { m_td->decode_sharpening = decodeSharpening; }
 
   void setNbThreads(const int nThreads) { m_td->nthreads = nThreads; }
@@ -579,6 +739,15 @@ protected:
   apriltag_family_t *m_tf;
   zarray_t *m_detections;
   bool m_zAlignedWithCameraFrame;
+  bool m_batch;
+  std::map<int, vpHomogeneousMatrix> m_currentPoses;
+  unsigned int m_fullDetectionPeriod;
+  unsigned int m_nbRoiDetections;
+  std::vector<vpRect> m_previousBBoxes;
+  std::map<int, vpHomogeneousMatrix> m_previousPoses;
+  double m_roiMargin;
+  std::vector<vpRect> m_rois;
+  bool m_tracking;
 };
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
@@ -649,6 +818,81 @@ bool vpDetectorAprilTag::detect(const vpImage<unsigned char> &I, const double ta
   return detected;
 }
 
+/*!
+  Detect AprilTag tags in a batch of images, for instance acquired by the
+  cameras of a multi-camera rig. This is a convenience wrapper: the images are
+  not processed concurrently but in turn by the same AprilTag detector, whose
+  worker threads, see setAprilTagNbThreads(), parallelize the detection within
+  each image. The images are not copied. The results are the same as calling
+  detect() on each image, except that the regions of interest and the tracking
+  are not used.
+
+  After the call, getNbObjects(), getPolygon(), getMessage() and getPose()
+  refer to the tags detected in the last image.
+
+  \param[in] images : Input images.
+  \param[out] polygons : For each image, the corners of the detected tags.
+  \param[out] messages : For each image, the messages of the detected tags.
+  \return true if at least one tag is detected in one of the images.
+*/
+bool vpDetectorAprilTag::detect(const std::vector<const vpImage<unsigned char> *> &images,
+                                std::vector<std::vector<std::vector<vpImagePoint> > > &polygons,
+                                std::vector<std::vector<std::string> > &messages)
+{
+  return detect(images, 1.0, std::vector<vpCameraParameters>(), polygons, messages, NULL);
+}
+
+/*!
+  Detect AprilTag tags in a batch of images as the batch detect() without
+  pose, and compute the corresponding tag poses considering that all the tags
+  have the same size.
+
+  \param[in] images : Input images.
+  \param[in] tagSize : Tag size in meter corresponding to the external width of the pattern.
+  \param[in] cams : Camera intrinsic parameters of each image.
+  \param[out] polygons : For each image, the corners of the detected tags.
+  \param[out] messages : For each image, the messages of the detected tags.
+  \param[out] cMo_vecs : Optional tag poses for each image, computed when not NULL.
+  \return true if at least one tag is detected in one of the images.
+*/
+bool vpDetectorAprilTag::detect(const std::vector<const vpImage<unsigned char> *> &images, const double tagSize,
+                                const std::vector<vpCameraParameters> &cams,
+                                std::vector<std::vector<std::vector<vpImagePoint> > > &polygons,
+                                std::vector<std::vector<std::string> > &messages,
+                                std::vector<std::vector<vpHomogeneousMatrix> > *cMo_vecs)
+{
+  if (cMo_vecs && cams.size() != images.size()) {
+    throw(vpException(vpException::dimensionError, "%d camera parameters are given for %d images",
+                      (int)cams.size(), (int)images.size()));
+  }
+
+  polygons.resize(images.size());
+  messages.resize(images.size());
+  if (cMo_vecs) {
+    cMo_vecs->clear();
+    cMo_vecs->resize(images.size());
+    m_impl->setTagSize(tagSize);
+  }
+
+  bool detected = false;
+  for (size_t i = 0; i < images.size(); i++) {
+    polygons[i].clear();
+    messages[i].clear();
+    if (cMo_vecs) {
+      m_impl->setCameraParameters(cams[i]);
+    }
+    detected = m_impl->detect(*images[i], polygons[i], messages[i], m_displayTag, m_displayTagColor,
+                              m_displayTagThickness, cMo_vecs ? &(*cMo_vecs)[i] : NULL, NULL, NULL, NULL, true) ||
+               detected;
+  }
+
+  m_polygon = polygons.empty() ? std::vector<std::vector<vpImagePoint> >() : polygons.back();
+  m_message = messages.empty() ? std::vector<std::string>() : messages.back();
+  m_nb_objects = m_message.size();
+
+  return detected;
+}
+
 /*!
   Get the pose of a tag depending on its size and camera parameters.
   This function is useful to get the pose of tags with different sizes, while
@@ -690,6 +934,57 @@ void vpDetectorAprilTag::setAprilTagDecodeSharpening(const double decodeSharpeni
   return (m_impl->setAprilTagDecodeSharpening(decodeSharpening));
 }
 
+/*!
+  Set the number of consecutive detections on regions of interest after which
+  the next detection is done on the whole image, to find the tags that were
+  not tracked or that appear outside the regions (default is 10).
+
+  \param period : Number of detections on regions of interest, 0 to never
+  fall back to a detection on the whole image.
+
+  \sa setAprilTagRegionsOfInterest(), setAprilTagTracking()
+*/
+void vpDetectorAprilTag::setAprilTagFullDetectionPeriod(const unsigned int period)
+{
+  m_impl->setFullDetectionPeriod(period);
+}
+
+/*!
+  Restrict the detection to regions of interest, for instance predicted from
+  the previous tag poses. The regions are used by all the next calls to
+  detect(), except the periodic detections on the whole image, see
+  setAprilTagFullDetectionPeriod(). The image buffer is not copied.
+
+  \param rois : Regions of interest, an empty list to detect on the whole
+  image.
+*/
+void vpDetectorAprilTag::setAprilTagRegionsOfInterest(const std::vector<vpRect> &rois)
+{
+  m_impl->setRegionsOfInterest(rois);
+}
+
+/*!
+  Enable the tracking of the tags between consecutive images. The tags are
+  then searched in the bounding boxes of the tags detected in the previous
+  image, enlarged by \e roiMargin times their size, in addition to the
+  regions given by setAprilTagRegionsOfInterest(). When no tag was detected
+  and periodically, see setAprilTagFullDetectionPeriod(), the detection is
+  done on the whole image.
+
+  With the HOMOGRAPHY_VIRTUAL_VS, DEMENTHON_VIRTUAL_VS and LAGRANGE_VIRTUAL_VS
+  methods, the virtual visual servoing that refines the pose of a tag is
+  initialized with its pose in the previous image, the tag ids being
+  considered unique.
+
+  \param tracking : If true, enable the tracking.
+  \param roiMargin : Margin added around the previous bounding boxes, as a
+  ratio of their size.
+*/
+void vpDetectorAprilTag::setAprilTagTracking(const bool tracking, const double roiMargin)
+{
+  m_impl->setTracking(tracking, roiMargin);
+}
+
 /*!
   Set the number of threads for April Tag detection (default is 1).
 
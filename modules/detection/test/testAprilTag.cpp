@@ -216,6 +216,224 @@ std::ostream &operator<<(std::ostream &os, TagGroundTruth &t)
 
   return os;
 }
+
+/*
+  Draw a tag36h11 tag in a white image. The 8x8 cells of the tag are \e cell
+  pixels wide, its black border starts at (\e top, \e left). The code bits
+  of the ids 0 and 1 are given row by row, 1 for a white cell.
+*/
+void drawTag36h11(vpImage<unsigned char> &I, int id, unsigned int top, unsigned int left, unsigned int cell)
+{
+  const char *codes[2][6] = {{"110101", "011101", "011000", "101000", "010110", "000100"},
+                             {"110110", "010111", "111100", "011000", "101101", "001001"}};
+  for (unsigned int i = 0; i < 8 * cell; i++) {
+    for (unsigned int j = 0; j < 8 * cell; j++) {
+      const unsigned int r = i / cell, c = j / cell;
+      const bool white = r > 0 && r < 7 && c > 0 && c < 7 && codes[id][r - 1][c - 1] == '1';
+      I[top + i][left + j] = white ? 255 : 0;
+    }
+  }
+}
+
+/*
+  Image with the tags 0 and 1, shifted by \e shift pixels.
+*/
+void createTagsImage(vpImage<unsigned char> &I, unsigned int shift = 0)
+{
+  I.resize(480, 640, 255);
+  drawTag36h11(I, 0, 60 + shift, 80 + shift, 12);
+  drawTag36h11(I, 1, 280 + shift, 420 + shift, 12);
+}
+
+bool findTag(vpDetectorBase &detector, const std::string &message, size_t &index)
+{
+  for (index = 0; index < detector.getNbObjects(); index++) {
+    if (detector.getMessage(index) == message) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/*
+  Detection in regions of interest and with the pose of the previous image as
+  prior, on synthetic images that do not need the dataset.
+*/
+bool testRegionsOfInterest()
+{
+  vpImage<unsigned char> I;
+  createTagsImage(I);
+  vpCameraParameters cam;
+  cam.initPersProjWithoutDistortion(600, 600, 320, 240);
+  // The black border is 96 pixels wide, the tags are 0.5 meter away
+  const double tagSize = 0.08;
+  const std::string msg0 = "36h11 id: 0", msg1 = "36h11 id: 1";
+
+  vpDetectorAprilTag detector(vpDetectorAprilTag::TAG_36h11);
+  std::vector<vpHomogeneousMatrix> cMo_vec;
+  detector.detect(I, tagSize, cam, cMo_vec);
+  size_t idx0 = 0, idx1 = 0;
+  if (detector.getNbObjects() != 2 || !findTag(detector, msg0, idx0) || !findTag(detector, msg1, idx1)) {
+    std::cerr << "Problem, " << detector.getNbObjects() << " tags detected in the synthetic image" << std::endl;
+    return false;
+  }
+  const TagGroundTruth tag0(msg0, detector.getPolygon(idx0)), tag1(msg1, detector.getPolygon(idx1));
+
+  // Inside the region, the tag 0 is found at the same place than in the whole image. Every fourth detection
+  // is done on the whole image and finds the tag 1, outside the region.
+  const unsigned int period = 3;
+  detector.setAprilTagRegionsOfInterest(std::vector<vpRect>(1, vpRect(50, 30, 160, 160)));
+  detector.setAprilTagFullDetectionPeriod(period);
+  for (unsigned int iter = 0; iter < 3 * (period + 1); iter++) {
+    detector.detect(I);
+    const bool fullDetection = (iter % (period + 1)) == period;
+    size_t idx = 0;
+    if (detector.getNbObjects() != (fullDetection ? 2u : 1u) || !findTag(detector, msg0, idx) ||
+        (fullDetection && !findTag(detector, msg1, idx1))) {
+      std::cerr << "Problem, " << detector.getNbObjects() << " tags detected with a region of interest at iteration "
+                << iter << std::endl;
+      return false;
+    }
+    TagGroundTruth current(msg0, detector.getPolygon(idx));
+    if (current != tag0) {
+      std::cerr << "Problem, tag detected in the region of interest:\n" << current << std::endl;
+      return false;
+    }
+  }
+
+  // A region without tag and no detection on the whole image
+  detector.setAprilTagRegionsOfInterest(std::vector<vpRect>(1, vpRect(250, 150, 120, 100)));
+  detector.setAprilTagFullDetectionPeriod(0);
+  for (unsigned int iter = 0; iter < 2 * (period + 1); iter++) {
+    if (detector.detect(I) || detector.getNbObjects() != 0) {
+      std::cerr << "Problem, " << detector.getNbObjects() << " tags detected outside the tags" << std::endl;
+      return false;
+    }
+  }
+
+  // With tracking, the next detections are done around the previous tags and the pose estimation starts from the
+  // previous pose. The image is shifted to check that the prior does not stick to the previous pose.
+  detector.setAprilTagRegionsOfInterest(std::vector<vpRect>());
+  detector.setAprilTagPoseEstimationMethod(vpDetectorAprilTag::HOMOGRAPHY_VIRTUAL_VS);
+  detector.setAprilTagTracking(true);
+  for (unsigned int shift = 0; shift <= 6; shift += 3) {
+    createTagsImage(I, shift);
+    cMo_vec.clear();
+    detector.detect(I, tagSize, cam, cMo_vec);
+
+    vpDetectorAprilTag detectorRef(vpDetectorAprilTag::TAG_36h11);
+    detectorRef.setAprilTagPoseEstimationMethod(vpDetectorAprilTag::HOMOGRAPHY_VIRTUAL_VS);
+    std::vector<vpHomogeneousMatrix> cMo_vec_ref;
+    detectorRef.detect(I, tagSize, cam, cMo_vec_ref);
+    if (detector.getNbObjects() != 2 || cMo_vec.size() != 2 || cMo_vec_ref.size() != 2) {
+      std::cerr << "Problem, " << detector.getNbObjects() << " tags tracked in the image shifted by " << shift
+                << " pixels" << std::endl;
+      return false;
+    }
+
+    // Fronto-parallel tags, the tag frame z-axis goes toward the camera
+    vpRotationMatrix R;
+    R[1][1] = R[2][2] = -1;
+    for (size_t i = 0; i < cMo_vec.size(); i++) {
+      size_t j = 0;
+      findTag(detectorRef, detector.getMessage(i), j);
+      // Black border from the top left corner of the tag, the center of the pixels is at integer coordinates
+      const double u = (detector.getMessage(i) == msg0 ? 80 : 420) + shift + 47.5;
+      const double v = (detector.getMessage(i) == msg0 ? 60 : 280) + shift + 47.5;
+      const double Z = cam.get_px() * tagSize / 96;
+      const vpTranslationVector t((u - cam.get_u0()) * Z / cam.get_px(), (v - cam.get_v0()) * Z / cam.get_py(), Z);
+      const vpHomogeneousMatrix cMo_gt(t, R);
+      for (unsigned int k = 0; k < 3; k++) {
+        for (unsigned int l = 0; l < 4; l++) {
+          // 2 millimeters and 0.01 for the rotation matrix coefficients
+          const double eps = l < 3 ? 0.01 : 0.002;
+          if (!vpMath::equal(cMo_vec[i][k][l], cMo_gt[k][l], eps) ||
+              !vpMath::equal(cMo_vec_ref[j][k][l], cMo_gt[k][l], eps)) {
+            std::cerr << "Problem, pose with prior:\n" << cMo_vec[i] << "\nWithout prior:\n" << cMo_vec_ref[j]
+                      << "\nExpected:\n" << cMo_gt << std::endl;
+            return false;
+          }
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+/*
+  The batch detection gives for each image the tags and the poses of a
+  detection on this image alone.
+*/
+bool testBatchDetection()
+{
+  const unsigned int nbImages = 3;
+  std::vector<vpImage<unsigned char> > I(nbImages);
+  std::vector<const vpImage<unsigned char> *> images;
+  std::vector<vpCameraParameters> cams(nbImages);
+  for (unsigned int i = 0; i < nbImages; i++) {
+    createTagsImage(I[i], 4 * i);
+    images.push_back(&I[i]);
+    cams[i].initPersProjWithoutDistortion(600 + 20 * i, 600 + 20 * i, 320 - 5 * i, 240 + 5 * i);
+  }
+  // A single tag in the last image
+  for (unsigned int i = 250; i < I[nbImages - 1].getHeight(); i++) {
+    for (unsigned int j = 0; j < I[nbImages - 1].getWidth(); j++) {
+      I[nbImages - 1][i][j] = 255;
+    }
+  }
+  const double tagSize = 0.08;
+
+  vpDetectorAprilTag detector(vpDetectorAprilTag::TAG_36h11);
+  std::vector<std::vector<std::vector<vpImagePoint> > > polygons;
+  std::vector<std::vector<std::string> > messages;
+  std::vector<std::vector<vpHomogeneousMatrix> > cMo_vecs;
+  if (!detector.detect(images, tagSize, cams, polygons, messages, &cMo_vecs) || polygons.size() != nbImages ||
+      messages.size() != nbImages || cMo_vecs.size() != nbImages) {
+    std::cerr << "Problem with the batch detection" << std::endl;
+    return false;
+  }
+
+  for (unsigned int i = 0; i < nbImages; i++) {
+    vpDetectorAprilTag detectorRef(vpDetectorAprilTag::TAG_36h11);
+    std::vector<vpHomogeneousMatrix> cMo_vec;
+    detectorRef.detect(I[i], tagSize, cams[i], cMo_vec);
+    const size_t nbTags = i + 1 < nbImages ? 2 : 1;
+    if (messages[i].size() != nbTags || detectorRef.getNbObjects() != nbTags || polygons[i].size() != nbTags ||
+        cMo_vecs[i].size() != nbTags) {
+      std::cerr << "Problem, " << messages[i].size() << " tags detected in the batch image " << i << " and "
+                << detectorRef.getNbObjects() << " in the image alone" << std::endl;
+      return false;
+    }
+
+    for (size_t j = 0; j < nbTags; j++) {
+      TagGroundTruth batchTag(messages[i][j], polygons[i][j]);
+      TagGroundTruth tag(detectorRef.getMessage(j), detectorRef.getPolygon(j));
+      if (batchTag != tag) {
+        std::cerr << "Problem, tag in the batch image " << i << ":\n" << batchTag << "\nIn the image alone:\n" << tag
+                  << std::endl;
+        return false;
+      }
+      for (unsigned int k = 0; k < 3; k++) {
+        for (unsigned int l = 0; l < 4; l++) {
+          if (!vpMath::equal(cMo_vecs[i][j][k][l], cMo_vec[j][k][l], 1e-6)) {
+            std::cerr << "Problem, pose in the batch image " << i << ":\n" << cMo_vecs[i][j]
+                      << "\nIn the image alone:\n" << cMo_vec[j] << std::endl;
+            return false;
+          }
+        }
+      }
+    }
+  }
+
+  // The detector refers to the last image
+  if (detector.getNbObjects() != 1 || detector.getMessage(0) != messages.back()[0]) {
+    std::cerr << "Problem, the detector does not refer to the last batch image" << std::endl;
+    return false;
+  }
+
+  return true;
+}
 }
 
 int main(int argc, const char *argv[])
@@ -266,6 +484,10 @@ int main(int argc, const char *argv[])
     // Here starts really the test
     //
 
+    if (!testRegionsOfInterest() || !testBatchDetection()) {
+      return EXIT_FAILURE;
+    }
+
     vpImage<unsigned char> I;
     if (opt_ppath.empty()) {
       filename = vpIoTools::createFilePath(ipath, "AprilTag/AprilTag.pgm");
@@ -423,6 +645,55 @@ int main(int argc, const char *argv[])
       }
     }
 
+    // Detection restricted to the neighborhood of the previous tags
+    if (use_detection_ground_truth) {
+      const size_t nbTags = detector->getNbObjects();
+      dynamic_cast<vpDetectorAprilTag *>(detector)->setAprilTagTracking(true);
+      std::vector<vpHomogeneousMatrix> cMo_vec_tracking;
+      dynamic_cast<vpDetectorAprilTag *>(detector)->detect(I, tagSize, cam, cMo_vec_tracking);
+      if (detector->getNbObjects() != nbTags) {
+        std::cerr << "Problem, " << detector->getNbObjects() << " tags detected with tracking instead of " << nbTags
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      for (size_t i = 0; i < detector->getNbObjects(); i++) {
+        std::string message = detector->getMessage(i);
+        std::replace(message.begin(), message.end(), ' ', '_');
+        std::map<std::string, TagGroundTruth>::iterator it = mapOfTagsGroundTruth.find(message);
+        TagGroundTruth current(message, detector->getPolygon(i));
+        if (it == mapOfTagsGroundTruth.end() || it->second != current) {
+          std::cerr << "Problem with the tracked tag:\n" << current << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Batch detection, as with the images of a multi-camera rig
+    if (use_detection_ground_truth) {
+      const size_t nbTags = detector->getNbObjects();
+      std::vector<const vpImage<unsigned char> *> images(2, &I);
+      std::vector<std::vector<std::vector<vpImagePoint> > > polygons;
+      std::vector<std::vector<std::string> > messages;
+      dynamic_cast<vpDetectorAprilTag *>(detector)->detect(images, polygons, messages);
+      for (size_t i = 0; i < images.size(); i++) {
+        if (messages[i].size() != nbTags) {
+          std::cerr << "Problem, " << messages[i].size() << " tags detected in the batch image " << i << std::endl;
+          return EXIT_FAILURE;
+        }
+        for (size_t j = 0; j < messages[i].size(); j++) {
+          std::string message = messages[i][j];
+          std::replace(message.begin(), message.end(), ' ', '_');
+          std::map<std::string, TagGroundTruth>::iterator it = mapOfTagsGroundTruth.find(message);
+          TagGroundTruth current(message, polygons[i][j]);
+          if (it == mapOfTagsGroundTruth.end() || it->second != current) {
+            std::cerr << "Problem with the tag in the batch image " << i << ":\n" << current << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
     if (opt_display) {
       vpDisplay::displayText(I, 20, 20, "Click to quit.", vpColor::red);
       vpDisplay::flush(I);
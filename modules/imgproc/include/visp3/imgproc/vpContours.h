@@ -168,6 +168,14 @@ typedef enum {
   CONTOUR_RETR_EXTERNAL /*!< Retrieve only external contours. */
 } vpContourRetrievalType;
 
+typedef enum {
+  CONTOUR_APPROX_NONE,      /*!< Store all the contour points. */
+  CONTOUR_APPROX_SIMPLE,    /*!< Store only the end points of the horizontal, vertical
+                               and diagonal segments of the contours. */
+  CONTOUR_APPROX_CHAIN_CODE /*!< Store only the first point and the chain code of the
+                               contours. */
+} vpContourApproximationType;
+
 struct vpContour {
   std::vector<vpContour *> m_children;
   vpContourType m_contourType;
@@ -241,6 +249,40 @@ struct vpContour {
   }
 };
 
+/*!
+  Contours stored in contiguous arrays of integer coordinates, as extracted by
+  the vp::findContours() variant that does not build a tree of vpContour.
+
+  The points of the contour \e k are the points between the indexes \e m_pointIndex[k] and
+  \e m_pointIndex[k+1] - 1, the point \e n being stored as (i, j) = (\e m_points[2n], \e m_points[2n+1]).
+  With vp::CONTOUR_APPROX_CHAIN_CODE, only the first point of each contour is stored and the moves
+  to the next points are given by the codes between the indexes \e m_chainCodeIndex[k] and
+  \e m_chainCodeIndex[k+1] - 1: 0 for north, 1 for north-east, 2 for east and so on clockwise up
+  to 7 for north-west.
+*/
+struct VISP_EXPORT vpContourArray {
+  vpContourApproximationType m_approximation; //!< Approximation used to store the contours
+  std::vector<int> m_points;                  //!< (i, j) coordinates of the points of all the contours
+  std::vector<unsigned int> m_pointIndex;     //!< Index of the first point of each contour, plus the end index
+  std::vector<unsigned char> m_chainCodes;    //!< Chain codes of all the contours
+  std::vector<unsigned int> m_chainCodeIndex; //!< Index of the first chain code of each contour, plus the end index
+  std::vector<vpContourType> m_contourTypes;  //!< Type of each contour
+  std::vector<int> m_parents;                 //!< Index of the parent of each contour, -1 for the top level contours
+
+  vpContourArray()
+    : m_approximation(vp::CONTOUR_APPROX_NONE), m_points(), m_pointIndex(1, 0), m_chainCodes(), m_chainCodeIndex(1, 0),
+      m_contourTypes(), m_parents()
+  {
+  }
+
+  void clear();
+  void getContour(const unsigned int index, std::vector<vpImagePoint> &points) const;
+  /*!
+    Return the number of contours.
+  */
+  inline unsigned int size() const { return (unsigned int)m_contourTypes.size(); }
+};
+
 VISP_EXPORT void drawContours(vpImage<unsigned char> &I, const std::vector<std::vector<vpImagePoint> > &contours,
                               unsigned char grayValue = 255);
 VISP_EXPORT void drawContours(vpImage<vpRGBa> &I, const std::vector<std::vector<vpImagePoint> > &contours,
@@ -249,6 +291,10 @@ VISP_EXPORT void drawContours(vpImage<vpRGBa> &I, const std::vector<std::vector<
 VISP_EXPORT void findContours(const vpImage<unsigned char> &I_original, vpContour &contours,
                               std::vector<std::vector<vpImagePoint> > &contourPts,
                               const vpContourRetrievalType &retrievalMode = vp::CONTOUR_RETR_TREE);
+
+VISP_EXPORT void findContours(const vpImage<unsigned char> &I, vpContourArray &contours,
+                              const vpContourRetrievalType &retrievalMode = vp::CONTOUR_RETR_TREE,
+                              const vpContourApproximationType &approximation = vp::CONTOUR_APPROX_NONE);
 }
 
 #endif
@@ -45,8 +45,10 @@
 #ifndef _vpImgproc_h_
 #define _vpImgproc_h_
 
+#include <visp3/core/vpHistogram.h>
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpImageMorphology.h>
+#include <visp3/core/vpRect.h>
 #include <visp3/imgproc/vpContours.h>
 
 #define USE_OLD_FILL_HOLE 0
@@ -83,6 +85,22 @@ typedef enum {
                               */
 } vpAutoThresholdMethod;
 
+typedef enum {
+  ADAPTIVE_THRESHOLD_MEAN,   /*!< Bradley, D & Roth, G (2007), "Adaptive thresholding using
+                                the integral image", Journal of Graphics Tools 12 (2): 13-21,
+                                the threshold is the local mean times (1 - k) */
+  ADAPTIVE_THRESHOLD_SAUVOLA /*!< Sauvola, J & Pietikainen, M (2000), "Adaptive document image
+                                binarization", Pattern Recognition 33 (2): 225-236, the threshold
+                                is the local mean times (1 + k (local standard deviation / 128 - 1)) */
+} vpAdaptiveThresholdMethod;
+
+typedef enum {
+  STRUCTURING_ELEMENT_RECT, /*!< Rectangle of width x height pixels, a horizontal or a vertical
+                                 line when the height or the width is 1 */
+  STRUCTURING_ELEMENT_DISK  /*!< Disk whose diameter is the width rounded up to an odd value, i.e. of radius
+                                 width / 2, the height is ignored */
+} vpStructuringElementType;
+
 VISP_EXPORT void adjust(vpImage<unsigned char> &I, const double alpha, const double beta);
 VISP_EXPORT void adjust(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const double alpha,
                         const double beta);
@@ -127,6 +145,10 @@ VISP_EXPORT void unsharpMask(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &Ires, co
 VISP_EXPORT void
 connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
                     const vpImageMorphology::vpConnexityType &connexity = vpImageMorphology::CONNEXITY_4);
+VISP_EXPORT void
+connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
+                    std::vector<unsigned int> &areas, std::vector<vpRect> &bboxes, std::vector<vpImagePoint> &centroids,
+                    const vpImageMorphology::vpConnexityType &connexity = vpImageMorphology::CONNEXITY_4);
 
 VISP_EXPORT void fillHoles(vpImage<unsigned char> &I
 #if USE_OLD_FILL_HOLE
@@ -143,9 +165,32 @@ VISP_EXPORT void reconstruct(const vpImage<unsigned char> &marker, const vpImage
                              vpImage<unsigned char> &I,
                              const vpImageMorphology::vpConnexityType &connexity = vpImageMorphology::CONNEXITY_4);
 
+VISP_EXPORT void erode(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+                       const unsigned int height, const vpStructuringElementType &type = STRUCTURING_ELEMENT_RECT);
+VISP_EXPORT void dilate(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+                        const unsigned int height, const vpStructuringElementType &type = STRUCTURING_ELEMENT_RECT);
+VISP_EXPORT void opening(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+                         const unsigned int height, const vpStructuringElementType &type = STRUCTURING_ELEMENT_RECT);
+VISP_EXPORT void closing(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+                         const unsigned int height, const vpStructuringElementType &type = STRUCTURING_ELEMENT_RECT);
+VISP_EXPORT void topHat(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+                        const unsigned int height, const vpStructuringElementType &type = STRUCTURING_ELEMENT_RECT);
+VISP_EXPORT void blackHat(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+                          const unsigned int height, const vpStructuringElementType &type = STRUCTURING_ELEMENT_RECT);
+
 VISP_EXPORT unsigned char autoThreshold(vpImage<unsigned char> &I, const vp::vpAutoThresholdMethod &method,
                                         const unsigned char backgroundValue = 0,
                                         const unsigned char foregroundValue = 255);
+VISP_EXPORT unsigned char autoThreshold(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2,
+                                        const vp::vpAutoThresholdMethod &method,
+                                        const unsigned char backgroundValue = 0,
+                                        const unsigned char foregroundValue = 255);
+VISP_EXPORT int computeAutoThreshold(const vpHistogram &hist, const vp::vpAutoThresholdMethod &method);
+
+VISP_EXPORT void adaptiveThreshold(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2,
+                                   const vp::vpAdaptiveThresholdMethod &method, const unsigned int windowSize = 31,
+                                   const double k = 0.2, const unsigned char backgroundValue = 0,
+                                   const unsigned char foregroundValue = 255);
 }
 
 #endif
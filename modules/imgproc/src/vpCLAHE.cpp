@@ -84,6 +84,10 @@
 #include <visp3/core/vpImageConvert.h>
 #include <visp3/imgproc/vpImgproc.h>
 
+#ifdef VISP_HAVE_OPENMP
+#include <omp.h>
+#endif
+
 namespace
 {
 int fastRound(const float value) { return (int)(value + 0.5f); }
@@ -120,8 +124,8 @@ void clipHistogram(const std::vector<int> &hist, std::vector<int> &clippedHist,
   } while (clippedEntries != clippedEntriesBefore);
 }
 
-void createHistogram(const int blockRadius, const int bins, const int blockXCenter, const int blockYCenter,
-                     const vpImage<unsigned char> &I, std::vector<int> &hist)
+void createHistogram(const int blockRadius, const int blockXCenter, const int blockYCenter,
+                     const vpImage<unsigned char> &I, const std::vector<int> &binOf, std::vector<int> &hist)
 {
   std::fill(hist.begin(), hist.end(), 0);
 
@@ -132,7 +136,7 @@ void createHistogram(const int blockRadius, const int bins, const int blockXCent
 
   for (int y = yMin; y < yMax; ++y) {
     for (int x = xMin; x < xMax; ++x) {
-      ++hist[fastRound(I[y][x] / 255.0f * bins)];
+      ++hist[binOf[I[y][x]]];
     }
   }
 }
@@ -247,6 +251,12 @@ void vp::clahe(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, con
 
   I2.resize(I1.getHeight(), I1.getWidth());
 
+  // Histogram bin of each grey level
+  std::vector<int> binOf(256);
+  for (int v = 0; v < 256; v++) {
+    binOf[(size_t)v] = fastRound(v / 255.0f * bins);
+  }
+
   if (fast) {
     int blockSize = 2 * blockRadius + 1;
     int limit = (int)(slope * blockSize * blockSize / bins + 0.5);
@@ -312,154 +322,149 @@ void vp::clahe(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, con
       rs[nr + 1] = I1.getHeight() - blockRadius - 1;
     }
 
-    std::vector<int> hist((size_t)(bins + 1));
-    std::vector<int> cdfs((size_t)(bins + 1));
-    std::vector<float> tl;
-    std::vector<float> tr;
-    std::vector<float> br;
-    std::vector<float> bl;
-
-    for (int r = 0; r <= (int)rs.size(); ++r) {
-      int r0 = std::max(0, r - 1);
-      int r1 = std::min((int)rs.size() - 1, r);
-      int dr = rs[r1] - rs[r0];
-
-      createHistogram(blockRadius, bins, cs[0], rs[r0], I1, hist);
-      tr = createTransfer(hist, limit, cdfs);
-      if (r0 == r1) {
-        br = tr;
-      } else {
-        createHistogram(blockRadius, bins, cs[0], rs[r1], I1, hist);
-        br = createTransfer(hist, limit, cdfs);
+    // Transfer functions of all the blocks, as look-up tables on the grey levels
+    const int nbRows = (int)rs.size(), nbCols = (int)cs.size();
+    std::vector<float> luts((size_t)(nbRows * nbCols) * 256);
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+    for (int k = 0; k < nbRows * nbCols; k++) {
+      std::vector<int> hist((size_t)(bins + 1));
+      std::vector<int> cdfs((size_t)(bins + 1));
+      createHistogram(blockRadius, cs[(size_t)(k % nbCols)], rs[(size_t)(k / nbCols)], I1, binOf, hist);
+      std::vector<float> transfer = createTransfer(hist, limit, cdfs);
+      float *lut = &luts[(size_t)k * 256];
+      for (int v = 0; v < 256; v++) {
+        lut[v] = transfer[(size_t)binOf[(size_t)v]];
       }
+    }
 
-      int yMin = (r == 0 ? 0 : rs[r0]);
-      int yMax = (r < (int)rs.size() ? rs[r1] : I1.getHeight());
-
-      for (int c = 0; c <= (int)cs.size(); ++c) {
-        int c0 = std::max(0, c - 1);
-        int c1 = std::min((int)cs.size() - 1, c);
-        int dc = cs[c1] - cs[c0];
-
-        tl = tr;
-        bl = br;
-
-        if (c0 != c1) {
-          createHistogram(blockRadius, bins, cs[c1], rs[r0], I1, hist);
-          tr = createTransfer(hist, limit, cdfs);
-          if (r0 == r1) {
-            br = tr;
-          } else {
-            createHistogram(blockRadius, bins, cs[c1], rs[r1], I1, hist);
-            br = createTransfer(hist, limit, cdfs);
-          }
-        }
-
-        int xMin = (c == 0 ? 0 : cs[c0]);
-        int xMax = (c < (int)cs.size() ? cs[c1] : I1.getWidth());
-        for (int y = yMin; y < yMax; ++y) {
-          float wy = (float)(rs[r1] - y) / dr;
-
-          for (int x = xMin; x < xMax; ++x) {
-            float wx = (float)(cs[c1] - x) / dc;
-            int v = fastRound(I1[y][x] / 255.0f * bins);
-            float t00 = tl[v];
-            float t01 = tr[v];
-            float t10 = bl[v];
-            float t11 = br[v];
-            float t0 = 0.0f, t1 = 0.0f;
-
-            if (c0 == c1) {
-              t0 = t00;
-              t1 = t10;
-            } else {
-              t0 = wx * t00 + (1.0f - wx) * t01;
-              t1 = wx * t10 + (1.0f - wx) * t11;
-            }
-
-            float t = (r0 == r1) ? t0 : wy * t0 + (1.0f - wy) * t1;
-            I2[y][x] = std::max(0, std::min(255, fastRound(t * 255.0f)));
-          }
-        }
+    // Region between the block centers of each row and column, and interpolation weights along the columns
+    std::vector<int> rowRegion(I1.getHeight()), colRegion(I1.getWidth());
+    for (int r = 0, y = 0; y < (int)I1.getHeight(); y++) {
+      while (r < nbRows && y >= rs[(size_t)r]) {
+        r++;
       }
+      rowRegion[(size_t)y] = r;
+    }
+    std::vector<float> wxs(I1.getWidth());
+    for (int c = 0, x = 0; x < (int)I1.getWidth(); x++) {
+      while (c < nbCols && x >= cs[(size_t)c]) {
+        c++;
+      }
+      colRegion[(size_t)x] = c;
+      int c0 = std::max(0, c - 1);
+      int c1 = std::min(nbCols - 1, c);
+      wxs[(size_t)x] = (c0 == c1) ? 1.0f : (float)(cs[(size_t)c1] - x) / (cs[(size_t)c1] - cs[(size_t)c0]);
     }
-  } else {
-    std::vector<int> hist(bins + 1), prev_hist(bins + 1);
-    std::vector<int> clippedHist(bins + 1);
-
-    bool first = true;
-    int xMin0 = 0;
-    int xMax0 = std::min((int)I1.getWidth(), blockRadius);
 
+    // Bilinear interpolation of the transfer functions of the four neighbor blocks
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
     for (int y = 0; y < (int)I1.getHeight(); y++) {
-      int yMin = std::max(0, y - (int)blockRadius);
-      int yMax = std::min((int)I1.getHeight(), y + blockRadius + 1);
-      int h = yMax - yMin;
-
-#if 0
-      std::fill(hist.begin(), hist.end(), 0);
-      // Compute histogram for the current block
-      for (int yi = yMin; yi < yMax; yi++) {
-        for (int xi = xMin0; xi < xMax0; xi++) {
-          ++hist[fastRound(I1[yi][xi] / 255.0f * bins)];
+      const int r = rowRegion[(size_t)y];
+      const int r0 = std::max(0, r - 1);
+      const int r1 = std::min(nbRows - 1, r);
+      const float wy = (r0 == r1) ? 1.0f : (float)(rs[(size_t)r1] - y) / (rs[(size_t)r1] - rs[(size_t)r0]);
+      const unsigned char *src = I1[(unsigned int)y];
+      unsigned char *dst = I2[(unsigned int)y];
+
+      for (int x = 0; x < (int)I1.getWidth();) {
+        const int c = colRegion[(size_t)x];
+        const int c0 = std::max(0, c - 1);
+        const int c1 = std::min(nbCols - 1, c);
+        const float *tl = &luts[(size_t)(r0 * nbCols + c0) * 256];
+        const float *tr = &luts[(size_t)(r0 * nbCols + c1) * 256];
+        const float *bl = &luts[(size_t)(r1 * nbCols + c0) * 256];
+        const float *br = &luts[(size_t)(r1 * nbCols + c1) * 256];
+
+        for (; x < (int)I1.getWidth() && colRegion[(size_t)x] == c; x++) {
+          const float wx = wxs[(size_t)x];
+          const unsigned char v = src[x];
+          const float t0 = (c0 == c1) ? tl[v] : wx * tl[v] + (1.0f - wx) * tr[v];
+          const float t1 = (c0 == c1) ? bl[v] : wx * bl[v] + (1.0f - wx) * br[v];
+          const float t = (r0 == r1) ? t0 : wy * t0 + (1.0f - wy) * t1;
+          dst[x] = (unsigned char)std::max(0, std::min(255, fastRound(t * 255.0f)));
         }
       }
-#else
-      if (first) {
-        first = false;
-        // Compute histogram for the block at (0,0)
-        for (int yi = yMin; yi < yMax; yi++) {
-          for (int xi = xMin0; xi < xMax0; xi++) {
-            ++hist[fastRound(I1[yi][xi] / 255.0f * bins)];
+    }
+  } else {
+    // The image is split in horizontal strips processed in parallel, each strip sliding its own histogram
+    int nbStrips = 1;
+#ifdef VISP_HAVE_OPENMP
+    nbStrips = std::max(1, std::min(omp_get_max_threads(), (int)I1.getHeight()));
+#pragma omp parallel for schedule(static) num_threads(nbStrips)
+#endif
+    for (int strip = 0; strip < nbStrips; strip++) {
+      const int yBegin = (int)((size_t)I1.getHeight() * strip / nbStrips);
+      const int yEnd = (int)((size_t)I1.getHeight() * (strip + 1) / nbStrips);
+      std::vector<int> hist(bins + 1), prev_hist(bins + 1);
+      std::vector<int> clippedHist(bins + 1);
+
+      int xMin0 = 0;
+      int xMax0 = std::min((int)I1.getWidth(), blockRadius);
+
+      for (int y = yBegin; y < yEnd; y++) {
+        int yMin = std::max(0, y - (int)blockRadius);
+        int yMax = std::min((int)I1.getHeight(), y + blockRadius + 1);
+        int h = yMax - yMin;
+
+        if (y == yBegin) {
+          // Compute histogram for the first block of the strip
+          std::fill(hist.begin(), hist.end(), 0);
+          for (int yi = yMin; yi < yMax; yi++) {
+            for (int xi = xMin0; xi < xMax0; xi++) {
+              ++hist[(size_t)binOf[I1[yi][xi]]];
+            }
           }
-        }
-      } else {
-        hist = prev_hist;
-
-        if (yMin > 0) {
-          int yMin1 = yMin - 1;
-          // Sliding histogram, remove top
-          for (int xi = xMin0; xi < xMax0; xi++) {
-            --hist[fastRound(I1[yMin1][xi] / 255.0f * bins)];
+        } else {
+          hist = prev_hist;
+
+          if (yMin > 0) {
+            int yMin1 = yMin - 1;
+            // Sliding histogram, remove top
+            for (int xi = xMin0; xi < xMax0; xi++) {
+              --hist[(size_t)binOf[I1[yMin1][xi]]];
+            }
           }
-        }
 
-        if (y + blockRadius < (int)I1.getHeight()) {
-          int yMax1 = yMax - 1;
-          // Sliding histogram, add bottom
-          for (int xi = xMin0; xi < xMax0; xi++) {
-            ++hist[fastRound(I1[yMax1][xi] / 255.0f * bins)];
+          if (y + blockRadius < (int)I1.getHeight()) {
+            int yMax1 = yMax - 1;
+            // Sliding histogram, add bottom
+            for (int xi = xMin0; xi < xMax0; xi++) {
+              ++hist[(size_t)binOf[I1[yMax1][xi]]];
+            }
           }
         }
-      }
-      prev_hist = hist;
-#endif
+        prev_hist = hist;
 
-      for (int x = 0; x < (int)I1.getWidth(); x++) {
-        int xMin = std::max(0, x - (int)blockRadius);
-        int xMax = x + blockRadius + 1;
+        for (int x = 0; x < (int)I1.getWidth(); x++) {
+          int xMin = std::max(0, x - (int)blockRadius);
+          int xMax = x + blockRadius + 1;
 
-        if (xMin > 0) {
-          int xMin1 = xMin - 1;
-          // Sliding histogram, remove left
-          for (int yi = yMin; yi < yMax; yi++) {
-            --hist[fastRound(I1[yi][xMin1] / 255.0f * bins)];
+          if (xMin > 0) {
+            int xMin1 = xMin - 1;
+            // Sliding histogram, remove left
+            for (int yi = yMin; yi < yMax; yi++) {
+              --hist[(size_t)binOf[I1[yi][xMin1]]];
+            }
           }
-        }
 
-        if (xMax <= (int)I1.getWidth()) {
-          int xMax1 = xMax - 1;
-          // Sliding histogram, add right
-          for (int yi = yMin; yi < yMax; yi++) {
-            ++hist[fastRound(I1[yi][xMax1] / 255.0f * bins)];
+          if (xMax <= (int)I1.getWidth()) {
+            int xMax1 = xMax - 1;
+            // Sliding histogram, add right
+            for (int yi = yMin; yi < yMax; yi++) {
+              ++hist[(size_t)binOf[I1[yi][xMax1]]];
+            }
           }
-        }
 
-        int v = fastRound(I1[y][x] / 255.0f * bins);
-        int w = std::min((int)I1.getWidth(), xMax) - xMin;
-        int n = h * w;
-        int limit = (int)(slope * n / bins + 0.5f);
-        I2[y][x] = fastRound(transferValue(v, hist, clippedHist, limit) * 255.0f);
+          int v = binOf[I1[y][x]];
+          int w = std::min((int)I1.getWidth(), xMax) - xMin;
+          int n = h * w;
+          int limit = (int)(slope * n / bins + 0.5f);
+          I2[y][x] = fastRound(transferValue(v, hist, clippedHist, limit) * 255.0f);
+        }
       }
     }
   }
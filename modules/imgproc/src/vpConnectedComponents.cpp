@@ -41,66 +41,218 @@
   \brief Basic connected components.
 */
 
-#include <queue>
+#include <algorithm>
+#include <limits>
 #include <visp3/imgproc/vpImgproc.h>
 
+#ifdef VISP_HAVE_OPENMP
+#include <omp.h>
+#endif
+
 namespace
 {
-void getNeighbors(const vpImage<unsigned char> &I, std::queue<vpImagePoint> &listOfNeighbors, const unsigned int i,
-                  const unsigned int j, const vpImageMorphology::vpConnexityType &connexity)
+// Horizontal run of pixels with the same non null value
+struct Run {
+  unsigned int start; // first column
+  unsigned int end;   // last column + 1
+  unsigned char value;
+};
+
+unsigned int findRoot(std::vector<unsigned int> &parent, unsigned int k)
 {
-  unsigned char currValue = I[i][j];
+  unsigned int root = k;
+  while (parent[root] != root) {
+    root = parent[root];
+  }
+  // Path compression
+  while (parent[k] != root) {
+    unsigned int next = parent[k];
+    parent[k] = root;
+    k = next;
+  }
+  return root;
+}
 
-  if (connexity == vpImageMorphology::CONNEXITY_4) {
-    // Top
-    if (I[i - 1][j] == currValue) {
-      listOfNeighbors.push(vpImagePoint(i - 1, j));
-    }
+// The root of a set is its smallest run index, that is its first run in raster order
+void unite(std::vector<unsigned int> &parent, unsigned int a, unsigned int b)
+{
+  a = findRoot(parent, a);
+  b = findRoot(parent, b);
+  if (a < b) {
+    parent[b] = a;
+  } else if (b < a) {
+    parent[a] = b;
+  }
+}
 
-    // Left
-    if (I[i][j - 1] == currValue) {
-      listOfNeighbors.push(vpImagePoint(i, j - 1));
+// Merge the runs of a row with the connected runs of the previous row
+void mergeRows(const std::vector<Run> &runs, const std::vector<unsigned int> &rowOffsets, unsigned int row,
+               bool connexity8, std::vector<unsigned int> &parent)
+{
+  // With 8-connexity, runs touching by a corner are connected
+  const unsigned int extent = connexity8 ? 1 : 0;
+  const unsigned int endA = rowOffsets[row];
+  unsigned int firstA = rowOffsets[row - 1];
+  for (unsigned int b = rowOffsets[row]; b < rowOffsets[row + 1]; b++) {
+    // Skip the runs of the previous row that end before the current run
+    while (firstA < endA && runs[firstA].end + extent <= runs[b].start) {
+      firstA++;
     }
 
-    // Right
-    if (I[i][j + 1] == currValue) {
-      listOfNeighbors.push(vpImagePoint(i, j + 1));
+    for (unsigned int a = firstA; a < endA && runs[a].start < runs[b].end + extent; a++) {
+      if (runs[a].value == runs[b].value) {
+        unite(parent, a, b);
+      }
     }
+  }
+}
 
-    // Bottom
-    if (I[i + 1][j] == currValue) {
-      listOfNeighbors.push(vpImagePoint(i + 1, j));
+void connectedComponentsImpl(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
+                             const vpImageMorphology::vpConnexityType &connexity, std::vector<unsigned int> *areas,
+                             std::vector<vpRect> *bboxes, std::vector<vpImagePoint> *centroids)
+{
+  const unsigned int height = I.getHeight(), width = I.getWidth();
+  const bool connexity8 = (connexity == vpImageMorphology::CONNEXITY_8);
+  labels.resize(height, width);
+
+  // Run-length encoding, the runs are numbered in raster order
+  std::vector<unsigned int> rowOffsets(height + 1, 0);
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int i = 0; i < (int)height; i++) {
+    const unsigned char *row = I[(unsigned int)i];
+    unsigned int nbRuns = 0;
+    for (unsigned int j = 0; j < width; j++) {
+      if (row[j] && (j == 0 || row[j - 1] != row[j])) {
+        nbRuns++;
+      }
     }
-  } else {
-    for (int cpt1 = -1; cpt1 <= 1; cpt1++) {
-      for (int cpt2 = -1; cpt2 <= 1; cpt2++) {
-        // Everything except the current position
-        if (cpt1 != 0 || cpt2 != 0) {
-          if (I[(int)i + cpt1][(int)j + cpt2] == currValue) {
-            listOfNeighbors.push(vpImagePoint((int)i + cpt1, (int)j + cpt2));
-          }
+    rowOffsets[(size_t)i + 1] = nbRuns;
+  }
+  for (unsigned int i = 0; i < height; i++) {
+    rowOffsets[i + 1] += rowOffsets[i];
+  }
+
+  std::vector<Run> runs(rowOffsets[height]);
+  std::vector<unsigned int> parent(runs.size());
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int i = 0; i < (int)height; i++) {
+    const unsigned char *row = I[(unsigned int)i];
+    unsigned int k = rowOffsets[(size_t)i];
+    for (unsigned int j = 0; j < width;) {
+      if (row[j]) {
+        Run &run = runs[k];
+        run.start = j;
+        run.value = row[j];
+        while (j < width && row[j] == run.value) {
+          j++;
         }
+        run.end = j;
+        parent[k] = k;
+        k++;
+      } else {
+        j++;
       }
     }
   }
-}
 
-void visitNeighbors(vpImage<unsigned char> &I_copy, std::queue<vpImagePoint> &listOfNeighbors, vpImage<int> &labels,
-                    const int current_label, const vpImageMorphology::vpConnexityType &connexity)
-{
-  // Visit the neighbors
-  while (!listOfNeighbors.empty()) {
-    vpImagePoint imPt = listOfNeighbors.front();
-    unsigned int i = (unsigned int)imPt.get_i();
-    unsigned int j = (unsigned int)imPt.get_j();
-    listOfNeighbors.pop();
-
-    if (I_copy[i][j]) {
-      getNeighbors(I_copy, listOfNeighbors, i, j, connexity);
-
-      // Reset current position and set label
-      I_copy[i][j] = 0;
-      labels[i][j] = current_label;
+  // Union of the connected runs, by horizontal strips first and then at the strip borders. Within a strip, the
+  // unions only involve runs of the strip.
+  int nbStrips = 1;
+#ifdef VISP_HAVE_OPENMP
+  nbStrips = (std::max)(1, (std::min)(omp_get_max_threads(), (int)height / 32));
+#endif
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(static) num_threads(nbStrips)
+#endif
+  for (int strip = 0; strip < nbStrips; strip++) {
+    const unsigned int firstRow = (unsigned int)((size_t)height * strip / nbStrips);
+    const unsigned int lastRow = (unsigned int)((size_t)height * (strip + 1) / nbStrips);
+    for (unsigned int i = firstRow + 1; i < lastRow; i++) {
+      mergeRows(runs, rowOffsets, i, connexity8, parent);
+    }
+  }
+  for (int strip = 1; strip < nbStrips; strip++) {
+    mergeRows(runs, rowOffsets, (unsigned int)((size_t)height * strip / nbStrips), connexity8, parent);
+  }
+
+  // Final labels, numbered by order of appearance in raster order, and statistics from the runs
+  const bool computeStats = (areas || bboxes || centroids);
+  std::vector<int> runLabels(runs.size());
+  std::vector<unsigned int> area, minI, maxI, minJ, maxJ;
+  std::vector<double> sumI, sumJ;
+  nbComponents = 0;
+  unsigned int row = 0;
+  for (unsigned int k = 0; k < runs.size(); k++) {
+    const unsigned int root = findRoot(parent, k);
+    if (root == k) {
+      runLabels[k] = ++nbComponents;
+      if (computeStats) {
+        area.push_back(0);
+        minI.push_back(std::numeric_limits<unsigned int>::max());
+        maxI.push_back(0);
+        minJ.push_back(std::numeric_limits<unsigned int>::max());
+        maxJ.push_back(0);
+        sumI.push_back(0.0);
+        sumJ.push_back(0.0);
+      }
+    } else {
+      runLabels[k] = runLabels[root];
+    }
+
+    if (computeStats) {
+      while (rowOffsets[row + 1] <= k) {
+        row++;
+      }
+      const Run &run = runs[k];
+      const size_t c = (size_t)runLabels[k] - 1;
+      const unsigned int length = run.end - run.start;
+      area[c] += length;
+      minI[c] = (std::min)(minI[c], row);
+      maxI[c] = (std::max)(maxI[c], row);
+      minJ[c] = (std::min)(minJ[c], run.start);
+      maxJ[c] = (std::max)(maxJ[c], run.end - 1);
+      sumI[c] += (double)row * length;
+      sumJ[c] += 0.5 * ((double)run.start + run.end - 1) * length;
+    }
+  }
+
+  if (areas) {
+    *areas = area;
+  }
+  if (bboxes) {
+    bboxes->resize((size_t)nbComponents);
+    for (size_t c = 0; c < (size_t)nbComponents; c++) {
+      (*bboxes)[c] = vpRect(minJ[c], minI[c], maxJ[c] - minJ[c] + 1, maxI[c] - minI[c] + 1);
+    }
+  }
+  if (centroids) {
+    centroids->resize((size_t)nbComponents);
+    for (size_t c = 0; c < (size_t)nbComponents; c++) {
+      (*centroids)[c].set_ij(sumI[c] / area[c], sumJ[c] / area[c]);
+    }
+  }
+
+  // Label image
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int i = 0; i < (int)height; i++) {
+    int *labelRow = labels[(unsigned int)i];
+    unsigned int j = 0;
+    for (unsigned int k = rowOffsets[(size_t)i]; k < rowOffsets[(size_t)i + 1]; k++) {
+      for (; j < runs[k].start; j++) {
+        labelRow[j] = 0;
+      }
+      for (; j < runs[k].end; j++) {
+        labelRow[j] = runLabels[k];
+      }
+    }
+    for (; j < width; j++) {
+      labelRow[j] = 0;
     }
   }
 }
@@ -109,11 +261,15 @@ void visitNeighbors(vpImage<unsigned char> &I_copy, std::queue<vpImagePoint> &li
 /*!
   \ingroup group_imgproc_connected_components
 
-  Perform connected components detection.
+  Perform connected components detection. Neighbor pixels with the same non
+  null value belong to the same component. The labeling is done on the
+  horizontal runs of pixels with a union-find structure, in parallel by
+  horizontal strips when OpenMP is available.
 
   \param I : Input image (0 means background).
   \param labels : Label image that contain for each position the component
-  label. \param nbComponents : Number of connected components. \param
+  label, the components being numbered from 1 in raster order of their first
+  pixel. \param nbComponents : Number of connected components. \param
   connexity : Type of connexity.
 */
 void vp::connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
@@ -123,50 +279,38 @@ void vp::connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labe
     return;
   }
 
-  labels.resize(I.getHeight(), I.getWidth());
-
-  vpImage<unsigned char> I_copy(I.getHeight() + 2, I.getWidth() + 2);
-  // Copy and add border
-  for (unsigned int i = 0; i < I_copy.getHeight(); i++) {
-    if (i == 0 || i == I_copy.getHeight() - 1) {
-      memset(I_copy[i], 0, sizeof(unsigned char) * I_copy.getWidth());
-    } else {
-      I_copy[i][0] = 0;
-      memcpy(I_copy[i] + 1, I[i - 1], sizeof(unsigned char) * I.getWidth());
-      I_copy[i][I_copy.getWidth() - 1] = 0;
-    }
-  }
-
-  vpImage<int> labels_copy(I.getHeight() + 2, I.getWidth() + 2, 0);
-
-  int current_label = 1;
-  std::queue<vpImagePoint> listOfNeighbors;
-
-  for (unsigned int cpt1 = 0; cpt1 < I.getHeight(); cpt1++) {
-    unsigned int i = cpt1 + 1;
-
-    for (unsigned int cpt2 = 0; cpt2 < I.getWidth(); cpt2++) {
-      unsigned int j = cpt2 + 1;
-
-      if (I_copy[i][j] && labels_copy[i][j] == 0) {
-        // Get all the neighbors relative to the current position
-        getNeighbors(I_copy, listOfNeighbors, i, j, connexity);
-
-        // Reset current position and set label
-        I_copy[i][j] = 0;
-        labels_copy[i][j] = current_label;
+  connectedComponentsImpl(I, labels, nbComponents, connexity, NULL, NULL, NULL);
+}
 
-        visitNeighbors(I_copy, listOfNeighbors, labels_copy, current_label, connexity);
+/*!
+  \ingroup group_imgproc_connected_components
 
-        // Increment label
-        current_label++;
-      }
-    }
-  }
+  Perform connected components detection and compute the statistics of each
+  component in the same pass, see
+  connectedComponents(const vpImage<unsigned char> &, vpImage<int> &, int &, const vpImageMorphology::vpConnexityType &).
 
-  for (unsigned int i = 0; i < labels.getHeight(); i++) {
-    memcpy(labels[i], labels_copy[i + 1] + 1, sizeof(int) * labels.getWidth());
+  \param I : Input image (0 means background).
+  \param labels : Label image that contain for each position the component
+  label.
+  \param nbComponents : Number of connected components.
+  \param areas : Number of pixels of each component, the index \e k
+  corresponding to the label \e k+1.
+  \param bboxes : Bounding box of each component.
+  \param centroids : Center of gravity of each component.
+  \param connexity : Type of connexity.
+*/
+void vp::connectedComponents(const vpImage<unsigned char> &I, vpImage<int> &labels, int &nbComponents,
+                             std::vector<unsigned int> &areas, std::vector<vpRect> &bboxes,
+                             std::vector<vpImagePoint> &centroids,
+                             const vpImageMorphology::vpConnexityType &connexity)
+{
+  areas.clear();
+  bboxes.clear();
+  centroids.clear();
+  if (I.getSize() == 0) {
+    nbComponents = 0;
+    return;
   }
 
-  nbComponents = current_label - 1;
+  connectedComponentsImpl(I, labels, nbComponents, connexity, &areas, &bboxes, &centroids);
 }
@@ -236,6 +236,176 @@ void getContoursList(const vp::vpContour &root, const int level, vp::vpContour &
     getContoursList(**it, level + 1, contour_list);
   }
 }
+
+// Offsets of the neighbours in the vpDirectionType order, from north and clockwise
+const int g_dirI[8] = {-1, -1, 0, 1, 1, 1, 0, -1};
+const int g_dirJ[8] = {0, 1, 1, 1, 0, -1, -1, -1};
+
+// States of the pixels in the padded label image of the compact border following
+enum { PIXEL_BACKGROUND = 0, PIXEL_OBJECT = 1, PIXEL_BORDER = 2, PIXEL_BORDER_EAST = 3 };
+
+/*
+  Compact replacement of the int label image of the Suzuki algorithm: the sign of the label of each pixel
+  is kept in a one byte state image and the border numbers are only stored for the border pixels of
+  the scan row (dense) and of the rows below it (sparse), the rows above being never read again.
+*/
+struct vpBorderLabels {
+  vpImage<unsigned char> m_states;
+  std::vector<int> m_rowLabels;
+  std::vector<std::vector<std::pair<unsigned int, int> > > m_nextRowLabels;
+  unsigned int m_row;
+  bool m_useLabels;
+
+  vpBorderLabels(const vpImage<unsigned char> &I, const bool useLabels)
+    : m_states(I.getHeight() + 2, I.getWidth() + 2, PIXEL_BACKGROUND), m_rowLabels(), m_nextRowLabels(), m_row(0),
+      m_useLabels(useLabels)
+  {
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      const unsigned char *src = I[i];
+      unsigned char *dst = m_states[i + 1] + 1;
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        dst[j] = src[j] != 0 ? PIXEL_OBJECT : PIXEL_BACKGROUND;
+      }
+    }
+
+    if (m_useLabels) {
+      m_rowLabels.resize(m_states.getWidth());
+      m_nextRowLabels.resize(m_states.getHeight());
+    }
+  }
+
+  void setLabel(const unsigned int i, const unsigned int j, const int nbd)
+  {
+    if (m_useLabels) {
+      if (i == m_row) {
+        m_rowLabels[j] = nbd;
+      } else if (i > m_row) {
+        m_nextRowLabels[i].push_back(std::make_pair(j, nbd));
+      }
+    }
+  }
+
+  void startRow(const unsigned int i)
+  {
+    m_row = i;
+    if (m_useLabels) {
+      // The labels are stored in the order they have been set, the last one wins
+      std::vector<std::pair<unsigned int, int> > &labels = m_nextRowLabels[i];
+      for (size_t k = 0; k < labels.size(); k++) {
+        m_rowLabels[labels[k].first] = labels[k].second;
+      }
+      std::vector<std::pair<unsigned int, int> >().swap(labels);
+    }
+  }
+};
+
+/*
+  Border following (3) of the Suzuki algorithm on the compact labels, starting at (i, j) with the
+  0-pixel (i2, j2) in the direction fromDir. The moves between the successive border points, plus
+  the move closing the border, are returned in codes, which is empty for a single pixel border.
+*/
+void followBorderCompact(vpBorderLabels &labels, unsigned int i, unsigned int j, const int fromDir, const int nbd,
+                         std::vector<unsigned char> &codes)
+{
+  codes.clear();
+
+  unsigned char *states = labels.m_states.bitmap;
+  const int stride = (int)labels.m_states.getWidth();
+  int offsets[8];
+  for (int d = 0; d < 8; d++) {
+    offsets[d] = g_dirI[d] * stride + g_dirJ[d];
+  }
+
+  const int p0 = (int)(i * (unsigned int)stride + j);
+
+  // Find i1j1 (3.1)
+  int firstDir = -1;
+  for (int k = 1; k < 8; k++) {
+    int d = (fromDir + k) & 7;
+    if (states[p0 + offsets[d]] != PIXEL_BACKGROUND) {
+      firstDir = d;
+      break;
+    }
+  }
+
+  if (firstDir < 0) {
+    //(3.1) ; single pixel contour
+    states[p0] = PIXEL_BORDER_EAST;
+    labels.setLabel(i, j, nbd);
+    return;
+  }
+
+  const int p1 = p0 + offsets[firstDir];
+  int p3 = p0;        //(3.2)
+  int dir = firstDir; // direction from i3j3 to i2j2
+
+  while (true) {
+    //(3.3)
+    bool eastChecked = false;
+    int d = (dir + 7) & 7;
+    while (states[p3 + offsets[d]] == PIXEL_BACKGROUND) {
+      eastChecked = eastChecked || d == EAST;
+      d = (d + 7) & 7;
+    }
+    int p4 = p3 + offsets[d];
+
+    //(3.4)
+    if (eastChecked) {
+      states[p3] = PIXEL_BORDER_EAST;
+      labels.setLabel(i, j, nbd);
+    } else if (states[p3] == PIXEL_OBJECT) {
+      states[p3] = PIXEL_BORDER;
+      labels.setLabel(i, j, nbd);
+    }
+
+    if (p4 == p0 && p3 == p1) {
+      //(3.5)
+      break;
+    }
+
+    //(3.5)
+    codes.push_back((unsigned char)d);
+    i += g_dirI[d];
+    j += g_dirJ[d];
+    dir = (d + 4) & 7;
+    p3 = p4;
+  }
+
+  // Move from i1j1 back to ij
+  codes.push_back((unsigned char)((firstDir + 4) & 7));
+}
+
+void addContour(vp::vpContourArray &contours, const int i, const int j, const std::vector<unsigned char> &codes,
+                const vp::vpContourType type, const int parent)
+{
+  if (contours.m_approximation == vp::CONTOUR_APPROX_CHAIN_CODE) {
+    contours.m_points.push_back(i - 1); // remove 1-pixel padding
+    contours.m_points.push_back(j - 1);
+    if (!codes.empty()) {
+      contours.m_chainCodes.insert(contours.m_chainCodes.end(), codes.begin(), codes.end() - 1);
+    }
+  } else {
+    const size_t nbPoints = (std::max)(codes.size(), (size_t)1);
+    int ii = i - 1, jj = j - 1; // remove 1-pixel padding
+    for (size_t k = 0; k < nbPoints; k++) {
+      if (contours.m_approximation == vp::CONTOUR_APPROX_NONE || codes.empty() ||
+          codes[k] != codes[(k + nbPoints - 1) % nbPoints]) {
+        contours.m_points.push_back(ii);
+        contours.m_points.push_back(jj);
+      }
+
+      if (!codes.empty()) {
+        ii += g_dirI[codes[k]];
+        jj += g_dirJ[codes[k]];
+      }
+    }
+  }
+
+  contours.m_pointIndex.push_back((unsigned int)(contours.m_points.size() / 2));
+  contours.m_chainCodeIndex.push_back((unsigned int)contours.m_chainCodes.size());
+  contours.m_contourTypes.push_back(type);
+  contours.m_parents.push_back(parent);
+}
 } // namespace
 
 /*!
@@ -466,3 +636,133 @@ void vp::findContours(const vpImage<unsigned char> &I_original, vpContour &conto
   delete root;
   root = NULL;
 }
+
+/*!
+  Remove all the contours.
+*/
+void vp::vpContourArray::clear()
+{
+  m_points.clear();
+  m_pointIndex.assign(1, 0);
+  m_chainCodes.clear();
+  m_chainCodeIndex.assign(1, 0);
+  m_contourTypes.clear();
+  m_parents.clear();
+}
+
+/*!
+  Get the points of a contour. With vp::CONTOUR_APPROX_CHAIN_CODE the chain code is decoded to retrieve all
+  the contour points.
+
+  \param index : Index of the contour.
+  \param points : Contour points.
+*/
+void vp::vpContourArray::getContour(const unsigned int index, std::vector<vpImagePoint> &points) const
+{
+  if (index >= size()) {
+    throw vpException(vpException::badValue, "Contour index %d is out of range (%d contours)", index, size());
+  }
+
+  points.clear();
+  for (unsigned int k = m_pointIndex[index]; k < m_pointIndex[index + 1]; k++) {
+    points.push_back(vpImagePoint(m_points[2 * k], m_points[2 * k + 1]));
+  }
+
+  if (m_approximation == vp::CONTOUR_APPROX_CHAIN_CODE && !points.empty()) {
+    int i = m_points[2 * m_pointIndex[index]], j = m_points[2 * m_pointIndex[index] + 1];
+    for (unsigned int k = m_chainCodeIndex[index]; k < m_chainCodeIndex[index + 1]; k++) {
+      i += g_dirI[m_chainCodes[k]];
+      j += g_dirJ[m_chainCodes[k]];
+      points.push_back(vpImagePoint(i, j));
+    }
+  }
+}
+
+/*!
+  \ingroup group_imgproc_contours
+
+  Extract contours from a binary image, without building a tree of vpContour. The Suzuki border following
+  runs directly on a one byte per pixel label image and the contours are stored in contiguous arrays of
+  integer coordinates, which is faster and needs much less memory than the vp::findContours() version
+  building a vpContour tree on large images. The contours are the same and are given in the same order.
+
+  \param I : Input binary image (0 means background, other values mean foreground).
+  \param contours : Detected contours, with the index of the parent of each contour for vp::CONTOUR_RETR_TREE
+  (-1 for the other retrieval modes).
+  \param retrievalMode : Contour retrieval mode.
+  \param approximation : Contour approximation method.
+*/
+void vp::findContours(const vpImage<unsigned char> &I, vpContourArray &contours,
+                      const vpContourRetrievalType &retrievalMode, const vpContourApproximationType &approximation)
+{
+  contours.clear();
+  contours.m_approximation = approximation;
+
+  if (I.getSize() == 0) {
+    return;
+  }
+
+  // The border numbers are only needed to retrieve the hierarchy
+  vpBorderLabels labels(I, retrievalMode != CONTOUR_RETR_LIST);
+  const unsigned char *states = labels.m_states.bitmap;
+  const unsigned int width = labels.m_states.getWidth();
+
+  // Type, parent border and contour index of each border, the background being the border 1
+  std::vector<vpContourType> borderTypes(2, CONTOUR_HOLE);
+  std::vector<int> borderParents(2, 0);
+  std::vector<int> borderContours(2, -1);
+  std::vector<unsigned char> codes;
+
+  int nbd = 1; // Newest border
+  for (unsigned int i = 1; i + 1 < labels.m_states.getHeight(); i++) {
+    labels.startRow(i);
+    int lnbd = 1; // Last newest border
+
+    const unsigned char *row = states + i * width;
+    for (unsigned int j = 1; j + 1 < width; j++) {
+      const unsigned char state = row[j];
+      if (state == PIXEL_BACKGROUND) {
+        continue;
+      }
+
+      // Without the border numbers, lnbd stays the background
+      const int label = (state >= PIXEL_BORDER && labels.m_useLabels) ? labels.m_rowLabels[j] : 1;
+      const bool isOuter = state == PIXEL_OBJECT && row[j - 1] == PIXEL_BACKGROUND;
+      const bool isHole = !isOuter && state != PIXEL_BORDER_EAST && row[j + 1] == PIXEL_BACKGROUND;
+
+      if (isOuter || isHole) {
+        nbd++;
+        int parent = 1;
+        if (isOuter) {
+          //(1) (a) and Table 1
+          parent = borderTypes[lnbd] == CONTOUR_OUTER ? borderParents[lnbd] : lnbd;
+        } else {
+          //(1) (b) and Table 1
+          if (state == PIXEL_BORDER) {
+            lnbd = label;
+          }
+          parent = borderTypes[lnbd] == CONTOUR_OUTER ? lnbd : borderParents[lnbd];
+        }
+
+        const vpContourType type = isOuter ? CONTOUR_OUTER : CONTOUR_HOLE;
+        followBorderCompact(labels, i, j, isOuter ? WEST : EAST, nbd, codes);
+
+        int contourIndex = -1;
+        if (retrievalMode != CONTOUR_RETR_EXTERNAL || (isOuter && parent == 1)) {
+          contourIndex = (int)contours.size();
+          addContour(contours, (int)i, (int)j, codes, type,
+                     retrievalMode == CONTOUR_RETR_TREE ? borderContours[parent] : -1);
+        }
+
+        borderTypes.push_back(type);
+        borderParents.push_back(parent);
+        borderContours.push_back(contourIndex);
+      }
+
+      //(4)
+      if (state >= PIXEL_BORDER) {
+        lnbd = label;
+      }
+    }
+  }
+}
@@ -41,9 +41,389 @@
   \brief Additional image morphology functions.
 */
 
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpImageTools.h>
 #include <visp3/imgproc/vpImgproc.h>
 
+#include <stdint.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
+#ifdef VISP_HAVE_OPENMP
+#include <omp.h>
+#endif
+
+namespace
+{
+template <bool erosion> inline unsigned char extremum(const unsigned char a, const unsigned char b)
+{
+  return erosion ? (std::min)(a, b) : (std::max)(a, b);
+}
+
+// Element-wise minimum (erosion) or maximum (dilatation) of two rows
+template <bool erosion>
+void combineRows(const unsigned char *a, const unsigned char *b, unsigned char *dst, const int n, const bool checkSSE2)
+{
+  int j = 0;
+#if VISP_HAVE_SSE2
+  if (checkSSE2) {
+    for (; j <= n - 16; j += 16) {
+      const __m128i ma = _mm_loadu_si128((const __m128i *)(a + j));
+      const __m128i mb = _mm_loadu_si128((const __m128i *)(b + j));
+      _mm_storeu_si128((__m128i *)(dst + j), erosion ? _mm_min_epu8(ma, mb) : _mm_max_epu8(ma, mb));
+    }
+  }
+#else
+  (void)checkSSE2;
+#endif
+
+  for (; j < n; j++) {
+    dst[j] = extremum<erosion>(a[j], b[j]);
+  }
+}
+
+/*
+  Minimum (erosion) or maximum (dilatation) of each row of I over the window [x - left, x + right], with the van Herk /
+  Gil-Werman algorithm: the padded row is cut in blocks of the window size, and the result for a pixel is the extremum
+  of a suffix of one block and of a prefix of the next one, hence three comparisons per pixel whatever the window size.
+*/
+template <bool erosion>
+void morphRows(const vpImage<unsigned char> &I, vpImage<unsigned char> &T, const int left, const int right)
+{
+  const int width = (int)I.getWidth(), w = left + right + 1, m = width + w - 1;
+  const unsigned char pad = erosion ? 255 : 0;
+  if (w == 1) {
+    T = I;
+    return;
+  }
+
+  T.resize(I.getHeight(), I.getWidth());
+  bool checkSSE2 = false;
+#if VISP_HAVE_SSE2
+  checkSSE2 = vpCPUFeatures::checkSSE2();
+#endif
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel
+#endif
+  {
+    std::vector<unsigned char> p((size_t)m), g((size_t)m), h((size_t)m);
+    std::fill(p.begin(), p.begin() + left, pad);
+    std::fill(p.begin() + left + width, p.end(), pad);
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (int i = 0; i < (int)I.getHeight(); i++) {
+      memcpy(&p[(size_t)left], I[(unsigned int)i], (size_t)width);
+
+      for (int start = 0; start < m; start += w) {
+        const int end = (std::min)(start + w, m);
+        g[(size_t)start] = p[(size_t)start];
+        for (int k = start + 1; k < end; k++) {
+          g[(size_t)k] = extremum<erosion>(g[(size_t)k - 1], p[(size_t)k]);
+        }
+        h[(size_t)end - 1] = p[(size_t)end - 1];
+        for (int k = end - 2; k >= start; k--) {
+          h[(size_t)k] = extremum<erosion>(h[(size_t)k + 1], p[(size_t)k]);
+        }
+      }
+
+      combineRows<erosion>(&h[0], &g[(size_t)w - 1], T[(unsigned int)i], width, checkSSE2);
+    }
+  }
+}
+
+// Row k of the image T padded with top rows of padding
+inline const unsigned char *paddedRow(const vpImage<unsigned char> &T, const std::vector<unsigned char> &padRow,
+                                      const int k, const int top)
+{
+  return (k < top || k >= top + (int)T.getHeight()) ? &padRow[0] : T[(unsigned int)(k - top)];
+}
+
+// Same as morphRows() along the columns, the prefix and suffix extrema being computed on whole rows
+template <bool erosion>
+void morphCols(const vpImage<unsigned char> &T, vpImage<unsigned char> &I, const int top, const int bottom)
+{
+  const int width = (int)T.getWidth(), height = (int)T.getHeight();
+  const int w = top + bottom + 1, m = height + w - 1;
+  if (w == 1) {
+    I = T;
+    return;
+  }
+
+  bool checkSSE2 = false;
+#if VISP_HAVE_SSE2
+  checkSSE2 = vpCPUFeatures::checkSSE2();
+#endif
+  const std::vector<unsigned char> padRow((size_t)width, erosion ? 255 : 0);
+  std::vector<unsigned char> g((size_t)m * width), h((size_t)m * width);
+  const int nbBlocks = (m + w - 1) / w;
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int block = 0; block < nbBlocks; block++) {
+    const int start = block * w, end = (std::min)(start + w, m);
+    memcpy(&g[(size_t)start * width], paddedRow(T, padRow, start, top), (size_t)width);
+    for (int k = start + 1; k < end; k++) {
+      combineRows<erosion>(&g[(size_t)(k - 1) * width], paddedRow(T, padRow, k, top), &g[(size_t)k * width], width,
+                           checkSSE2);
+    }
+    memcpy(&h[(size_t)(end - 1) * width], paddedRow(T, padRow, end - 1, top), (size_t)width);
+    for (int k = end - 2; k >= start; k--) {
+      combineRows<erosion>(&h[(size_t)(k + 1) * width], paddedRow(T, padRow, k, top), &h[(size_t)k * width], width,
+                           checkSSE2);
+    }
+  }
+
+  I.resize((unsigned int)height, (unsigned int)width);
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int i = 0; i < height; i++) {
+    combineRows<erosion>(&h[(size_t)i * width], &g[(size_t)(i + w - 1) * width], I[(unsigned int)i], width, checkSSE2);
+  }
+}
+
+// Bits [64 * k + s, 64 * k + s + 63] of a packed row, bits outside the row being set
+inline uint64_t shiftedWord(const uint64_t *row, const int nbWords, const int k, const int s)
+{
+  const int pos = 64 * k + s;
+  const int q = (pos >= 0 ? pos : pos - 63) / 64, b = pos - 64 * q;
+  const uint64_t lo = (q >= 0 && q < nbWords) ? row[q] : ~(uint64_t)0;
+  if (b == 0) {
+    return lo;
+  }
+  const uint64_t hi = (q + 1 >= 0 && q + 1 < nbWords) ? row[q + 1] : ~(uint64_t)0;
+  return (lo >> b) | (hi << (64 - b));
+}
+
+// Bit j of the packed row is set for the pixels equal to value, the bits after the row are set
+void packRow(const unsigned char *src, const int width, const unsigned char value, uint64_t *row, const bool checkSSE2)
+{
+  for (int k = 0; k < (width + 63) / 64; k++) {
+    const unsigned char *chunk = src + 64 * k;
+    const int n = (std::min)(64, width - 64 * k);
+    uint64_t word = n < 64 ? ~(uint64_t)0 << n : 0;
+    int b = 0;
+#if VISP_HAVE_SSE2
+    if (checkSSE2) {
+      const __m128i mvalue = _mm_set1_epi8((char)value);
+      for (; b <= n - 16; b += 16) {
+        const __m128i m = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(chunk + b)), mvalue);
+        word |= (uint64_t)(unsigned int)_mm_movemask_epi8(m) << b;
+      }
+    }
+#else
+    (void)checkSSE2;
+#endif
+    for (; b < n; b++) {
+      word |= (uint64_t)(chunk[b] == value) << b;
+    }
+    row[k] = word;
+  }
+}
+
+// Inverse of packRow(): the pixels of the set bits are equal to value, the other ones to 255 - value
+void unpackRow(const uint64_t *row, const int width, const unsigned char value, unsigned char *dst,
+               const bool checkSSE2)
+{
+  int j = 0;
+#if VISP_HAVE_SSE2
+  if (checkSSE2) {
+    const __m128i bitMask = _mm_set_epi32((int)0x80402010, (int)0x08040201, (int)0x80402010, (int)0x08040201);
+    const __m128i flip = _mm_set1_epi8(value ? 0 : (char)0xFF);
+    for (; j <= width - 16; j += 16) {
+      const unsigned int bits = (unsigned int)(row[j / 64] >> (j % 64)) & 0xFFFF;
+      // Byte i of the lower (upper) half holds the lower (upper) byte of the bits
+      const __m128i bytes = _mm_unpacklo_epi64(_mm_set1_epi8((char)(bits & 0xFF)), _mm_set1_epi8((char)(bits >> 8)));
+      const __m128i m = _mm_cmpeq_epi8(_mm_and_si128(bytes, bitMask), bitMask);
+      _mm_storeu_si128((__m128i *)(dst + j), _mm_xor_si128(m, flip));
+    }
+  }
+#else
+  (void)checkSSE2;
+#endif
+  for (; j < width; j++) {
+    dst[j] = ((row[j / 64] >> (j % 64)) & 1) ? value : (unsigned char)(255 - value);
+  }
+}
+
+/*
+  Rectangular erosion or dilatation of a binary image (0 or 255) packed 64 pixels per word. A dilatation is computed
+  as the erosion of the background. Along the rows, the AND over the window is obtained by doubling runs of set bits,
+  along the columns with the van Herk / Gil-Werman algorithm on whole words.
+*/
+void morphRectBinary(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const int width, const int height,
+                     const bool erosion)
+{
+  const int W = (int)I1.getWidth(), H = (int)I1.getHeight();
+  const int left = erosion ? width / 2 : width - 1 - width / 2;
+  const int top = erosion ? height / 2 : height - 1 - height / 2;
+  const unsigned char set = erosion ? 255 : 0;
+  const int nbPaddedWords = (W + width - 1 + 63) / 64, nbWords = (W + 63) / 64;
+  const int m = H + height - 1;
+  const uint64_t ones = ~(uint64_t)0;
+  bool checkSSE2 = false;
+#if VISP_HAVE_SSE2
+  checkSSE2 = vpCPUFeatures::checkSSE2();
+#endif
+
+  // Rows padded with the neutral element of the vertical pass
+  std::vector<uint64_t> rows((size_t)m * nbWords, ones);
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel
+#endif
+  {
+    std::vector<uint64_t> packed((size_t)nbWords), cur((size_t)nbPaddedWords);
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp for schedule(static)
+#endif
+    for (int i = 0; i < H; i++) {
+      // Row shifted by the left padding
+      packRow(I1[(unsigned int)i], W, set, &packed[0], checkSSE2);
+      for (int k = 0; k < nbPaddedWords; k++) {
+        cur[(size_t)k] = shiftedWord(&packed[0], nbWords, k, -left);
+      }
+
+      // After this loop, bit k is the AND of bits [k, k + span - 1]
+      int span = 1;
+      for (; 2 * span <= width; span *= 2) {
+        for (int k = 0; k < nbPaddedWords; k++) {
+          cur[(size_t)k] &= shiftedWord(&cur[0], nbPaddedWords, k, span);
+        }
+      }
+
+      uint64_t *dst = &rows[(size_t)(i + top) * nbWords];
+      for (int k = 0; k < nbWords; k++) {
+        dst[k] = span < width ? cur[(size_t)k] & shiftedWord(&cur[0], nbPaddedWords, k, width - span) : cur[(size_t)k];
+      }
+    }
+  }
+
+  std::vector<uint64_t> g((size_t)m * nbWords), h((size_t)m * nbWords);
+  const int nbBlocks = (m + height - 1) / height;
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int block = 0; block < nbBlocks; block++) {
+    const int start = block * height, end = (std::min)(start + height, m);
+    for (int k = 0; k < nbWords; k++) {
+      g[(size_t)start * nbWords + k] = rows[(size_t)start * nbWords + k];
+      h[(size_t)(end - 1) * nbWords + k] = rows[(size_t)(end - 1) * nbWords + k];
+    }
+    for (int i = start + 1; i < end; i++) {
+      for (int k = 0; k < nbWords; k++) {
+        g[(size_t)i * nbWords + k] = g[(size_t)(i - 1) * nbWords + k] & rows[(size_t)i * nbWords + k];
+      }
+    }
+    for (int i = end - 2; i >= start; i--) {
+      for (int k = 0; k < nbWords; k++) {
+        h[(size_t)i * nbWords + k] = h[(size_t)(i + 1) * nbWords + k] & rows[(size_t)i * nbWords + k];
+      }
+    }
+  }
+
+  I2.resize((unsigned int)H, (unsigned int)W);
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+  for (int i = 0; i < H; i++) {
+    uint64_t *hi = &h[(size_t)i * nbWords];
+    const uint64_t *gi = &g[(size_t)(i + height - 1) * nbWords];
+    for (int k = 0; k < nbWords; k++) {
+      hi[k] &= gi[k];
+    }
+    unpackRow(hi, W, set, I2[(unsigned int)i], checkSSE2);
+  }
+}
+
+bool isBinary(const vpImage<unsigned char> &I)
+{
+  for (unsigned int i = 0; i < I.getSize(); i++) {
+    if (I.bitmap[i] != 0 && I.bitmap[i] != 255) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+template <bool erosion>
+void morph(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+           const unsigned int height, const vp::vpStructuringElementType &type)
+{
+  if (width == 0 || (height == 0 && type == vp::STRUCTURING_ELEMENT_RECT)) {
+    throw vpException(vpException::badValue, "The structuring element size must be positive!");
+  }
+  if (I1.getSize() == 0) {
+    I2 = I1;
+    return;
+  }
+
+  vpImage<unsigned char> T;
+  if (type == vp::STRUCTURING_ELEMENT_RECT) {
+    if (isBinary(I1)) {
+      morphRectBinary(I1, I2, (int)width, (int)height, erosion);
+      return;
+    }
+
+    // The dilatation uses the reflected structuring element so that the opening and the closing are idempotent
+    const int left = erosion ? (int)width / 2 : (int)width - 1 - (int)width / 2;
+    const int top = erosion ? (int)height / 2 : (int)height - 1 - (int)height / 2;
+    morphRows<erosion>(I1, T, left, (int)width - 1 - left);
+    morphCols<erosion>(T, I2, top, (int)height - 1 - top);
+    return;
+  }
+
+  // A disk is the union of horizontal chords: the image is eroded by each distinct chord, and the rows of these
+  // results are combined with the corresponding vertical offsets
+  const int radius = (int)width / 2, H = (int)I1.getHeight();
+  std::vector<int> halfWidths((size_t)radius + 1);
+  for (int dy = 0; dy <= radius; dy++) {
+    halfWidths[(size_t)dy] = vpMath::round(sqrt((double)(radius * radius - dy * dy)));
+  }
+
+  bool checkSSE2 = false;
+#if VISP_HAVE_SSE2
+  checkSSE2 = vpCPUFeatures::checkSSE2();
+#endif
+  vpImage<unsigned char> R(I1.getHeight(), I1.getWidth(), erosion ? 255 : 0);
+  for (int dy = 0; dy <= radius; dy++) {
+    if (dy > 0 && halfWidths[(size_t)dy] == halfWidths[(size_t)dy - 1]) {
+      continue;
+    }
+    const int halfWidth = halfWidths[(size_t)dy];
+    morphRows<erosion>(I1, T, halfWidth, halfWidth);
+
+    // All the offsets sharing this chord
+    for (int dz = dy; dz <= radius && halfWidths[(size_t)dz] == halfWidth; dz++) {
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+      for (int i = 0; i < H; i++) {
+        if (i + dz < H) {
+          combineRows<erosion>(R[(unsigned int)i], T[(unsigned int)(i + dz)], R[(unsigned int)i], (int)R.getWidth(),
+                               checkSSE2);
+        }
+        if (dz > 0 && i - dz >= 0) {
+          combineRows<erosion>(R[(unsigned int)i], T[(unsigned int)(i - dz)], R[(unsigned int)i], (int)R.getWidth(),
+                               checkSSE2);
+        }
+      }
+    }
+  }
+
+  I2 = R;
+}
+}
+
 /*!
   \ingroup group_imgproc_morph
 
@@ -178,3 +558,145 @@ void vp::reconstruct(const vpImage<unsigned char> &marker, const vpImage<unsigne
     h_k = h_kp1;
   } while (true);
 }
+
+/*!
+  \ingroup group_imgproc_morph
+
+  Erode a grayscale image with a flat rectangular or disk structuring element of any size:
+  \f$ I_2 \left( x,y \right) = \textbf{min} \left \{ I_1 \left ( x+x', y+y' \right ) | \left ( x', y'\right )
+  \subseteq D_B \right \} \f$, the image being assumed to be \f$ + \infty \f$ outside its domain.
+
+  A rectangle is processed as a horizontal and a vertical line with the van Herk / Gil-Werman algorithm, at a constant
+  cost per pixel whatever its size. A binary image (only 0 and 255 values) is processed 64 pixels at a time on bits.
+  A disk costs one pass per distinct chord, i.e. linear in its radius.
+
+  The disk has a radius \f$ r = \lfloor width / 2 \rfloor \f$ and contains the offsets \f$ (x', y') \f$ with
+  \f$ |y'| \leq r \f$ and \f$ |x'| \leq \textbf{round} ( \sqrt{r^2 - y'^2} ) \f$. Its diameter is \f$ 2 r + 1 \f$,
+  i.e. an even width is rounded up to the next odd value.
+
+  \param I1 : Input image.
+  \param I2 : Eroded image, can be the input image.
+  \param width : Width of the rectangle (anchored at (width / 2, height / 2)) or diameter of the disk, rounded up to
+  an odd value.
+  \param height : Height of the rectangle, ignored for a disk.
+  \param type : Type of structuring element.
+
+  \sa dilate(), opening(), closing(), vpImageMorphology::erosion()
+*/
+void vp::erode(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+               const unsigned int height, const vpStructuringElementType &type)
+{
+  morph<true>(I1, I2, width, height, type);
+}
+
+/*!
+  \ingroup group_imgproc_morph
+
+  Dilate a grayscale image with a flat rectangular or disk structuring element of any size:
+  \f$ I_2 \left( x,y \right) = \textbf{max} \left \{ I_1 \left ( x-x', y-y' \right ) | \left ( x', y'\right )
+  \subseteq D_B \right \} \f$, the image being assumed to be \f$ - \infty \f$ outside its domain.
+
+  See erode() for the algorithms and the footprint of the disk.
+
+  \param I1 : Input image.
+  \param I2 : Dilated image, can be the input image.
+  \param width : Width of the rectangle (anchored at (width / 2, height / 2)) or diameter of the disk, rounded up to
+  an odd value.
+  \param height : Height of the rectangle, ignored for a disk.
+  \param type : Type of structuring element.
+
+  \sa erode(), opening(), closing(), vpImageMorphology::dilatation()
+*/
+void vp::dilate(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+                const unsigned int height, const vpStructuringElementType &type)
+{
+  morph<false>(I1, I2, width, height, type);
+}
+
+/*!
+  \ingroup group_imgproc_morph
+
+  Morphological opening: erosion followed by a dilatation with the same structuring element. Removes the bright
+  details smaller than the structuring element.
+
+  \param I1 : Input image.
+  \param I2 : Opened image, can be the input image.
+  \param width : Width of the rectangle or diameter of the disk, rounded up to an odd value.
+  \param height : Height of the rectangle, ignored for a disk.
+  \param type : Type of structuring element.
+
+  \sa erode(), dilate(), topHat()
+*/
+void vp::opening(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+                 const unsigned int height, const vpStructuringElementType &type)
+{
+  vpImage<unsigned char> I_eroded;
+  erode(I1, I_eroded, width, height, type);
+  dilate(I_eroded, I2, width, height, type);
+}
+
+/*!
+  \ingroup group_imgproc_morph
+
+  Morphological closing: dilatation followed by an erosion with the same structuring element. Fills the dark details
+  smaller than the structuring element.
+
+  \param I1 : Input image.
+  \param I2 : Closed image, can be the input image.
+  \param width : Width of the rectangle or diameter of the disk, rounded up to an odd value.
+  \param height : Height of the rectangle, ignored for a disk.
+  \param type : Type of structuring element.
+
+  \sa erode(), dilate(), blackHat()
+*/
+void vp::closing(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+                 const unsigned int height, const vpStructuringElementType &type)
+{
+  vpImage<unsigned char> I_dilated;
+  dilate(I1, I_dilated, width, height, type);
+  erode(I_dilated, I2, width, height, type);
+}
+
+/*!
+  \ingroup group_imgproc_morph
+
+  White top-hat transform: difference between the image and its opening, i.e. the bright details smaller than the
+  structuring element.
+
+  \param I1 : Input image.
+  \param I2 : Top-hat image, can be the input image.
+  \param width : Width of the rectangle or diameter of the disk, rounded up to an odd value.
+  \param height : Height of the rectangle, ignored for a disk.
+  \param type : Type of structuring element.
+
+  \sa opening(), blackHat()
+*/
+void vp::topHat(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+                const unsigned int height, const vpStructuringElementType &type)
+{
+  vpImage<unsigned char> I_opened;
+  opening(I1, I_opened, width, height, type);
+  vpImageTools::imageSubtract(I1, I_opened, I2, true);
+}
+
+/*!
+  \ingroup group_imgproc_morph
+
+  Black top-hat transform: difference between the closing of the image and the image, i.e. the dark details smaller
+  than the structuring element.
+
+  \param I1 : Input image.
+  \param I2 : Black top-hat image, can be the input image.
+  \param width : Width of the rectangle or diameter of the disk, rounded up to an odd value.
+  \param height : Height of the rectangle, ignored for a disk.
+  \param type : Type of structuring element.
+
+  \sa closing(), topHat()
+*/
+void vp::blackHat(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2, const unsigned int width,
+                  const unsigned int height, const vpStructuringElementType &type)
+{
+  vpImage<unsigned char> I_closed;
+  closing(I1, I_closed, width, height, type);
+  vpImageTools::imageSubtract(I_closed, I1, I2, true);
+}
@@ -45,6 +45,10 @@
 #include <visp3/core/vpImageTools.h>
 #include <visp3/imgproc/vpImgproc.h>
 
+#ifdef VISP_HAVE_OPENMP
+#include <omp.h>
+#endif
+
 namespace
 {
 bool isBimodal(const std::vector<float> &hist_float)
@@ -364,58 +368,267 @@ int computeThresholdTriangle(vpHistogram &hist)
 /*!
   \ingroup group_imgproc_threshold
 
-  Automatic thresholding.
+  Compute the threshold of an automatic thresholding method from an image histogram, for instance
+  to threshold many images with a histogram accumulated over a region of interest or over several
+  frames.
 
-  \param I : Input grayscale image.
+  \param hist : Image histogram, with 256 bins.
   \param method : Automatic thresholding method.
-  \param backgroundValue : Value to set to the background.
-  \param foregroundValue : Value to set to the foreground.
+  \return The threshold, or -1 if it cannot be computed.
 */
-unsigned char vp::autoThreshold(vpImage<unsigned char> &I, const vpAutoThresholdMethod &method,
-                                const unsigned char backgroundValue, const unsigned char foregroundValue)
+int vp::computeAutoThreshold(const vpHistogram &hist, const vpAutoThresholdMethod &method)
 {
-  if (I.getSize() == 0) {
-    return 0;
+  if (hist.getSize() != 256) {
+    throw vpException(vpException::dimensionError, "The histogram must have 256 bins, not %d", hist.getSize());
+  }
+
+  unsigned int imageSize = 0;
+  for (unsigned int cpt = 0; cpt < hist.getSize(); cpt++) {
+    imageSize += hist[cpt];
+  }
+
+  if (imageSize == 0) {
+    return -1;
   }
 
-  // Compute image histogram
-  vpHistogram histogram(I);
   int threshold = -1;
 
   switch (method) {
   case AUTO_THRESHOLD_HUANG:
-    threshold = computeThresholdHuang(histogram);
+    threshold = computeThresholdHuang(hist);
     break;
 
   case AUTO_THRESHOLD_INTERMODES:
-    threshold = computeThresholdIntermodes(histogram);
+    threshold = computeThresholdIntermodes(hist);
     break;
 
   case AUTO_THRESHOLD_ISODATA:
-    threshold = computeThresholdIsoData(histogram, I.getSize());
+    threshold = computeThresholdIsoData(hist, imageSize);
     break;
 
   case AUTO_THRESHOLD_MEAN:
-    threshold = computeThresholdMean(histogram, I.getSize());
+    threshold = computeThresholdMean(hist, imageSize);
     break;
 
   case AUTO_THRESHOLD_OTSU:
-    threshold = computeThresholdOtsu(histogram, I.getSize());
+    threshold = computeThresholdOtsu(hist, imageSize);
     break;
 
-  case AUTO_THRESHOLD_TRIANGLE:
-    threshold = computeThresholdTriangle(histogram);
+  case AUTO_THRESHOLD_TRIANGLE: {
+    // The histogram is flipped in place
+    vpHistogram hist_copy(hist);
+    threshold = computeThresholdTriangle(hist_copy);
     break;
+  }
 
   default:
     break;
   }
 
+  return threshold;
+}
+
+/*!
+  \ingroup group_imgproc_threshold
+
+  Automatic thresholding.
+
+  \param I : Input grayscale image.
+  \param method : Automatic thresholding method.
+  \param backgroundValue : Value to set to the background.
+  \param foregroundValue : Value to set to the foreground.
+*/
+unsigned char vp::autoThreshold(vpImage<unsigned char> &I, const vpAutoThresholdMethod &method,
+                                const unsigned char backgroundValue, const unsigned char foregroundValue)
+{
+  return vp::autoThreshold(I, I, method, backgroundValue, foregroundValue);
+}
+
+/*!
+  \ingroup group_imgproc_threshold
+
+  Automatic thresholding. The pixel values are counted in interleaved banks by vpHistogram and the
+  binary image is written with a branchless comparison, in parallel when OpenMP is available.
+
+  \param I1 : Input grayscale image.
+  \param I2 : Binary image, can be the input image.
+  \param method : Automatic thresholding method.
+  \param backgroundValue : Value to set to the pixels lower than the threshold.
+  \param foregroundValue : Value to set to the other pixels.
+  \return The threshold. If it cannot be computed, the output image is not modified.
+*/
+unsigned char vp::autoThreshold(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2,
+                                const vpAutoThresholdMethod &method, const unsigned char backgroundValue,
+                                const unsigned char foregroundValue)
+{
+  if (I1.getSize() == 0) {
+    return 0;
+  }
+
+  // Compute image histogram
+  vpHistogram histogram(I1);
+  int threshold = computeAutoThreshold(histogram, method);
+
   if (threshold != -1) {
     // Threshold
-    vpImageTools::binarise(I, (unsigned char)threshold, (unsigned char)255, backgroundValue, foregroundValue,
-                           foregroundValue);
+    if (&I1 != &I2) {
+      I2.resize(I1.getHeight(), I1.getWidth());
+    }
+
+    const unsigned char *src = I1.bitmap;
+    unsigned char *dst = I2.bitmap;
+    const unsigned char thresh = (unsigned char)threshold;
+    const int size = (int)I1.getSize();
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for
+#endif
+    for (int cpt = 0; cpt < size; cpt++) {
+      dst[cpt] = src[cpt] < thresh ? backgroundValue : foregroundValue;
+    }
   }
 
   return threshold;
 }
+
+/*!
+  \ingroup group_imgproc_threshold
+
+  Adaptive thresholding, the threshold of each pixel being computed from the mean, and the standard
+  deviation for vp::ADAPTIVE_THRESHOLD_SAUVOLA, of the pixels in a window centered on it. The local
+  statistics are computed in constant time per pixel with the integral, along the rows, of running
+  column sums.
+
+  \param I1 : Input grayscale image.
+  \param I2 : Binary image, can be the input image.
+  \param method : Adaptive thresholding method.
+  \param windowSize : Side of the square window, an even size is increased by one. The window is
+  clipped at the image borders.
+  \param k : Sensitivity parameter of the method, see vp::vpAdaptiveThresholdMethod.
+  \param backgroundValue : Value to set to the pixels lower than or equal to their threshold.
+  \param foregroundValue : Value to set to the pixels greater than their threshold.
+*/
+void vp::adaptiveThreshold(const vpImage<unsigned char> &I1, vpImage<unsigned char> &I2,
+                           const vpAdaptiveThresholdMethod &method, const unsigned int windowSize, const double k,
+                           const unsigned char backgroundValue, const unsigned char foregroundValue)
+{
+  if (I1.getSize() == 0) {
+    return;
+  }
+
+  if (windowSize == 0) {
+    throw vpException(vpException::badValue, "The window size must be positive");
+  }
+
+  if (&I1 != &I2) {
+    I2.resize(I1.getHeight(), I1.getWidth());
+  }
+
+  // The rows leaving the window are read after having been thresholded when working in place
+  vpImage<unsigned char> I_copy;
+  if (&I1 == &I2) {
+    I_copy = I1;
+  }
+  const unsigned char *rows = (&I1 == &I2) ? I_copy.bitmap : I1.bitmap;
+
+  const int height = (int)I1.getHeight(), width = (int)I1.getWidth();
+  const int radius = (int)windowSize / 2;
+  const bool sauvola = method == ADAPTIVE_THRESHOLD_SAUVOLA;
+  // Standard deviation normalization of Sauvola, for 8-bit images
+  const double R = 128.0;
+
+  // Window bounds and inverse window width of each column
+  std::vector<int> lefts((size_t)width), rights((size_t)width);
+  std::vector<double> invWidths((size_t)width);
+  for (int j = 0; j < width; j++) {
+    lefts[(size_t)j] = (std::max)(j - radius, 0);
+    rights[(size_t)j] = (std::min)(j + radius + 1, width);
+    invWidths[(size_t)j] = 1.0 / (rights[(size_t)j] - lefts[(size_t)j]);
+  }
+
+  // The image is split in horizontal strips processed in parallel. Each strip slides the sums of the
+  // columns of the window rows, whose integral along the row gives the window sums in constant time,
+  // which avoids to store the integral images of the whole image.
+  int nbStrips = 1;
+#ifdef VISP_HAVE_OPENMP
+  nbStrips = std::max(1, std::min(omp_get_max_threads(), height));
+#pragma omp parallel for schedule(static) num_threads(nbStrips)
+#endif
+  for (int strip = 0; strip < nbStrips; strip++) {
+    const int iBegin = (int)((size_t)height * strip / nbStrips);
+    const int iEnd = (int)((size_t)height * (strip + 1) / nbStrips);
+
+    std::vector<unsigned int> colSums((size_t)width, 0);
+    std::vector<double> colSumsSq((size_t)width, 0.0);
+    std::vector<double> rowIntegral((size_t)width + 1, 0.0), rowIntegralSq((size_t)width + 1, 0.0);
+    // Rows of the window of the row before the strip, the first slide of the strip removes its top row
+    for (int i = (std::max)(iBegin - radius - 1, 0); i < (std::min)(iBegin + radius, height); i++) {
+      const unsigned char *row = rows + (size_t)i * width;
+      for (int j = 0; j < width; j++) {
+        colSums[(size_t)j] += row[j];
+      }
+      if (sauvola) {
+        for (int j = 0; j < width; j++) {
+          colSumsSq[(size_t)j] += row[j] * row[j];
+        }
+      }
+    }
+
+    for (int i = iBegin; i < iEnd; i++) {
+      // Slide the window rows
+      if (i + radius < height) {
+        const unsigned char *row = rows + (size_t)(i + radius) * width;
+        for (int j = 0; j < width; j++) {
+          colSums[(size_t)j] += row[j];
+        }
+        if (sauvola) {
+          for (int j = 0; j < width; j++) {
+            colSumsSq[(size_t)j] += row[j] * row[j];
+          }
+        }
+      }
+      if (i - radius - 1 >= 0) {
+        const unsigned char *row = rows + (size_t)(i - radius - 1) * width;
+        for (int j = 0; j < width; j++) {
+          colSums[(size_t)j] -= row[j];
+        }
+        if (sauvola) {
+          for (int j = 0; j < width; j++) {
+            colSumsSq[(size_t)j] -= row[j] * row[j];
+          }
+        }
+      }
+
+      for (int j = 0; j < width; j++) {
+        rowIntegral[(size_t)j + 1] = rowIntegral[(size_t)j] + colSums[(size_t)j];
+      }
+      if (sauvola) {
+        for (int j = 0; j < width; j++) {
+          rowIntegralSq[(size_t)j + 1] = rowIntegralSq[(size_t)j] + colSumsSq[(size_t)j];
+        }
+      }
+
+      const double invHeight = 1.0 / ((std::min)(i + radius + 1, height) - (std::max)(i - radius, 0));
+      const unsigned char *src = rows + (size_t)i * width;
+      unsigned char *dst = I2[i];
+
+      if (sauvola) {
+        for (int j = 0; j < width; j++) {
+          const int left = lefts[(size_t)j], right = rights[(size_t)j];
+          const double invArea = invHeight * invWidths[(size_t)j];
+          const double mean = (rowIntegral[(size_t)right] - rowIntegral[(size_t)left]) * invArea;
+          const double meanSq = (rowIntegralSq[(size_t)right] - rowIntegralSq[(size_t)left]) * invArea;
+          const double stdev = sqrt((std::max)(meanSq - mean * mean, 0.0));
+          dst[j] = src[j] > mean * (1.0 + k * (stdev / R - 1.0)) ? foregroundValue : backgroundValue;
+        }
+      } else {
+        const double scale = (1.0 - k) * invHeight;
+        for (int j = 0; j < width; j++) {
+          const int left = lefts[(size_t)j], right = rights[(size_t)j];
+          const double threshold =
+              (rowIntegral[(size_t)right] - rowIntegral[(size_t)left]) * scale * invWidths[(size_t)j];
+          dst[j] = src[j] > threshold ? foregroundValue : backgroundValue;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,267 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ *
+ * Description:
+ * Test CLAHE on random images.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testCLAHE.cpp
+
+  Compare the exact and the fast Contrast Limited Adaptive Histogram
+  Equalization with straightforward implementations on random images.
+*/
+
+#include <cstdlib>
+#include <iostream>
+
+#include <visp3/core/vpUniRand.h>
+#include <visp3/imgproc/vpImgproc.h>
+
+namespace
+{
+int fastRound(const float value) { return (int)(value + 0.5f); }
+
+/*
+  Clip the histogram at the limit and redistribute the clipped entries, as in
+  the CLAHE ImageJ plugin.
+*/
+void clipHistogram(std::vector<int> &hist, const int limit)
+{
+  const int histlength = (int)hist.size();
+  int clippedEntries = 0, clippedEntriesBefore = 0;
+  do {
+    clippedEntriesBefore = clippedEntries;
+    clippedEntries = 0;
+    for (int i = 0; i < histlength; i++) {
+      if (hist[i] > limit) {
+        clippedEntries += hist[i] - limit;
+        hist[i] = limit;
+      }
+    }
+
+    for (int i = 0; i < histlength; i++) {
+      hist[i] += clippedEntries / histlength;
+    }
+    const int m = clippedEntries % histlength;
+    if (m != 0) {
+      const int s = (histlength - 1) / m;
+      for (int i = s / 2; i < histlength; i += s) {
+        hist[i]++;
+      }
+    }
+  } while (clippedEntries != clippedEntriesBefore);
+}
+
+/*
+  Transfer function of the clipped histogram of the (2*blockRadius+1) block
+  centered on (x, y), cut by the image borders, for each bin.
+*/
+std::vector<float> transferFunction(const vpImage<unsigned char> &I, const int x, const int y, const int blockRadius,
+                                    const int bins, const int limit)
+{
+  std::vector<int> hist((size_t)(bins + 1), 0);
+  for (int i = std::max(0, y - blockRadius); i <= std::min((int)I.getHeight() - 1, y + blockRadius); i++) {
+    for (int j = std::max(0, x - blockRadius); j <= std::min((int)I.getWidth() - 1, x + blockRadius); j++) {
+      hist[(size_t)fastRound(I[i][j] / 255.0f * bins)]++;
+    }
+  }
+  clipHistogram(hist, limit);
+
+  // The cumulated histogram starts at the first non empty bin
+  size_t hMin = 0;
+  while (hMin + 1 < hist.size() && hist[hMin] == 0) {
+    hMin++;
+  }
+  int total = 0;
+  for (size_t i = hMin; i < hist.size(); i++) {
+    total += hist[i];
+  }
+
+  std::vector<float> transfer(hist.size());
+  int cdf = 0;
+  for (size_t i = 0; i < hist.size(); i++) {
+    if (i >= hMin) {
+      cdf += hist[i];
+    }
+    transfer[i] = (cdf - hist[hMin]) / (float)(total - hist[hMin]);
+  }
+
+  return transfer;
+}
+
+void referenceCLAHE(const vpImage<unsigned char> &I, vpImage<unsigned char> &I_ref, const int blockRadius,
+                    const int bins, const float slope)
+{
+  I_ref.resize(I.getHeight(), I.getWidth());
+  for (int y = 0; y < (int)I.getHeight(); y++) {
+    for (int x = 0; x < (int)I.getWidth(); x++) {
+      const int h = std::min((int)I.getHeight(), y + blockRadius + 1) - std::max(0, y - blockRadius);
+      const int w = std::min((int)I.getWidth(), x + blockRadius + 1) - std::max(0, x - blockRadius);
+      const int limit = (int)(slope * h * w / bins + 0.5f);
+      const std::vector<float> transfer = transferFunction(I, x, y, blockRadius, bins, limit);
+      I_ref[y][x] = (unsigned char)fastRound(transfer[(size_t)fastRound(I[y][x] / 255.0f * bins)] * 255.0f);
+    }
+  }
+}
+
+/*
+  Block centers of the fast CLAHE along a dimension. When the size is not a
+  multiple of the block size, the blocks are centered and two blocks are
+  added on the borders.
+*/
+std::vector<int> blockCenters(const int size, const int blockRadius)
+{
+  const int blockSize = 2 * blockRadius + 1;
+  const int n = size / blockSize, remainder = size - n * blockSize;
+  std::vector<int> centers;
+  if (remainder > 1) {
+    centers.push_back(blockRadius + 1);
+  }
+  for (int i = 0; i < n; i++) {
+    centers.push_back(i * blockSize + blockRadius + 1 + (remainder > 1 ? remainder / 2 : 0));
+  }
+  if (remainder > 0) {
+    centers.push_back(size - blockRadius - 1);
+  }
+  return centers;
+}
+
+/*
+  Neighbor block centers c0 <= v < c1 of a pixel, the same block on the
+  borders.
+*/
+void neighborCenters(const std::vector<int> &centers, const int v, int &c0, int &c1)
+{
+  int c = 0;
+  while (c < (int)centers.size() && centers[(size_t)c] <= v) {
+    c++;
+  }
+  c0 = std::max(0, c - 1);
+  c1 = std::min((int)centers.size() - 1, c);
+}
+
+void referenceFastCLAHE(const vpImage<unsigned char> &I, vpImage<unsigned char> &I_ref, const int blockRadius,
+                        const int bins, const float slope)
+{
+  const int blockSize = 2 * blockRadius + 1;
+  const int limit = (int)(slope * blockSize * blockSize / bins + 0.5);
+  const std::vector<int> cs = blockCenters((int)I.getWidth(), blockRadius);
+  const std::vector<int> rs = blockCenters((int)I.getHeight(), blockRadius);
+
+  I_ref.resize(I.getHeight(), I.getWidth());
+  for (int y = 0; y < (int)I.getHeight(); y++) {
+    int r0 = 0, r1 = 0;
+    neighborCenters(rs, y, r0, r1);
+    for (int x = 0; x < (int)I.getWidth(); x++) {
+      int c0 = 0, c1 = 0;
+      neighborCenters(cs, x, c0, c1);
+      const size_t v = (size_t)fastRound(I[y][x] / 255.0f * bins);
+      const float t00 = transferFunction(I, cs[(size_t)c0], rs[(size_t)r0], blockRadius, bins, limit)[v];
+      const float t01 = transferFunction(I, cs[(size_t)c1], rs[(size_t)r0], blockRadius, bins, limit)[v];
+      const float t10 = transferFunction(I, cs[(size_t)c0], rs[(size_t)r1], blockRadius, bins, limit)[v];
+      const float t11 = transferFunction(I, cs[(size_t)c1], rs[(size_t)r1], blockRadius, bins, limit)[v];
+
+      // Bilinear interpolation between the neighbor blocks
+      float t0 = t00, t1 = t10;
+      if (c0 != c1) {
+        const float wx = (float)(cs[(size_t)c1] - x) / (cs[(size_t)c1] - cs[(size_t)c0]);
+        t0 = wx * t00 + (1.0f - wx) * t01;
+        t1 = wx * t10 + (1.0f - wx) * t11;
+      }
+      float t = t0;
+      if (r0 != r1) {
+        const float wy = (float)(rs[(size_t)r1] - y) / (rs[(size_t)r1] - rs[(size_t)r0]);
+        t = wy * t0 + (1.0f - wy) * t1;
+      }
+      I_ref[y][x] = (unsigned char)std::max(0, std::min(255, fastRound(t * 255.0f)));
+    }
+  }
+}
+
+bool checkCLAHE(const vpImage<unsigned char> &I, const int blockRadius, const int bins, const float slope,
+                const bool fast)
+{
+  vpImage<unsigned char> I_clahe, I_ref;
+  vp::clahe(I, I_clahe, blockRadius, bins, slope, fast);
+  if (fast) {
+    referenceFastCLAHE(I, I_ref, blockRadius, bins, slope);
+  } else {
+    referenceCLAHE(I, I_ref, blockRadius, bins, slope);
+  }
+
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      if (I_clahe[i][j] != I_ref[i][j]) {
+        std::cerr << "Wrong " << (fast ? "fast " : "") << "CLAHE at (" << i << ", " << j << ") for a "
+                  << I.getHeight() << "x" << I.getWidth() << " image, a block radius of " << blockRadius << " and "
+                  << bins << " bins: " << (int)I_clahe[i][j] << " instead of " << (int)I_ref[i][j] << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  vpUniRand random(1);
+  // Sizes that are a multiple of the block size or not, with one or more remaining pixels
+  const unsigned int sizes[][2] = {{37, 53}, {64, 80}, {61, 41}};
+  const int blockRadius[] = {2, 5, 12, 20};
+  const int bins[] = {16, 64, 256, 256};
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    // Bimodal image with a gradient
+    vpImage<unsigned char> I(sizes[s][0], sizes[s][1]);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        I[i][j] = (unsigned char)(j + (random() < 0.3 ? 50 : 120) + random() * 60);
+      }
+    }
+
+    for (unsigned int b = 0; b < sizeof(blockRadius) / sizeof(blockRadius[0]); b++) {
+      if ((unsigned int)(2 * blockRadius[b] + 1) > std::min(I.getHeight(), I.getWidth())) {
+        continue;
+      }
+
+      if (!checkCLAHE(I, blockRadius[b], bins[b], 3.0f, false) || !checkCLAHE(I, blockRadius[b], bins[b], 3.0f, true) ||
+          !checkCLAHE(I, blockRadius[b], bins[b], 1.5f, true)) {
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::cout << "testCLAHE is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test connected components on random images.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testConnectedComponentsRandom.cpp
+
+  Compare the connected components labeling with a flood fill and check the
+  statistics of the components, on random images.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <queue>
+#include <utility>
+
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/imgproc/vpImgproc.h>
+
+namespace
+{
+// Reference labeling with a flood fill, the components are numbered in raster order
+int floodFillLabeling(const vpImage<unsigned char> &I, vpImage<int> &labels, bool connexity8)
+{
+  const int h = (int)I.getHeight(), w = (int)I.getWidth();
+  labels.resize(I.getHeight(), I.getWidth(), 0);
+  int nbComponents = 0;
+  for (int i0 = 0; i0 < h; i0++) {
+    for (int j0 = 0; j0 < w; j0++) {
+      if (I[i0][j0] == 0 || labels[i0][j0] != 0) {
+        continue;
+      }
+
+      nbComponents++;
+      std::queue<std::pair<int, int> > queue;
+      queue.push(std::make_pair(i0, j0));
+      labels[i0][j0] = nbComponents;
+      while (!queue.empty()) {
+        std::pair<int, int> p = queue.front();
+        queue.pop();
+        for (int di = -1; di <= 1; di++) {
+          for (int dj = -1; dj <= 1; dj++) {
+            if ((di == 0 && dj == 0) || (!connexity8 && di != 0 && dj != 0)) {
+              continue;
+            }
+            int i = p.first + di, j = p.second + dj;
+            if (i >= 0 && i < h && j >= 0 && j < w && labels[i][j] == 0 && I[i][j] == I[i0][j0]) {
+              labels[i][j] = nbComponents;
+              queue.push(std::make_pair(i, j));
+            }
+          }
+        }
+      }
+    }
+  }
+  return nbComponents;
+}
+
+bool checkImage(const vpImage<unsigned char> &I, bool connexity8)
+{
+  vpImage<int> labels_ref, labels;
+  int nbComponents_ref = floodFillLabeling(I, labels_ref, connexity8);
+
+  int nbComponents = 0;
+  std::vector<unsigned int> areas;
+  std::vector<vpRect> bboxes;
+  std::vector<vpImagePoint> centroids;
+  vp::connectedComponents(I, labels, nbComponents, areas, bboxes, centroids,
+                          connexity8 ? vpImageMorphology::CONNEXITY_8 : vpImageMorphology::CONNEXITY_4);
+
+  if (nbComponents != nbComponents_ref || labels != labels_ref) {
+    std::cerr << "Bad labeling: " << nbComponents << " components instead of " << nbComponents_ref << std::endl;
+    return false;
+  }
+
+  std::vector<unsigned int> areas_ref((size_t)nbComponents, 0);
+  std::vector<double> sumI((size_t)nbComponents, 0), sumJ((size_t)nbComponents, 0);
+  std::vector<unsigned int> minI((size_t)nbComponents, I.getHeight()), maxI((size_t)nbComponents, 0);
+  std::vector<unsigned int> minJ((size_t)nbComponents, I.getWidth()), maxJ((size_t)nbComponents, 0);
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      if (labels_ref[i][j] > 0) {
+        size_t c = (size_t)labels_ref[i][j] - 1;
+        minI[c] = (std::min)(minI[c], i);
+        maxI[c] = (std::max)(maxI[c], i);
+        minJ[c] = (std::min)(minJ[c], j);
+        maxJ[c] = (std::max)(maxJ[c], j);
+        areas_ref[c]++;
+        sumI[c] += i;
+        sumJ[c] += j;
+      }
+    }
+  }
+
+  for (size_t c = 0; c < (size_t)nbComponents; c++) {
+    vpRect bbox_ref(minJ[c], minI[c], maxJ[c] - minJ[c] + 1, maxI[c] - minI[c] + 1);
+    if (areas[c] != areas_ref[c] || bboxes[c] != bbox_ref ||
+        !vpMath::equal(centroids[c].get_i(), sumI[c] / areas_ref[c], 1e-9) ||
+        !vpMath::equal(centroids[c].get_j(), sumJ[c] / areas_ref[c], 1e-9)) {
+      std::cerr << "Bad statistics for the component " << c + 1 << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  vpUniRand random(1);
+  const unsigned int sizes[][2] = {{1, 1}, {1, 57}, {57, 1}, {64, 80}, {317, 251}};
+  // With little background, the components are large and cross the strips of the parallel labeling
+  const double backgroundRatios[] = {0.5, 0.15};
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    for (unsigned int r = 0; r < sizeof(backgroundRatios) / sizeof(backgroundRatios[0]); r++) {
+      for (unsigned int nbValues = 1; nbValues <= 3; nbValues++) {
+        vpImage<unsigned char> I(sizes[s][0], sizes[s][1]);
+        for (unsigned int k = 0; k < I.getSize(); k++) {
+          // The pixels that are not background take nbValues values
+          I.bitmap[k] = random() < backgroundRatios[r]
+                            ? 0
+                            : (unsigned char)(1 + (unsigned int)(random() * nbValues) % nbValues);
+        }
+
+        if (!checkImage(I, false) || !checkImage(I, true)) {
+          std::cerr << "Failure for a " << I.getHeight() << "x" << I.getWidth() << " image with "
+                    << backgroundRatios[r] * 100 << "% of background and " << nbValues << " values" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  std::cout << "testConnectedComponentsRandom is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,202 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the compact contour extraction against the contour tree.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testContoursArray.cpp
+
+  Compare the contours extracted into a vp::vpContourArray, with all the
+  retrieval modes and approximation methods, with the contours extracted into
+  a tree of vp::vpContour on random images.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+#include <visp3/core/vpUniRand.h>
+#include <visp3/imgproc/vpImgproc.h>
+
+namespace
+{
+typedef std::pair<std::pair<std::vector<int>, int>, std::vector<int> > vpContourKey;
+
+std::vector<int> toCoordinates(const std::vector<vpImagePoint> &points)
+{
+  std::vector<int> coordinates;
+  for (size_t k = 0; k < points.size(); k++) {
+    coordinates.push_back((int)points[k].get_i());
+    coordinates.push_back((int)points[k].get_j());
+  }
+  return coordinates;
+}
+
+// Contour points, contour type and parent contour points of all the contours of the tree
+void getTreeKeys(const vp::vpContour &contour, std::vector<vpContourKey> &keys)
+{
+  for (size_t k = 0; k < contour.m_children.size(); k++) {
+    const vp::vpContour &child = *contour.m_children[k];
+    std::vector<int> parent;
+    if (contour.m_parent != NULL) {
+      parent = toCoordinates(contour.m_points);
+    }
+    keys.push_back(std::make_pair(std::make_pair(toCoordinates(child.m_points), (int)child.m_contourType), parent));
+    getTreeKeys(child, keys);
+  }
+}
+
+// Keep only the points where the direction of the contour changes
+std::vector<int> simplify(const std::vector<int> &coordinates)
+{
+  const size_t n = coordinates.size() / 2;
+  if (n < 2) {
+    return coordinates;
+  }
+
+  std::vector<int> vertices;
+  for (size_t k = 0; k < n; k++) {
+    size_t prev = (k + n - 1) % n, next = (k + 1) % n;
+    if (coordinates[2 * k] - coordinates[2 * prev] != coordinates[2 * next] - coordinates[2 * k] ||
+        coordinates[2 * k + 1] - coordinates[2 * prev + 1] != coordinates[2 * next + 1] - coordinates[2 * k + 1]) {
+      vertices.push_back(coordinates[2 * k]);
+      vertices.push_back(coordinates[2 * k + 1]);
+    }
+  }
+  return vertices;
+}
+
+bool checkImage(const vpImage<unsigned char> &I, const vp::vpContourRetrievalType &retrievalMode)
+{
+  vpImage<unsigned char> I_bin(I.getHeight(), I.getWidth());
+  for (unsigned int k = 0; k < I.getSize(); k++) {
+    I_bin.bitmap[k] = I.bitmap[k] != 0 ? 1 : 0;
+  }
+
+  vp::vpContour tree;
+  std::vector<std::vector<vpImagePoint> > contourPts;
+  vp::findContours(I_bin, tree, contourPts, retrievalMode);
+
+  vp::vpContourArray contours, chainCodes, polygons;
+  vp::findContours(I, contours, retrievalMode, vp::CONTOUR_APPROX_NONE);
+  vp::findContours(I, chainCodes, retrievalMode, vp::CONTOUR_APPROX_CHAIN_CODE);
+  vp::findContours(I, polygons, retrievalMode, vp::CONTOUR_APPROX_SIMPLE);
+
+  if (contours.size() != contourPts.size() || chainCodes.size() != contourPts.size() ||
+      polygons.size() != contourPts.size()) {
+    std::cerr << "Wrong number of contours: " << contours.size() << " instead of " << contourPts.size() << std::endl;
+    return false;
+  }
+
+  std::vector<vpContourKey> keys;
+  for (unsigned int k = 0; k < contours.size(); k++) {
+    std::vector<vpImagePoint> points, decoded, vertices;
+    contours.getContour(k, points);
+    chainCodes.getContour(k, decoded);
+    polygons.getContour(k, vertices);
+
+    const std::vector<int> coordinates = toCoordinates(points);
+    if (coordinates != toCoordinates(contourPts[k]) || toCoordinates(decoded) != coordinates ||
+        toCoordinates(vertices) != simplify(coordinates)) {
+      std::cerr << "Wrong points for the contour " << k << std::endl;
+      return false;
+    }
+
+    if (retrievalMode != vp::CONTOUR_RETR_TREE && contours.m_parents[k] != -1) {
+      std::cerr << "Unexpected parent for the contour " << k << std::endl;
+      return false;
+    }
+
+    std::vector<int> parent;
+    if (contours.m_parents[k] >= 0) {
+      std::vector<vpImagePoint> parentPoints;
+      contours.getContour((unsigned int)contours.m_parents[k], parentPoints);
+      parent = toCoordinates(parentPoints);
+    }
+    keys.push_back(std::make_pair(std::make_pair(coordinates, (int)contours.m_contourTypes[k]), parent));
+  }
+
+  if (retrievalMode != vp::CONTOUR_RETR_LIST) {
+    std::vector<vpContourKey> treeKeys;
+    getTreeKeys(tree, treeKeys);
+    std::sort(keys.begin(), keys.end());
+    std::sort(treeKeys.begin(), treeKeys.end());
+    if (keys != treeKeys) {
+      std::cerr << "Wrong contour types or hierarchy" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  vpUniRand random(1);
+  const unsigned int sizes[][2] = {{1, 1}, {1, 70}, {70, 1}, {37, 131}, {90, 67}};
+  const double densities[] = {0.1, 0.5, 0.9};
+  const vp::vpContourRetrievalType modes[] = {vp::CONTOUR_RETR_TREE, vp::CONTOUR_RETR_LIST,
+                                              vp::CONTOUR_RETR_EXTERNAL};
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    for (unsigned int d = 0; d < sizeof(densities) / sizeof(densities[0]); d++) {
+      vpImage<unsigned char> I(sizes[s][0], sizes[s][1]);
+      for (unsigned int k = 0; k < I.getSize(); k++) {
+        I.bitmap[k] = random() < densities[d] ? 255 : 0;
+      }
+
+      // Nested squares
+      if (d == 0) {
+        for (unsigned int i = 0; i < I.getHeight(); i++) {
+          for (unsigned int j = 0; j < I.getWidth(); j++) {
+            unsigned int ring = (std::min)((std::min)(i, I.getHeight() - 1 - i), (std::min)(j, I.getWidth() - 1 - j));
+            if (ring % 4 == 1) {
+              I[i][j] = 255;
+            }
+          }
+        }
+      }
+
+      for (unsigned int m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        if (!checkImage(I, modes[m])) {
+          std::cerr << "Failure for a " << I.getHeight() << "x" << I.getWidth() << " image with a density of "
+                    << densities[d] << " and the retrieval mode " << modes[m] << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
+  std::cout << "testContoursArray is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
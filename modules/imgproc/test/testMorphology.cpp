@@ -0,0 +1,188 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test morphology with large structuring elements on random images.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMorphology.cpp
+
+  Compare the erosion and the dilatation with rectangular and disk
+  structuring elements with a brute force implementation, on grayscale and
+  binary random images, and check the properties of the opening and the
+  closing.
+*/
+
+#include <cstdlib>
+#include <iostream>
+
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/imgproc/vpImgproc.h>
+
+namespace
+{
+// Brute force erosion or dilatation, the structuring element being reflected for the dilatation
+void morphReference(const vpImage<unsigned char> &I, vpImage<unsigned char> &Ires, int width, int height,
+                    vp::vpStructuringElementType type, bool erosion)
+{
+  int left = erosion ? width / 2 : width - 1 - width / 2;
+  int top = erosion ? height / 2 : height - 1 - height / 2;
+  int right = width - 1 - left, bottom = height - 1 - top;
+  int radius = width / 2;
+  if (type == vp::STRUCTURING_ELEMENT_DISK) {
+    left = right = top = bottom = radius;
+  }
+
+  Ires.resize(I.getHeight(), I.getWidth());
+  for (int i = 0; i < (int)I.getHeight(); i++) {
+    for (int j = 0; j < (int)I.getWidth(); j++) {
+      unsigned char value = erosion ? 255 : 0;
+      for (int di = -top; di <= bottom; di++) {
+        for (int dj = -left; dj <= right; dj++) {
+          if (type == vp::STRUCTURING_ELEMENT_DISK &&
+              std::abs(dj) > vpMath::round(sqrt((double)(radius * radius - di * di)))) {
+            continue;
+          }
+          int y = i + di, x = j + dj;
+          if (y >= 0 && y < (int)I.getHeight() && x >= 0 && x < (int)I.getWidth()) {
+            value = erosion ? (std::min)(value, I[y][x]) : (std::max)(value, I[y][x]);
+          }
+        }
+      }
+      Ires[i][j] = value;
+    }
+  }
+}
+
+bool checkImage(const vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                vp::vpStructuringElementType type)
+{
+  vpImage<unsigned char> I_ref, I_res;
+  for (int erosion = 0; erosion < 2; erosion++) {
+    morphReference(I, I_ref, (int)width, (int)height, type, erosion != 0);
+    if (erosion) {
+      vp::erode(I, I_res, width, height, type);
+    } else {
+      vp::dilate(I, I_res, width, height, type);
+    }
+
+    if (I_res != I_ref) {
+      std::cerr << (erosion ? "Bad erosion" : "Bad dilatation") << std::endl;
+      return false;
+    }
+  }
+
+  // The opening is anti-extensive and idempotent, the closing extensive and idempotent
+  vpImage<unsigned char> I_open, I_close, I_tmp;
+  vp::opening(I, I_open, width, height, type);
+  vp::closing(I, I_close, width, height, type);
+  for (unsigned int k = 0; k < I.getSize(); k++) {
+    if (I_open.bitmap[k] > I.bitmap[k] || I_close.bitmap[k] < I.bitmap[k]) {
+      std::cerr << "The opening or the closing is not ordered" << std::endl;
+      return false;
+    }
+  }
+  vp::opening(I_open, I_tmp, width, height, type);
+  if (I_tmp != I_open) {
+    std::cerr << "The opening is not idempotent" << std::endl;
+    return false;
+  }
+  vp::closing(I_close, I_tmp, width, height, type);
+  if (I_tmp != I_close) {
+    std::cerr << "The closing is not idempotent" << std::endl;
+    return false;
+  }
+
+  // In place top-hat
+  I_tmp = I;
+  vp::topHat(I_tmp, I_tmp, width, height, type);
+  for (unsigned int k = 0; k < I.getSize(); k++) {
+    if (I_tmp.bitmap[k] != I.bitmap[k] - I_open.bitmap[k]) {
+      std::cerr << "Bad top-hat" << std::endl;
+      return false;
+    }
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  vpUniRand random(1);
+  // Widths around the 64 pixels words of the packed binary images, heights lower and greater than the elements
+  const unsigned int sizes[][2] = {{1, 1}, {2, 63}, {85, 1}, {37, 64}, {90, 65}, {17, 130}};
+  const unsigned int elements[][2] = {{1, 1}, {3, 3}, {4, 1}, {1, 6}, {9, 5}, {64, 2}, {11, 40}, {81, 3}};
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    for (int binary = 0; binary < 2; binary++) {
+      vpImage<unsigned char> I(sizes[s][0], sizes[s][1]);
+      for (unsigned int k = 0; k < I.getSize(); k++) {
+        I.bitmap[k] = binary ? (random() < 0.7 ? 255 : 0) : (unsigned char)(random() * 256);
+      }
+
+      for (unsigned int e = 0; e < sizeof(elements) / sizeof(elements[0]); e++) {
+        if (!checkImage(I, elements[e][0], elements[e][1], vp::STRUCTURING_ELEMENT_RECT) ||
+            !checkImage(I, elements[e][0], elements[e][1], vp::STRUCTURING_ELEMENT_DISK)) {
+          std::cerr << "Failure for a " << I.getHeight() << "x" << I.getWidth() << (binary ? " binary" : "")
+                    << " image with a " << elements[e][0] << "x" << elements[e][1] << " structuring element"
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // A 3x3 square is the 8-connexity neighborhood
+    vpImage<unsigned char> I(sizes[s][0], sizes[s][1]), I_res;
+    for (unsigned int k = 0; k < I.getSize(); k++) {
+      I.bitmap[k] = (unsigned char)(random() * 256);
+    }
+    vp::erode(I, I_res, 3, 3);
+    vpImageMorphology::erosion(I, vpImageMorphology::CONNEXITY_8);
+    if (I_res != I) {
+      std::cerr << "Erosion different from vpImageMorphology::erosion()" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The diameter of a disk is rounded up to an odd value
+    vpImage<unsigned char> I_odd;
+    vp::dilate(I, I_res, 8, 1, vp::STRUCTURING_ELEMENT_DISK);
+    vp::dilate(I, I_odd, 9, 1, vp::STRUCTURING_ELEMENT_DISK);
+    if (I_res != I_odd) {
+      std::cerr << "Disk of even diameter different from the next odd one" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "testMorphology is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,191 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test histogram, automatic and adaptive thresholding on random images.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testThresholdRandom.cpp
+
+  Compare the histogram, the automatic thresholding and the adaptive
+  thresholding with brute force implementations on random images.
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include <visp3/core/vpUniRand.h>
+#include <visp3/imgproc/vpImgproc.h>
+
+namespace
+{
+bool checkHistogram(const vpImage<unsigned char> &I)
+{
+  const unsigned int nbins[] = {256, 64, 7};
+  for (unsigned int b = 0; b < sizeof(nbins) / sizeof(nbins[0]); b++) {
+    std::vector<unsigned int> reference(nbins[b], 0);
+    for (unsigned int k = 0; k < I.getSize(); k++) {
+      reference[(unsigned int)(I.bitmap[k] * nbins[b] / 256.0)]++;
+    }
+
+    for (unsigned int nbThreads = 1; nbThreads <= 4; nbThreads += 3) {
+      vpHistogram hist;
+      hist.calculate(I, nbins[b], nbThreads);
+      for (unsigned int i = 0; i < nbins[b]; i++) {
+        if (hist[i] != reference[i]) {
+          std::cerr << "Wrong histogram with " << nbins[b] << " bins and " << nbThreads << " threads" << std::endl;
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+bool checkAutoThreshold(const vpImage<unsigned char> &I)
+{
+  const vp::vpAutoThresholdMethod methods[] = {vp::AUTO_THRESHOLD_HUANG, vp::AUTO_THRESHOLD_INTERMODES,
+                                               vp::AUTO_THRESHOLD_ISODATA, vp::AUTO_THRESHOLD_MEAN,
+                                               vp::AUTO_THRESHOLD_OTSU, vp::AUTO_THRESHOLD_TRIANGLE};
+  vpHistogram hist(I);
+  for (unsigned int m = 0; m < sizeof(methods) / sizeof(methods[0]); m++) {
+    int threshold = vp::computeAutoThreshold(hist, methods[m]);
+    vpImage<unsigned char> I_res, I_inplace = I;
+    unsigned char threshold_res = vp::autoThreshold(I, I_res, methods[m], 10, 200);
+    unsigned char threshold_inplace = vp::autoThreshold(I_inplace, methods[m], 10, 200);
+    if (threshold_res != (unsigned char)threshold || threshold_inplace != (unsigned char)threshold) {
+      std::cerr << "Wrong threshold for the method " << methods[m] << std::endl;
+      return false;
+    }
+
+    // The image is left unchanged when there is no threshold
+    if (threshold < 0) {
+      if (I_inplace != I) {
+        std::cerr << "Image modified without threshold for the method " << methods[m] << std::endl;
+        return false;
+      }
+      continue;
+    }
+
+    if (I_inplace != I_res) {
+      std::cerr << "In place automatic thresholding differs for the method " << methods[m] << std::endl;
+      return false;
+    }
+
+    for (unsigned int k = 0; k < I.getSize(); k++) {
+      if (I_res.bitmap[k] != (I.bitmap[k] < threshold ? 10 : 200)) {
+        std::cerr << "Wrong binarization for the method " << methods[m] << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool checkAdaptiveThreshold(const vpImage<unsigned char> &I, const vp::vpAdaptiveThresholdMethod &method,
+                            unsigned int windowSize, double k)
+{
+  vpImage<unsigned char> I_res, I_inplace = I;
+  vp::adaptiveThreshold(I, I_res, method, windowSize, k, 10, 200);
+  vp::adaptiveThreshold(I_inplace, I_inplace, method, windowSize, k, 10, 200);
+  if (I_inplace != I_res) {
+    std::cerr << "In place adaptive thresholding differs" << std::endl;
+    return false;
+  }
+
+  const int radius = (int)windowSize / 2;
+  for (int i = 0; i < (int)I.getHeight(); i++) {
+    for (int j = 0; j < (int)I.getWidth(); j++) {
+      double sum = 0.0, sumSq = 0.0, area = 0.0;
+      for (int y = std::max(i - radius, 0); y <= std::min(i + radius, (int)I.getHeight() - 1); y++) {
+        for (int x = std::max(j - radius, 0); x <= std::min(j + radius, (int)I.getWidth() - 1); x++) {
+          sum += I[y][x];
+          sumSq += I[y][x] * I[y][x];
+          area++;
+        }
+      }
+
+      const double mean = sum / area;
+      double threshold = mean * (1.0 - k);
+      if (method == vp::ADAPTIVE_THRESHOLD_SAUVOLA) {
+        threshold = mean * (1.0 + k * (std::sqrt(std::max(sumSq / area - mean * mean, 0.0)) / 128.0 - 1.0));
+      }
+
+      // Skip the ties, which depend on the rounding errors
+      if (std::fabs(I[i][j] - threshold) > 1e-6 && I_res[i][j] != (I[i][j] > threshold ? 200 : 10)) {
+        std::cerr << "Wrong adaptive thresholding at (" << i << ", " << j << ") for a " << windowSize << "x"
+                  << windowSize << " window" << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+}
+
+int main()
+{
+  vpUniRand random(1);
+  // Images smaller and larger than the windows, with strips shorter or taller than the window radius
+  const unsigned int sizes[][2] = {{1, 1}, {3, 200}, {200, 3}, {23, 97}, {129, 61}};
+  const unsigned int windowSizes[] = {1, 3, 8, 15, 41, 301};
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    // Bimodal image with a gradient
+    vpImage<unsigned char> I(sizes[s][0], sizes[s][1]);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        I[i][j] = (unsigned char)(j + (random() < 0.3 ? 50 : 120) + random() * 60);
+      }
+    }
+
+    // The histogram of the tiny images is not suitable to the automatic thresholding methods
+    if (!checkHistogram(I) || (I.getSize() > 1000 && !checkAutoThreshold(I))) {
+      std::cerr << "Failure for a " << I.getHeight() << "x" << I.getWidth() << " image" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    for (unsigned int w = 0; w < sizeof(windowSizes) / sizeof(windowSizes[0]); w++) {
+      if (!checkAdaptiveThreshold(I, vp::ADAPTIVE_THRESHOLD_MEAN, windowSizes[w], 0.1) ||
+          !checkAdaptiveThreshold(I, vp::ADAPTIVE_THRESHOLD_SAUVOLA, windowSizes[w], 0.3)) {
+        std::cerr << "Failure for a " << I.getHeight() << "x" << I.getWidth() << " image" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::cout << "testThresholdRandom is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,125 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Write images in background threads.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpAsyncImageWriter.h
+  \brief Write images in background threads
+*/
+
+#ifndef vpAsyncImageWriter_h
+#define vpAsyncImageWriter_h
+
+#include <string>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpRGBa.h>
+
+/*!
+  \class vpAsyncImageWriter
+
+  \ingroup group_io_image
+
+  \brief Writes images with vpImageIo::write() in background threads, so that
+  recording images does not slow down the thread that produces them.
+
+  write() copies the image into a buffer of a bounded queue and returns. Worker
+  threads encode the queued images and write them to disk. The queue buffers
+  are recycled, so that no memory is allocated once the image size is stable,
+  and the memory used is bounded by the queue size.
+
+  When the workers do not keep up and the queue is full, the queue policy
+  selects between waiting for a free buffer (BLOCK), replacing the oldest
+  queued image (DROP_OLDEST) or dropping the new image (DROP_NEWEST). flush()
+  waits until all the queued images are written.
+
+  \code
+#include <cstdio>
+#include <iostream>
+#include <visp3/io/vpAsyncImageWriter.h>
+
+int main()
+{
+  vpImage<unsigned char> I(480, 640);
+  vpAsyncImageWriter writer(32, 2, vpAsyncImageWriter::DROP_OLDEST);
+
+  for (unsigned int i = 0; i < 1000; i++) {
+    // Here the code to acquire I
+    char filename[FILENAME_MAX];
+    sprintf(filename, "/tmp/image%04u.png", i);
+    writer.write(I, filename);
+  }
+
+  writer.flush(); // wait until all the images are written
+  std::cout << writer.getDroppedCount() << " images dropped" << std::endl;
+  return 0;
+}
+  \endcode
+
+  \note The background threads require a C++11 compiler. Otherwise write()
+  writes the image before returning.
+
+  \sa vpVideoWriter::setAsynchronous()
+*/
+class VISP_EXPORT vpAsyncImageWriter
+{
+public:
+  //! Behavior of write() when the queue is full.
+  typedef enum {
+    BLOCK,       /*!< Wait until a queued image is written. */
+    DROP_OLDEST, /*!< Drop the oldest image not being written yet. */
+    DROP_NEWEST  /*!< Drop the image passed to write(). */
+  } vpQueuePolicy;
+
+  explicit vpAsyncImageWriter(unsigned int queue_size = 16, unsigned int nb_threads = 1,
+                              vpQueuePolicy policy = BLOCK);
+  virtual ~vpAsyncImageWriter();
+
+  void flush();
+  unsigned int getDroppedCount() const;
+  unsigned int getQueueSize() const;
+  unsigned int getWrittenCount() const;
+  bool write(const vpImage<unsigned char> &I, const std::string &filename);
+  bool write(const vpImage<vpRGBa> &I, const std::string &filename);
+
+private:
+  vpAsyncImageWriter(const vpAsyncImageWriter &);            // noncopyable
+  vpAsyncImageWriter &operator=(const vpAsyncImageWriter &); //
+
+  class Impl;
+  Impl *m_impl;
+};
+
+#endif
@@ -141,6 +141,10 @@ public:
     Return the current image number.
   */
   long getImageNumber() { return m_image_number; };
+  /*!
+    Return the number of the image read by the next call to acquire().
+  */
+  long getNextImageNumber() const { return m_image_number_next; }
 
   void open(vpImage<unsigned char> &I);
   void open(vpImage<vpRGBa> &I);
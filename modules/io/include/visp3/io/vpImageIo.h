@@ -48,6 +48,8 @@
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpImageConvert.h>
 #include <visp3/core/vpRGBa.h>
+#include <visp3/io/vpRawImageReader.h>
+#include <visp3/io/vpRawImageWriter.h>
 
 #include <iostream>
 #include <stdio.h>
@@ -75,7 +77,8 @@
 
   \brief Read/write images with various image format.
 
-  This class has its own implementation of PGM and PPM images read/write.
+  This class has its own implementation of PGM and PPM images read/write, and
+  of raw images of any pixel type with readRAW() and writeRAW().
 
   This class may benefit from optional 3rd parties:
   - libpng: If installed this optional 3rd party is used to read/write PNG
@@ -115,6 +118,21 @@ int main()
   read/write jpeg images. It supposes that `libjpeg` is installed.
 
   \include tutorial-image-reader.cpp
+
+  When processing large image sequences, readJPEG() is able to decode an
+  image directly at a reduced size and writePNG() to trade file size for
+  writing speed with a low zlib compression level:
+
+  \code
+#include <visp3/io/vpImageIo.h>
+
+int main()
+{
+  vpImage<unsigned char> I;
+  vpImageIo::readJPEG(I, "image.jpg", 2); // Half size image decoded by libjpeg
+  vpImageIo::writePNG(I, "image.png", 1); // Fast compression
+}
+  \endcode
 */
 
 class VISP_EXPORT vpImageIo
@@ -154,8 +172,25 @@ public:
   static void readPPM(vpImage<unsigned char> &I, const std::string &filename);
   static void readPPM(vpImage<vpRGBa> &I, const std::string &filename);
 
-  static void readJPEG(vpImage<unsigned char> &I, const std::string &filename);
-  static void readJPEG(vpImage<vpRGBa> &I, const std::string &filename);
+  /*!
+    Read an image from a raw image file written by writeRAW() or
+    vpRawImageWriter. The file is mapped in memory and the pixels are copied
+    in \e I with a single memcpy().
+
+    \param I : Image of any pixel type to set with the \e filename content.
+    \param filename : Name of the file containing the image.
+    \param index : Index of the image when the file contains a sequence.
+
+    \sa vpRawImageReader
+  */
+  template <class Type> static void readRAW(vpImage<Type> &I, const std::string &filename, unsigned int index = 0)
+  {
+    vpRawImageReader reader(filename);
+    reader.read(I, index);
+  }
+
+  static void readJPEG(vpImage<unsigned char> &I, const std::string &filename, unsigned int downscale = 1);
+  static void readJPEG(vpImage<vpRGBa> &I, const std::string &filename, unsigned int downscale = 1);
 
   static void readPNG(vpImage<unsigned char> &I, const std::string &filename);
   static void readPNG(vpImage<vpRGBa> &I, const std::string &filename);
@@ -169,10 +204,26 @@ public:
   static void writePPM(const vpImage<unsigned char> &I, const std::string &filename);
   static void writePPM(const vpImage<vpRGBa> &I, const std::string &filename);
 
+  /*!
+    Write an image of any pixel type, like a depth map or a float image,
+    without any encoding in a raw image file, see vpRawImageFormat.
+
+    \param I : Image to save.
+    \param filename : Name of the file containing the image.
+
+    \sa vpRawImageWriter to write a sequence of images with their timestamp
+    and camera parameters.
+  */
+  template <class Type> static void writeRAW(const vpImage<Type> &I, const std::string &filename)
+  {
+    vpRawImageWriter writer(filename);
+    writer.write(I);
+  }
+
   static void writeJPEG(const vpImage<unsigned char> &I, const std::string &filename);
   static void writeJPEG(const vpImage<vpRGBa> &I, const std::string &filename);
 
-  static void writePNG(const vpImage<unsigned char> &I, const std::string &filename);
-  static void writePNG(const vpImage<vpRGBa> &I, const std::string &filename);
+  static void writePNG(const vpImage<unsigned char> &I, const std::string &filename, int compression_level = -1);
+  static void writePNG(const vpImage<vpRGBa> &I, const std::string &filename, int compression_level = -1);
 };
 #endif
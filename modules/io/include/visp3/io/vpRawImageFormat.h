@@ -0,0 +1,159 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Raw image file format.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpRawImageFormat.h
+  \brief Raw image file format
+*/
+
+#ifndef vpRawImageFormat_h
+#define vpRawImageFormat_h
+
+#include <stdint.h> //for uint32_t related types ; works also with >= VS2010 / _MSC_VER >= 1600
+#include <string.h>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpRGBa.h>
+
+/*!
+  \class vpRawImageFormat
+
+  \ingroup group_io_image
+
+  \brief Description of the raw image file format written by vpRawImageWriter
+  and read by vpRawImageReader.
+
+  A raw image file is a sequence of images. Each image starts with a
+  vpFrameHeader giving the pixel type, the image size, the timestamp and the
+  optional camera intrinsic parameters, followed by the pixels stored row by
+  row as in vpImage::bitmap. Appending an image to a sequence simply writes a
+  new header and its pixels at the end of the file.
+
+  The pixels of each image start at an offset aligned on \e alignment bytes,
+  so that they can be accessed in place once the file is mapped in memory.
+  The headers and the pixels are stored in the byte order of the computer that
+  wrote them, given by vpFrameHeader::byte_order.
+
+  The pixel type of vpImage<Type> is given by getPixelType(). Images of other
+  types are stored as PIXEL_USER with their size.
+*/
+class vpRawImageFormat
+{
+public:
+  //! Type of the pixels of an image.
+  typedef enum {
+    PIXEL_USER,   /*!< Other pixel type, only identified by its size. */
+    PIXEL_UCHAR,  /*!< unsigned char */
+    PIXEL_CHAR,   /*!< char */
+    PIXEL_USHORT, /*!< unsigned short, e.g. a depth map */
+    PIXEL_SHORT,  /*!< short */
+    PIXEL_UINT,   /*!< unsigned int */
+    PIXEL_INT,    /*!< int */
+    PIXEL_FLOAT,  /*!< float */
+    PIXEL_DOUBLE, /*!< double */
+    PIXEL_RGBA    /*!< vpRGBa */
+  } vpPixelType;
+
+  //! Header preceding the pixels of each image of a file.
+  typedef struct {
+    char magic[4];        //!< "VPRI"
+    uint32_t byte_order;  //!< 0x01020304 written in the byte order of the file
+    uint32_t header_size; //!< Size of this header
+    uint32_t data_offset; //!< Offset of the pixels from the beginning of the header
+    uint32_t pixel_type;  //!< vpPixelType of the pixels
+    uint32_t pixel_size;  //!< Size of a pixel in bytes
+    uint32_t width;       //!< Image width
+    uint32_t height;      //!< Image height
+    uint32_t stride;      //!< Number of bytes between the beginning of two rows
+    uint32_t has_camera;  //!< 1 when the camera parameters are set
+    uint32_t projection;  //!< vpCameraParameters::vpCameraParametersProjType
+    uint32_t reserved;    //!< Unused, set to 0
+    uint64_t frame_size;  //!< Size of the image with its header, offset of the next image
+    double timestamp;     //!< Acquisition time of the image
+    double px;            //!< Camera parameter \f$p_x\f$
+    double py;            //!< Camera parameter \f$p_y\f$
+    double u0;            //!< Camera parameter \f$u_0\f$
+    double v0;            //!< Camera parameter \f$v_0\f$
+    double kud;           //!< Camera parameter \f$k_{ud}\f$
+    double kdu;           //!< Camera parameter \f$k_{du}\f$
+  } vpFrameHeader;
+
+  //! Alignment in bytes of the images in a file.
+  static const unsigned int alignment = 64;
+
+  /*!
+    Check the consistency of an image header read from a file.
+
+    \return NULL if the header is valid, otherwise the description of the error.
+  */
+  static const char *checkHeader(const vpFrameHeader &header)
+  {
+    if (memcmp(header.magic, "VPRI", 4) != 0) {
+      return "not a raw image file";
+    }
+    if (header.byte_order != 0x01020304) {
+      return "written with another byte order";
+    }
+    if (header.header_size < sizeof(vpFrameHeader) || header.data_offset < header.header_size ||
+        header.stride < (uint64_t)header.width * header.pixel_size ||
+        header.frame_size < header.data_offset + (uint64_t)header.stride * header.height ||
+        header.frame_size % alignment != 0) {
+      return "corrupted image header";
+    }
+    return NULL;
+  }
+
+  /*!
+    Return the type of the pixels of a vpImage<Type>.
+  */
+  template <class Type> static vpPixelType getPixelType() { return PIXEL_USER; }
+};
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+template <> inline vpRawImageFormat::vpPixelType vpRawImageFormat::getPixelType<unsigned char>() { return PIXEL_UCHAR; }
+template <> inline vpRawImageFormat::vpPixelType vpRawImageFormat::getPixelType<char>() { return PIXEL_CHAR; }
+template <> inline vpRawImageFormat::vpPixelType vpRawImageFormat::getPixelType<unsigned short>()
+{
+  return PIXEL_USHORT;
+}
+template <> inline vpRawImageFormat::vpPixelType vpRawImageFormat::getPixelType<short>() { return PIXEL_SHORT; }
+template <> inline vpRawImageFormat::vpPixelType vpRawImageFormat::getPixelType<unsigned int>() { return PIXEL_UINT; }
+template <> inline vpRawImageFormat::vpPixelType vpRawImageFormat::getPixelType<int>() { return PIXEL_INT; }
+template <> inline vpRawImageFormat::vpPixelType vpRawImageFormat::getPixelType<float>() { return PIXEL_FLOAT; }
+template <> inline vpRawImageFormat::vpPixelType vpRawImageFormat::getPixelType<double>() { return PIXEL_DOUBLE; }
+template <> inline vpRawImageFormat::vpPixelType vpRawImageFormat::getPixelType<vpRGBa>() { return PIXEL_RGBA; }
+#endif
+
+#endif
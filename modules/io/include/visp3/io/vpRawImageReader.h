@@ -0,0 +1,173 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Read images and their metadata from a memory mapped raw image file.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpRawImageReader.h
+  \brief Read images and their metadata from a memory mapped raw image file
+*/
+
+#ifndef vpRawImageReader_h
+#define vpRawImageReader_h
+
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/io/vpRawImageFormat.h>
+
+/*!
+  \class vpRawImageReader
+
+  \ingroup group_io_image
+
+  \brief Reads the images of a raw image file written by vpRawImageWriter,
+  see vpRawImageFormat.
+
+  The file is mapped in memory when opened, so that the images are never
+  parsed from a stream: read() copies the pixels of an image with a single
+  memcpy() and getPixels() gives a direct access to the pixels without any
+  copy. The images of a sequence can be read in any order.
+
+  An incomplete image at the end of the file, for example when the recording
+  was interrupted, is ignored.
+
+  \code
+#include <iostream>
+#include <visp3/io/vpRawImageReader.h>
+
+int main()
+{
+  vpImage<vpRGBa> I_color;
+  vpImage<unsigned short> I_depth;
+  vpCameraParameters cam;
+
+  vpRawImageReader reader("/tmp/sequence.raw");
+  for (unsigned int i = 0; i + 1 < reader.getFrameCount(); i += 2) {
+    reader.read(I_color, i);
+    reader.read(I_depth, i + 1);
+    reader.getCameraParameters(i, cam);
+    std::cout << "Images acquired at " << reader.getTimestamp(i) << std::endl;
+    // Here the code to process I_color and I_depth
+  }
+  return 0;
+}
+  \endcode
+
+  \sa vpImageIo::readRAW()
+*/
+class VISP_EXPORT vpRawImageReader
+{
+public:
+  vpRawImageReader();
+  explicit vpRawImageReader(const std::string &filename);
+  virtual ~vpRawImageReader();
+
+  void close();
+  bool getCameraParameters(unsigned int index, vpCameraParameters &cam) const;
+  /*!
+    Return the number of images in the file.
+  */
+  unsigned int getFrameCount() const { return static_cast<unsigned int>(m_offsets.size()); }
+  const vpRawImageFormat::vpFrameHeader &getHeader(unsigned int index) const;
+  unsigned int getHeight(unsigned int index) const;
+  vpRawImageFormat::vpPixelType getPixelType(unsigned int index) const;
+  double getTimestamp(unsigned int index) const;
+  unsigned int getWidth(unsigned int index) const;
+  /*!
+    Return true if a file is open.
+  */
+  bool isOpen() const { return !m_filename.empty(); }
+  void open(const std::string &filename);
+
+  /*!
+    Return a pointer to the pixels of an image in the memory mapped file,
+    without any copy. The pixels are stored row by row, the rows being
+    separated by getHeader(index).stride bytes.
+
+    The pointer is only valid until the file is closed.
+
+    \param index : Index of the image in the file.
+
+    \exception vpException::badValue : If the image has not pixels of type
+    \e Type.
+  */
+  template <class Type> const Type *getPixels(unsigned int index) const
+  {
+    return reinterpret_cast<const Type *>(getData(index, vpRawImageFormat::getPixelType<Type>(), sizeof(Type)));
+  }
+
+  /*!
+    Read an image of the file. The memory of \e I is only allocated when its
+    size changes.
+
+    \param I : Image to set with the pixels of the image in the file.
+    \param index : Index of the image in the file.
+
+    \exception vpException::badValue : If the image has not pixels of type
+    \e Type.
+  */
+  template <class Type> void read(vpImage<Type> &I, unsigned int index) const
+  {
+    const unsigned char *data = getData(index, vpRawImageFormat::getPixelType<Type>(), sizeof(Type));
+    const vpRawImageFormat::vpFrameHeader &header = getHeader(index);
+    I.resize(header.height, header.width);
+
+    size_t row_size = header.width * sizeof(Type);
+    if (header.stride == row_size) {
+      memcpy(static_cast<void *>(I.bitmap), data, row_size * header.height);
+    } else {
+      for (unsigned int i = 0; i < header.height; i++) {
+        memcpy(static_cast<void *>(I[i]), data + (size_t)i * header.stride, row_size);
+      }
+    }
+  }
+
+private:
+  vpRawImageReader(const vpRawImageReader &);            // noncopyable
+  vpRawImageReader &operator=(const vpRawImageReader &); //
+
+  const unsigned char *getData(unsigned int index, vpRawImageFormat::vpPixelType pixel_type,
+                               unsigned int pixel_size) const;
+
+  unsigned char *m_data;
+  size_t m_size;
+  std::string m_filename;
+  std::vector<size_t> m_offsets;
+};
+
+#endif
@@ -0,0 +1,146 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Write images and their metadata in a raw image file.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpRawImageWriter.h
+  \brief Write images and their metadata in a raw image file
+*/
+
+#ifndef vpRawImageWriter_h
+#define vpRawImageWriter_h
+
+#include <stdio.h>
+#include <string>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/io/vpRawImageFormat.h>
+
+/*!
+  \class vpRawImageWriter
+
+  \ingroup group_io_image
+
+  \brief Writes images of any pixel type with their timestamp and camera
+  parameters in a raw image file, see vpRawImageFormat.
+
+  The pixels are written as is, without any encoding, so that images like
+  depth maps or float images are stored without loss. Successive calls to
+  write() append the images to the same file, which allows to record a whole
+  sequence, for example the color and depth images of a RGB-D camera, and to
+  replay it later with vpRawImageReader.
+
+  \code
+#include <visp3/core/vpTime.h>
+#include <visp3/io/vpRawImageWriter.h>
+
+int main()
+{
+  vpImage<vpRGBa> I_color(480, 640);
+  vpImage<unsigned short> I_depth(480, 640);
+  vpCameraParameters cam(600, 600, 320, 240);
+
+  vpRawImageWriter writer("/tmp/sequence.raw");
+  for (unsigned int i = 0; i < 100; i++) {
+    // Here the code to acquire I_color and I_depth
+    double t = vpTime::measureTimeMs();
+    writer.write(I_color, t, cam);
+    writer.write(I_depth, t);
+  }
+  writer.close();
+  return 0;
+}
+  \endcode
+
+  \sa vpImageIo::writeRAW()
+*/
+class VISP_EXPORT vpRawImageWriter
+{
+public:
+  vpRawImageWriter();
+  explicit vpRawImageWriter(const std::string &filename, bool append = false);
+  virtual ~vpRawImageWriter();
+
+  void close();
+  /*!
+    Return the number of images written since the file was opened.
+  */
+  unsigned int getFrameCount() const { return m_frameCount; }
+  /*!
+    Return true if a file is open.
+  */
+  bool isOpen() const { return m_file != NULL; }
+  void open(const std::string &filename, bool append = false);
+
+  /*!
+    Append an image to the file.
+
+    \param I : Image to write.
+    \param timestamp : Acquisition time of the image.
+  */
+  template <class Type> void write(const vpImage<Type> &I, double timestamp = 0.)
+  {
+    writeFrame(vpRawImageFormat::getPixelType<Type>(), sizeof(Type), I.getHeight(), I.getWidth(), I.bitmap,
+               timestamp, NULL);
+  }
+
+  /*!
+    Append an image and the intrinsic parameters of the camera that acquired
+    it to the file.
+
+    \param I : Image to write.
+    \param timestamp : Acquisition time of the image.
+    \param cam : Camera parameters.
+  */
+  template <class Type> void write(const vpImage<Type> &I, double timestamp, const vpCameraParameters &cam)
+  {
+    writeFrame(vpRawImageFormat::getPixelType<Type>(), sizeof(Type), I.getHeight(), I.getWidth(), I.bitmap,
+               timestamp, &cam);
+  }
+
+private:
+  vpRawImageWriter(const vpRawImageWriter &);            // noncopyable
+  vpRawImageWriter &operator=(const vpRawImageWriter &); //
+
+  void writeFrame(vpRawImageFormat::vpPixelType pixel_type, unsigned int pixel_size, unsigned int height,
+                  unsigned int width, const void *data, double timestamp, const vpCameraParameters *cam);
+
+  FILE *m_file;
+  std::string m_filename;
+  unsigned int m_frameCount;
+};
+
+#endif
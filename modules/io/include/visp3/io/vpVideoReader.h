@@ -145,6 +145,21 @@ int main()
 }
   \endcode
 
+  When the images of a sequence are processed offline, reading and decoding
+the next image can take as much time as the processing itself. setPrefetch()
+enables a background thread that decodes the next images of the sequence while
+the current one is processed:
+\code
+  reader.setFileName("./image/image%04d.jpeg");
+  reader.setPrefetch(4); // decode up to 4 images ahead
+  reader.open(I);
+
+  while (! reader.end() ) {
+    reader.acquire(I); // waits only if the next image is not decoded yet
+    // process I
+  }
+\endcode
+
   Note that it is also possible to access to a specific frame using
 getFrame().
 \code
@@ -223,6 +238,13 @@ private:
   //! The frame step
   long frameStep;
   double frameRate;
+  //! Number of frames decoded ahead by a background thread
+  unsigned int prefetchSize;
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  class vpFramePrefetcher;
+#endif
+  //! Background decoding of image sequences
+  vpFramePrefetcher *prefetcher;
 
   // private:
   //#ifndef DOXYGEN_SHOULD_SKIP_THIS
@@ -322,6 +344,12 @@ public:
     \return Returns the frame step value.
   */
   inline long getFrameStep() const { return frameStep; }
+  /*!
+    Gets the number of frames decoded ahead.
+
+    \sa setPrefetch()
+  */
+  inline unsigned int getPrefetch() const { return prefetchSize; }
   void open(vpImage<vpRGBa> &I);
   void open(vpImage<unsigned char> &I);
 
@@ -374,6 +402,7 @@ public:
   \sa setFrameStep()
 */
   inline void setFrameStep(const long frame_step) { this->frameStep = frame_step; }
+  void setPrefetch(unsigned int nb_frames);
 
 private:
   vpVideoFormatType getFormat(const char *filename);
@@ -385,6 +414,9 @@ private:
   long extractImageIndex(const std::string &imageName, const std::string &format);
   bool checkImageNameFormat(const std::string &format);
   void getProperties();
+  bool usePrefetch() const;
+  template <class Type> void acquirePrefetched(vpImage<Type> &I);
+  template <class Type> void getPrefetchedFrame(vpImage<Type> &I, long frame_index);
 };
 
 #endif
@@ -46,6 +46,7 @@
 
 #include <string>
 
+#include <visp3/io/vpAsyncImageWriter.h>
 #include <visp3/io/vpImageIo.h>
 
 #if VISP_HAVE_OPENCV_VERSION >= 0x020200
@@ -116,6 +117,10 @@ image sequence. The images are stored in the folder "./image" and are named
   }
   \endcode
 
+  When images are recorded in a real-time loop, setAsynchronous() moves the
+encoding and the writing of the images of a sequence to background threads:
+saveFrame() then only copies the image in a bounded queue.
+
   The other following example explains how to use the class to write directly
 an mpeg file.
 
@@ -195,12 +200,15 @@ private:
   //! Size of the frame
   unsigned int width;
   unsigned int height;
+  //! Writes the images of a sequence in background threads when not NULL
+  vpAsyncImageWriter *asyncWriter;
 
 public:
   vpVideoWriter();
   virtual ~vpVideoWriter();
 
   void close();
+  void flush();
 
   /*!
     Gets the current frame index.
@@ -225,6 +233,8 @@ public:
   inline void setCodec(const int fourcc_codec) { this->fourcc = fourcc_codec; }
 #endif
 
+  void setAsynchronous(unsigned int queue_size, unsigned int nb_threads = 1,
+                       vpAsyncImageWriter::vpQueuePolicy policy = vpAsyncImageWriter::BLOCK);
   void setFileName(const char *filename);
   void setFileName(const std::string &filename);
   /*!
@@ -245,6 +255,9 @@ public:
 #endif
 
 private:
+  vpVideoWriter(const vpVideoWriter &);            // noncopyable
+  vpVideoWriter &operator=(const vpVideoWriter &); //
+
   vpVideoFormatType getFormat(const char *filename);
   static std::string getExtension(const std::string &filename);
 };
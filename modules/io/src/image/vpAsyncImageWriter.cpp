@@ -0,0 +1,319 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Write images in background threads.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpAsyncImageWriter.cpp
+  \brief Write images in background threads
+*/
+
+#include <visp3/core/vpException.h>
+#include <visp3/io/vpAsyncImageWriter.h>
+#include <visp3/io/vpImageIo.h>
+
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+class vpAsyncImageWriter::Impl
+{
+public:
+  Impl(unsigned int queue_size, unsigned int nb_threads, vpQueuePolicy policy)
+    :
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+      m_mutex(), m_cond(), m_threads(), m_slots(queue_size), m_free(), m_pending(), m_nbWriting(0), m_stop(false),
+#endif
+      m_queueSize(queue_size), m_policy(policy), m_nbDropped(0), m_nbWritten(0), m_nbErrors(0), m_error()
+  {
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+    for (size_t i = 0; i < m_slots.size(); i++) {
+      m_free.push_back(&m_slots[i]);
+    }
+    for (unsigned int i = 0; i < nb_threads; i++) {
+      m_threads.push_back(std::thread(&Impl::run, this));
+    }
+#else
+    (void)nb_threads;
+#endif
+  }
+
+  ~Impl()
+  {
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cond.notify_all();
+    for (size_t i = 0; i < m_threads.size(); i++) {
+      m_threads[i].join();
+    }
+#endif
+  }
+
+  void flush()
+  {
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cond.wait(lock, [this] { return m_pending.empty() && m_nbWriting == 0; });
+#endif
+    if (m_nbErrors > 0) {
+      unsigned int nbErrors = m_nbErrors;
+      m_nbErrors = 0;
+      throw vpException(vpException::ioError, "Cannot write %u images: %s", nbErrors, m_error.c_str());
+    }
+  }
+
+  template <class Type> bool write(const vpImage<Type> &I, const std::string &filename)
+  {
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (m_free.empty()) {
+      if (m_policy == DROP_NEWEST) {
+        m_nbDropped++;
+        return false;
+      }
+      if (m_policy == DROP_OLDEST && !m_pending.empty()) {
+        m_free.push_back(m_pending.front());
+        m_pending.pop_front();
+        m_nbDropped++;
+      } else {
+        // All the buffers are being written with DROP_OLDEST, or BLOCK
+        m_cond.wait(lock, [this] { return !m_free.empty(); });
+      }
+    }
+    vpSlot *slot = m_free.back();
+    m_free.pop_back();
+    lock.unlock();
+
+    // The slot is owned by this thread until it is queued
+    setImage(*slot, I);
+    slot->filename = filename;
+
+    lock.lock();
+    m_pending.push_back(slot);
+    lock.unlock();
+    m_cond.notify_all();
+#else
+    try {
+      vpImageIo::write(I, filename);
+      m_nbWritten++;
+    } catch (const vpException &e) {
+      m_nbErrors++;
+      m_error = e.getStringMessage();
+    }
+#endif
+    return true;
+  }
+
+  unsigned int getDroppedCount()
+  {
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+    std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+    return m_nbDropped;
+  }
+
+  unsigned int getQueueSize() const { return m_queueSize; }
+
+  unsigned int getWrittenCount()
+  {
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+    std::lock_guard<std::mutex> lock(m_mutex);
+#endif
+    return m_nbWritten;
+  }
+
+private:
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  struct vpSlot {
+    vpSlot() : Ig(), Ic(), color(false), filename() {}
+
+    vpImage<unsigned char> Ig;
+    vpImage<vpRGBa> Ic;
+    bool color;
+    std::string filename;
+  };
+
+  // Copies reusing the buffer of the slot, while operator=() always reallocates
+  template <class Type> static void copy(const vpImage<Type> &src, vpImage<Type> &dst)
+  {
+    dst.resize(src.getHeight(), src.getWidth());
+    memcpy(static_cast<void *>(dst.bitmap), src.bitmap, src.getSize() * sizeof(Type));
+  }
+
+  static void setImage(vpSlot &slot, const vpImage<unsigned char> &I)
+  {
+    copy(I, slot.Ig);
+    slot.color = false;
+  }
+  static void setImage(vpSlot &slot, const vpImage<vpRGBa> &I)
+  {
+    copy(I, slot.Ic);
+    slot.color = true;
+  }
+
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true) {
+      m_cond.wait(lock, [this] { return m_stop || !m_pending.empty(); });
+      if (m_pending.empty()) {
+        // Stopped once all the queued images are written
+        break;
+      }
+      vpSlot *slot = m_pending.front();
+      m_pending.pop_front();
+      m_nbWriting++;
+      lock.unlock();
+
+      bool failed = false;
+      std::string error;
+      try {
+        if (slot->color) {
+          vpImageIo::write(slot->Ic, slot->filename);
+        } else {
+          vpImageIo::write(slot->Ig, slot->filename);
+        }
+      } catch (const vpException &e) {
+        failed = true;
+        error = e.getStringMessage();
+      }
+
+      lock.lock();
+      if (failed) {
+        m_nbErrors++;
+        m_error = error;
+      } else {
+        m_nbWritten++;
+      }
+      m_nbWriting--;
+      m_free.push_back(slot);
+      m_cond.notify_all();
+    }
+  }
+
+  std::mutex m_mutex;
+  //! Signals queued images, free buffers and the end of the writes
+  std::condition_variable m_cond;
+  std::vector<std::thread> m_threads;
+  std::vector<vpSlot> m_slots;
+  std::vector<vpSlot *> m_free;
+  std::deque<vpSlot *> m_pending;
+  unsigned int m_nbWriting;
+  bool m_stop;
+#endif
+  unsigned int m_queueSize;
+  vpQueuePolicy m_policy;
+  unsigned int m_nbDropped;
+  unsigned int m_nbWritten;
+  unsigned int m_nbErrors;
+  std::string m_error;
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Starts the worker threads.
+
+  \param queue_size : Maximum number of images queued or being written.
+  \param nb_threads : Number of worker threads encoding and writing images.
+  \param policy : Behavior of write() when the queue is full.
+*/
+vpAsyncImageWriter::vpAsyncImageWriter(unsigned int queue_size, unsigned int nb_threads, vpQueuePolicy policy)
+  : m_impl(NULL)
+{
+  if (queue_size == 0 || nb_threads == 0) {
+    throw vpException(vpException::badValue, "The queue size and the number of threads must be positive");
+  }
+  m_impl = new Impl(queue_size, nb_threads, policy);
+}
+
+/*!
+  Writes the queued images and stops the worker threads. Write errors that
+  were not reported by flush() are ignored.
+*/
+vpAsyncImageWriter::~vpAsyncImageWriter() { delete m_impl; }
+
+/*!
+  Waits until all the queued images are written.
+
+  \exception vpException::ioError : If images could not be written since the
+  previous call. The message of the last error is reported.
+*/
+void vpAsyncImageWriter::flush() { m_impl->flush(); }
+
+/*!
+  Returns the number of images dropped because the queue was full.
+*/
+unsigned int vpAsyncImageWriter::getDroppedCount() const { return m_impl->getDroppedCount(); }
+
+/*!
+  Returns the maximum number of images queued or being written.
+*/
+unsigned int vpAsyncImageWriter::getQueueSize() const { return m_impl->getQueueSize(); }
+
+/*!
+  Returns the number of images successfully written.
+*/
+unsigned int vpAsyncImageWriter::getWrittenCount() const { return m_impl->getWrittenCount(); }
+
+/*!
+  Queues a copy of \e I to be written to \e filename by a worker thread. The
+  file format follows the extension, see vpImageIo::write().
+
+  \return false if the image was dropped because the queue was full with the
+  DROP_NEWEST policy, true otherwise. Write errors are reported by flush().
+*/
+bool vpAsyncImageWriter::write(const vpImage<unsigned char> &I, const std::string &filename)
+{
+  return m_impl->write(I, filename);
+}
+
+/*!
+  Queues a copy of \e I to be written to \e filename by a worker thread. The
+  file format follows the extension, see vpImageIo::write().
+
+  \return false if the image was dropped because the queue was full with the
+  DROP_NEWEST policy, true otherwise. Write errors are reported by flush().
+*/
+bool vpAsyncImageWriter::write(const vpImage<vpRGBa> &I, const std::string &filename)
+{
+  return m_impl->write(I, filename);
+}
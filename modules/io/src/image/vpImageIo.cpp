@@ -48,6 +48,8 @@
 
 void vp_decodeHeaderPNM(const std::string &filename, std::ifstream &fd, const std::string &magic, unsigned int &w,
                         unsigned int &h, unsigned int &maxval);
+void vp_checkJPEGDownscale(unsigned int downscale);
+void vp_checkPNGCompressionLevel(int compression_level);
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
 /*!
@@ -114,6 +116,31 @@ void vp_decodeHeaderPNM(const std::string &filename, std::ifstream &fd, const st
     }
   }
 }
+
+/*!
+ * Check the reduction factor used to read a JPEG image.
+ * \param downscale[in] : Reduction factor that should be 1, 2, 4 or 8.
+ */
+void vp_checkJPEGDownscale(unsigned int downscale)
+{
+  if (downscale != 1 && downscale != 2 && downscale != 4 && downscale != 8) {
+    throw(vpException(vpException::badValue,
+                      "Cannot read JPEG image with a %d reduction factor: should be 1, 2, 4 or 8", downscale));
+  }
+}
+
+/*!
+ * Check the zlib compression level used to write a PNG image.
+ * \param compression_level[in] : Compression level that should be in [0, 9]
+ * or -1 for the default level.
+ */
+void vp_checkPNGCompressionLevel(int compression_level)
+{
+  if (compression_level < -1 || compression_level > 9) {
+    throw(vpException(vpException::badValue, "Cannot write PNG image with a %d compression level: should be in [-1, 9]",
+                      compression_level));
+  }
+}
 #endif
 
 vpImageIo::vpImageFormatType vpImageIo::getFormat(const std::string &filename)
@@ -982,20 +1009,14 @@ void vpImageIo::writeJPEG(const vpImage<unsigned char> &I, const std::string &fi
 
   jpeg_start_compress(&cinfo, TRUE);
 
-  unsigned char *line;
-  line = new unsigned char[width];
-  unsigned char *input = (unsigned char *)I.bitmap;
+  // libjpeg only reads the scanlines, the image rows are given as is
   while (cinfo.next_scanline < cinfo.image_height) {
-    for (unsigned int i = 0; i < width; i++) {
-      line[i] = *(input);
-      input++;
-    }
-    jpeg_write_scanlines(&cinfo, &line, 1);
+    JSAMPROW row = (JSAMPROW)I[cinfo.next_scanline];
+    jpeg_write_scanlines(&cinfo, &row, 1);
   }
 
   jpeg_finish_compress(&cinfo);
   jpeg_destroy_compress(&cinfo);
-  delete[] line;
   fclose(file);
 }
 
@@ -1033,12 +1054,24 @@ void vpImageIo::writeJPEG(const vpImage<vpRGBa> &I, const std::string &filename)
 
   cinfo.image_width = width;
   cinfo.image_height = height;
+#if defined(JCS_EXTENSIONS)
+  // libjpeg-turbo skips the alpha channel itself
+  cinfo.input_components = 4;
+  cinfo.in_color_space = JCS_EXT_RGBX;
+#else
   cinfo.input_components = 3;
   cinfo.in_color_space = JCS_RGB;
+#endif
   jpeg_set_defaults(&cinfo);
 
   jpeg_start_compress(&cinfo, TRUE);
 
+#if defined(JCS_EXTENSIONS)
+  while (cinfo.next_scanline < cinfo.image_height) {
+    JSAMPROW row = (JSAMPROW)I[cinfo.next_scanline];
+    jpeg_write_scanlines(&cinfo, &row, 1);
+  }
+#else
   unsigned char *line;
   line = new unsigned char[3 * width];
   unsigned char *input = (unsigned char *)I.bitmap;
@@ -1054,10 +1087,11 @@ void vpImageIo::writeJPEG(const vpImage<vpRGBa> &I, const std::string &filename)
     }
     jpeg_write_scanlines(&cinfo, &line, 1);
   }
+  delete[] line;
+#endif
 
   jpeg_finish_compress(&cinfo);
   jpeg_destroy_compress(&cinfo);
-  delete[] line;
   fclose(file);
 }
 
@@ -1066,8 +1100,12 @@ void vpImageIo::writeJPEG(const vpImage<vpRGBa> &I, const std::string &filename)
   for the corresponding gray level image, if necessary convert the data in
   gray level, and set the bitmap whith the gray level data. That means that
   the image \e I is a "black and white" rendering of the original image in \e
-  filename, as in a black and white photograph. If necessary, the quantization
-  formula used is \f$0,299 r + 0,587 g + 0,114 b\f$.
+  filename, as in a black and white photograph.
+
+  Color images are directly decoded in gray level by libjpeg that only
+  keeps the luminance channel of the file, without building an intermediate
+  color image. The luminance corresponds to the quantization formula
+  \f$0,299 r + 0,587 g + 0,114 b\f$.
 
   If the image has been already initialized, memory allocation is done
   only if the new image size is different, else we re-use the same
@@ -1075,14 +1113,19 @@ void vpImageIo::writeJPEG(const vpImage<vpRGBa> &I, const std::string &filename)
 
   \param I : Image to set with the \e filename content.
   \param filename : Name of the file containing the image.
-
+  \param downscale : Reduction factor of the image size. Could be 1, 2, 4 or
+  8. When greater than 1, the image is decoded by libjpeg directly at
+  \f$1/downscale\f$ of its size (rounded up), which is much faster than
+  decoding the full image and subsampling it afterwards.
 */
-void vpImageIo::readJPEG(vpImage<unsigned char> &I, const std::string &filename)
+void vpImageIo::readJPEG(vpImage<unsigned char> &I, const std::string &filename, unsigned int downscale)
 {
   struct jpeg_decompress_struct cinfo;
   struct jpeg_error_mgr jerr;
   FILE *file;
 
+  vp_checkJPEGDownscale(downscale);
+
   cinfo.err = jpeg_std_error(&jerr);
   jpeg_create_decompress(&cinfo);
 
@@ -1100,37 +1143,33 @@ void vpImageIo::readJPEG(vpImage<unsigned char> &I, const std::string &filename)
   jpeg_stdio_src(&cinfo, file);
   jpeg_read_header(&cinfo, TRUE);
 
-  unsigned int width = cinfo.image_width;
-  unsigned int height = cinfo.image_height;
-
-  if ((width != I.getWidth()) || (height != I.getHeight()))
-    I.resize(height, width);
+  if (cinfo.jpeg_color_space == JCS_YCbCr || cinfo.jpeg_color_space == JCS_GRAYSCALE)
+    cinfo.out_color_space = JCS_GRAYSCALE;
+  cinfo.scale_num = 1;
+  cinfo.scale_denom = downscale;
 
   jpeg_start_decompress(&cinfo);
 
-  unsigned int rowbytes = cinfo.output_width * (unsigned int)(cinfo.output_components);
-  JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, rowbytes, 1);
+  unsigned int width = cinfo.output_width;
+  unsigned int height = cinfo.output_height;
 
-  if (cinfo.out_color_space == JCS_RGB) {
-    vpImage<vpRGBa> Ic(height, width);
-    unsigned char *output = (unsigned char *)Ic.bitmap;
+  if ((width != I.getWidth()) || (height != I.getHeight()))
+    I.resize(height, width);
+
+  if (cinfo.out_color_space == JCS_GRAYSCALE) {
     while (cinfo.output_scanline < cinfo.output_height) {
-      jpeg_read_scanlines(&cinfo, buffer, 1);
-      for (unsigned int i = 0; i < width; i++) {
-        *(output++) = buffer[0][i * 3];
-        *(output++) = buffer[0][i * 3 + 1];
-        *(output++) = buffer[0][i * 3 + 2];
-        *(output++) = vpRGBa::alpha_default;
-      }
+      JSAMPROW row = (JSAMPROW)I[cinfo.output_scanline];
+      jpeg_read_scanlines(&cinfo, &row, 1);
     }
-    vpImageConvert::convert(Ic, I);
   }
 
-  else if (cinfo.out_color_space == JCS_GRAYSCALE) {
+  else if (cinfo.out_color_space == JCS_RGB) {
+    unsigned int rowbytes = cinfo.output_width * (unsigned int)(cinfo.output_components);
+    JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, rowbytes, 1);
     while (cinfo.output_scanline < cinfo.output_height) {
       unsigned int row = cinfo.output_scanline;
       jpeg_read_scanlines(&cinfo, buffer, 1);
-      memcpy(I[row], buffer[0], rowbytes);
+      vpImageConvert::RGBToGrey(buffer[0], I[row], width);
     }
   }
 
@@ -1156,13 +1195,18 @@ void vpImageIo::readJPEG(vpImage<unsigned char> &I, const std::string &filename)
 
   \param I : Color image to set with the \e filename content.
   \param filename : Name of the file containing the image.
+  \param downscale : Reduction factor of the image size. Could be 1, 2, 4 or
+  8. When greater than 1, the image is decoded by libjpeg directly at
+  \f$1/downscale\f$ of its size (rounded up).
 */
-void vpImageIo::readJPEG(vpImage<vpRGBa> &I, const std::string &filename)
+void vpImageIo::readJPEG(vpImage<vpRGBa> &I, const std::string &filename, unsigned int downscale)
 {
   struct jpeg_decompress_struct cinfo;
   struct jpeg_error_mgr jerr;
   FILE *file;
 
+  vp_checkJPEGDownscale(downscale);
+
   cinfo.err = jpeg_std_error(&jerr);
   jpeg_create_decompress(&cinfo);
 
@@ -1181,40 +1225,54 @@ void vpImageIo::readJPEG(vpImage<vpRGBa> &I, const std::string &filename)
 
   jpeg_read_header(&cinfo, TRUE);
 
-  unsigned int width = cinfo.image_width;
-  unsigned int height = cinfo.image_height;
-
-  if ((width != I.getWidth()) || (height != I.getHeight()))
-    I.resize(height, width);
+#if defined(JCS_EXTENSIONS)
+  // libjpeg-turbo fills the alpha channel with 255, i.e. vpRGBa::alpha_default
+  if (cinfo.jpeg_color_space == JCS_YCbCr || cinfo.jpeg_color_space == JCS_GRAYSCALE)
+    cinfo.out_color_space = JCS_EXT_RGBA;
+#endif
+  cinfo.scale_num = 1;
+  cinfo.scale_denom = downscale;
 
   jpeg_start_decompress(&cinfo);
 
-  unsigned int rowbytes = cinfo.output_width * (unsigned int)(cinfo.output_components);
-  JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, rowbytes, 1);
+  unsigned int width = cinfo.output_width;
+  unsigned int height = cinfo.output_height;
+
+  if ((width != I.getWidth()) || (height != I.getHeight()))
+    I.resize(height, width);
 
-  if (cinfo.out_color_space == JCS_RGB) {
-    unsigned char *output = (unsigned char *)I.bitmap;
+#if defined(JCS_EXTENSIONS)
+  if (cinfo.out_color_space == JCS_EXT_RGBA) {
     while (cinfo.output_scanline < cinfo.output_height) {
-      jpeg_read_scanlines(&cinfo, buffer, 1);
-      for (unsigned int i = 0; i < width; i++) {
-        *(output++) = buffer[0][i * 3];
-        *(output++) = buffer[0][i * 3 + 1];
-        *(output++) = buffer[0][i * 3 + 2];
-        *(output++) = vpRGBa::alpha_default;
+      JSAMPROW row = (JSAMPROW)I[cinfo.output_scanline];
+      jpeg_read_scanlines(&cinfo, &row, 1);
+    }
+  } else
+#endif
+  {
+    unsigned int rowbytes = cinfo.output_width * (unsigned int)(cinfo.output_components);
+    JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, rowbytes, 1);
+
+    if (cinfo.out_color_space == JCS_RGB) {
+      unsigned char *output = (unsigned char *)I.bitmap;
+      while (cinfo.output_scanline < cinfo.output_height) {
+        jpeg_read_scanlines(&cinfo, buffer, 1);
+        for (unsigned int i = 0; i < width; i++) {
+          *(output++) = buffer[0][i * 3];
+          *(output++) = buffer[0][i * 3 + 1];
+          *(output++) = buffer[0][i * 3 + 2];
+          *(output++) = vpRGBa::alpha_default;
+        }
       }
     }
-  }
-
-  else if (cinfo.out_color_space == JCS_GRAYSCALE) {
-    vpImage<unsigned char> Ig(height, width);
 
-    while (cinfo.output_scanline < cinfo.output_height) {
-      unsigned int row = cinfo.output_scanline;
-      jpeg_read_scanlines(&cinfo, buffer, 1);
-      memcpy(Ig[row], buffer[0], rowbytes);
+    else if (cinfo.out_color_space == JCS_GRAYSCALE) {
+      while (cinfo.output_scanline < cinfo.output_height) {
+        unsigned int row = cinfo.output_scanline;
+        jpeg_read_scanlines(&cinfo, buffer, 1);
+        vpImageConvert::GreyToRGBa(buffer[0], (unsigned char *)I[row], width);
+      }
     }
-
-    vpImageConvert::convert(Ig, I);
   }
 
   jpeg_finish_decompress(&cinfo);
@@ -1284,10 +1342,14 @@ void vpImageIo::writeJPEG(const vpImage<vpRGBa> &I, const std::string &filename)
 
   \param I : Image to set with the \e filename content.
   \param filename : Name of the file containing the image.
-
+  \param downscale : Reduction factor of the image size. Could be 1, 2, 4 or
+  8. When greater than 1, the decoded image is subsampled to
+  \f$1/downscale\f$ of its size.
 */
-void vpImageIo::readJPEG(vpImage<unsigned char> &I, const std::string &filename)
+void vpImageIo::readJPEG(vpImage<unsigned char> &I, const std::string &filename, unsigned int downscale)
 {
+  vp_checkJPEGDownscale(downscale);
+
 #if (VISP_HAVE_OPENCV_VERSION >= 0x030000)
   cv::Mat Ip = cv::imread(filename.c_str(), cv::IMREAD_GRAYSCALE);
   if (!Ip.empty())
@@ -1309,6 +1371,11 @@ void vpImageIo::readJPEG(vpImage<unsigned char> &I, const std::string &filename)
     throw(vpImageException(vpImageException::ioError, "Can't read the image"));
   cvReleaseImage(&Ip);
 #endif
+
+  if (downscale > 1) {
+    vpImage<unsigned char> I_full = I;
+    I_full.subsample(downscale, downscale, I);
+  }
 }
 
 /*!
@@ -1328,9 +1395,14 @@ void vpImageIo::readJPEG(vpImage<unsigned char> &I, const std::string &filename)
 
   \param I : Color image to set with the \e filename content.
   \param filename : Name of the file containing the image.
+  \param downscale : Reduction factor of the image size. Could be 1, 2, 4 or
+  8. When greater than 1, the decoded image is subsampled to
+  \f$1/downscale\f$ of its size.
 */
-void vpImageIo::readJPEG(vpImage<vpRGBa> &I, const std::string &filename)
+void vpImageIo::readJPEG(vpImage<vpRGBa> &I, const std::string &filename, unsigned int downscale)
 {
+  vp_checkJPEGDownscale(downscale);
+
 #if (VISP_HAVE_OPENCV_VERSION >= 0x030000)
   cv::Mat Ip = cv::imread(filename.c_str(), cv::IMREAD_GRAYSCALE);
   if (!Ip.empty())
@@ -1352,14 +1424,19 @@ void vpImageIo::readJPEG(vpImage<vpRGBa> &I, const std::string &filename)
     throw(vpImageException(vpImageException::ioError, "Can't read the image"));
   cvReleaseImage(&Ip);
 #endif
+
+  if (downscale > 1) {
+    vpImage<vpRGBa> I_full = I;
+    I_full.subsample(downscale, downscale, I);
+  }
 }
 #else
 // jpeg interface not available (nor with libjpeg, nor with OpenCV
-void vpImageIo::readJPEG(vpImage<unsigned char> &, const std::string &)
+void vpImageIo::readJPEG(vpImage<unsigned char> &, const std::string &, unsigned int)
 {
   throw(vpException(vpException::fatalError, "Cannot read jpeg image since ViSP in not built with OpenCV or libjpeg 3rd parties"));
 }
-void vpImageIo::readJPEG(vpImage<vpRGBa> &, const std::string &)
+void vpImageIo::readJPEG(vpImage<vpRGBa> &, const std::string &, unsigned int)
 {
   throw(vpException(vpException::fatalError, "Cannot read jpeg image since ViSP in not built with OpenCV or libjpeg 3rd parties"));
 }
@@ -1385,11 +1462,18 @@ void vpImageIo::writeJPEG(const vpImage<vpRGBa> &, const std::string &)
 
   \param I : Image to save as a PNG file.
   \param filename : Name of the file containing the image.
+  \param compression_level : zlib compression level, from 0 (no
+  compression) to 9 (best compression). Low levels like 1 are a lot faster
+  to write at the price of bigger files; up to level 3 the rows are also
+  encoded with a single filter instead of the adaptive one. The default value
+  -1 lets zlib use its default compromise.
 */
-void vpImageIo::writePNG(const vpImage<unsigned char> &I, const std::string &filename)
+void vpImageIo::writePNG(const vpImage<unsigned char> &I, const std::string &filename, int compression_level)
 {
   FILE *file;
 
+  vp_checkPNGCompressionLevel(compression_level);
+
   // Test the filename
   if (filename.empty()) {
     throw(vpImageException(vpImageException::ioError, "Cannot create PNG file: filename empty"));
@@ -1446,29 +1530,24 @@ void vpImageIo::writePNG(const vpImage<unsigned char> &I, const std::string &fil
   png_set_IHDR(png_ptr, info_ptr, width, height, bit_depth, color_type, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE,
                PNG_FILTER_TYPE_BASE);
 
+  if (compression_level >= 0) {
+    png_set_compression_level(png_ptr, compression_level);
+    // For fast compression, the adaptive row filtering costs more than zlib
+    if (compression_level <= 3)
+      png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+  }
+
   png_write_info(png_ptr, info_ptr);
 
+  // libpng only reads the rows, the image rows are given as is
   png_bytep *row_ptrs = new png_bytep[height];
   for (unsigned int i = 0; i < height; i++)
-    row_ptrs[i] = new png_byte[width];
-
-  unsigned char *input = (unsigned char *)I.bitmap;
-
-  for (unsigned int i = 0; i < height; i++) {
-    png_byte *row = row_ptrs[i];
-    for (unsigned int j = 0; j < width; j++) {
-      row[j] = *(input);
-      input++;
-    }
-  }
+    row_ptrs[i] = (png_bytep)I[i];
 
   png_write_image(png_ptr, row_ptrs);
 
   png_write_end(png_ptr, NULL);
 
-  for (unsigned int j = 0; j < height; j++)
-    delete[] row_ptrs[j];
-
   delete[] row_ptrs;
 
   png_destroy_write_struct(&png_ptr, &info_ptr);
@@ -1482,11 +1561,18 @@ void vpImageIo::writePNG(const vpImage<unsigned char> &I, const std::string &fil
 
   \param I : Image to save as a PNG file.
   \param filename : Name of the file containing the image.
+  \param compression_level : zlib compression level, from 0 (no
+  compression) to 9 (best compression). Low levels like 1 are a lot faster
+  to write at the price of bigger files; up to level 3 the rows are also
+  encoded with a single filter instead of the adaptive one. The default value
+  -1 lets zlib use its default compromise.
 */
-void vpImageIo::writePNG(const vpImage<vpRGBa> &I, const std::string &filename)
+void vpImageIo::writePNG(const vpImage<vpRGBa> &I, const std::string &filename, int compression_level)
 {
   FILE *file;
 
+  vp_checkPNGCompressionLevel(compression_level);
+
   // Test the filename
   if (filename.empty()) {
     throw(vpImageException(vpImageException::ioError, "Cannot create PNG file: filename empty"));
@@ -1543,35 +1629,26 @@ void vpImageIo::writePNG(const vpImage<vpRGBa> &I, const std::string &filename)
   png_set_IHDR(png_ptr, info_ptr, width, height, bit_depth, color_type, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE,
                PNG_FILTER_TYPE_BASE);
 
+  if (compression_level >= 0) {
+    png_set_compression_level(png_ptr, compression_level);
+    // For fast compression, the adaptive row filtering costs more than zlib
+    if (compression_level <= 3)
+      png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_SUB);
+  }
+
   png_write_info(png_ptr, info_ptr);
 
+  // Let libpng strip the alpha channel of the image rows
+  png_set_filler(png_ptr, 0, PNG_FILLER_AFTER);
+
   png_bytep *row_ptrs = new png_bytep[height];
   for (unsigned int i = 0; i < height; i++)
-    row_ptrs[i] = new png_byte[3 * width];
-
-  unsigned char *input = (unsigned char *)I.bitmap;
-  ;
-
-  for (unsigned int i = 0; i < height; i++) {
-    png_byte *row = row_ptrs[i];
-    for (unsigned int j = 0; j < width; j++) {
-      row[3 * j] = *(input);
-      input++;
-      row[3 * j + 1] = *(input);
-      input++;
-      row[3 * j + 2] = *(input);
-      input++;
-      input++;
-    }
-  }
+    row_ptrs[i] = (png_bytep)I[i];
 
   png_write_image(png_ptr, row_ptrs);
 
   png_write_end(png_ptr, NULL);
 
-  for (unsigned int j = 0; j < height; j++)
-    delete[] row_ptrs[j];
-
   delete[] row_ptrs;
 
   png_destroy_write_struct(&png_ptr, &info_ptr);
@@ -1698,57 +1775,39 @@ void vpImageIo::readPNG(vpImage<unsigned char> &I, const std::string &filename)
 
   png_bytep *rowPtrs = new png_bytep[height];
 
-  unsigned int stride = png_get_rowbytes(png_ptr, info_ptr);
-  unsigned char *data = new unsigned char[stride * height];
-
-  for (unsigned int i = 0; i < height; i++)
-    rowPtrs[i] = (png_bytep)data + (i * stride);
-
-  png_read_image(png_ptr, rowPtrs);
-
-  vpImage<vpRGBa> Ic(height, width);
-  unsigned char *output;
-
-  switch (channels) {
-  case 1:
-    output = (unsigned char *)I.bitmap;
-    for (unsigned int i = 0; i < width * height; i++) {
-      *(output++) = data[i];
-    }
-    break;
-
-  case 2:
-    output = (unsigned char *)I.bitmap;
-    for (unsigned int i = 0; i < width * height; i++) {
-      *(output++) = data[i * 2];
-    }
-    break;
-
-  case 3:
-    output = (unsigned char *)Ic.bitmap;
-    for (unsigned int i = 0; i < width * height; i++) {
-      *(output++) = data[i * 3];
-      *(output++) = data[i * 3 + 1];
-      *(output++) = data[i * 3 + 2];
-      *(output++) = vpRGBa::alpha_default;
+  if (channels == 1) {
+    // Gray level rows are decoded by libpng directly in the image
+    for (unsigned int i = 0; i < height; i++)
+      rowPtrs[i] = (png_bytep)I[i];
+
+    png_read_image(png_ptr, rowPtrs);
+  } else {
+    // Color rows are converted in gray level as soon as they are decoded.
+    // Only interlaced images need to be entirely buffered.
+    unsigned int stride = png_get_rowbytes(png_ptr, info_ptr);
+    bool interlaced = (png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE);
+    unsigned char *data = new unsigned char[interlaced ? stride * height : stride];
+
+    for (unsigned int i = 0; i < height; i++)
+      rowPtrs[i] = (png_bytep)data + (interlaced ? i * stride : 0);
+
+    if (interlaced)
+      png_read_image(png_ptr, rowPtrs);
+
+    for (unsigned int i = 0; i < height; i++) {
+      if (!interlaced)
+        png_read_row(png_ptr, rowPtrs[i], NULL);
+
+      if (channels == 3)
+        vpImageConvert::RGBToGrey(rowPtrs[i], I[i], width);
+      else
+        vpImageConvert::RGBaToGrey(rowPtrs[i], I[i], width);
     }
-    vpImageConvert::convert(Ic, I);
-    break;
 
-  case 4:
-    output = (unsigned char *)Ic.bitmap;
-    for (unsigned int i = 0; i < width * height; i++) {
-      *(output++) = data[i * 4];
-      *(output++) = data[i * 4 + 1];
-      *(output++) = data[i * 4 + 2];
-      *(output++) = data[i * 4 + 3];
-    }
-    vpImageConvert::convert(Ic, I);
-    break;
+    delete[] data;
   }
 
   delete[](png_bytep) rowPtrs;
-  delete[] data;
   png_read_end(png_ptr, NULL);
   png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
   fclose(file);
@@ -1840,10 +1899,9 @@ void vpImageIo::readPNG(vpImage<vpRGBa> &I, const std::string &filename)
   unsigned int width = png_get_image_width(png_ptr, info_ptr);
   unsigned int height = png_get_image_height(png_ptr, info_ptr);
 
-  unsigned int bit_depth, channels, color_type;
+  unsigned int bit_depth, color_type;
   /* get some useful information from header */
   bit_depth = png_get_bit_depth(png_ptr, info_ptr);
-  channels = png_get_channels(png_ptr, info_ptr);
   color_type = png_get_color_type(png_ptr, info_ptr);
 
   /* convert index color images to RGB images */
@@ -1865,67 +1923,29 @@ void vpImageIo::readPNG(vpImage<vpRGBa> &I, const std::string &filename)
   else if (bit_depth < 8)
     png_set_packing(png_ptr);
 
+  /* convert grayscale images to RGB and add an opaque alpha channel to get
+     vpRGBa pixels */
+  if (color_type == PNG_COLOR_TYPE_GRAY || color_type == PNG_COLOR_TYPE_GRAY_ALPHA)
+    png_set_gray_to_rgb(png_ptr);
+
+  if (color_type != PNG_COLOR_TYPE_RGB_ALPHA)
+    png_set_filler(png_ptr, vpRGBa::alpha_default, PNG_FILLER_AFTER);
+
   /* update info structure to apply transformations */
   png_read_update_info(png_ptr, info_ptr);
 
-  channels = png_get_channels(png_ptr, info_ptr);
-
   if ((width != I.getWidth()) || (height != I.getHeight()))
     I.resize(height, width);
 
+  // Rows are decoded by libpng directly in the image
   png_bytep *rowPtrs = new png_bytep[height];
 
-  unsigned int stride = png_get_rowbytes(png_ptr, info_ptr);
-  unsigned char *data = new unsigned char[stride * height];
-
   for (unsigned int i = 0; i < height; i++)
-    rowPtrs[i] = (png_bytep)data + (i * stride);
+    rowPtrs[i] = (png_bytep)I[i];
 
   png_read_image(png_ptr, rowPtrs);
 
-  vpImage<unsigned char> Ig(height, width);
-  unsigned char *output;
-
-  switch (channels) {
-  case 1:
-    output = (unsigned char *)Ig.bitmap;
-    for (unsigned int i = 0; i < width * height; i++) {
-      *(output++) = data[i];
-    }
-    vpImageConvert::convert(Ig, I);
-    break;
-
-  case 2:
-    output = (unsigned char *)Ig.bitmap;
-    for (unsigned int i = 0; i < width * height; i++) {
-      *(output++) = data[i * 2];
-    }
-    vpImageConvert::convert(Ig, I);
-    break;
-
-  case 3:
-    output = (unsigned char *)I.bitmap;
-    for (unsigned int i = 0; i < width * height; i++) {
-      *(output++) = data[i * 3];
-      *(output++) = data[i * 3 + 1];
-      *(output++) = data[i * 3 + 2];
-      *(output++) = vpRGBa::alpha_default;
-    }
-    break;
-
-  case 4:
-    output = (unsigned char *)I.bitmap;
-    for (unsigned int i = 0; i < width * height; i++) {
-      *(output++) = data[i * 4];
-      *(output++) = data[i * 4 + 1];
-      *(output++) = data[i * 4 + 2];
-      *(output++) = data[i * 4 + 3];
-    }
-    break;
-  }
-
   delete[](png_bytep) rowPtrs;
-  delete[] data;
   png_read_end(png_ptr, NULL);
   png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
   fclose(file);
@@ -1939,18 +1959,29 @@ void vpImageIo::readPNG(vpImage<vpRGBa> &I, const std::string &filename)
 
   \param I : Image to save as a PNG file.
   \param filename : Name of the file containing the image.
+  \param compression_level : zlib compression level, from 0 (no
+  compression) to 9 (best compression). The default value -1 lets OpenCV use
+  its default level.
 */
-void vpImageIo::writePNG(const vpImage<unsigned char> &I, const std::string &filename)
+void vpImageIo::writePNG(const vpImage<unsigned char> &I, const std::string &filename, int compression_level)
 {
+  vp_checkPNGCompressionLevel(compression_level);
+
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   cv::Mat Ip;
   vpImageConvert::convert(I, Ip);
-  cv::imwrite(filename.c_str(), Ip);
+  std::vector<int> params;
+  if (compression_level >= 0) {
+    params.push_back(cv::IMWRITE_PNG_COMPRESSION);
+    params.push_back(compression_level);
+  }
+  cv::imwrite(filename.c_str(), Ip, params);
 #else
   IplImage *Ip = NULL;
   vpImageConvert::convert(I, Ip);
 
-  cvSaveImage(filename.c_str(), Ip);
+  int params[3] = {CV_IMWRITE_PNG_COMPRESSION, compression_level, 0};
+  cvSaveImage(filename.c_str(), Ip, compression_level >= 0 ? params : NULL);
 
   cvReleaseImage(&Ip);
 #endif
@@ -1962,18 +1993,29 @@ void vpImageIo::writePNG(const vpImage<unsigned char> &I, const std::string &fil
 
   \param I : Image to save as a PNG file.
   \param filename : Name of the file containing the image.
+  \param compression_level : zlib compression level, from 0 (no
+  compression) to 9 (best compression). The default value -1 lets OpenCV use
+  its default level.
 */
-void vpImageIo::writePNG(const vpImage<vpRGBa> &I, const std::string &filename)
+void vpImageIo::writePNG(const vpImage<vpRGBa> &I, const std::string &filename, int compression_level)
 {
+  vp_checkPNGCompressionLevel(compression_level);
+
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   cv::Mat Ip;
   vpImageConvert::convert(I, Ip);
-  cv::imwrite(filename.c_str(), Ip);
+  std::vector<int> params;
+  if (compression_level >= 0) {
+    params.push_back(cv::IMWRITE_PNG_COMPRESSION);
+    params.push_back(compression_level);
+  }
+  cv::imwrite(filename.c_str(), Ip, params);
 #else
   IplImage *Ip = NULL;
   vpImageConvert::convert(I, Ip);
 
-  cvSaveImage(filename.c_str(), Ip);
+  int params[3] = {CV_IMWRITE_PNG_COMPRESSION, compression_level, 0};
+  cvSaveImage(filename.c_str(), Ip, compression_level >= 0 ? params : NULL);
 
   cvReleaseImage(&Ip);
 #endif
@@ -2072,11 +2114,11 @@ void vpImageIo::readPNG(vpImage<vpRGBa> &, const std::string &)
 {
   throw(vpException(vpException::fatalError, "Cannot read png image since ViSP in not built with OpenCV or libpng 3rd parties"));
 }
-void vpImageIo::writePNG(const vpImage<unsigned char> &, const std::string &)
+void vpImageIo::writePNG(const vpImage<unsigned char> &, const std::string &, int)
 {
   throw(vpException(vpException::fatalError, "Cannot read png image since ViSP in not built with OpenCV or libpng 3rd parties"));
 }
-void vpImageIo::writePNG(const vpImage<vpRGBa> &, const std::string &)
+void vpImageIo::writePNG(const vpImage<vpRGBa> &, const std::string &, int)
 {
   throw(vpException(vpException::fatalError, "Cannot read png image since ViSP in not built with OpenCV or libpng 3rd parties"));
 }
@@ -0,0 +1,268 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Read images and their metadata from a memory mapped raw image file.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpRawImageReader.cpp
+  \brief Read images and their metadata from a memory mapped raw image file
+*/
+
+#include <limits>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImageException.h>
+#include <visp3/io/vpRawImageReader.h>
+
+/*!
+  Default constructor. open() should be called before reading images.
+*/
+vpRawImageReader::vpRawImageReader() : m_data(NULL), m_size(0), m_filename(), m_offsets() {}
+
+/*!
+  Open a raw image file to read its images.
+
+  \param filename : Name of the file.
+
+  \sa open()
+*/
+vpRawImageReader::vpRawImageReader(const std::string &filename) : m_data(NULL), m_size(0), m_filename(), m_offsets()
+{
+  open(filename);
+}
+
+/*!
+  Destructor that closes the file.
+*/
+vpRawImageReader::~vpRawImageReader() { close(); }
+
+/*!
+  Close the file. The pointers returned by getPixels() are no longer valid.
+*/
+void vpRawImageReader::close()
+{
+  if (m_data != NULL) {
+#if defined(_WIN32)
+    UnmapViewOfFile(m_data);
+#else
+    munmap(m_data, m_size);
+#endif
+    m_data = NULL;
+  }
+  m_size = 0;
+  m_filename.clear();
+  m_offsets.clear();
+}
+
+/*!
+  Get the intrinsic parameters of the camera that acquired an image.
+
+  \param index : Index of the image in the file.
+  \param cam : Camera parameters written with the image.
+
+  \return true if camera parameters were written with the image, false
+  otherwise. In that case \e cam is unchanged.
+*/
+bool vpRawImageReader::getCameraParameters(unsigned int index, vpCameraParameters &cam) const
+{
+  const vpRawImageFormat::vpFrameHeader &header = getHeader(index);
+  if (!header.has_camera) {
+    return false;
+  }
+
+  if (header.projection == vpCameraParameters::perspectiveProjWithDistortion) {
+    cam.initPersProjWithDistortion(header.px, header.py, header.u0, header.v0, header.kud, header.kdu);
+  } else {
+    cam.initPersProjWithoutDistortion(header.px, header.py, header.u0, header.v0);
+  }
+  return true;
+}
+
+const unsigned char *vpRawImageReader::getData(unsigned int index, vpRawImageFormat::vpPixelType pixel_type,
+                                               unsigned int pixel_size) const
+{
+  const vpRawImageFormat::vpFrameHeader &header = getHeader(index);
+  if (header.pixel_type != (uint32_t)pixel_type || header.pixel_size != pixel_size) {
+    throw(vpException(vpException::badValue,
+                      "Cannot read image %u of \"%s\": pixels of type %u and size %u instead of type %d and size %u",
+                      index, m_filename.c_str(), header.pixel_type, header.pixel_size, pixel_type, pixel_size));
+  }
+
+  return m_data + m_offsets[index] + header.data_offset;
+}
+
+/*!
+  Return the header of an image that gives its pixel type, size, timestamp
+  and camera parameters.
+
+  \param index : Index of the image in the file.
+
+  \exception vpException::badValue : If there is no image \e index in the file.
+*/
+const vpRawImageFormat::vpFrameHeader &vpRawImageReader::getHeader(unsigned int index) const
+{
+  if (index >= m_offsets.size()) {
+    throw(vpException(vpException::badValue, "Cannot read image %u of \"%s\" that contains %u images", index,
+                      m_filename.c_str(), getFrameCount()));
+  }
+
+  return *reinterpret_cast<const vpRawImageFormat::vpFrameHeader *>(m_data + m_offsets[index]);
+}
+
+/*!
+  Return the height of an image.
+
+  \param index : Index of the image in the file.
+*/
+unsigned int vpRawImageReader::getHeight(unsigned int index) const { return getHeader(index).height; }
+
+/*!
+  Return the type of the pixels of an image.
+
+  \param index : Index of the image in the file.
+*/
+vpRawImageFormat::vpPixelType vpRawImageReader::getPixelType(unsigned int index) const
+{
+  return (vpRawImageFormat::vpPixelType)getHeader(index).pixel_type;
+}
+
+/*!
+  Return the acquisition time of an image.
+
+  \param index : Index of the image in the file.
+*/
+double vpRawImageReader::getTimestamp(unsigned int index) const { return getHeader(index).timestamp; }
+
+/*!
+  Return the width of an image.
+
+  \param index : Index of the image in the file.
+*/
+unsigned int vpRawImageReader::getWidth(unsigned int index) const { return getHeader(index).width; }
+
+/*!
+  Map a raw image file in memory and index its images. A file already open
+  is closed.
+
+  \param filename : Name of the file.
+
+  \exception vpImageException::ioError : If the file cannot be mapped in
+  memory or is not a raw image file.
+*/
+void vpRawImageReader::open(const std::string &filename)
+{
+  close();
+
+  if (filename.empty()) {
+    throw(vpImageException(vpImageException::ioError, "Cannot read raw image file: filename empty"));
+  }
+
+  bool mapped = false;
+  uint64_t size = 0;
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file != INVALID_HANDLE_VALUE) {
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx(file, &file_size)) {
+      size = (uint64_t)file_size.QuadPart;
+      mapped = (size == 0);
+      if (size > 0 && size <= (std::numeric_limits<size_t>::max)()) {
+        HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) {
+          // The view keeps the file mapped once the handles are closed
+          m_data = (unsigned char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+          mapped = (m_data != NULL);
+          CloseHandle(mapping);
+        }
+      }
+    }
+    CloseHandle(file);
+  }
+#else
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  if (fd >= 0) {
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0) {
+      size = (uint64_t)file_stat.st_size;
+      mapped = (size == 0);
+      if (size > 0 && size <= (std::numeric_limits<size_t>::max)()) {
+        // The mapping remains valid once the file is closed
+        void *data = mmap(NULL, (size_t)size, PROT_READ, MAP_SHARED, fd, 0);
+        if (data != MAP_FAILED) {
+          m_data = (unsigned char *)data;
+          mapped = true;
+        }
+      }
+    }
+    ::close(fd);
+  }
+#endif
+  if (!mapped) {
+    m_data = NULL;
+    throw(vpImageException(vpImageException::ioError, "Cannot map raw image file \"%s\" in memory", filename.c_str()));
+  }
+  m_size = (size_t)size;
+
+  // Index the images
+  const size_t header_size = sizeof(vpRawImageFormat::vpFrameHeader);
+  size_t offset = 0;
+  while (m_size - offset >= header_size) {
+    const vpRawImageFormat::vpFrameHeader &header =
+        *reinterpret_cast<const vpRawImageFormat::vpFrameHeader *>(m_data + offset);
+    const char *error = vpRawImageFormat::checkHeader(header);
+    if (error != NULL) {
+      close();
+      throw(vpImageException(vpImageException::ioError, "Cannot read image at offset %lu of \"%s\": %s",
+                             (unsigned long)offset, filename.c_str(), error));
+    }
+
+    // An incomplete last image is ignored
+    if (header.frame_size > m_size - offset) {
+      break;
+    }
+    m_offsets.push_back(offset);
+    offset += (size_t)header.frame_size;
+  }
+
+  m_filename = filename;
+}
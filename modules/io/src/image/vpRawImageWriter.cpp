@@ -0,0 +1,204 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Write images and their metadata in a raw image file.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpRawImageWriter.cpp
+  \brief Write images and their metadata in a raw image file
+*/
+
+#include <string.h>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImageException.h>
+#include <visp3/io/vpRawImageWriter.h>
+
+namespace
+{
+// True if the images of the file are valid and the last one is complete, as checked by vpRawImageReader::open()
+bool isComplete(FILE *file)
+{
+#if defined(_WIN32)
+  const int64_t size = (_fseeki64(file, 0, SEEK_END) == 0) ? (int64_t)_ftelli64(file) : -1;
+#else
+  const int64_t size = (fseeko(file, 0, SEEK_END) == 0) ? (int64_t)ftello(file) : -1;
+#endif
+  if (size < 0) {
+    return false;
+  }
+
+  int64_t offset = 0;
+  vpRawImageFormat::vpFrameHeader header;
+  while (offset < size) {
+#if defined(_WIN32)
+    const bool positioned = (_fseeki64(file, offset, SEEK_SET) == 0);
+#else
+    const bool positioned = (fseeko(file, (off_t)offset, SEEK_SET) == 0);
+#endif
+    if (size - offset < (int64_t)sizeof(header) || !positioned || fread(&header, sizeof(header), 1, file) != 1 ||
+        vpRawImageFormat::checkHeader(header) != NULL || header.frame_size > (uint64_t)(size - offset)) {
+      return false;
+    }
+    offset += (int64_t)header.frame_size;
+  }
+  return true;
+}
+}
+
+/*!
+  Default constructor. open() should be called before writing images.
+*/
+vpRawImageWriter::vpRawImageWriter() : m_file(NULL), m_filename(), m_frameCount(0) {}
+
+/*!
+  Open a raw image file to write images.
+
+  \param filename : Name of the file.
+  \param append : When true, the images are appended to an existing file.
+  Otherwise the file is overwritten.
+
+  \sa open()
+*/
+vpRawImageWriter::vpRawImageWriter(const std::string &filename, bool append)
+  : m_file(NULL), m_filename(), m_frameCount(0)
+{
+  open(filename, append);
+}
+
+/*!
+  Destructor that closes the file.
+*/
+vpRawImageWriter::~vpRawImageWriter() { close(); }
+
+/*!
+  Close the file. The images written before are complete in the file.
+*/
+void vpRawImageWriter::close()
+{
+  if (m_file != NULL) {
+    fclose(m_file);
+    m_file = NULL;
+  }
+}
+
+/*!
+  Open a raw image file to write images. A file already open is closed.
+
+  \param filename : Name of the file.
+  \param append : When true, the images are appended to an existing file.
+  Otherwise the file is overwritten.
+
+  \exception vpImageException::ioError : If the file cannot be opened, or if
+  the images of the file to append are not valid or its last image is not
+  complete.
+*/
+void vpRawImageWriter::open(const std::string &filename, bool append)
+{
+  close();
+
+  if (filename.empty()) {
+    throw(vpImageException(vpImageException::ioError, "Cannot create raw image file: filename empty"));
+  }
+
+  // Walk the image headers of the file to append, which must end with a complete image
+  if (append) {
+    FILE *file = fopen(filename.c_str(), "rb");
+    if (file != NULL) {
+      bool complete = isComplete(file);
+      fclose(file);
+      if (!complete) {
+        throw(vpImageException(vpImageException::ioError, "Cannot append to \"%s\": not a complete raw image file",
+                               filename.c_str()));
+      }
+    }
+  }
+
+  m_file = fopen(filename.c_str(), append ? "ab" : "wb");
+  if (m_file == NULL) {
+    throw(vpImageException(vpImageException::ioError, "Cannot create raw image file \"%s\"", filename.c_str()));
+  }
+
+  m_filename = filename;
+  m_frameCount = 0;
+}
+
+void vpRawImageWriter::writeFrame(vpRawImageFormat::vpPixelType pixel_type, unsigned int pixel_size,
+                                  unsigned int height, unsigned int width, const void *data, double timestamp,
+                                  const vpCameraParameters *cam)
+{
+  if (m_file == NULL) {
+    throw(vpException(vpException::notInitialized, "Cannot write image: no raw image file open"));
+  }
+
+  const uint64_t alignment = vpRawImageFormat::alignment;
+  vpRawImageFormat::vpFrameHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, "VPRI", 4);
+  header.byte_order = 0x01020304;
+  header.header_size = sizeof(header);
+  header.data_offset = (uint32_t)(((sizeof(header) + alignment - 1) / alignment) * alignment);
+  header.pixel_type = (uint32_t)pixel_type;
+  header.pixel_size = pixel_size;
+  header.width = width;
+  header.height = height;
+  header.stride = width * pixel_size;
+  uint64_t data_size = (uint64_t)header.stride * height;
+  header.frame_size = ((header.data_offset + data_size + alignment - 1) / alignment) * alignment;
+  header.timestamp = timestamp;
+  if (cam != NULL) {
+    header.has_camera = 1;
+    header.projection = (uint32_t)cam->get_projModel();
+    header.px = cam->get_px();
+    header.py = cam->get_py();
+    header.u0 = cam->get_u0();
+    header.v0 = cam->get_v0();
+    header.kud = cam->get_kud();
+    header.kdu = cam->get_kdu();
+  }
+
+  char padding[vpRawImageFormat::alignment];
+  memset(padding, 0, sizeof(padding));
+  size_t header_padding = header.data_offset - sizeof(header);
+  size_t data_padding = (size_t)(header.frame_size - header.data_offset - data_size);
+
+  if (fwrite(&header, sizeof(header), 1, m_file) != 1 ||
+      (header_padding > 0 && fwrite(padding, header_padding, 1, m_file) != 1) ||
+      (data_size > 0 && fwrite(data, (size_t)data_size, 1, m_file) != 1) ||
+      (data_padding > 0 && fwrite(padding, data_padding, 1, m_file) != 1)) {
+    throw(vpImageException(vpImageException::ioError, "Cannot write image %u in raw image file \"%s\"", m_frameCount,
+                           m_filename.c_str()));
+  }
+
+  m_frameCount++;
+}
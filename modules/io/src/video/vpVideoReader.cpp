@@ -44,13 +44,199 @@
 
 #include <visp3/core/vpDebug.h>
 #include <visp3/core/vpIoTools.h>
+#include <visp3/io/vpImageIo.h>
 #include <visp3/io/vpVideoReader.h>
 
 #include <cctype>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <limits> // numeric_limits
 
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+/*
+  Decodes the images of a sequence ahead of their acquisition in a background
+  thread. The images are stored in a ring of buffers that are reused from one
+  image to the next, so that the memory is bounded by the ring size.
+*/
+class vpVideoReader::vpFramePrefetcher
+{
+public:
+  explicit vpFramePrefetcher(const std::string &genericName)
+    : m_genericName(genericName), m_thread(), m_mutex(), m_cond(), m_slots(), m_headSlot(0), m_count(0), m_head(0),
+      m_step(1), m_first(0), m_last(0), m_color(false), m_stop(false), m_running(false)
+  {
+  }
+
+  ~vpFramePrefetcher() { stop(); }
+
+  /*
+    Copies the image \e index into \e I. If the ring does not start with this
+    image, or if the reading parameters changed, the decoding restarts from
+    \e index, then goes on with the following images in [first, last]. When
+    \e consume is false, the image stays at the head of the ring.
+  */
+  template <class Type>
+  void read(vpImage<Type> &I, long index, long step, long first, long last, unsigned int size, bool consume)
+  {
+    const bool color = isColor(I);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_running || m_head != index || m_step != step || m_first != first || m_last != last ||
+        m_color != color || m_slots.size() != size) {
+      lock.unlock();
+      start(index, step, first, last, color, size);
+      lock.lock();
+    }
+    m_cond.wait(lock, [this] { return m_count > 0; });
+    // The producer does not write the head slot until it is consumed
+    vpSlot &slot = m_slots[m_headSlot];
+    lock.unlock();
+
+    bool failed = slot.failed;
+    std::string error = slot.error;
+    if (!failed) {
+      // Reuse the buffer of I, while operator=() always reallocates
+      const vpImage<Type> &src = image(slot, I);
+      I.resize(src.getHeight(), src.getWidth());
+      memcpy(static_cast<void *>(I.bitmap), src.bitmap, src.getSize() * sizeof(Type));
+    }
+
+    if (consume) {
+      lock.lock();
+      m_headSlot = (m_headSlot + 1) % m_slots.size();
+      m_head += m_step;
+      m_count--;
+      lock.unlock();
+      m_cond.notify_all();
+    }
+
+    if (failed) {
+      throw vpException(vpException::ioError, error);
+    }
+  }
+
+private:
+  struct vpSlot {
+    vpSlot() : Ig(), Ic(), failed(false), error() {}
+
+    vpImage<unsigned char> Ig;
+    vpImage<vpRGBa> Ic;
+    bool failed;
+    std::string error;
+  };
+
+  static bool isColor(const vpImage<unsigned char> &) { return false; }
+  static bool isColor(const vpImage<vpRGBa> &) { return true; }
+  static const vpImage<unsigned char> &image(const vpSlot &slot, const vpImage<unsigned char> &) { return slot.Ig; }
+  static const vpImage<vpRGBa> &image(const vpSlot &slot, const vpImage<vpRGBa> &) { return slot.Ic; }
+
+  void start(long index, long step, long first, long last, bool color, unsigned int size)
+  {
+    stop();
+
+    m_slots.resize(size);
+    m_headSlot = 0;
+    m_count = 0;
+    m_head = index;
+    m_step = step;
+    m_first = first;
+    m_last = last;
+    m_color = color;
+    m_stop = false;
+    m_running = true;
+    m_thread = std::thread(&vpFramePrefetcher::run, this);
+  }
+
+  void stop()
+  {
+    if (m_running) {
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+      }
+      m_cond.notify_all();
+      m_thread.join();
+      m_running = false;
+    }
+  }
+
+  void decode(vpSlot &slot, long index)
+  {
+    char filename[FILENAME_MAX];
+    sprintf(filename, m_genericName.c_str(), index);
+    try {
+      if (m_color) {
+        vpImageIo::read(slot.Ic, filename);
+      } else {
+        vpImageIo::read(slot.Ig, filename);
+      }
+      slot.failed = false;
+    } catch (const vpException &e) {
+      slot.failed = true;
+      slot.error = e.getStringMessage();
+    }
+  }
+
+  void run()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    long index = m_head;
+    // The requested image is always decoded, the following ones only within the sequence bounds
+    bool requested = true;
+    while (!m_stop) {
+      m_cond.wait(lock, [this] { return m_stop || m_count < m_slots.size(); });
+      if (m_stop) {
+        break;
+      }
+      if (!requested && (m_step == 0 || index < m_first || index > m_last)) {
+        m_cond.wait(lock, [this] { return m_stop; });
+        break;
+      }
+      requested = false;
+
+      vpSlot &slot = m_slots[(m_headSlot + m_count) % m_slots.size()];
+      lock.unlock();
+      decode(slot, index);
+      lock.lock();
+
+      m_count++;
+      index += m_step;
+      m_cond.notify_all();
+    }
+  }
+
+  const std::string m_genericName;
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cond;
+  std::vector<vpSlot> m_slots;
+  //! Ring position of the oldest decoded image
+  size_t m_headSlot;
+  //! Number of decoded images not consumed yet
+  size_t m_count;
+  //! Index of the image at the head of the ring
+  long m_head;
+  long m_step;
+  long m_first;
+  long m_last;
+  bool m_color;
+  bool m_stop;
+  bool m_running;
+};
+#else
+class vpVideoReader::vpFramePrefetcher
+{
+};
+#endif
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
 Basic constructor.
 */
@@ -60,7 +246,8 @@ vpVideoReader::vpVideoReader()
     capture(), frame(),
 #endif
     formatType(FORMAT_UNKNOWN), initFileName(false), isOpen(false), frameCount(0), firstFrame(0), lastFrame(0),
-    firstFrameIndexIsSet(false), lastFrameIndexIsSet(false), frameStep(1), frameRate(0.)
+    firstFrameIndexIsSet(false), lastFrameIndexIsSet(false), frameStep(1), frameRate(0.), prefetchSize(0),
+    prefetcher(NULL)
 {
 }
 
@@ -69,6 +256,9 @@ Basic destructor.
 */
 vpVideoReader::~vpVideoReader()
 {
+  if (prefetcher != NULL) {
+    delete prefetcher;
+  }
   if (imSequence != NULL) {
     delete imSequence;
   }
@@ -102,6 +292,11 @@ void vpVideoReader::setFileName(const char *filename)
 
   strcpy(this->fileName, filename);
 
+  if (prefetcher != NULL) {
+    delete prefetcher;
+    prefetcher = NULL;
+  }
+
   formatType = getFormat(fileName);
 
   if (formatType == FORMAT_UNKNOWN) {
@@ -269,6 +464,11 @@ void vpVideoReader::acquire(vpImage<vpRGBa> &I)
     open(I);
   }
 
+  if (usePrefetch()) {
+    acquirePrefetched(I);
+    return;
+  }
+
   // getFrame(I,frameCount);
   if (imSequence != NULL) {
     imSequence->setStep(frameStep);
@@ -341,6 +541,11 @@ void vpVideoReader::acquire(vpImage<unsigned char> &I)
     open(I);
   }
 
+  if (usePrefetch()) {
+    acquirePrefetched(I);
+    return;
+  }
+
   if (imSequence != NULL) {
     imSequence->setStep(frameStep);
     imSequence->acquire(I);
@@ -413,7 +618,14 @@ images one after one.
 */
 bool vpVideoReader::getFrame(vpImage<vpRGBa> &I, long frame_index)
 {
-  if (imSequence != NULL) {
+  if (usePrefetch()) {
+    try {
+      getPrefetchedFrame(I, frame_index);
+    } catch (...) {
+      vpERROR_TRACE("Couldn't find the %ld th frame", frame_index);
+      return false;
+    }
+  } else if (imSequence != NULL) {
     try {
       imSequence->acquire(I, frame_index);
       width = I.getWidth();
@@ -483,7 +695,14 @@ images one after one.
 */
 bool vpVideoReader::getFrame(vpImage<unsigned char> &I, long frame_index)
 {
-  if (imSequence != NULL) {
+  if (usePrefetch()) {
+    try {
+      getPrefetchedFrame(I, frame_index);
+    } catch (...) {
+      vpERROR_TRACE("Couldn't find the %ld th frame", frame_index);
+      return false;
+    }
+  } else if (imSequence != NULL) {
     try {
       imSequence->acquire(I, frame_index);
       width = I.getWidth();
@@ -542,6 +761,91 @@ bool vpVideoReader::getFrame(vpImage<unsigned char> &I, long frame_index)
   return true;
 }
 
+/*!
+  Enables the decoding of the next images of a sequence in a background
+  thread, to overlap the reading and the decoding of the images with their
+  processing. The decoded images are stored in a ring of \e nb_frames
+  recycled images, which bounds the memory used to \e nb_frames times the
+  image size.
+
+  acquire() then only waits when the next image is not decoded yet, and
+  getFrame() restarts the decoding from the requested frame. Images that are
+  read in order are decoded once.
+
+  \param nb_frames : Number of images decoded ahead. 0, the default value,
+  decodes the images in acquire() and getFrame().
+
+  \note The background decoding requires a C++11 compiler. It only applies to
+  image sequences: video files are always decoded in acquire().
+*/
+void vpVideoReader::setPrefetch(unsigned int nb_frames)
+{
+  prefetchSize = nb_frames;
+  if (prefetchSize == 0 && prefetcher != NULL) {
+    delete prefetcher;
+    prefetcher = NULL;
+  }
+}
+
+/*!
+  Return true if the images are decoded in a background thread.
+*/
+bool vpVideoReader::usePrefetch() const
+{
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  return (imSequence != NULL && prefetchSize > 0);
+#else
+  return false;
+#endif
+}
+
+/*!
+  Prefetched counterpart of the image sequence acquisition.
+*/
+template <class Type> void vpVideoReader::acquirePrefetched(vpImage<Type> &I)
+{
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  if (prefetcher == NULL) {
+    prefetcher = new vpFramePrefetcher(fileName);
+  }
+
+  long frame_index = imSequence->getNextImageNumber();
+  prefetcher->read(I, frame_index, frameStep, firstFrame, lastFrame, prefetchSize, true);
+
+  frameCount = frame_index;
+  if (frameCount + frameStep > lastFrame || frameCount + frameStep < firstFrame) {
+    imSequence->setImageNumber(frameCount);
+  } else {
+    imSequence->setImageNumber(frameCount + frameStep);
+  }
+#else
+  (void)I;
+#endif
+}
+
+/*!
+  Prefetched counterpart of getFrame() for image sequences. The frame stays
+  in the ring since the next acquire() returns it again.
+*/
+template <class Type> void vpVideoReader::getPrefetchedFrame(vpImage<Type> &I, long frame_index)
+{
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  if (prefetcher == NULL) {
+    prefetcher = new vpFramePrefetcher(fileName);
+  }
+
+  prefetcher->read(I, frame_index, frameStep, firstFrame, lastFrame, prefetchSize, false);
+  width = I.getWidth();
+  height = I.getHeight();
+
+  frameCount = frame_index;
+  imSequence->setImageNumber(frameCount); // to not increment the next image
+#else
+  (void)I;
+  (void)frame_index;
+#endif
+}
+
 /*!
 Gets the format of the file(s) which has/have to be read.
 
@@ -57,7 +57,8 @@ vpVideoWriter::vpVideoWriter()
 #if VISP_HAVE_OPENCV_VERSION >= 0x020100
     writer(), fourcc(0), framerate(0.),
 #endif
-    formatType(FORMAT_UNKNOWN), initFileName(false), isOpen(false), frameCount(0), firstFrame(0), width(0), height(0)
+    formatType(FORMAT_UNKNOWN), initFileName(false), isOpen(false), frameCount(0), firstFrame(0), width(0), height(0),
+    asyncWriter(NULL)
 {
   initFileName = false;
   firstFrame = 0;
@@ -76,7 +77,12 @@ vpVideoWriter::vpVideoWriter()
 /*!
   Basic destructor.
 */
-vpVideoWriter::~vpVideoWriter() {}
+vpVideoWriter::~vpVideoWriter()
+{
+  if (asyncWriter != NULL) {
+    delete asyncWriter;
+  }
+}
 
 /*!
   It enables to set the path and the name of the files which will be saved.
@@ -215,7 +221,11 @@ void vpVideoWriter::saveFrame(vpImage<vpRGBa> &I)
 
     sprintf(name, fileName, frameCount);
 
-    vpImageIo::write(I, name);
+    if (asyncWriter != NULL) {
+      asyncWriter->write(I, name);
+    } else {
+      vpImageIo::write(I, name);
+    }
   } else {
 #if VISP_HAVE_OPENCV_VERSION >= 0x020100
     cv::Mat matFrame;
@@ -248,7 +258,11 @@ void vpVideoWriter::saveFrame(vpImage<unsigned char> &I)
 
     sprintf(name, fileName, frameCount);
 
-    vpImageIo::write(I, name);
+    if (asyncWriter != NULL) {
+      asyncWriter->write(I, name);
+    } else {
+      vpImageIo::write(I, name);
+    }
   } else {
 #if VISP_HAVE_OPENCV_VERSION >= 0x030000
     cv::Mat matFrame, rgbMatFrame;
@@ -275,6 +289,49 @@ void vpVideoWriter::close()
     vpERROR_TRACE("The video has to be open first with the open method");
     throw(vpException(vpException::notInitialized, "file not yet opened"));
   }
+
+  flush();
+}
+
+/*!
+  Waits until all the images saved with saveFrame() are written. This is only
+  needed when the images are written asynchronously.
+
+  \exception vpException::ioError : If images could not be written.
+
+  \sa setAsynchronous()
+*/
+void vpVideoWriter::flush()
+{
+  if (asyncWriter != NULL) {
+    asyncWriter->flush();
+  }
+}
+
+/*!
+  Writes the images of a sequence in background threads, so that saveFrame()
+  only copies the image in a queue. See vpAsyncImageWriter.
+
+  Dropped images keep their frame number, so that the gaps in the file names
+  show which images are missing. Write errors are reported by flush() and
+  close(). Video files are always written by saveFrame().
+
+  \param queue_size : Maximum number of images queued or being written. 0
+  writes the images in saveFrame().
+  \param nb_threads : Number of threads encoding and writing images.
+  \param policy : Behavior of saveFrame() when the queue is full.
+*/
+void vpVideoWriter::setAsynchronous(unsigned int queue_size, unsigned int nb_threads,
+                                    vpAsyncImageWriter::vpQueuePolicy policy)
+{
+  if (asyncWriter != NULL) {
+    asyncWriter->flush();
+    delete asyncWriter;
+    asyncWriter = NULL;
+  }
+  if (queue_size > 0) {
+    asyncWriter = new vpAsyncImageWriter(queue_size, nb_threads, policy);
+  }
 }
 
 /*!
@@ -170,7 +170,20 @@ public:
     border. This list is update after a call to track().
 
   */
-  void getEdges(std::list<vpImagePoint> &edges_list) const { edges_list = this->ip_edges_list; };
+  void getEdges(std::list<vpImagePoint> &edges_list) const
+  {
+    edges_list.assign(this->ip_edges_list.begin(), this->ip_edges_list.end());
+  };
+  /*!
+
+    Return the vector of all the image points on the dot
+    border, without the copy in a list.
+
+    \param edges_list : The vector of all the images points on the dot
+    border. This vector is update after a call to track().
+
+  */
+  void getEdges(std::vector<vpImagePoint> &edges_list) const { edges_list = this->ip_edges_list; };
   /*!
 
     Return the list of all the image points on the dot
@@ -180,7 +193,10 @@ public:
     border. This list is update after a call to track().
 
   */
-  std::list<vpImagePoint> getEdges() const { return (this->ip_edges_list); };
+  std::list<vpImagePoint> getEdges() const
+  {
+    return (std::list<vpImagePoint>(this->ip_edges_list.begin(), this->ip_edges_list.end()));
+  };
   /*!
     Get the percentage of sampled points that are considered non conform
     in terms of the gray level on the inner and the ouside ellipses.
@@ -191,8 +207,15 @@ public:
 
   double getEllipsoidShapePrecision() const;
   void getFreemanChain(std::list<unsigned int> &freeman_chain) const;
+  void getFreemanChain(std::vector<unsigned int> &freeman_chain) const;
 
   inline double getGamma() const { return this->gamma; };
+  /*!
+    Return true if the graphics overlay is activated during the tracking.
+
+    \sa setGraphics()
+  */
+  inline bool getGraphics() const { return graphics; }
   /*!
     Return the color level of pixels inside the dot.
 
@@ -338,6 +361,27 @@ public:
   void setGrayLevelPrecision(const double &grayLevelPrecision);
   void setHeight(const double &height);
   void setMaxSizeSearchDistancePrecision(const double &maxSizeSearchDistancePrecision);
+  /*!
+    Activates the single pass search of the dots in searchDotsInArea().
+
+    Instead of testing the seeds of a grid and following the border of a
+    dot from each of them, the pixels of the area whose gray level is in
+    [getGrayLevelMin(), getGrayLevelMax()] are labeled in a single pass into
+    8-connected components. The bounding box of each component is compared
+    to the size of the wanted dot, and the Freeman chain, the surface and the
+    ellipsoid shape tests are only computed for the components that pass this
+    comparison. The surface is not compared during the labeling since the
+    pixel count of a dot with holes differs from the surface inside its
+    border. All the dots of the area are found, even the ones smaller than
+    the search grid.
+
+    This mode is much faster when many dots are searched, for instance on a
+    calibration grid.
+
+    \param activate : true to use the single pass search, false to use the
+    search grid (the default).
+  */
+  void setSinglePassSearch(const bool activate) { single_pass_search = activate; }
   void setSizePrecision(const double &sizePrecision);
   void setWidth(const double &width);
 
@@ -424,6 +468,8 @@ private:
   void init();
 
   bool computeParameters(const vpImage<unsigned char> &I, const double &u = -1.0, const double &v = -1.0);
+  void searchDotsInAreaSinglePass(const vpImage<unsigned char> &I, double area_center_u, double area_center_v,
+                                  std::list<vpDot2> &niceDots);
 
   bool findFirstBorder(const vpImage<unsigned char> &I, const unsigned int &u, const unsigned int &v,
                        unsigned int &border_u, unsigned int &border_v);
@@ -489,12 +535,13 @@ private:
   vpRect area;
 
   // other
-  std::list<unsigned int> direction_list;
-  std::list<vpImagePoint> ip_edges_list;
+  std::vector<unsigned int> direction_list;
+  std::vector<vpImagePoint> ip_edges_list;
 
   // flag
-  bool compute_moment; // true moment are computed
-  bool graphics;       // true for graphic overlay display
+  bool compute_moment;     // true moment are computed
+  bool graphics;           // true for graphic overlay display
+  bool single_pass_search; // true to search the dots in a single labeling pass
 
   unsigned int thickness; // Graphics thickness
 
@@ -0,0 +1,140 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Track many dots in parallel.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpDot2MultiTracker.h
+  \brief Track many dots in parallel.
+*/
+
+#ifndef vpDot2MultiTracker_hh
+#define vpDot2MultiTracker_hh
+
+#include <visp3/blob/vpDot2.h>
+
+#include <vector>
+
+/*!
+  \class vpDot2MultiTracker
+
+  \ingroup module_blob
+
+  \brief Track a set of vpDot2 blobs, the dots being tracked in parallel
+  when OpenMP is available.
+
+  Each dot is tracked with vpDot2::track(). A dot that can not be tracked in
+  the current image keeps its previous parameters and is reported by
+  isTracked(), instead of throwing an exception that would stop the tracking
+  of the other dots. It is tracked again from its previous position in the
+  next image.
+
+  When the graphics of a dot are activated with vpDot2::setGraphics(), the
+  dots are tracked sequentially since the displays are not thread safe. Use
+  display() after track() instead.
+
+  The dots are stored by value: a dot of a class derived from vpDot2 that is
+  given to addDot() or to the constructor is copied as a vpDot2, so that its
+  derived part is lost.
+
+  \code
+  vpDot2MultiTracker tracker;
+  for (size_t i = 0; i < dots.size(); i++) {
+    tracker.addDot(dots[i]); // dots already initialized with initTracking()
+  }
+  while (grab(I)) {
+    unsigned int nbTrackedDots = tracker.track(I);
+    for (unsigned int i = 0; i < tracker.getNbDots(); i++) {
+      if (tracker.isTracked(i)) {
+        vpImagePoint cog = tracker.getDot(i).getCog();
+      }
+    }
+  }
+  \endcode
+*/
+class VISP_EXPORT vpDot2MultiTracker
+{
+public:
+  vpDot2MultiTracker();
+  explicit vpDot2MultiTracker(const std::vector<vpDot2> &dots);
+
+  void addDot(const vpDot2 &dot);
+  void clear();
+  void display(const vpImage<unsigned char> &I, vpColor color = vpColor::red, unsigned int thickness = 1) const;
+
+  /*!
+    Return the dot \e i.
+  */
+  inline const vpDot2 &getDot(unsigned int i) const { return m_dots[i]; }
+  /*!
+    Return the dot \e i, to change its parameters.
+  */
+  inline vpDot2 &getDot(unsigned int i) { return m_dots[i]; }
+  /*!
+    Return all the dots.
+  */
+  inline const std::vector<vpDot2> &getDots() const { return m_dots; }
+  /*!
+    Return the number of dots.
+  */
+  inline unsigned int getNbDots() const { return (unsigned int)m_dots.size(); }
+  /*!
+    Return the number of threads used by track(), 0 meaning the OpenMP
+    default.
+  */
+  inline unsigned int getNbThreads() const { return m_nbThreads; }
+
+  /*!
+    Return true if the dot \e i was found in the last image given to
+    track().
+  */
+  inline bool isTracked(unsigned int i) const { return m_tracked[i] != 0; }
+
+  /*!
+    Set the number of threads used by track(), 0 (the default) meaning the
+    OpenMP default, usually the number of cores.
+  */
+  inline void setNbThreads(unsigned int nbThreads) { m_nbThreads = nbThreads; }
+
+  unsigned int track(const vpImage<unsigned char> &I);
+
+protected:
+  //! Tracked dots
+  std::vector<vpDot2> m_dots;
+  //! Number of threads, 0 for the OpenMP default
+  unsigned int m_nbThreads;
+  //! Tracking status of each dot in the last image
+  std::vector<unsigned char> m_tracked;
+};
+
+#endif
@@ -57,6 +57,37 @@
 #include <math.h>
 #include <visp3/blob/vpDot2.h>
 
+namespace
+{
+// Horizontal run of pixels with a good level, on row v between columns u_min and u_max
+struct vpDotRun {
+  unsigned int v;
+  unsigned int u_min;
+  unsigned int u_max;
+};
+
+unsigned int findRoot(std::vector<unsigned int> &parent, unsigned int i)
+{
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+// The root of a set of runs is its first run in raster order
+void mergeRuns(std::vector<unsigned int> &parent, unsigned int i, unsigned int j)
+{
+  i = findRoot(parent, i);
+  j = findRoot(parent, j);
+  if (i < j) {
+    parent[j] = i;
+  } else if (j < i) {
+    parent[i] = j;
+  }
+}
+}
+
 /******************************************************************************
  *
  *      CONSTRUCTORS AND DESTRUCTORS
@@ -95,6 +126,7 @@ void vpDot2::init()
 
   compute_moment = false;
   graphics = false;
+  single_pass_search = false;
   thickness = 1;
 }
 
@@ -106,7 +138,8 @@ vpDot2::vpDot2()
     surface(0), gray_level_min(128), gray_level_max(255), mean_gray_level(0), grayLevelPrecision(0.8), gamma(1.5),
     sizePrecision(0.65), ellipsoidShapePrecision(0.65), maxSizeSearchDistancePrecision(0.65),
     allowedBadPointsPercentage_(0.), area(), direction_list(), ip_edges_list(), compute_moment(false), graphics(false),
-    thickness(1), bbox_u_min(0), bbox_u_max(0), bbox_v_min(0), bbox_v_max(0), firstBorder_u(0), firstBorder_v()
+    single_pass_search(false), thickness(1), bbox_u_min(0), bbox_u_max(0), bbox_v_min(0), bbox_v_max(0),
+    firstBorder_u(0), firstBorder_v()
 {
 }
 
@@ -123,7 +156,8 @@ vpDot2::vpDot2(const vpImagePoint &ip)
     surface(0), gray_level_min(128), gray_level_max(255), mean_gray_level(0), grayLevelPrecision(0.8), gamma(1.5),
     sizePrecision(0.65), ellipsoidShapePrecision(0.65), maxSizeSearchDistancePrecision(0.65),
     allowedBadPointsPercentage_(0.), area(), direction_list(), ip_edges_list(), compute_moment(false), graphics(false),
-    thickness(1), bbox_u_min(0), bbox_u_max(0), bbox_v_min(0), bbox_v_max(0), firstBorder_u(0), firstBorder_v()
+    single_pass_search(false), thickness(1), bbox_u_min(0), bbox_u_max(0), bbox_v_min(0), bbox_v_max(0),
+    firstBorder_u(0), firstBorder_v()
 {
 }
 
@@ -135,8 +169,8 @@ vpDot2::vpDot2(const vpDot2 &twinDot)
     width(0), height(0), surface(0), gray_level_min(128), gray_level_max(255), mean_gray_level(0),
     grayLevelPrecision(0.8), gamma(1.5), sizePrecision(0.65), ellipsoidShapePrecision(0.65),
     maxSizeSearchDistancePrecision(0.65), allowedBadPointsPercentage_(0.), area(), direction_list(), ip_edges_list(),
-    compute_moment(false), graphics(false), thickness(1), bbox_u_min(0), bbox_u_max(0), bbox_v_min(0), bbox_v_max(0),
-    firstBorder_u(0), firstBorder_v()
+    compute_moment(false), graphics(false), single_pass_search(false), thickness(1), bbox_u_min(0), bbox_u_max(0),
+    bbox_v_min(0), bbox_v_max(0), firstBorder_u(0), firstBorder_v()
 {
   *this = twinDot;
 }
@@ -168,6 +202,7 @@ vpDot2 &vpDot2::operator=(const vpDot2 &twinDot)
 
   compute_moment = twinDot.compute_moment;
   graphics = twinDot.graphics;
+  single_pass_search = twinDot.single_pass_search;
   thickness = twinDot.thickness;
 
   bbox_u_min = twinDot.bbox_u_min;
@@ -212,7 +247,7 @@ vpDot2::~vpDot2() {}
 void vpDot2::display(const vpImage<unsigned char> &I, vpColor color, unsigned int t) const
 {
   vpDisplay::displayCross(I, cog, 3 * t + 8, color, t);
-  std::list<vpImagePoint>::const_iterator it;
+  std::vector<vpImagePoint>::const_iterator it;
 
   for (it = ip_edges_list.begin(); it != ip_edges_list.end(); ++it) {
     vpDisplay::displayPoint(I, *it, color);
@@ -991,6 +1026,11 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char> &I, int area_u, int a
   vpDisplay::displayRectangle(I, area, vpColor::blue);
   vpDisplay::flush(I);
 #endif
+  if (single_pass_search) {
+    searchDotsInAreaSinglePass(I, area_u + area_w / 2.0 - 0.5, area_v + area_h / 2.0 - 0.5, niceDots);
+    return;
+  }
+
   // start the search loop; for all points of the search grid,
   // test if the pixel belongs to a valid dot.
   // if it is so eventually add it to the vector of valid dots.
@@ -1060,7 +1100,7 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char> &I, int area_u, int a
       while (itbad != badDotsVector.end() && good_germ == true) {
         if ((double)u >= vpBAD_DOT_VALUE.bbox_u_min && (double)u <= vpBAD_DOT_VALUE.bbox_u_max &&
             (double)v >= vpBAD_DOT_VALUE.bbox_v_min && (double)v <= vpBAD_DOT_VALUE.bbox_v_max) {
-          std::list<vpImagePoint>::const_iterator it_edges = ip_edges_list.begin();
+          std::vector<vpImagePoint>::const_iterator it_edges = ip_edges_list.begin();
           while (it_edges != ip_edges_list.end() && good_germ == true) {
             // Test if the germ belong to a previously detected dot:
             // - from the germ go right to the border and compare this
@@ -1196,6 +1236,150 @@ void vpDot2::searchDotsInArea(const vpImage<unsigned char> &I, int area_u, int a
     delete dotToTest;
 }
 
+/*!
+
+  Search the dots of the area in a single pass, see setSinglePassSearch().
+
+  \param I : Image to process.
+  \param area_center_u : Coordinate (column) of the center of the input area.
+  \param area_center_v : Coordinate (row) of the center of the input area.
+  \param niceDots : List of the dots that are found, sorted by distance to the
+  center of the input area.
+*/
+void vpDot2::searchDotsInAreaSinglePass(const vpImage<unsigned char> &I, double area_center_u, double area_center_v,
+                                        std::list<vpDot2> &niceDots)
+{
+  unsigned int area_u_min = (unsigned int)area.getLeft();
+  unsigned int area_u_max = (unsigned int)area.getRight();
+  unsigned int area_v_min = (unsigned int)area.getTop();
+  unsigned int area_v_max = (unsigned int)area.getBottom();
+
+  // Extract the runs of pixels with a good level, and merge the runs that are
+  // 8-connected with a run of the previous row
+  std::vector<vpDotRun> runs;
+  std::vector<unsigned int> parent;
+  unsigned int prev_begin = 0, prev_end = 0;
+  for (unsigned int v = area_v_min; v <= area_v_max; v++) {
+    const unsigned char *row = I[v];
+    unsigned int begin = (unsigned int)runs.size();
+    unsigned int u = area_u_min;
+    while (u <= area_u_max) {
+      while (u <= area_u_max && (row[u] < gray_level_min || row[u] > gray_level_max)) {
+        u++;
+      }
+      if (u > area_u_max) {
+        break;
+      }
+
+      vpDotRun run;
+      run.v = v;
+      run.u_min = u;
+      while (u <= area_u_max && row[u] >= gray_level_min && row[u] <= gray_level_max) {
+        u++;
+      }
+      run.u_max = u - 1;
+      parent.push_back((unsigned int)runs.size());
+      runs.push_back(run);
+    }
+
+    unsigned int j = prev_begin;
+    for (unsigned int i = begin; i < runs.size(); i++) {
+      while (j < prev_end && runs[j].u_max + 1 < runs[i].u_min) {
+        j++;
+      }
+      for (unsigned int k = j; k < prev_end && runs[k].u_min <= runs[i].u_max + 1; k++) {
+        mergeRuns(parent, i, k);
+      }
+    }
+    prev_begin = begin;
+    prev_end = (unsigned int)runs.size();
+  }
+
+  // Bounding box of each component, stored in the first run of the component
+  // with the row of its last run
+  std::vector<vpDotRun> bboxes(runs);
+  std::vector<unsigned int> firstRuns;
+  for (unsigned int i = 0; i < runs.size(); i++) {
+    unsigned int root = findRoot(parent, i);
+    if (root == i) {
+      firstRuns.push_back(i);
+    } else {
+      bboxes[root].u_min = std::min(bboxes[root].u_min, runs[i].u_min);
+      bboxes[root].u_max = std::max(bboxes[root].u_max, runs[i].u_max);
+      bboxes[root].v = runs[i].v;
+    }
+  }
+
+  // The size of a component is the size of the dot that would be computed
+  // from its border, which allows to reject it before following its border
+  double size_precision = getSizePrecision();
+  double epsilon = 0.001;
+  bool check_size = std::fabs(getWidth()) > std::numeric_limits<double>::epsilon() &&
+                    std::fabs(getHeight()) > std::numeric_limits<double>::epsilon() &&
+                    std::fabs(getArea()) > std::numeric_limits<double>::epsilon() &&
+                    std::fabs(size_precision) > std::numeric_limits<double>::epsilon();
+
+  for (size_t c = 0; c < firstRuns.size(); c++) {
+    const vpDotRun &first_run = runs[firstRuns[c]];
+    double bbox_width = bboxes[firstRuns[c]].u_max - bboxes[firstRuns[c]].u_min + 1.0;
+    double bbox_height = bboxes[firstRuns[c]].v - first_run.v + 1.0;
+    if (check_size &&
+        (!(getWidth() * size_precision - epsilon < bbox_width) ||
+         !(bbox_width < getWidth() / (size_precision + epsilon)) ||
+         !(getHeight() * size_precision - epsilon < bbox_height) ||
+         !(bbox_height < getHeight() / (size_precision + epsilon)))) {
+      continue;
+    }
+
+    // The first run is on the outside border of the component
+    vpImagePoint germ;
+    germ.set_u(first_run.u_min);
+    germ.set_v(first_run.v);
+
+    vpDot2 *dotToTest = getInstance();
+    dotToTest->setCog(germ);
+    dotToTest->setGrayLevelMin(getGrayLevelMin());
+    dotToTest->setGrayLevelMax(getGrayLevelMax());
+    dotToTest->setGrayLevelPrecision(getGrayLevelPrecision());
+    dotToTest->setSizePrecision(getSizePrecision());
+    dotToTest->setGraphics(graphics);
+    dotToTest->setGraphicsThickness(thickness);
+    dotToTest->setComputeMoments(true);
+    dotToTest->setArea(area);
+    dotToTest->setEllipsoidShapePrecision(ellipsoidShapePrecision);
+    dotToTest->setEllipsoidBadPointsPercentage(allowedBadPointsPercentage_);
+
+    if (dotToTest->computeParameters(I) && dotToTest->isValid(I, *this)) {
+      // Insert the dot sorted by distance to the area center, unless a dot
+      // with the same center is already there. The whole list is checked
+      // since a close center is not necessarily at a close distance.
+      vpImagePoint cogDotToTest = dotToTest->getCog();
+      double thisDist = sqrt(vpMath::sqr(cogDotToTest.get_u() - area_center_u) +
+                             vpMath::sqr(cogDotToTest.get_v() - area_center_v));
+      std::list<vpDot2>::iterator itinsert = niceDots.end();
+      bool duplicate = false;
+      for (std::list<vpDot2>::iterator itnice = niceDots.begin(); itnice != niceDots.end() && !duplicate;
+           ++itnice) {
+        vpImagePoint cogTmpDot = itnice->getCog();
+        if (fabs(cogTmpDot.get_u() - cogDotToTest.get_u()) < 3.0 &&
+            fabs(cogTmpDot.get_v() - cogDotToTest.get_v()) < 3.0) {
+          duplicate = true;
+        } else if (itinsert == niceDots.end()) {
+          double otherDist = sqrt(vpMath::sqr(cogTmpDot.get_u() - area_center_u) +
+                                  vpMath::sqr(cogTmpDot.get_v() - area_center_v));
+          if (otherDist > thisDist) {
+            itinsert = itnice;
+          }
+        }
+      }
+      if (!duplicate) {
+        niceDots.insert(itinsert, *dotToTest);
+      }
+    }
+    delete dotToTest;
+  }
+}
+
 /*!
 
   Check if the dot is "like" the wanted dot passed in.
@@ -1509,7 +1693,20 @@ vpDot2 *vpDot2::getInstance() { return new vpDot2(); }
   - 6 : down
   - 7 : down right
 */
-void vpDot2::getFreemanChain(std::list<unsigned int> &freeman_chain) const { freeman_chain = direction_list; }
+void vpDot2::getFreemanChain(std::list<unsigned int> &freeman_chain) const
+{
+  freeman_chain.assign(direction_list.begin(), direction_list.end());
+}
+
+/*!
+
+  Returns the Freeman chain code used to turn around the dot
+  counterclockwise, without the copy in a list.
+
+  \param freeman_chain : Vector of Freeman chain code, see
+  getFreemanChain(std::list<unsigned int> &) const.
+*/
+void vpDot2::getFreemanChain(std::vector<unsigned int> &freeman_chain) const { freeman_chain = direction_list; }
 
 /******************************************************************************
  *
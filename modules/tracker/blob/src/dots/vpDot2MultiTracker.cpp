@@ -0,0 +1,145 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Track many dots in parallel.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpDot2MultiTracker.cpp
+  \brief Track many dots in parallel.
+*/
+
+#include <visp3/blob/vpDot2MultiTracker.h>
+#include <visp3/core/vpDisplay.h>
+
+#ifdef VISP_HAVE_OPENMP
+#include <omp.h>
+#endif
+
+/*!
+  Default constructor, without dots.
+*/
+vpDot2MultiTracker::vpDot2MultiTracker() : m_dots(), m_nbThreads(0), m_tracked() {}
+
+/*!
+  Constructor from dots already initialized with vpDot2::initTracking().
+
+  \param dots : Dots to track.
+*/
+vpDot2MultiTracker::vpDot2MultiTracker(const std::vector<vpDot2> &dots)
+  : m_dots(dots), m_nbThreads(0), m_tracked(dots.size(), 1)
+{
+}
+
+/*!
+  Add a dot to track.
+
+  \param dot : Dot already initialized with vpDot2::initTracking().
+*/
+void vpDot2MultiTracker::addDot(const vpDot2 &dot)
+{
+  m_dots.push_back(dot);
+  m_tracked.push_back(1);
+}
+
+/*!
+  Remove all the dots.
+*/
+void vpDot2MultiTracker::clear()
+{
+  m_dots.clear();
+  m_tracked.clear();
+}
+
+/*!
+  Display the edges and the center of gravity of the dots tracked in the last
+  image.
+
+  \param I : Image.
+  \param color : The color used for the display.
+  \param thickness : Thickness of the displayed cross located at the dot cog.
+*/
+void vpDot2MultiTracker::display(const vpImage<unsigned char> &I, vpColor color, unsigned int thickness) const
+{
+  for (size_t i = 0; i < m_dots.size(); i++) {
+    if (m_tracked[i]) {
+      m_dots[i].display(I, color, thickness);
+    }
+  }
+}
+
+/*!
+  Track all the dots in a new image, in parallel when OpenMP is available.
+
+  \param I : Image.
+
+  \return The number of dots that were tracked, see isTracked() to know which
+  ones.
+*/
+unsigned int vpDot2MultiTracker::track(const vpImage<unsigned char> &I)
+{
+  bool graphics = false;
+  for (size_t i = 0; i < m_dots.size(); i++) {
+    graphics = graphics || m_dots[i].getGraphics();
+  }
+
+#ifdef VISP_HAVE_OPENMP
+  int nbThreads = graphics ? 1 : (m_nbThreads > 0 ? (int)m_nbThreads : omp_get_max_threads());
+#pragma omp parallel num_threads(nbThreads)
+#endif
+  {
+    // The dot keeps its previous parameters when it is lost. The copy reuses
+    // the memory of the border of the previous dot copied by this thread.
+    vpDot2 previousDot;
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp for schedule(dynamic)
+#endif
+    for (int i = 0; i < (int)m_dots.size(); i++) {
+      previousDot = m_dots[(size_t)i];
+      try {
+        m_dots[(size_t)i].track(I);
+        m_tracked[(size_t)i] = 1;
+      } catch (const vpException &) {
+        m_dots[(size_t)i] = previousDot;
+        m_tracked[(size_t)i] = 0;
+      }
+    }
+  }
+
+  unsigned int nbTrackedDots = 0;
+  for (size_t i = 0; i < m_tracked.size(); i++) {
+    nbTrackedDots += m_tracked[i];
+  }
+
+  return nbTrackedDots;
+}
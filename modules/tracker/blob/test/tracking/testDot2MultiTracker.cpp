@@ -0,0 +1,144 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the tracking of many dots in parallel.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testDot2MultiTracker.cpp
+
+  Track a grid of moving synthetic dots with vpDot2MultiTracker and compare
+  with the tracking of each dot with vpDot2, one dot disappearing in some
+  images.
+*/
+
+#include <cstdlib>
+#include <iostream>
+
+#include <visp3/blob/vpDot2MultiTracker.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+
+namespace
+{
+// 10 x 8 white dots of radius 8 on a black background, translated by
+// (du, dv), the dot lost_dot being hidden
+void drawDots(vpImage<unsigned char> &I, double du, double dv, int lost_dot)
+{
+  const int radius = 8;
+  I.resize(480, 640, 0);
+  for (int r = 0; r < 8; r++) {
+    for (int c = 0; c < 10; c++) {
+      if (r * 10 + c == lost_dot) {
+        continue;
+      }
+      double cu = 60 + c * 55 + du, cv = 60 + r * 50 + dv;
+      for (int v = (int)cv - radius - 1; v <= (int)cv + radius + 1; v++) {
+        for (int u = (int)cu - radius - 1; u <= (int)cu + radius + 1; u++) {
+          if (vpMath::sqr(u - cu) + vpMath::sqr(v - cv) <= radius * radius) {
+            I[(unsigned int)v][(unsigned int)u] = 230;
+          }
+        }
+      }
+    }
+  }
+}
+}
+
+int main()
+{
+  vpImage<unsigned char> I;
+  drawDots(I, 0, 0, -1);
+
+  std::vector<vpDot2> dots;
+  for (int r = 0; r < 8; r++) {
+    for (int c = 0; c < 10; c++) {
+      vpDot2 dot;
+      dot.setGraphics(false);
+      dot.initTracking(I, vpImagePoint(60 + r * 50, 60 + c * 55));
+      dots.push_back(dot);
+    }
+  }
+
+  vpDot2MultiTracker tracker(dots);
+  tracker.setNbThreads(4);
+  const int lost_dot = 23;
+  double t_dots = 0, t_tracker = 0;
+  for (int k = 1; k <= 20; k++) {
+    // The dot lost_dot is hidden in images 8 and 9
+    bool hidden = (k == 8 || k == 9);
+    drawDots(I, 1.3 * k, 0.7 * k, hidden ? lost_dot : -1);
+
+    double t = vpTime::measureTimeMs();
+    for (size_t i = 0; i < dots.size(); i++) {
+      try {
+        dots[i].track(I);
+      } catch (const vpException &) {
+        if (i != (size_t)lost_dot || !hidden) {
+          std::cerr << "Dot " << i << " lost in image " << k << std::endl;
+          return EXIT_FAILURE;
+        }
+        dots[i] = tracker.getDot((unsigned int)i);
+      }
+    }
+    t_dots += vpTime::measureTimeMs() - t;
+
+    t = vpTime::measureTimeMs();
+    unsigned int nb_tracked_dots = tracker.track(I);
+    t_tracker += vpTime::measureTimeMs() - t;
+
+    if (nb_tracked_dots != (hidden ? dots.size() - 1 : dots.size())) {
+      std::cerr << "Wrong number of tracked dots " << nb_tracked_dots << " in image " << k << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int i = 0; i < tracker.getNbDots(); i++) {
+      if (tracker.isTracked(i) == (hidden && i == lost_dot)) {
+        std::cerr << "Wrong tracking status of the dot " << i << " in image " << k << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (tracker.getDot(i).getCog() != dots[i].getCog() || tracker.getDot(i).getArea() != dots[i].getArea()) {
+        std::cerr << "Dot " << i << " differs from vpDot2 in image " << k << std::endl;
+        return EXIT_FAILURE;
+      }
+      vpImagePoint cog(60 + (i / 10) * 50 + 0.7 * k, 60 + (i % 10) * 55 + 1.3 * k);
+      if (tracker.isTracked(i) && vpImagePoint::distance(tracker.getDot(i).getCog(), cog) > 0.5) {
+        std::cerr << "Dot " << i << " too far from its position in image " << k << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  std::cout << "Tracking of " << dots.size() << " dots in " << t_dots / 20 << " ms with vpDot2, "
+            << t_tracker / 20 << " ms with vpDot2MultiTracker" << std::endl;
+  std::cout << "testDot2MultiTracker is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,154 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the search of many dots with vpDot2.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testDot2SearchDots.cpp
+
+  Search the dots of a synthetic calibration grid with vpDot2, with the
+  search grid and with the single pass search, and compare the results.
+*/
+
+#include <cstdlib>
+#include <iostream>
+
+#include <visp3/blob/vpDot2.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+
+namespace
+{
+bool findDot(const std::list<vpDot2> &dots, const vpDot2 &dot)
+{
+  for (std::list<vpDot2>::const_iterator it = dots.begin(); it != dots.end(); ++it) {
+    if (vpMath::equal(it->getCog().get_u(), dot.getCog().get_u(), 1e-6) &&
+        vpMath::equal(it->getCog().get_v(), dot.getCog().get_v(), 1e-6) &&
+        vpMath::equal(it->getArea(), dot.getArea(), 1e-6) && it->getBBox() == dot.getBBox()) {
+      return true;
+    }
+  }
+  return false;
+}
+}
+
+int main()
+{
+  // 20 x 12 white dots of radius 9 on a black background, with a few
+  // smaller and larger blobs that should be rejected
+  const unsigned int nb_cols = 20, nb_rows = 12, step = 40, radius = 9;
+  vpImage<unsigned char> I(nb_rows * step + 80, nb_cols * step + 40, 0);
+  std::vector<vpImagePoint> centers;
+  for (unsigned int r = 0; r < nb_rows; r++) {
+    for (unsigned int c = 0; c < nb_cols; c++) {
+      // Sub-pixel centers
+      vpImagePoint center(40 + r * step + 0.3 * (c % 3), 40 + c * step + 0.25 * (r % 4));
+      centers.push_back(center);
+      for (int i = -(int)radius - 1; i <= (int)radius + 1; i++) {
+        for (int j = -(int)radius - 1; j <= (int)radius + 1; j++) {
+          int y = vpMath::round(center.get_i()) + i, x = vpMath::round(center.get_j()) + j;
+          if (vpMath::sqr(y - center.get_i()) + vpMath::sqr(x - center.get_j()) <= radius * radius) {
+            I[(unsigned int)y][(unsigned int)x] = 255;
+          }
+        }
+      }
+    }
+  }
+  for (unsigned int k = 0; k < nb_cols; k++) {
+    I[20 + 3 * (k % 2)][60 + k * step] = 255;
+  }
+  for (unsigned int i = 0; i < 30; i++) {
+    for (unsigned int j = 0; j < 60; j++) {
+      I[I.getHeight() - 35 + i][20 + j] = 200;
+    }
+  }
+
+  vpDot2 wanted;
+  wanted.setGrayLevelMin(150);
+  wanted.setGrayLevelMax(255);
+  wanted.setWidth(2 * radius + 1);
+  wanted.setHeight(2 * radius + 1);
+  wanted.setArea(M_PI * radius * radius);
+  wanted.setGrayLevelPrecision(0.8);
+  wanted.setSizePrecision(0.65);
+  wanted.setEllipsoidShapePrecision(0.65);
+
+  std::list<vpDot2> dots_grid, dots_single_pass;
+  double t = vpTime::measureTimeMs();
+  wanted.searchDotsInArea(I, dots_grid);
+  double t_grid = vpTime::measureTimeMs() - t;
+
+  wanted.setSinglePassSearch(true);
+  t = vpTime::measureTimeMs();
+  wanted.searchDotsInArea(I, dots_single_pass);
+  double t_single_pass = vpTime::measureTimeMs() - t;
+  std::cout << dots_grid.size() << " dots found with the search grid in " << t_grid << " ms, "
+            << dots_single_pass.size() << " dots found in a single pass in " << t_single_pass << " ms" << std::endl;
+
+  if (dots_single_pass.size() != centers.size()) {
+    std::cerr << "Wrong number of dots: " << dots_single_pass.size() << " instead of " << centers.size() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // Same dots as with the search grid
+  for (std::list<vpDot2>::const_iterator it = dots_grid.begin(); it != dots_grid.end(); ++it) {
+    if (!findDot(dots_single_pass, *it)) {
+      std::cerr << "Dot " << it->getCog() << " found with the search grid and not in a single pass" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Sorted by distance to the image center, and close to the drawn centers
+  vpImagePoint image_center((I.getHeight() - 1) / 2., (I.getWidth() - 1) / 2.);
+  double prev_dist = 0;
+  for (std::list<vpDot2>::const_iterator it = dots_single_pass.begin(); it != dots_single_pass.end(); ++it) {
+    double dist = vpImagePoint::distance(it->getCog(), image_center);
+    if (dist < prev_dist) {
+      std::cerr << "Dots not sorted by distance to the area center" << std::endl;
+      return EXIT_FAILURE;
+    }
+    prev_dist = dist;
+
+    double min_dist = std::numeric_limits<double>::max();
+    for (size_t k = 0; k < centers.size(); k++) {
+      min_dist = std::min(min_dist, vpImagePoint::distance(it->getCog(), centers[k]));
+    }
+    if (min_dist > 0.5) {
+      std::cerr << "Dot " << it->getCog() << " too far from the drawn dots" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "testDot2SearchDots is ok" << std::endl;
+  return EXIT_SUCCESS;
+}
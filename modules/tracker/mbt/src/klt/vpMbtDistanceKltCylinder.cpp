@@ -285,19 +285,25 @@ void vpMbtDistanceKltCylinder::computeInteractionMatrixAndResidu(const vpHomogen
 
   cylinder.changeFrame(_cMc0 * c0Mo);
 
+  // Project all the initial 3D points at once
+  unsigned int nbPoints = static_cast<unsigned int>(curPoints.size());
+  std::vector<double> oX(nbPoints), oY(nbPoints), oZ(nbPoints), x0(nbPoints), y0(nbPoints);
   std::map<int, vpImagePoint>::const_iterator iter = curPoints.begin();
-  for (; iter != curPoints.end(); ++iter) {
-    int id(iter->first);
+  for (unsigned int k = 0; iter != curPoints.end(); ++iter, k++) {
+    const vpPoint &p0 = initPoints3D[iter->first];
+    oX[k] = p0.get_oX();
+    oY[k] = p0.get_oY();
+    oZ[k] = p0.get_oZ();
+  }
+  vpPoint::projectPoints(_cMc0, nbPoints, oX.data(), oY.data(), oZ.data(), x0.data(), y0.data());
+
+  for (iter = curPoints.begin(); iter != curPoints.end(); ++iter) {
     double i_cur(iter->second.get_i()), j_cur(iter->second.get_j());
 
     double x_cur(0), y_cur(0);
     vpPixelMeterConversion::convertPoint(cam, j_cur, i_cur, x_cur, y_cur);
 
-    vpPoint p0 = initPoints3D[id];
-    p0.changeFrame(_cMc0);
-    p0.project();
-
-    double x0_transform(p0.get_x()), y0_transform(p0.get_y());
+    double x0_transform(x0[index_]), y0_transform(y0[index_]);
 
     double Z = computeZ(x_cur, y_cur);
 
@@ -0,0 +1,194 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Matching of binary descriptors with the Hamming distance.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpHammingMatcher.h
+  \brief Matching of binary descriptors with the Hamming distance.
+*/
+
+#ifndef _vpHammingMatcher_h_
+#define _vpHammingMatcher_h_
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \class vpHammingMatcher
+  \ingroup group_vision_keypoints
+
+  \brief Find the two nearest neighbors of binary descriptors (ORB, BRISK,
+  FREAK, ...) using the Hamming distance.
+
+  The train descriptors are copied in a contiguous buffer where each row is
+  padded to a multiple of 64 bits. The distances are computed with AVX2 or
+  POPCNT instructions when the CPU supports them, whatever the build flags.
+  The query descriptors are processed by blocks in parallel when OpenMP is
+  available.
+
+  Two search methods are available:
+  - vpHammingMatcher::BRUTE_FORCE compares each query descriptor with all the
+    train descriptors. The train set is scanned by tiles that fit in the cache
+    and the computation of a distance stops as soon as it exceeds the distance
+    of the current second nearest neighbor.
+  - vpHammingMatcher::MULTI_INDEX_HASHING splits the descriptors in 16 bits
+    substrings, each substring being indexed in a hash table \cite Norouzi12.
+    The buckets are probed with an increasing radius and the search stops as
+    soon as the two nearest neighbors are known, or as soon as the ratio test
+    is guaranteed to succeed. The result is exact unless the search radius
+    limit given by setMaxSearchRadius() is reached, in which case the best
+    candidates found so far are returned. When less than two candidates are
+    found, the query is matched by brute force.
+
+  \code
+#include <visp3/vision/vpHammingMatcher.h>
+
+int main()
+{
+  std::vector<unsigned char> train(1000 * 32), query(10 * 32);
+  // Fill the descriptors
+  vpHammingMatcher matcher(vpHammingMatcher::MULTI_INDEX_HASHING);
+  matcher.setRatioThreshold(0.8);
+  matcher.train(&train[0], 1000, 32);
+
+  std::vector<vpHammingMatcher::vpHammingMatch> matches;
+  matcher.match(&query[0], 10, 32, matches);
+}
+  \endcode
+*/
+class VISP_EXPORT vpHammingMatcher
+{
+public:
+  typedef enum {
+    BRUTE_FORCE,        /*!< Exhaustive search. */
+    MULTI_INDEX_HASHING /*!< Multi-index hashing of 16 bits substrings. */
+  } vpHammingIndexType;
+
+  /*!
+    The two nearest neighbors of a query descriptor. An index is equal to -1
+    when there is no corresponding train descriptor.
+  */
+  struct vpHammingMatch {
+    int trainIdx;                //!< Index of the nearest train descriptor
+    unsigned int distance;       //!< Distance to the nearest train descriptor
+    int secondTrainIdx;          //!< Index of the second nearest train descriptor
+    unsigned int secondDistance; //!< Distance to the second nearest train descriptor
+  };
+
+  explicit vpHammingMatcher(const vpHammingIndexType &type = BRUTE_FORCE);
+
+  void clear();
+
+  static unsigned int distance(const unsigned char *a, const unsigned char *b, unsigned int descriptorSize);
+
+  /*!
+    \return The size in bytes of the train descriptors.
+  */
+  inline unsigned int getDescriptorSize() const { return m_descriptorSize; }
+  /*!
+    \return The search method.
+  */
+  inline vpHammingIndexType getIndexType() const { return m_indexType; }
+  /*!
+    \return The maximal radius used to probe the buckets of the hash tables.
+  */
+  inline unsigned int getMaxSearchRadius() const { return m_maxSearchRadius; }
+  /*!
+    \return The number of train descriptors.
+  */
+  inline unsigned int getNbTrainDescriptors() const { return m_nbTrain; }
+  /*!
+    \return The ratio threshold used to stop the search early.
+  */
+  inline double getRatioThreshold() const { return m_ratioThreshold; }
+
+  void match(const unsigned char *queryDescriptors, unsigned int nbQueryDescriptors, size_t queryStep,
+             std::vector<vpHammingMatch> &matches) const;
+
+  void setIndexType(const vpHammingIndexType &type);
+  /*!
+    Set the maximal radius used to probe the buckets of the hash tables with
+    vpHammingMatcher::MULTI_INDEX_HASHING. Each increment multiplies the
+    number of probed buckets by about 16 / radius. A radius of 16 gives an
+    exact search.
+
+    \param radius : Maximal search radius, between 0 and 16.
+  */
+  inline void setMaxSearchRadius(const unsigned int radius) { m_maxSearchRadius = (radius > 16 ? 16 : radius); }
+  /*!
+    Set the ratio threshold of the nearest neighbor distance ratio test that
+    is applied after the matching. With multi-index hashing, the search of a
+    query stops as soon as the ratio between the nearest and the second
+    nearest distances is known to be below this threshold; the second
+    nearest neighbor returned is then only an upper bound. A value outside
+    ]0, 1[ disables this early exit.
+
+    \param ratio : Ratio threshold.
+  */
+  inline void setRatioThreshold(const double ratio) { m_ratioThreshold = ratio; }
+
+  void train(const unsigned char *trainDescriptors, unsigned int nbTrainDescriptors, unsigned int descriptorSize,
+             size_t trainStep = 0);
+
+private:
+  void buildIndex();
+  void matchBruteForce(const unsigned char *queryDescriptors, unsigned int nbQueryDescriptors, size_t queryStep,
+                       std::vector<vpHammingMatch> &matches) const;
+  void matchMultiIndex(const unsigned char *queryDescriptors, unsigned int nbQueryDescriptors, size_t queryStep,
+                       std::vector<vpHammingMatch> &matches) const;
+
+  //! Search method
+  vpHammingIndexType m_indexType;
+  //! Maximal radius used to probe the hash tables
+  unsigned int m_maxSearchRadius;
+  //! Ratio threshold used to stop the search early
+  double m_ratioThreshold;
+  //! Size of a descriptor in bytes
+  unsigned int m_descriptorSize;
+  //! Size of a padded descriptor in 64 bits words
+  unsigned int m_nbWords;
+  //! Number of train descriptors
+  unsigned int m_nbTrain;
+  //! Padded train descriptors
+  std::vector<unsigned long long> m_train;
+  //! Number of hash tables, one per 16 bits substring
+  unsigned int m_nbTables;
+  //! First index in m_bucketIds of each bucket, 65537 values per table
+  std::vector<unsigned int> m_bucketOffsets;
+  //! Train indexes sorted by bucket, m_nbTrain values per table
+  std::vector<unsigned int> m_bucketIds;
+};
+
+#endif
@@ -275,7 +275,8 @@ public:
 
   static bool ransac(const std::vector<double> &xb, const std::vector<double> &yb, const std::vector<double> &xa,
                      const std::vector<double> &ya, vpHomography &aHb, std::vector<bool> &inliers, double &residual,
-                     unsigned int nbInliersConsensus, double threshold, bool normalization = true);
+                     unsigned int nbInliersConsensus, double threshold, bool normalization = true,
+                     bool useParallelRansac = false);
 
   static vpImagePoint project(const vpCameraParameters &cam, const vpHomography &bHa, const vpImagePoint &iPa);
   static vpPoint project(const vpHomography &bHa, const vpPoint &Pa);
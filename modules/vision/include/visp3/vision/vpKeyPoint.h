@@ -55,6 +55,7 @@
 #include <visp3/core/vpPlane.h>
 #include <visp3/core/vpPoint.h>
 #include <visp3/vision/vpBasicKeyPoint.h>
+#include <visp3/vision/vpHammingMatcher.h>
 #include <visp3/vision/vpPose.h>
 #ifdef VISP_HAVE_MODULE_IO
 #  include <visp3/io/vpImageIo.h>
@@ -704,6 +705,8 @@ public:
 #endif
 
   void loadLearningData(const std::string &filename, const bool binaryMode = false, const bool append = false);
+  void loadLearningDatabase(const std::string &filename, const bool append = false);
+  void loadLearningDatabase(const std::string &filename, const std::vector<int> &imageIds, const bool append = false);
 
   void match(const cv::Mat &trainDescriptors, const cv::Mat &queryDescriptors, std::vector<cv::DMatch> &matches,
              double &elapsedTime);
@@ -743,6 +746,8 @@ public:
 
   void saveLearningData(const std::string &filename, const bool binaryMode = false,
                         const bool saveTrainingImages = true);
+  void saveLearningDatabase(const std::string &filename, const bool append = false,
+                            const bool saveTrainingImages = true);
 
   /*!
     Set if the covariance matrix has to be computed in the Virtual Visual
@@ -771,6 +776,53 @@ public:
    */
   inline void setDetectionMethod(const vpDetectionMethodType &method) { m_detectionMethod = method; }
 
+  /*!
+     Limit the number of detected keypoints with a grid based non-maximum
+     suppression: the image is divided in square cells and only the keypoints
+     with the highest responses are kept in each cell. This spreads the
+     keypoints over the image and bounds the cost of the extraction and of
+     the matching.
+
+     \param cellSize : Size of a cell in pixels, 0 to disable the grid.
+     \param maxKeyPointsPerCell : Maximum number of keypoints kept in a cell.
+     \param maxKeyPoints : Maximum number of keypoints kept in the image
+     after the grid filtering, 0 for no limit.
+   */
+  inline void setDetectionGrid(const unsigned int cellSize, const unsigned int maxKeyPointsPerCell,
+                               const unsigned int maxKeyPoints = 0)
+  {
+    m_gridCellSize = cellSize;
+    m_gridMaxKeyPointsPerCell = maxKeyPointsPerCell;
+    m_maxKeyPoints = maxKeyPoints;
+  }
+
+  /*!
+     Split the image in tiles where the keypoints are detected in parallel,
+     each thread using its own detector instances. A keypoint is kept by the
+     tile whose interior contains it, the tiles being enlarged by \p overlap
+     pixels so that the detectors see the neighborhood of the keypoints close
+     to the tile borders.
+
+     \param nbTilesX : Number of tiles along the image width.
+     \param nbTilesY : Number of tiles along the image height.
+     \param overlap : Number of pixels added around each tile.
+
+     \note The detector instances of the threads are created with the
+     parameters of the detectors returned by getDetector() when they can be
+     serialized by OpenCV, otherwise with their default parameters. They are
+     kept between the detections, call again this function to take into
+     account parameters modified afterwards through getDetector().
+   */
+  inline void setDetectionTiles(const unsigned int nbTilesX, const unsigned int nbTilesY,
+                                const unsigned int overlap = 32)
+  {
+    m_detectionTilesX = (std::max)(1u, nbTilesX);
+    m_detectionTilesY = (std::max)(1u, nbTilesY);
+    m_detectionTileOverlap = overlap;
+    m_threadDetectors.clear();
+    m_threadExtractors.clear();
+  }
+
   /*!
      Set and initialize a detector.
 
@@ -812,6 +864,7 @@ public:
     if (m_detectors.find(detectorName) != m_detectors.end()) {
       m_detectors[detectorName]->set(parameterName, value);
     }
+    m_threadDetectors.clear();
   }
 #endif
 
@@ -871,6 +924,7 @@ public:
     if (m_extractors.find(extractorName) != m_extractors.end()) {
       m_extractors[extractorName]->set(parameterName, value);
     }
+    m_threadExtractors.clear();
   }
 #endif
 
@@ -903,11 +957,22 @@ public:
        - BruteForce-Hamming
        - BruteForce-Hamming(2)
        - FlannBased
+       - vpBruteForce-Hamming (ViSP exhaustive search, see vpHammingMatcher)
+       - vpMultiIndex-Hamming (ViSP multi-index hashing, see vpHammingMatcher)
 
      L1 and L2 norms are preferable choices for SIFT and SURF descriptors,
      NORM_HAMMING should be used with ORB, BRISK and BRIEF, NORM_HAMMING2
      should be used with ORB when WTA_K==3 or 4.
 
+     The vpBruteForce-Hamming and vpMultiIndex-Hamming matchers are
+     dedicated to binary descriptors (ORB, BRISK, FREAK, ...). They use SIMD
+     Hamming distances and process the query descriptors in parallel. With
+     ratioDistanceThreshold or stdAndRatioDistanceThreshold filtering, the
+     multi-index hashing search of a query stops as soon as the ratio test is
+     known to succeed, which makes it suited to large train sets. They are
+     not used when matching the train descriptors to the query descriptors
+     (see setMatchingTrainToQuery()).
+
      \param matcherName : Name of the matcher.
    */
   inline void setMatcher(const std::string &matcherName)
@@ -960,6 +1025,46 @@ public:
     }
   }
 
+  /*!
+     Enable the guided matching in matchPoint() methods that compute the
+     pose. When the pose of the previous image is known, the train 3D points
+     are projected with this pose and each query keypoint is only matched
+     with the train keypoints whose projection lies within \p radius pixels.
+     This reduces the matching cost and the ratio of outliers given to the
+     pose estimation when the object moves slowly between two images.
+
+     The pose used for the projection is the last one successfully estimated
+     by matchPoint(), or the one given with setGuidedMatchingPose(). When the
+     pose estimation fails after a guided matching, the query descriptors
+     already extracted are matched against all the train keypoints.
+
+     With the ratio test, a query keypoint is rejected when less than two
+     train keypoints are found in its search region.
+
+     \param guided : If true, use the guided matching.
+     \param radius : Search radius in pixels.
+   */
+  inline void setGuidedMatching(const bool guided, const double radius = 20.0)
+  {
+    m_useGuidedMatching = guided;
+    m_guidedMatchingRadius = radius;
+  }
+
+  /*!
+     Set the pose used to project the train 3D points for the next guided
+     matching, for instance a pose given by a tracker.
+
+     \param cMo : Homogeneous matrix between the object frame and the
+     camera frame.
+
+     \sa setGuidedMatching()
+   */
+  inline void setGuidedMatchingPose(const vpHomogeneousMatrix &cMo)
+  {
+    m_guidedMatchingPose = cMo;
+    m_guidedMatchingPoseValid = true;
+  }
+
   /*!
     Set the factor value for the filtering method:
     constantFactorDistanceThreshold.
@@ -1164,6 +1269,43 @@ public:
   inline void setUseSingleMatchFilter(const bool singleMatchFilter) { m_useSingleMatchFilter = singleMatchFilter; }
 
 private:
+  /*!
+    Memory holding a learning database loaded with loadLearningDatabase().
+    The train descriptors point directly into this memory, that is mapped
+    from the file when possible.
+  */
+  struct vpLearningDatabaseMemory {
+    vpLearningDatabaseMemory() : m_data(NULL), m_size(0), m_mapped(false) {}
+    ~vpLearningDatabaseMemory();
+
+    char *m_data;
+    size_t m_size;
+    bool m_mapped;
+
+  private:
+    vpLearningDatabaseMemory(const vpLearningDatabaseMemory &);
+    vpLearningDatabaseMemory &operator=(const vpLearningDatabaseMemory &);
+  };
+
+  /*!
+    Location in a learning database of the train keypoints, that allows
+    saveLearningDatabase() to only write the new keypoints in append mode.
+  */
+  struct vpLearningDatabaseLocation {
+    vpLearningDatabaseLocation() : m_filename(), m_first(0), m_size(0), m_classIdOffset(0), m_imageIdOffset(0) {}
+
+    //! Learning database, empty if the train keypoints are not stored in a database
+    std::string m_filename;
+    //! Index in the database of the first train keypoint
+    int m_first;
+    //! Number of train keypoints stored in the database
+    int m_size;
+    //! Offset from the class id of a train keypoint to its class id in the database
+    int m_classIdOffset;
+    //! Offset from a training image id to its id in the database
+    int m_imageIdOffset;
+  };
+
   //! If true, compute covariance matrix if the user select the pose
   //! estimation method using ViSP
   bool m_computeCovariance;
@@ -1179,6 +1321,12 @@ private:
   //! Detection threshold based on average of descriptor distances to decide
   //! if the object is present or not.
   double m_detectionThreshold;
+  //! Number of pixels added around the detection tiles.
+  unsigned int m_detectionTileOverlap;
+  //! Number of detection tiles along the image width.
+  unsigned int m_detectionTilesX;
+  //! Number of detection tiles along the image height.
+  unsigned int m_detectionTilesY;
   //! Elapsed time to detect keypoints.
   double m_detectionTime;
   //! List of detector names.
@@ -1199,6 +1347,19 @@ private:
   std::vector<cv::DMatch> m_filteredMatches;
   //! Chosen method of filtering to eliminate false matching.
   vpFilterMatchingType m_filterType;
+  //! Size of the cells of the grid non-maximum suppression, 0 if disabled.
+  unsigned int m_gridCellSize;
+  //! Maximum number of keypoints kept in a cell of the grid.
+  unsigned int m_gridMaxKeyPointsPerCell;
+  //! Pose used to project the train 3D points for the guided matching.
+  vpHomogeneousMatrix m_guidedMatchingPose;
+  //! True if m_guidedMatchingPose can be used.
+  bool m_guidedMatchingPoseValid;
+  //! Search radius in pixels for the guided matching.
+  double m_guidedMatchingRadius;
+  //! Matcher used with the vpBruteForce-Hamming and vpMultiIndex-Hamming
+  //! matcher names.
+  vpHammingMatcher m_hammingMatcher;
   //! Image format to use when saving the training images
   vpImageFormatType m_imageFormat;
   //! List of k-nearest neighbors for each detected keypoints (if the method
@@ -1229,6 +1390,9 @@ private:
   double m_matchingTime;
   //! List of pairs between the keypoint and the 3D point after the Ransac.
   std::vector<std::pair<cv::KeyPoint, cv::Point3f> > m_matchRansacKeyPointsToPoints;
+  //! Maximum number of keypoints kept after the grid filtering, 0 for no
+  //! limit.
+  unsigned int m_maxKeyPoints;
   //! Maximum number of iterations for the Ransac method.
   int m_nbRansacIterations;
   //! Minimum number of inliers for the Ransac method.
@@ -1264,6 +1428,12 @@ private:
   //! Maximum error (in meter for the ViSP method) to decide if a point is an
   //! inlier or not.
   double m_ransacThreshold;
+  //! Detectors of each thread for the parallel detection, the first thread
+  //! using m_detectors.
+  std::vector<std::map<std::string, cv::Ptr<cv::FeatureDetector> > > m_threadDetectors;
+  //! Extractors of each thread for the parallel extraction, the first thread
+  //! using m_extractors.
+  std::vector<std::map<std::string, cv::Ptr<cv::DescriptorExtractor> > > m_threadExtractors;
   //! Matrix of descriptors (each row contains the descriptors values for each
   //! keypoints
   // detected in the train images).
@@ -1288,6 +1458,10 @@ private:
   //! Flag set if a percentage value is used to determine the number of
   //! inliers for the Ransac method.
   bool m_useConsensusPercentage;
+  //! If true, use the guided matching when the previous pose is known.
+  bool m_useGuidedMatching;
+  //! If true, match with m_hammingMatcher instead of m_matcher.
+  bool m_useHammingMatcher;
   //! Flag set if a knn matching method must be used.
   bool m_useKnn;
   //! Flag set if we want to match the train keypoints to the query keypoints,
@@ -1302,9 +1476,29 @@ private:
   bool m_useSingleMatchFilter;
   //! Grayscale image buffer, used when passing color images
   vpImage<unsigned char> m_I;
+  //! Learning database the train descriptors may point to, shared between copies
+  cv::Ptr<vpLearningDatabaseMemory> m_learningDatabase;
+  //! Learning database storing the first train keypoints
+  vpLearningDatabaseLocation m_learningDatabaseLocation;
 
   void affineSkew(double tilt, double phi, cv::Mat &img, cv::Mat &mask, cv::Mat &Ai);
 
+  void computeDescriptors(const std::map<std::string, cv::Ptr<cv::DescriptorExtractor> > &extractors,
+                          const cv::Mat &matImg, std::vector<cv::KeyPoint> &keyPoints, cv::Mat &descriptors,
+                          std::vector<cv::Point3f> *trainPoints);
+
+  void detectKeyPoints(const std::map<std::string, cv::Ptr<cv::FeatureDetector> > &detectors, const cv::Mat &matImg,
+                       std::vector<cv::KeyPoint> &keyPoints, const cv::Mat &mask);
+
+  void gridFilter(std::vector<cv::KeyPoint> &keyPoints, const cv::Size &imageSize);
+
+  void matchGuided(const vpCameraParameters &cam, const unsigned int height, const unsigned int width,
+                   std::vector<cv::DMatch> &matches, double &elapsedTime);
+
+  bool matchQueryAndComputePose(const vpCameraParameters &cam, const unsigned int height, const unsigned int width,
+                                const bool guidedMatching, vpHomogeneousMatrix &cMo, double &error,
+                                double &elapsedTime, bool (*func)(const vpHomogeneousMatrix &));
+
   double computePoseEstimationError(const std::vector<std::pair<cv::KeyPoint, cv::Point3f> > &matchKeyPoints,
                                     const vpCameraParameters &cam, const vpHomogeneousMatrix &cMo_est);
 
@@ -1312,13 +1506,22 @@ private:
 
   void init();
   void initDetector(const std::string &detectorNames);
+  void initDetector(const std::string &detectorName, std::map<std::string, cv::Ptr<cv::FeatureDetector> > &detectors);
   void initDetectors(const std::vector<std::string> &detectorNames);
 
   void initExtractor(const std::string &extractorName);
+  void initExtractor(const std::string &extractorName,
+                     std::map<std::string, cv::Ptr<cv::DescriptorExtractor> > &extractors);
   void initExtractors(const std::vector<std::string> &extractorNames);
 
   void initFeatureNames();
 
+  void readLearningDatabase(const std::string &filename, const std::vector<int> *imageIds, const bool append);
+
+  void trainMatcher();
+
+  void updateThreadInstances(int nbThreads);
+
   inline size_t myKeypointHash(const cv::KeyPoint &kp)
   {
     size_t _Val = 2166136261U, scale = 16777619U;
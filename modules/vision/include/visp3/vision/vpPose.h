@@ -94,8 +94,15 @@ public:
                              initialization from Lagrange or Dementhon aproach */
     DEMENTHON_VIRTUAL_VS, /*!< Non linear virtual visual servoing approach
                              initialized by Dementhon approach */
-    LAGRANGE_VIRTUAL_VS   /*!< Non linear virtual visual servoing approach
+    LAGRANGE_VIRTUAL_VS,  /*!< Non linear virtual visual servoing approach
                              initialized by Lagrange approach */
+    P3P,                  /*!< Closed-form solution from three points, the fourth
+                             and following points are used to disambiguate between
+                             the up to four solutions (doesn't need an initialization) */
+    EPNP,                 /*!< Non iterative EPnP approach for non coplanar points
+                             (doesn't need an initialization) */
+    IPPE                  /*!< Infinitesimal plane-based pose estimation for coplanar
+                             points (doesn't need an initialization) */
   } vpPoseMethodType;
 
   enum RANSAC_FILTER_FLAGS {
@@ -137,9 +144,41 @@ private:
   double distanceToPlaneForCoplanarityTest;
   //! RANSAC flag to remove or not degenerate points
   RANSAC_FILTER_FLAGS ransacFlag;
+  //! Method used to compute the pose hypotheses in the RANSAC
+  vpPoseMethodType ransacHypothesisMethod;
   //! List of points used for the RANSAC (std::vector is contiguous whereas
   //! std::list is a linked list)
   std::vector<vpPoint> listOfPoints;
+
+  /*!
+    Contiguous storage of the 3D coordinates in the object frame and the 2D
+    normalized coordinates in the image plane of a set of points.
+  */
+  struct PointArrays {
+    std::vector<double> oX, oY, oZ, x, y;
+
+    void clear()
+    {
+      oX.clear();
+      oY.clear();
+      oZ.clear();
+      x.clear();
+      y.clear();
+    }
+
+    void push_back(const vpPoint &P)
+    {
+      oX.push_back(P.get_oX());
+      oY.push_back(P.get_oY());
+      oZ.push_back(P.get_oZ());
+      x.push_back(P.get_x());
+      y.push_back(P.get_y());
+    }
+
+    size_t size() const { return oX.size(); }
+  };
+  //! Same points than in listOfPoints, stored in contiguous arrays
+  PointArrays pointArrays;
   //! If true, use a parallel RANSAC implementation
   bool useParallelRansac;
   //! Number of threads to spawn for the parallel RANSAC implementation
@@ -154,8 +193,8 @@ private:
   public:
     RansacFunctor(const vpHomogeneousMatrix &cMo_, const unsigned int ransacNbInlierConsensus_,
                   const int ransacMaxTrials_, const double ransacThreshold_, const unsigned int initial_seed_,
-                  const bool checkDegeneratePoints_, const std::vector<vpPoint> &listOfUniquePoints_,
-                  bool (*func_)(const vpHomogeneousMatrix &)
+                  const bool checkDegeneratePoints_, const PointArrays &uniquePoints_,
+                  const vpPoseMethodType hypothesisMethod_, bool (*func_)(const vpHomogeneousMatrix &)
               #ifdef VISP_HAVE_CPP11_COMPATIBILITY
                   , std::atomic<bool> &abort
               #endif
@@ -164,10 +203,11 @@ private:
     #ifdef VISP_HAVE_CPP11_COMPATIBILITY
         m_abort(abort),
     #endif
-        m_best_consensus(), m_checkDegeneratePoints(checkDegeneratePoints_), m_cMo(cMo_), m_foundSolution(false),
-        m_func(func_), m_initial_seed(initial_seed_), m_listOfUniquePoints(listOfUniquePoints_), m_nbInliers(0),
+        m_best_consensus(), m_best_cMo(cMo_), m_checkDegeneratePoints(checkDegeneratePoints_), m_cMo(cMo_),
+        m_foundSolution(false), m_func(func_), m_hypothesisMethod(hypothesisMethod_), m_initial_seed(initial_seed_),
+        m_uniquePoints(uniquePoints_), m_nbInliers(0),
         m_ransacMaxTrials(ransacMaxTrials_), m_ransacNbInlierConsensus(ransacNbInlierConsensus_),
-        m_ransacThreshold(ransacThreshold_)
+        m_ransacThreshold(ransacThreshold_), m_curConsensus(), m_curRandoms(), m_usedPt(), m_xProj(), m_yProj()
     {
 #if (defined(_WIN32) && (defined(_MSC_VER) || defined(__MINGW32__)) || defined(ANDROID))
       (void)initial_seed_;
@@ -183,6 +223,9 @@ private:
 
     vpHomogeneousMatrix getEstimatedPose() const { return m_cMo; }
 
+    //! Pose hypothesis of the best consensus set
+    vpHomogeneousMatrix getBestPose() const { return m_best_cMo; }
+
     unsigned int getNbInliers() const { return m_nbInliers; }
 
   private:
@@ -190,18 +233,29 @@ private:
     std::atomic<bool> &m_abort;
 #endif
     std::vector<unsigned int> m_best_consensus;
+    vpHomogeneousMatrix m_best_cMo;
     bool m_checkDegeneratePoints;
     vpHomogeneousMatrix m_cMo;
     bool m_foundSolution;
     bool (*m_func)(const vpHomogeneousMatrix &);
+    vpPoseMethodType m_hypothesisMethod;
     unsigned int m_initial_seed;
-    std::vector<vpPoint> m_listOfUniquePoints;
+    //! Points shared between all the threads, never copied
+    const PointArrays &m_uniquePoints;
     unsigned int m_nbInliers;
     int m_ransacMaxTrials;
     unsigned int m_ransacNbInlierConsensus;
     double m_ransacThreshold;
 
+    // Scratch buffers reused between the RANSAC iterations
+    std::vector<unsigned int> m_curConsensus;
+    std::vector<unsigned int> m_curRandoms;
+    std::vector<bool> m_usedPt;
+    std::vector<double> m_xProj, m_yProj;
+
+    bool isDegenerate(unsigned int index, const std::vector<unsigned int> &indexes) const;
     bool poseRansacImpl();
+    bool poseRansacMinimalImpl();
   };
 
 protected:
@@ -228,6 +282,9 @@ public:
   void poseLagrangePlan(vpHomogeneousMatrix &cMo);
   void poseLagrangeNonPlan(vpHomogeneousMatrix &cMo);
   void poseLowe(vpHomogeneousMatrix &cMo);
+  void poseP3P(vpHomogeneousMatrix &cMo);
+  void poseEPnP(vpHomogeneousMatrix &cMo);
+  void poseIPPE(vpHomogeneousMatrix &cMo);
   bool poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(const vpHomogeneousMatrix &) = NULL);
   void poseVirtualVSrobust(vpHomogeneousMatrix &cMo);
   void poseVirtualVS(vpHomogeneousMatrix &cMo);
@@ -298,6 +355,15 @@ public:
   */
   inline void setRansacFilterFlag(const RANSAC_FILTER_FLAGS &flag) { ransacFlag = flag; }
 
+  /*!
+    Get the method used to compute the pose hypotheses in the RANSAC.
+
+    \sa setRansacHypothesisMethod
+  */
+  inline vpPoseMethodType getRansacHypothesisMethod() const { return ransacHypothesisMethod; }
+
+  void setRansacHypothesisMethod(const vpPoseMethodType &method);
+
   /*!
     Get the number of threads for the parallel RANSAC implementation.
 
@@ -347,6 +413,13 @@ public:
   static double poseFromRectangle(vpPoint &p1, vpPoint &p2, vpPoint &p3, vpPoint &p4, double lx,
                                   vpCameraParameters &cam, vpHomogeneousMatrix &cMo);
 
+  static unsigned int computeP3P(const double *oX, const double *oY, const double *oZ, const double *x,
+                                 const double *y, vpHomogeneousMatrix cMo[4]);
+  static bool computeEPnP(unsigned int n, const double *oX, const double *oY, const double *oZ, const double *x,
+                          const double *y, vpHomogeneousMatrix &cMo);
+  static unsigned int computeIPPE(unsigned int n, const double *oX, const double *oY, const double *oZ,
+                                  const double *x, const double *y, vpHomogeneousMatrix cMo[2]);
+
   static int computeRansacIterations(double probability, double epsilon, const int sampleSize = 4,
                                      int maxIterations = 2000);
 
@@ -36,14 +36,23 @@
  *
  *****************************************************************************/
 
+#include <algorithm> // std::sort
+#include <cstdlib>   // rand_r
+
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpRansac.h>
 #include <visp3/vision/vpHomography.h>
+#include <visp3/vision/vpPose.h>
 
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpMeterPixelConversion.h>
 
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+#include <atomic>
+#include <thread>
+#endif
+
 #define vpEps 1e-6
 
 /*!
@@ -271,6 +280,201 @@ double vpHomography::computeResidual(vpColVector &x, vpColVector &M, vpColVector
 
   return 0;
 }
+
+namespace
+{
+// Draw a random index in [0, n[
+inline unsigned int randomIndex(unsigned int &seed, unsigned int n)
+{
+#if defined(_WIN32) && (defined(_MSC_VER) || defined(__MINGW32__)) || defined(ANDROID)
+  (void)seed;
+  return (unsigned int)rand() % n;
+#else
+  return (unsigned int)rand_r(&seed) % n;
+#endif
+}
+
+// Return true if 3 of the 4 points of the sample are colinear, as degenerateConfiguration() with inhomogeneous
+// coordinates
+inline bool isColinearSample(const std::vector<double> &x, const std::vector<double> &y)
+{
+  for (unsigned int i = 0; i < 2; i++) {
+    for (unsigned int j = i + 1; j < 3; j++) {
+      for (unsigned int k = j + 1; k < 4; k++) {
+        double cross = (x[j] - x[i]) * (y[k] - y[i]) - (y[j] - y[i]) * (x[k] - x[i]);
+        if (cross * cross < vpEps) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+// State shared by the RANSAC workers
+struct HomographyRansacSharedState {
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  std::atomic<bool> abort;
+  std::atomic<unsigned int> bestNbInliers;
+#else
+  bool abort;
+  unsigned int bestNbInliers;
+#endif
+};
+
+/*
+  RANSAC loop run by each thread. The points are stored in a contiguous buffer,
+  4 doubles (xb, yb, xa, ya) per point, shuffled once so that the hypotheses
+  are scored on a random subset first: the scoring stops as soon as the
+  hypothesis cannot beat the best consensus found by all the workers. The
+  number of trials is adapted to the inlier ratio of the best consensus.
+*/
+class HomographyRansacFunctor
+{
+public:
+  HomographyRansacFunctor(const std::vector<double> &points, unsigned int nbInliersConsensus, int maxTrials,
+                          double threshold, bool normalization, unsigned int seed, unsigned int nbWorkers,
+                          HomographyRansacSharedState &state)
+    : m_bestConsensus(), m_curConsensus(), m_degenerate(false), m_maxTrials(maxTrials),
+      m_nbInliersConsensus(nbInliersConsensus), m_nbWorkers(nbWorkers), m_normalization(normalization),
+      m_points(&points), m_seed(seed), m_state(&state), m_threshold(threshold)
+  {
+  }
+
+  void operator()()
+  {
+    const unsigned int n = (unsigned int)(m_points->size() / 4);
+    const unsigned int nbMinRandom = 4;
+    const unsigned int maxDegenerateIter = 1000;
+    const double threshold2 = m_threshold * m_threshold;
+
+    std::vector<double> xa_rand(nbMinRandom), ya_rand(nbMinRandom), xb_rand(nbMinRandom), yb_rand(nbMinRandom);
+    unsigned int rand_ind[4];
+    m_curConsensus.reserve(n);
+    vpHomography aHb;
+
+    int maxTrials = m_maxTrials;
+    for (int nbTrials = 0; nbTrials < maxTrials && !m_state->abort; nbTrials++) {
+      unsigned int nbDegenerateIter = 0;
+      bool degenerate = true;
+      while (degenerate) {
+        for (unsigned int i = 0; i < nbMinRandom; i++) {
+          bool used = true;
+          while (used) {
+            rand_ind[i] = randomIndex(m_seed, n);
+            used = false;
+            for (unsigned int j = 0; j < i; j++) {
+              used = used || (rand_ind[j] == rand_ind[i]);
+            }
+          }
+
+          const double *p = &(*m_points)[4 * rand_ind[i]];
+          xb_rand[i] = p[0];
+          yb_rand[i] = p[1];
+          xa_rand[i] = p[2];
+          ya_rand[i] = p[3];
+        }
+
+        try {
+          if (!isColinearSample(xb_rand, yb_rand) && !isColinearSample(xa_rand, ya_rand)) {
+            vpHomography::DLT(xb_rand, yb_rand, xa_rand, ya_rand, aHb, m_normalization);
+            degenerate = false;
+          }
+        } catch (...) {
+          degenerate = true;
+        }
+
+        if (degenerate && ++nbDegenerateIter > maxDegenerateIter) {
+          m_degenerate = true;
+          return;
+        }
+      }
+
+      aHb /= aHb[2][2];
+      const double *H = aHb.data;
+
+      // Residual of the minimal sample
+      double r = 0;
+      for (unsigned int i = 0; i < nbMinRandom; i++) {
+        double w = H[6] * xb_rand[i] + H[7] * yb_rand[i] + H[8];
+        double du = (H[0] * xb_rand[i] + H[1] * yb_rand[i] + H[2]) / w - xa_rand[i];
+        double dv = (H[3] * xb_rand[i] + H[4] * yb_rand[i] + H[5]) / w - ya_rand[i];
+        r += du * du + dv * dv;
+      }
+      if (!(sqrt(r / nbMinRandom) < m_threshold)) {
+        continue;
+      }
+
+      // Score the hypothesis, a hypothesis with more than n - best outliers cannot be better than the best one
+      const unsigned int bestNbInliers =
+          (std::max)((unsigned int)m_bestConsensus.size(), (unsigned int)m_state->bestNbInliers);
+      const unsigned int maxNbOutliers = n - bestNbInliers;
+      unsigned int nbOutliers = 0;
+      m_curConsensus.clear();
+      for (unsigned int i = 0; i < n && nbOutliers < maxNbOutliers; i++) {
+        const double *p = &(*m_points)[4 * i];
+        double w = H[6] * p[0] + H[7] * p[1] + H[8];
+        double du = (H[0] * p[0] + H[1] * p[1] + H[2]) / w - p[2];
+        double dv = (H[3] * p[0] + H[4] * p[1] + H[5]) / w - p[3];
+        if (du * du + dv * dv <= threshold2) {
+          m_curConsensus.push_back(i);
+        } else {
+          nbOutliers++;
+        }
+      }
+
+      if (nbOutliers < maxNbOutliers && m_curConsensus.size() > m_bestConsensus.size()) {
+        m_bestConsensus.swap(m_curConsensus);
+        const unsigned int nbInliers = (unsigned int)m_bestConsensus.size();
+        updateBestNbInliers(nbInliers);
+
+        if (nbInliers >= m_nbInliersConsensus) {
+          m_state->abort = true;
+          break;
+        }
+
+        // Adaptive number of trials, shared between the workers
+        int nbTrialsNeeded = vpPose::computeRansacIterations(0.99, 1.0 - nbInliers / (double)n, (int)nbMinRandom,
+                                                             m_maxTrials * (int)m_nbWorkers);
+        nbTrialsNeeded = (nbTrialsNeeded + (int)m_nbWorkers - 1) / (int)m_nbWorkers;
+        if (nbTrialsNeeded > 0 && nbTrialsNeeded < maxTrials) {
+          maxTrials = nbTrialsNeeded;
+        }
+      }
+    }
+  }
+
+  const std::vector<unsigned int> &getBestConsensus() const { return m_bestConsensus; }
+  bool isDegenerate() const { return m_degenerate; }
+
+private:
+  void updateBestNbInliers(unsigned int nbInliers)
+  {
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+    unsigned int best = m_state->bestNbInliers.load();
+    while (nbInliers > best && !m_state->bestNbInliers.compare_exchange_weak(best, nbInliers)) {
+    }
+#else
+    if (nbInliers > m_state->bestNbInliers) {
+      m_state->bestNbInliers = nbInliers;
+    }
+#endif
+  }
+
+  std::vector<unsigned int> m_bestConsensus;
+  std::vector<unsigned int> m_curConsensus;
+  bool m_degenerate;
+  int m_maxTrials;
+  unsigned int m_nbInliersConsensus;
+  unsigned int m_nbWorkers;
+  bool m_normalization;
+  const std::vector<double> *m_points;
+  unsigned int m_seed;
+  HomographyRansacSharedState *m_state;
+  double m_threshold;
+};
+}
+
 #endif //#ifndef DOXYGEN_SHOULD_SKIP_THIS
 
 void vpHomography::initRansac(unsigned int n, double *xb, double *yb, double *xa, double *ya, vpColVector &x)
@@ -293,6 +497,10 @@ void vpHomography::initRansac(unsigned int n, double *xb, double *yb, double *xa
   computes the homography matrix by resolving \f$^a{\bf p} = ^a{\bf H}_b\;
   ^b{\bf p}\f$ using Ransac algorithm.
 
+  The number of trials is adapted to the ratio of inliers of the best
+  consensus set, up to 1000 trials, and the scoring of an hypothesis stops as
+  soon as it has more outliers than the best one.
+
   \param xb, yb : Coordinates vector of matched points in image b. These
   coordinates are expressed in meters. \param xa, ya : Coordinates vector of
   matched points in image a. These coordinates are expressed in meters. \param
@@ -312,12 +520,16 @@ void vpHomography::initRansac(unsigned int n, double *xb, double *yb, double *xa
   \param normalization : When set to true, the coordinates of the points are
   normalized. The normalization carried out is the one preconized by Hartley.
 
+  \param useParallelRansac : When set to true, the hypotheses are computed
+  and scored by as many threads as the number of CPU threads. Requires C++11.
+
   \return true if the homography could be computed, false otherwise.
 
 */
 bool vpHomography::ransac(const std::vector<double> &xb, const std::vector<double> &yb, const std::vector<double> &xa,
                           const std::vector<double> &ya, vpHomography &aHb, std::vector<bool> &inliers,
-                          double &residual, unsigned int nbInliersConsensus, double threshold, bool normalization)
+                          double &residual, unsigned int nbInliersConsensus, double threshold, bool normalization,
+                          bool useParallelRansac)
 {
   unsigned int n = (unsigned int)xb.size();
   if (yb.size() != n || xa.size() != n || ya.size() != n)
@@ -327,174 +539,118 @@ bool vpHomography::ransac(const std::vector<double> &xb, const std::vector<doubl
   if (n < 4)
     throw(vpException(vpException::fatalError, "There must be at least 4 matched points"));
 
-  vpUniRand random((long)time(NULL));
-
-  std::vector<unsigned int> best_consensus;
-  std::vector<unsigned int> cur_consensus;
-  std::vector<unsigned int> cur_outliers;
-  std::vector<unsigned int> cur_randoms;
-
-  std::vector<unsigned int> rand_ind;
-
-  unsigned int nbMinRandom = 4;
-  unsigned int ransacMaxTrials = 1000;
-  unsigned int maxDegenerateIter = 1000;
-
-  unsigned int nbTrials = 0;
-  unsigned int nbDegenerateIter = 0;
-  unsigned int nbInliers = 0;
-
-  bool foundSolution = false;
-
-  std::vector<double> xa_rand(nbMinRandom);
-  std::vector<double> ya_rand(nbMinRandom);
-  std::vector<double> xb_rand(nbMinRandom);
-  std::vector<double> yb_rand(nbMinRandom);
-
-  if (inliers.size() != n)
-    inliers.resize(n);
-
-  while (nbTrials < ransacMaxTrials && nbInliers < nbInliersConsensus) {
-    cur_outliers.clear();
-    cur_randoms.clear();
+  const int ransacMaxTrials = 1000;
+  unsigned int seed = (unsigned int)time(NULL);
+#if defined(_WIN32) && (defined(_MSC_VER) || defined(__MINGW32__)) || defined(ANDROID)
+  srand(seed);
+#endif
 
-    bool degenerate = true;
-    while (degenerate == true) {
-      std::vector<bool> usedPt(n, false);
-
-      rand_ind.clear();
-      for (unsigned int i = 0; i < nbMinRandom; i++) {
-        // Generate random indicies in the range 0..n
-        unsigned int r = (unsigned int)ceil(random() * n) - 1;
-        while (usedPt[r]) {
-          r = (unsigned int)ceil(random() * n) - 1;
-        }
-        usedPt[r] = true;
-        rand_ind.push_back(r);
+  // Contiguous buffer of the shuffled points
+  std::vector<unsigned int> order(n);
+  for (unsigned int i = 0; i < n; i++) {
+    order[i] = i;
+  }
+  for (unsigned int i = n - 1; i > 0; i--) {
+    std::swap(order[i], order[randomIndex(seed, i + 1)]);
+  }
+  std::vector<double> points(4 * n);
+  for (unsigned int i = 0; i < n; i++) {
+    points[4 * i] = xb[order[i]];
+    points[4 * i + 1] = yb[order[i]];
+    points[4 * i + 2] = xa[order[i]];
+    points[4 * i + 3] = ya[order[i]];
+  }
 
-        xa_rand[i] = xa[r];
-        ya_rand[i] = ya[r];
-        xb_rand[i] = xb[r];
-        yb_rand[i] = yb[r];
-      }
+  HomographyRansacSharedState state;
+  state.abort = false;
+  state.bestNbInliers = 0;
 
-      try {
-        if (!vpHomography::degenerateConfiguration(xb_rand, yb_rand, xa_rand, ya_rand)) {
-          vpHomography::DLT(xb_rand, yb_rand, xa_rand, ya_rand, aHb, normalization);
-          degenerate = false;
-        }
-      } catch (...) {
-        degenerate = true;
-      }
+  unsigned int nbThreads = 1;
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+  if (useParallelRansac) {
+    nbThreads = (std::max)(std::thread::hardware_concurrency(), 1u);
+  }
+#else
+  (void)useParallelRansac;
+#endif
+
+  std::vector<HomographyRansacFunctor> ransacWorkers;
+  ransacWorkers.reserve(nbThreads);
+  const int splitTrials = ransacMaxTrials / (int)nbThreads;
+  for (unsigned int i = 0; i < nbThreads; i++) {
+    const int maxTrials = (i < nbThreads - 1) ? splitTrials : ransacMaxTrials - splitTrials * (int)(nbThreads - 1);
+    ransacWorkers.push_back(HomographyRansacFunctor(points, nbInliersConsensus, maxTrials, threshold, normalization,
+                                                    seed + i, nbThreads, state));
+  }
 
-      nbDegenerateIter++;
+  if (nbThreads > 1) {
+#if defined(VISP_HAVE_CPP11_COMPATIBILITY)
+    std::vector<std::thread> threadpool;
+    for (auto &worker : ransacWorkers) {
+      threadpool.emplace_back(&HomographyRansacFunctor::operator(), &worker);
+    }
 
-      if (nbDegenerateIter > maxDegenerateIter) {
-        vpERROR_TRACE("Unable to select a nondegenerate data set");
-        throw(vpException(vpException::fatalError, "Unable to select a nondegenerate data set"));
-      }
+    for (auto &th : threadpool) {
+      th.join();
     }
+#endif
+  } else {
+    ransacWorkers[0]();
+  }
 
-    aHb /= aHb[2][2];
-
-    // Computing Residual
-    double r = 0;
-    vpColVector a(3), b(3), c(3);
-    for (unsigned int i = 0; i < nbMinRandom; i++) {
-      a[0] = xa_rand[i];
-      a[1] = ya_rand[i];
-      a[2] = 1;
-      b[0] = xb_rand[i];
-      b[1] = yb_rand[i];
-      b[2] = 1;
-
-      c = aHb * b;
-      c /= c[2];
-      r += (a - c).sumSquare();
-      // cout << "point " <<i << "  " << (a-c).sumSquare()  <<endl ;;
+  std::vector<unsigned int> best_consensus;
+  bool degenerate = true;
+  for (size_t i = 0; i < ransacWorkers.size(); i++) {
+    degenerate = degenerate && ransacWorkers[i].isDegenerate();
+    if (ransacWorkers[i].getBestConsensus().size() > best_consensus.size()) {
+      best_consensus = ransacWorkers[i].getBestConsensus();
     }
+  }
 
-    // Finding inliers & ouliers
-    r = sqrt(r / nbMinRandom);
-    // std::cout << "Candidate residual: " << r << std::endl;
-    if (r < threshold) {
-      unsigned int nbInliersCur = 0;
-      for (unsigned int i = 0; i < n; i++) {
-        a[0] = xa[i];
-        a[1] = ya[i];
-        a[2] = 1;
-        b[0] = xb[i];
-        b[1] = yb[i];
-        b[2] = 1;
-
-        c = aHb * b;
-        c /= c[2];
-        double error = sqrt((a - c).sumSquare());
-        if (error <= threshold) {
-          nbInliersCur++;
-          cur_consensus.push_back(i);
-          inliers[i] = true;
-        } else {
-          cur_outliers.push_back(i);
-          inliers[i] = false;
-        }
-      }
-      // std::cout << "nb inliers that matches: " << nbInliersCur <<
-      // std::endl;
-      if (nbInliersCur > nbInliers) {
-        foundSolution = true;
-        best_consensus = cur_consensus;
-        nbInliers = nbInliersCur;
-      }
+  if (degenerate) {
+    vpERROR_TRACE("Unable to select a nondegenerate data set");
+    throw(vpException(vpException::fatalError, "Unable to select a nondegenerate data set"));
+  }
 
-      cur_consensus.clear();
-    }
+  // Back to the indexes of the input points
+  for (size_t i = 0; i < best_consensus.size(); i++) {
+    best_consensus[i] = order[best_consensus[i]];
+  }
+  std::sort(best_consensus.begin(), best_consensus.end());
 
-    nbTrials++;
-    if (nbTrials >= ransacMaxTrials) {
-      vpERROR_TRACE("Ransac reached the maximum number of trials");
-      foundSolution = true;
-    }
+  inliers.assign(n, false);
+  for (size_t i = 0; i < best_consensus.size(); i++) {
+    inliers[best_consensus[i]] = true;
   }
 
-  if (foundSolution) {
-    if (nbInliers >= nbInliersConsensus) {
-      std::vector<double> xa_best(best_consensus.size());
-      std::vector<double> ya_best(best_consensus.size());
-      std::vector<double> xb_best(best_consensus.size());
-      std::vector<double> yb_best(best_consensus.size());
-
-      for (unsigned i = 0; i < best_consensus.size(); i++) {
-        xa_best[i] = xa[best_consensus[i]];
-        ya_best[i] = ya[best_consensus[i]];
-        xb_best[i] = xb[best_consensus[i]];
-        yb_best[i] = yb[best_consensus[i]];
-      }
+  if (best_consensus.size() < nbInliersConsensus) {
+    return false;
+  }
 
-      vpHomography::DLT(xb_best, yb_best, xa_best, ya_best, aHb, normalization);
-      aHb /= aHb[2][2];
+  std::vector<double> xa_best(best_consensus.size());
+  std::vector<double> ya_best(best_consensus.size());
+  std::vector<double> xb_best(best_consensus.size());
+  std::vector<double> yb_best(best_consensus.size());
 
-      residual = 0;
-      vpColVector a(3), b(3), c(3);
-      for (unsigned int i = 0; i < best_consensus.size(); i++) {
-        a[0] = xa_best[i];
-        a[1] = ya_best[i];
-        a[2] = 1;
-        b[0] = xb_best[i];
-        b[1] = yb_best[i];
-        b[2] = 1;
-
-        c = aHb * b;
-        c /= c[2];
-        residual += (a - c).sumSquare();
-      }
+  for (unsigned i = 0; i < best_consensus.size(); i++) {
+    xa_best[i] = xa[best_consensus[i]];
+    ya_best[i] = ya[best_consensus[i]];
+    xb_best[i] = xb[best_consensus[i]];
+    yb_best[i] = yb[best_consensus[i]];
+  }
 
-      residual = sqrt(residual / best_consensus.size());
-      return true;
-    } else {
-      return false;
-    }
-  } else {
-    return false;
+  vpHomography::DLT(xb_best, yb_best, xa_best, ya_best, aHb, normalization);
+  aHb /= aHb[2][2];
+
+  residual = 0;
+  const double *H = aHb.data;
+  for (unsigned int i = 0; i < best_consensus.size(); i++) {
+    double w = H[6] * xb_best[i] + H[7] * yb_best[i] + H[8];
+    double du = (H[0] * xb_best[i] + H[1] * yb_best[i] + H[2]) / w - xa_best[i];
+    double dv = (H[3] * xb_best[i] + H[4] * yb_best[i] + H[5]) / w - ya_best[i];
+    residual += du * du + dv * dv;
   }
+
+  residual = sqrt(residual / best_consensus.size());
+  return true;
 }
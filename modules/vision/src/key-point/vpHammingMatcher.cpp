@@ -0,0 +1,511 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Matching of binary descriptors with the Hamming distance.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include <visp3/core/vpCPUFeatures.h>
+#include <visp3/core/vpException.h>
+#include <visp3/vision/vpHammingMatcher.h>
+
+// The POPCNT and AVX2 kernels are compiled whatever the build flags and selected at runtime
+#if (defined __x86_64__ && (defined __clang__ || (defined __GNUC__ && __GNUC__ >= 5))) || \
+    (defined _MSC_VER && defined _M_X64)
+#include <immintrin.h>
+#define VISP_HAVE_HAMMING_SIMD 1
+#if defined _MSC_VER
+#include <intrin.h>
+#define VISP_HAMMING_TARGET(features)
+#define VISP_HAMMING_INLINE __forceinline
+#else
+#define VISP_HAMMING_TARGET(features) __attribute__((target(features)))
+#define VISP_HAMMING_INLINE inline __attribute__((always_inline))
+#endif
+#endif
+
+namespace
+{
+// Number of query descriptors processed together by a thread
+const int hammingQueryBlockSize = 64;
+// Number of train descriptors scanned for a block of queries before moving to the next ones, to stay in the cache
+const unsigned int hammingTrainTileSize = 2048;
+// Number of buckets of a hash table, indexed by a 16 bits substring
+const unsigned int hammingNbBuckets = 65536;
+
+inline unsigned int popcount64(unsigned long long v)
+{
+  v = v - ((v >> 1) & 0x5555555555555555ULL);
+  v = (v & 0x3333333333333333ULL) + ((v >> 2) & 0x3333333333333333ULL);
+  v = (v + (v >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  return (unsigned int)((v * 0x0101010101010101ULL) >> 56);
+}
+
+/*
+  Kernels computing the Hamming distance between two padded descriptors. The
+  computation stops as soon as the distance exceeds bound.
+*/
+struct HammingScalar {
+  static inline unsigned int distance(const unsigned long long *a, const unsigned long long *b, unsigned int nbWords,
+                                      unsigned int bound)
+  {
+    unsigned int dist = 0;
+    unsigned int i = 0;
+    for (; i + 4 <= nbWords; i += 4) {
+      dist += popcount64(a[i] ^ b[i]) + popcount64(a[i + 1] ^ b[i + 1]) + popcount64(a[i + 2] ^ b[i + 2]) +
+              popcount64(a[i + 3] ^ b[i + 3]);
+      if (dist > bound) {
+        return dist;
+      }
+    }
+    for (; i < nbWords; i++) {
+      dist += popcount64(a[i] ^ b[i]);
+    }
+    return dist;
+  }
+};
+
+#if VISP_HAVE_HAMMING_SIMD
+struct HammingPopcnt {
+  VISP_HAMMING_TARGET("popcnt")
+  static inline unsigned int distance(const unsigned long long *a, const unsigned long long *b, unsigned int nbWords,
+                                      unsigned int bound)
+  {
+    unsigned int dist = 0;
+    unsigned int i = 0;
+    for (; i + 4 <= nbWords; i += 4) {
+      dist += (unsigned int)(_mm_popcnt_u64(a[i] ^ b[i]) + _mm_popcnt_u64(a[i + 1] ^ b[i + 1]) +
+                             _mm_popcnt_u64(a[i + 2] ^ b[i + 2]) + _mm_popcnt_u64(a[i + 3] ^ b[i + 3]));
+      if (dist > bound) {
+        return dist;
+      }
+    }
+    for (; i < nbWords; i++) {
+      dist += (unsigned int)_mm_popcnt_u64(a[i] ^ b[i]);
+    }
+    return dist;
+  }
+};
+
+struct HammingAvx2 {
+  // Number of bits set in a ^ b for 256 bits, with the nibble lookup table method
+  VISP_HAMMING_TARGET("avx2")
+  static inline unsigned int popcount256(const unsigned long long *a, const unsigned long long *b)
+  {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+                                            1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowMask = _mm256_set1_epi8(0x0F);
+    const __m256i v =
+        _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)a), _mm256_loadu_si256((const __m256i *)b));
+    const __m256i lo = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, lowMask));
+    const __m256i hi = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), lowMask));
+    const __m256i sum = _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+    const __m128i sum128 = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    return (unsigned int)(_mm_cvtsi128_si32(sum128) + _mm_extract_epi32(sum128, 2));
+  }
+
+  VISP_HAMMING_TARGET("avx2,popcnt")
+  static inline unsigned int distance(const unsigned long long *a, const unsigned long long *b, unsigned int nbWords,
+                                      unsigned int bound)
+  {
+    unsigned int dist = 0;
+    unsigned int i = 0;
+    for (; i + 4 <= nbWords; i += 4) {
+      dist += popcount256(a + i, b + i);
+      if (dist > bound) {
+        return dist;
+      }
+    }
+    for (; i < nbWords; i++) {
+      dist += (unsigned int)_mm_popcnt_u64(a[i] ^ b[i]);
+    }
+    return dist;
+  }
+};
+#endif
+
+inline void updateMatch(vpHammingMatcher::vpHammingMatch &match, int trainIdx, unsigned int dist)
+{
+  if (dist < match.distance) {
+    match.secondTrainIdx = match.trainIdx;
+    match.secondDistance = match.distance;
+    match.trainIdx = trainIdx;
+    match.distance = dist;
+  } else if (dist < match.secondDistance) {
+    match.secondTrainIdx = trainIdx;
+    match.secondDistance = dist;
+  }
+}
+
+inline void initMatch(vpHammingMatcher::vpHammingMatch &match)
+{
+  match.trainIdx = -1;
+  match.distance = UINT_MAX;
+  match.secondTrainIdx = -1;
+  match.secondDistance = UINT_MAX;
+}
+
+// Update the two nearest neighbors of a query with the train descriptors ids[begin, end), or [begin, end) when ids
+// is NULL
+template <class Kernel>
+#if VISP_HAVE_HAMMING_SIMD
+VISP_HAMMING_INLINE
+#else
+inline
+#endif
+void scanTrain(const unsigned long long *query, const unsigned long long *train, unsigned int nbWords,
+               const unsigned int *ids, unsigned int begin, unsigned int end, vpHammingMatcher::vpHammingMatch &match)
+{
+  for (unsigned int k = begin; k < end; k++) {
+    const unsigned int i = ids != NULL ? ids[k] : k;
+    updateMatch(match, (int)i, Kernel::distance(query, train + (size_t)i * nbWords, nbWords, match.secondDistance));
+  }
+}
+
+typedef void (*ScanTrainFunction)(const unsigned long long *, const unsigned long long *, unsigned int,
+                                  const unsigned int *, unsigned int, unsigned int, vpHammingMatcher::vpHammingMatch &);
+
+void scanTrainScalar(const unsigned long long *query, const unsigned long long *train, unsigned int nbWords,
+                     const unsigned int *ids, unsigned int begin, unsigned int end,
+                     vpHammingMatcher::vpHammingMatch &match)
+{
+  scanTrain<HammingScalar>(query, train, nbWords, ids, begin, end, match);
+}
+
+#if VISP_HAVE_HAMMING_SIMD
+VISP_HAMMING_TARGET("popcnt")
+void scanTrainPopcnt(const unsigned long long *query, const unsigned long long *train, unsigned int nbWords,
+                     const unsigned int *ids, unsigned int begin, unsigned int end,
+                     vpHammingMatcher::vpHammingMatch &match)
+{
+  scanTrain<HammingPopcnt>(query, train, nbWords, ids, begin, end, match);
+}
+
+VISP_HAMMING_TARGET("avx2,popcnt")
+void scanTrainAvx2(const unsigned long long *query, const unsigned long long *train, unsigned int nbWords,
+                   const unsigned int *ids, unsigned int begin, unsigned int end,
+                   vpHammingMatcher::vpHammingMatch &match)
+{
+  scanTrain<HammingAvx2>(query, train, nbWords, ids, begin, end, match);
+}
+#endif
+
+// Fastest scan supported by the CPU. POPCNT comes with SSE4.2.
+ScanTrainFunction selectScanTrain()
+{
+#if VISP_HAVE_HAMMING_SIMD
+  if (vpCPUFeatures::checkAVX2() && vpCPUFeatures::checkSSE42()) {
+    return scanTrainAvx2;
+  }
+  if (vpCPUFeatures::checkSSE42()) {
+    return scanTrainPopcnt;
+  }
+#endif
+  return scanTrainScalar;
+}
+
+// Value of the 16 bits substring of index j of a descriptor of size bytes
+inline unsigned int substring(const unsigned char *descriptor, unsigned int j, unsigned int size)
+{
+  return 2 * j + 1 < size ? (unsigned int)(descriptor[2 * j] | (descriptor[2 * j + 1] << 8))
+                          : (unsigned int)descriptor[2 * j];
+}
+}
+
+/*!
+  Default constructor.
+
+  \param type : Search method.
+*/
+vpHammingMatcher::vpHammingMatcher(const vpHammingIndexType &type)
+  : m_indexType(type), m_maxSearchRadius(2), m_ratioThreshold(0.), m_descriptorSize(0), m_nbWords(0), m_nbTrain(0),
+    m_train(), m_nbTables(0), m_bucketOffsets(), m_bucketIds()
+{
+}
+
+/*!
+  Remove the train descriptors.
+*/
+void vpHammingMatcher::clear()
+{
+  m_descriptorSize = 0;
+  m_nbWords = 0;
+  m_nbTrain = 0;
+  m_train.clear();
+  m_nbTables = 0;
+  m_bucketOffsets.clear();
+  m_bucketIds.clear();
+}
+
+/*!
+  Compute the Hamming distance between two binary descriptors.
+
+  \param a : First descriptor.
+  \param b : Second descriptor.
+  \param descriptorSize : Size of the descriptors in bytes.
+  \return The number of bits that differ.
+*/
+unsigned int vpHammingMatcher::distance(const unsigned char *a, const unsigned char *b, unsigned int descriptorSize)
+{
+  unsigned int dist = 0;
+  unsigned int i = 0;
+  for (; i + 8 <= descriptorSize; i += 8) {
+    unsigned long long wa, wb;
+    std::memcpy(&wa, a + i, 8);
+    std::memcpy(&wb, b + i, 8);
+    dist += popcount64(wa ^ wb);
+  }
+  for (; i < descriptorSize; i++) {
+    dist += popcount64((unsigned long long)(a[i] ^ b[i]));
+  }
+  return dist;
+}
+
+/*!
+  Set the train descriptors. They are copied, so that the buffer can be
+  released after the call.
+
+  \param trainDescriptors : Train descriptors, one per row.
+  \param nbTrainDescriptors : Number of train descriptors.
+  \param descriptorSize : Size of a descriptor in bytes.
+  \param trainStep : Number of bytes between two rows, equal to \e
+  descriptorSize when 0.
+*/
+void vpHammingMatcher::train(const unsigned char *trainDescriptors, unsigned int nbTrainDescriptors,
+                             unsigned int descriptorSize, size_t trainStep)
+{
+  if (descriptorSize == 0) {
+    throw vpException(vpException::badValue, "The size of the descriptors cannot be 0");
+  }
+  if (trainStep == 0) {
+    trainStep = descriptorSize;
+  }
+
+  m_descriptorSize = descriptorSize;
+  m_nbWords = (descriptorSize + 7) / 8;
+  m_nbTrain = nbTrainDescriptors;
+  m_train.assign((size_t)m_nbTrain * m_nbWords, 0);
+  for (unsigned int i = 0; i < m_nbTrain; i++) {
+    std::memcpy(&m_train[(size_t)i * m_nbWords], trainDescriptors + i * trainStep, descriptorSize);
+  }
+
+  buildIndex();
+}
+
+/*!
+  Set the search method. The index is built again if needed.
+
+  \param type : Search method.
+*/
+void vpHammingMatcher::setIndexType(const vpHammingIndexType &type)
+{
+  m_indexType = type;
+  buildIndex();
+}
+
+void vpHammingMatcher::buildIndex()
+{
+  m_nbTables = 0;
+  m_bucketOffsets.clear();
+  m_bucketIds.clear();
+  if (m_indexType != MULTI_INDEX_HASHING || m_nbTrain == 0) {
+    return;
+  }
+
+  // Counting sort of the train descriptors by bucket, for each substring
+  m_nbTables = (m_descriptorSize + 1) / 2;
+  m_bucketOffsets.assign((size_t)m_nbTables * (hammingNbBuckets + 1), 0);
+  m_bucketIds.resize((size_t)m_nbTables * m_nbTrain);
+  std::vector<unsigned int> cursor(hammingNbBuckets);
+  for (unsigned int j = 0; j < m_nbTables; j++) {
+    unsigned int *offsets = &m_bucketOffsets[(size_t)j * (hammingNbBuckets + 1)];
+    unsigned int *ids = &m_bucketIds[(size_t)j * m_nbTrain];
+    for (unsigned int i = 0; i < m_nbTrain; i++) {
+      const unsigned char *descriptor = (const unsigned char *)&m_train[(size_t)i * m_nbWords];
+      offsets[substring(descriptor, j, m_descriptorSize) + 1]++;
+    }
+    for (unsigned int b = 0; b < hammingNbBuckets; b++) {
+      offsets[b + 1] += offsets[b];
+    }
+    std::memcpy(&cursor[0], offsets, hammingNbBuckets * sizeof(unsigned int));
+    for (unsigned int i = 0; i < m_nbTrain; i++) {
+      const unsigned char *descriptor = (const unsigned char *)&m_train[(size_t)i * m_nbWords];
+      ids[cursor[substring(descriptor, j, m_descriptorSize)]++] = i;
+    }
+  }
+}
+
+/*!
+  Find the two nearest train descriptors of each query descriptor.
+
+  \param queryDescriptors : Query descriptors, one per row, with the same size
+  as the train descriptors.
+  \param nbQueryDescriptors : Number of query descriptors.
+  \param queryStep : Number of bytes between two rows, equal to the descriptor
+  size when 0.
+  \param matches : The two nearest neighbors of each query descriptor.
+*/
+void vpHammingMatcher::match(const unsigned char *queryDescriptors, unsigned int nbQueryDescriptors,
+                             size_t queryStep, std::vector<vpHammingMatch> &matches) const
+{
+  matches.resize(nbQueryDescriptors);
+  if (m_nbTrain == 0) {
+    for (size_t i = 0; i < matches.size(); i++) {
+      initMatch(matches[i]);
+    }
+    return;
+  }
+  if (queryStep == 0) {
+    queryStep = m_descriptorSize;
+  }
+
+  if (m_indexType == MULTI_INDEX_HASHING) {
+    matchMultiIndex(queryDescriptors, nbQueryDescriptors, queryStep, matches);
+  } else {
+    matchBruteForce(queryDescriptors, nbQueryDescriptors, queryStep, matches);
+  }
+}
+
+void vpHammingMatcher::matchBruteForce(const unsigned char *queryDescriptors, unsigned int nbQueryDescriptors,
+                                       size_t queryStep, std::vector<vpHammingMatch> &matches) const
+{
+  const ScanTrainFunction scanTrain = selectScanTrain();
+  const int nbBlocks = ((int)nbQueryDescriptors + hammingQueryBlockSize - 1) / hammingQueryBlockSize;
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif
+  for (int block = 0; block < nbBlocks; block++) {
+    const unsigned int begin = (unsigned int)(block * hammingQueryBlockSize);
+    const unsigned int end = (std::min)(begin + (unsigned int)hammingQueryBlockSize, nbQueryDescriptors);
+
+    std::vector<unsigned long long> queries((size_t)(end - begin) * m_nbWords, 0);
+    for (unsigned int q = begin; q < end; q++) {
+      std::memcpy(&queries[(size_t)(q - begin) * m_nbWords], queryDescriptors + q * queryStep, m_descriptorSize);
+      initMatch(matches[q]);
+    }
+
+    for (unsigned int tileBegin = 0; tileBegin < m_nbTrain; tileBegin += hammingTrainTileSize) {
+      const unsigned int tileEnd = (std::min)(tileBegin + hammingTrainTileSize, m_nbTrain);
+      for (unsigned int q = begin; q < end; q++) {
+        const unsigned long long *query = &queries[(size_t)(q - begin) * m_nbWords];
+        vpHammingMatch &match = matches[q];
+        scanTrain(query, &m_train[0], m_nbWords, NULL, tileBegin, tileEnd, match);
+      }
+    }
+  }
+}
+
+void vpHammingMatcher::matchMultiIndex(const unsigned char *queryDescriptors, unsigned int nbQueryDescriptors,
+                                       size_t queryStep, std::vector<vpHammingMatch> &matches) const
+{
+  // Substring masks grouped by number of bits set
+  std::vector<std::vector<unsigned int> > masks(m_maxSearchRadius + 1);
+  for (unsigned int mask = 0; mask < hammingNbBuckets; mask++) {
+    unsigned int nbBits = popcount64(mask);
+    if (nbBits <= m_maxSearchRadius) {
+      masks[nbBits].push_back(mask);
+    }
+  }
+  const bool useRatio = m_ratioThreshold > 0. && m_ratioThreshold < 1.;
+  const ScanTrainFunction scanTrain = selectScanTrain();
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel
+#endif
+  {
+    // Marks the train descriptors already compared to the current query
+    std::vector<unsigned int> visited(m_nbTrain, 0);
+    unsigned int stamp = 0;
+    std::vector<unsigned long long> query(m_nbWords);
+    std::vector<unsigned int> candidates;
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp for schedule(dynamic, 16)
+#endif
+    for (int q = 0; q < (int)nbQueryDescriptors; q++) {
+      const unsigned char *queryDescriptor = queryDescriptors + (size_t)q * queryStep;
+      std::fill(query.begin(), query.end(), 0ULL);
+      std::memcpy(&query[0], queryDescriptor, m_descriptorSize);
+      vpHammingMatch &match = matches[(size_t)q];
+      initMatch(match);
+
+      if (++stamp == 0) {
+        std::fill(visited.begin(), visited.end(), 0U);
+        stamp = 1;
+      }
+
+      bool found = false;
+      for (unsigned int radius = 0; radius <= m_maxSearchRadius && !found; radius++) {
+        for (unsigned int j = 0; j < m_nbTables && !found; j++) {
+          const unsigned int key = substring(queryDescriptor, j, m_descriptorSize);
+          const unsigned int *offsets = &m_bucketOffsets[(size_t)j * (hammingNbBuckets + 1)];
+          const unsigned int *ids = &m_bucketIds[(size_t)j * m_nbTrain];
+          const std::vector<unsigned int> &radiusMasks = masks[radius];
+          for (size_t k = 0; k < radiusMasks.size(); k++) {
+            const unsigned int bucket = key ^ radiusMasks[k];
+            candidates.clear();
+            for (unsigned int l = offsets[bucket]; l < offsets[bucket + 1]; l++) {
+              const unsigned int i = ids[l];
+              if (visited[i] != stamp) {
+                visited[i] = stamp;
+                candidates.push_back(i);
+              }
+            }
+            if (!candidates.empty()) {
+              scanTrain(&query[0], &m_train[0], m_nbWords, &candidates[0], 0, (unsigned int)candidates.size(), match);
+            }
+          }
+
+          // A descriptor at a distance d has at least one substring at a distance lower or equal to d / nbTables:
+          // all the train descriptors at a distance lower or equal to bound have been compared
+          const unsigned int bound = m_nbTables * radius + j;
+          if (match.secondDistance <= bound) {
+            found = true;
+          } else if (useRatio && match.distance < m_ratioThreshold * (bound + 1)) {
+            // The second nearest neighbor is farther than bound, the ratio test succeeds
+            found = true;
+          }
+        }
+      }
+
+      if (match.trainIdx < 0 || (match.secondTrainIdx < 0 && m_nbTrain > 1)) {
+        // Not enough candidates in the probed buckets
+        initMatch(match);
+        scanTrain(&query[0], &m_train[0], m_nbWords, NULL, 0, m_nbTrain, match);
+      }
+    }
+  }
+}
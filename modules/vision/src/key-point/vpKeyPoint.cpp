@@ -38,8 +38,10 @@
 
 #include <iomanip>
 #include <limits>
+#include <stdint.h>
 
 #include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpMeterPixelConversion.h>
 #include <visp3/vision/vpKeyPoint.h>
 
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020101)
@@ -52,8 +54,82 @@
 #include <pugixml.hpp>
 #endif
 
+#include <cstring>
+#ifdef VISP_HAVE_OPENMP
+#include <omp.h>
+#endif
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace
 {
+// Order the keypoints by decreasing response, then by position so that the result does not depend on the
+// order of the detection, e.g. with tiles
+struct KeyPointResponseGreater {
+  bool operator()(const cv::KeyPoint &a, const cv::KeyPoint &b) const
+  {
+    if (a.response != b.response) {
+      return a.response > b.response;
+    }
+    if (a.pt.y != b.pt.y) {
+      return a.pt.y < b.pt.y;
+    }
+    return a.pt.x < b.pt.x;
+  }
+};
+
+// Order the keypoints by grid cell, then by decreasing response
+struct KeyPointCellLess {
+  explicit KeyPointCellLess(const std::vector<cv::KeyPoint> &keyPoints) : m_keyPoints(keyPoints) {}
+
+  bool operator()(const std::pair<int, size_t> &a, const std::pair<int, size_t> &b) const
+  {
+    if (a.first != b.first) {
+      return a.first < b.first;
+    }
+    return KeyPointResponseGreater()(m_keyPoints[a.second], m_keyPoints[b.second]);
+  }
+
+  const std::vector<cv::KeyPoint> &m_keyPoints;
+};
+
+// Copy the parameters of an OpenCV algorithm that can be serialized, keep the default ones otherwise
+void copyAlgorithmParameters(const cv::Algorithm &src, cv::Algorithm &dst)
+{
+#if (VISP_HAVE_OPENCV_VERSION < 0x030000)
+  if (src.info() == NULL || dst.info() == NULL) {
+    // Not registered algorithm, its parameters are not known
+    return;
+  }
+#endif
+  try {
+    cv::FileStorage fsWrite(".yml", cv::FileStorage::WRITE + cv::FileStorage::MEMORY);
+    src.write(fsWrite);
+    cv::FileStorage fsRead(fsWrite.releaseAndGetString(), cv::FileStorage::READ + cv::FileStorage::MEMORY);
+    dst.read(fsRead.root());
+  } catch (const cv::Exception &) {
+  }
+}
+
+// Norm used to compare the descriptors, consistent with the matcher
+int descriptorNormType(const std::string &matcherName, int descriptorDepth)
+{
+  if (matcherName.find("Hamming(2)") != std::string::npos) {
+    return cv::NORM_HAMMING2;
+  }
+  if (matcherName.find("Hamming") != std::string::npos || descriptorDepth == CV_8U) {
+    return cv::NORM_HAMMING;
+  }
+  if (matcherName.find("L1") != std::string::npos) {
+    return cv::NORM_L1;
+  }
+  return cv::NORM_L2;
+}
+
 // Specific Type transformation functions
 inline cv::DMatch knnToDMatch(const std::vector<cv::DMatch> &knnMatches)
 {
@@ -83,21 +159,26 @@ inline vpImagePoint matchRansacToVpImage(const std::pair<cv::KeyPoint, cv::Point
 vpKeyPoint::vpKeyPoint(const vpFeatureDetectorType &detectorType, const vpFeatureDescriptorType &descriptorType,
                        const std::string &matcherName, const vpFilterMatchingType &filterType)
   : m_computeCovariance(false), m_covarianceMatrix(), m_currentImageId(0), m_detectionMethod(detectionScore),
-    m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTime(0.), m_detectorNames(), m_detectors(),
+    m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTileOverlap(32),
+    m_detectionTilesX(1), m_detectionTilesY(1), m_detectionTime(0.), m_detectorNames(), m_detectors(),
     m_extractionTime(0.), m_extractorNames(), m_extractors(), m_filteredMatches(), m_filterType(filterType),
-    m_imageFormat(jpgImageFormat), m_knnMatches(), m_mapOfImageId(), m_mapOfImages(), m_matcher(),
-    m_matcherName(matcherName), m_matches(), m_matchingFactorThreshold(2.0), m_matchingRatioThreshold(0.85),
-    m_matchingTime(0.), m_matchRansacKeyPointsToPoints(), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100),
+    m_gridCellSize(0), m_gridMaxKeyPointsPerCell(0), m_guidedMatchingPose(), m_guidedMatchingPoseValid(false),
+    m_guidedMatchingRadius(20.0), m_hammingMatcher(), m_imageFormat(jpgImageFormat), m_knnMatches(),
+    m_mapOfImageId(), m_mapOfImages(), m_matcher(), m_matcherName(matcherName), m_matches(),
+    m_matchingFactorThreshold(2.0), m_matchingRatioThreshold(0.85), m_matchingTime(0.),
+    m_matchRansacKeyPointsToPoints(), m_maxKeyPoints(0), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100),
     m_objectFilteredPoints(), m_poseTime(0.), m_queryDescriptors(), m_queryFilteredKeyPoints(), m_queryKeyPoints(),
     m_ransacConsensusPercentage(20.0), m_ransacFilterFlag(vpPose::NO_FILTER), m_ransacInliers(), m_ransacOutliers(),
     m_ransacParallel(false), m_ransacParallelNbThreads(0), m_ransacReprojectionError(6.0),
-    m_ransacThreshold(0.01), m_trainDescriptors(), m_trainKeyPoints(), m_trainPoints(), m_trainVpPoints(),
-    m_useAffineDetection(false),
+    m_ransacThreshold(0.01), m_threadDetectors(), m_threadExtractors(), m_trainDescriptors(), m_trainKeyPoints(),
+    m_trainPoints(), m_trainVpPoints(), m_useAffineDetection(false),
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
     m_useBruteForceCrossCheck(true),
 #endif
-    m_useConsensusPercentage(false), m_useKnn(false), m_useMatchTrainToQuery(false), m_useRansacVVS(true),
-    m_useSingleMatchFilter(true), m_I()
+    m_useConsensusPercentage(false), m_useGuidedMatching(false),
+    m_useHammingMatcher(false), m_useKnn(false), m_useMatchTrainToQuery(false),
+    m_useRansacVVS(true), m_useSingleMatchFilter(true), m_I(), m_learningDatabase(),
+    m_learningDatabaseLocation()
 {
   initFeatureNames();
 
@@ -119,21 +200,26 @@ vpKeyPoint::vpKeyPoint(const vpFeatureDetectorType &detectorType, const vpFeatur
 vpKeyPoint::vpKeyPoint(const std::string &detectorName, const std::string &extractorName,
                        const std::string &matcherName, const vpFilterMatchingType &filterType)
   : m_computeCovariance(false), m_covarianceMatrix(), m_currentImageId(0), m_detectionMethod(detectionScore),
-    m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTime(0.), m_detectorNames(), m_detectors(),
+    m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTileOverlap(32),
+    m_detectionTilesX(1), m_detectionTilesY(1), m_detectionTime(0.), m_detectorNames(), m_detectors(),
     m_extractionTime(0.), m_extractorNames(), m_extractors(), m_filteredMatches(), m_filterType(filterType),
-    m_imageFormat(jpgImageFormat), m_knnMatches(), m_mapOfImageId(), m_mapOfImages(), m_matcher(),
-    m_matcherName(matcherName), m_matches(), m_matchingFactorThreshold(2.0), m_matchingRatioThreshold(0.85),
-    m_matchingTime(0.), m_matchRansacKeyPointsToPoints(), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100),
+    m_gridCellSize(0), m_gridMaxKeyPointsPerCell(0), m_guidedMatchingPose(), m_guidedMatchingPoseValid(false),
+    m_guidedMatchingRadius(20.0), m_hammingMatcher(), m_imageFormat(jpgImageFormat), m_knnMatches(),
+    m_mapOfImageId(), m_mapOfImages(), m_matcher(), m_matcherName(matcherName), m_matches(),
+    m_matchingFactorThreshold(2.0), m_matchingRatioThreshold(0.85), m_matchingTime(0.),
+    m_matchRansacKeyPointsToPoints(), m_maxKeyPoints(0), m_nbRansacIterations(200), m_nbRansacMinInlierCount(100),
     m_objectFilteredPoints(), m_poseTime(0.), m_queryDescriptors(), m_queryFilteredKeyPoints(), m_queryKeyPoints(),
     m_ransacConsensusPercentage(20.0), m_ransacFilterFlag(vpPose::NO_FILTER), m_ransacInliers(), m_ransacOutliers(),
     m_ransacParallel(false), m_ransacParallelNbThreads(0), m_ransacReprojectionError(6.0),
-    m_ransacThreshold(0.01), m_trainDescriptors(), m_trainKeyPoints(), m_trainPoints(), m_trainVpPoints(),
-    m_useAffineDetection(false),
+    m_ransacThreshold(0.01), m_threadDetectors(), m_threadExtractors(), m_trainDescriptors(), m_trainKeyPoints(),
+    m_trainPoints(), m_trainVpPoints(), m_useAffineDetection(false),
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
     m_useBruteForceCrossCheck(true),
 #endif
-    m_useConsensusPercentage(false), m_useKnn(false), m_useMatchTrainToQuery(false), m_useRansacVVS(true),
-    m_useSingleMatchFilter(true), m_I()
+    m_useConsensusPercentage(false), m_useGuidedMatching(false),
+    m_useHammingMatcher(false), m_useKnn(false), m_useMatchTrainToQuery(false),
+    m_useRansacVVS(true), m_useSingleMatchFilter(true), m_I(), m_learningDatabase(),
+    m_learningDatabaseLocation()
 {
   initFeatureNames();
 
@@ -155,20 +241,27 @@ vpKeyPoint::vpKeyPoint(const std::string &detectorName, const std::string &extra
 vpKeyPoint::vpKeyPoint(const std::vector<std::string> &detectorNames, const std::vector<std::string> &extractorNames,
                        const std::string &matcherName, const vpFilterMatchingType &filterType)
   : m_computeCovariance(false), m_covarianceMatrix(), m_currentImageId(0), m_detectionMethod(detectionScore),
-    m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTime(0.), m_detectorNames(detectorNames),
+    m_detectionScore(0.15), m_detectionThreshold(100.0), m_detectionTileOverlap(32),
+    m_detectionTilesX(1), m_detectionTilesY(1), m_detectionTime(0.), m_detectorNames(detectorNames),
     m_detectors(), m_extractionTime(0.), m_extractorNames(extractorNames), m_extractors(), m_filteredMatches(),
-    m_filterType(filterType), m_imageFormat(jpgImageFormat), m_knnMatches(), m_mapOfImageId(), m_mapOfImages(),
-    m_matcher(), m_matcherName(matcherName), m_matches(), m_matchingFactorThreshold(2.0),
-    m_matchingRatioThreshold(0.85), m_matchingTime(0.), m_matchRansacKeyPointsToPoints(), m_nbRansacIterations(200),
-    m_nbRansacMinInlierCount(100), m_objectFilteredPoints(), m_poseTime(0.), m_queryDescriptors(),
+    m_filterType(filterType), m_gridCellSize(0), m_gridMaxKeyPointsPerCell(0), m_guidedMatchingPose(),
+    m_guidedMatchingPoseValid(false), m_guidedMatchingRadius(20.0),
+    m_hammingMatcher(), m_imageFormat(jpgImageFormat), m_knnMatches(), m_mapOfImageId(),
+    m_mapOfImages(), m_matcher(), m_matcherName(matcherName), m_matches(), m_matchingFactorThreshold(2.0),
+    m_matchingRatioThreshold(0.85), m_matchingTime(0.), m_matchRansacKeyPointsToPoints(), m_maxKeyPoints(0),
+    m_nbRansacIterations(200), m_nbRansacMinInlierCount(100), m_objectFilteredPoints(), m_poseTime(0.),
+    m_queryDescriptors(),
     m_queryFilteredKeyPoints(), m_queryKeyPoints(), m_ransacConsensusPercentage(20.0), m_ransacFilterFlag(vpPose::NO_FILTER), m_ransacInliers(),
     m_ransacOutliers(), m_ransacParallel(false), m_ransacParallelNbThreads(0), m_ransacReprojectionError(6.0), m_ransacThreshold(0.01),
-    m_trainDescriptors(), m_trainKeyPoints(), m_trainPoints(), m_trainVpPoints(), m_useAffineDetection(false),
+    m_threadDetectors(), m_threadExtractors(), m_trainDescriptors(), m_trainKeyPoints(), m_trainPoints(),
+    m_trainVpPoints(), m_useAffineDetection(false),
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
     m_useBruteForceCrossCheck(true),
 #endif
-    m_useConsensusPercentage(false), m_useKnn(false), m_useMatchTrainToQuery(false), m_useRansacVVS(true),
-    m_useSingleMatchFilter(true), m_I()
+    m_useConsensusPercentage(false), m_useGuidedMatching(false),
+    m_useHammingMatcher(false), m_useKnn(false), m_useMatchTrainToQuery(false),
+    m_useRansacVVS(true), m_useSingleMatchFilter(true), m_I(), m_learningDatabase(),
+    m_learningDatabaseLocation()
 {
   initFeatureNames();
   init();
@@ -292,6 +385,7 @@ unsigned int vpKeyPoint::buildReference(const vpImage<unsigned char> &I, const v
   m_mapOfImageId.clear();
   m_mapOfImages.clear();
   m_currentImageId = 1;
+  m_learningDatabaseLocation = vpLearningDatabaseLocation();
 
   if (m_useAffineDetection) {
     std::vector<std::vector<cv::KeyPoint> > listOfTrainKeyPoints;
@@ -337,8 +431,7 @@ unsigned int vpKeyPoint::buildReference(const vpImage<unsigned char> &I, const v
   _reference_computed = true;
 
   // Add train descriptors in matcher object
-  m_matcher->clear();
-  m_matcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+  trainMatcher();
 
   return static_cast<unsigned int>(m_trainKeyPoints.size());
 }
@@ -468,6 +561,7 @@ void vpKeyPoint::buildReference(const vpImage<unsigned char> &I, const std::vect
     m_mapOfImages.clear();
     this->m_trainKeyPoints.clear();
     this->m_trainPoints.clear();
+    m_learningDatabaseLocation = vpLearningDatabaseLocation();
   }
 
   m_currentImageId++;
@@ -504,8 +598,7 @@ void vpKeyPoint::buildReference(const vpImage<unsigned char> &I, const std::vect
   vpConvert::convertFromOpenCV(this->m_trainPoints, m_trainVpPoints);
 
   // Add train descriptors in matcher object
-  m_matcher->clear();
-  m_matcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+  trainMatcher();
 
   _reference_computed = true;
 }
@@ -1371,14 +1464,166 @@ void vpKeyPoint::detect(const cv::Mat &matImg, std::vector<cv::KeyPoint> &keyPoi
   double t = vpTime::measureTimeMs();
   keyPoints.clear();
 
-  for (std::map<std::string, cv::Ptr<cv::FeatureDetector> >::const_iterator it = m_detectors.begin();
-       it != m_detectors.end(); ++it) {
+  const int nbTiles = static_cast<int>(m_detectionTilesX * m_detectionTilesY);
+  if (nbTiles <= 1) {
+    detectKeyPoints(m_detectors, matImg, keyPoints, mask);
+  } else {
+    // Each thread detects the keypoints of a tile with its own detectors
+    int nbThreads = 1;
+#ifdef VISP_HAVE_OPENMP
+    nbThreads = (std::min)(omp_get_max_threads(), nbTiles);
+#endif
+    updateThreadInstances(nbThreads);
+
+    const int nbTilesX = static_cast<int>(m_detectionTilesX), nbTilesY = static_cast<int>(m_detectionTilesY);
+    const int overlap = static_cast<int>(m_detectionTileOverlap);
+    std::vector<std::vector<cv::KeyPoint> > listOfTileKeyPoints((size_t)nbTiles);
+
+#ifdef VISP_HAVE_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(nbThreads)
+#endif
+    for (int tile = 0; tile < nbTiles; tile++) {
+      int threadId = 0;
+#ifdef VISP_HAVE_OPENMP
+      threadId = omp_get_thread_num();
+#endif
+      // Interior of the tile, and tile enlarged with the overlap
+      const int tx = tile % nbTilesX, ty = tile / nbTilesX;
+      const int x0 = tx * matImg.cols / nbTilesX, x1 = (tx + 1) * matImg.cols / nbTilesX;
+      const int y0 = ty * matImg.rows / nbTilesY, y1 = (ty + 1) * matImg.rows / nbTilesY;
+      const cv::Rect roi =
+          cv::Rect(x0 - overlap, y0 - overlap, x1 - x0 + 2 * overlap, y1 - y0 + 2 * overlap) &
+          cv::Rect(0, 0, matImg.cols, matImg.rows);
+
+      std::vector<cv::KeyPoint> kp;
+      detectKeyPoints(m_threadDetectors[(size_t)threadId], matImg(roi), kp, mask.empty() ? cv::Mat() : mask(roi));
+
+      std::vector<cv::KeyPoint> &tileKeyPoints = listOfTileKeyPoints[(size_t)tile];
+      tileKeyPoints.reserve(kp.size());
+      for (std::vector<cv::KeyPoint>::iterator it = kp.begin(); it != kp.end(); ++it) {
+        it->pt.x += roi.x;
+        it->pt.y += roi.y;
+        if (it->pt.x >= x0 && it->pt.x < x1 && it->pt.y >= y0 && it->pt.y < y1) {
+          tileKeyPoints.push_back(*it);
+        }
+      }
+    }
+
+    for (size_t i = 0; i < listOfTileKeyPoints.size(); i++) {
+      keyPoints.insert(keyPoints.end(), listOfTileKeyPoints[i].begin(), listOfTileKeyPoints[i].end());
+    }
+  }
+
+  if (m_gridCellSize > 0) {
+    gridFilter(keyPoints, matImg.size());
+  }
+
+  elapsedTime = vpTime::measureTimeMs() - t;
+}
+
+/*!
+   Detect the keypoints with a given set of detectors.
+
+   \param detectors : Feature detectors.
+   \param matImg : Input image.
+   \param keyPoints : Output list of the detected keypoints.
+   \param mask : 8-bit integer mask to detect only where mask[i][j] != 0.
+ */
+void vpKeyPoint::detectKeyPoints(const std::map<std::string, cv::Ptr<cv::FeatureDetector> > &detectors,
+                                 const cv::Mat &matImg, std::vector<cv::KeyPoint> &keyPoints, const cv::Mat &mask)
+{
+  for (std::map<std::string, cv::Ptr<cv::FeatureDetector> >::const_iterator it = detectors.begin();
+       it != detectors.end(); ++it) {
     std::vector<cv::KeyPoint> kp;
     it->second->detect(matImg, kp, mask);
     keyPoints.insert(keyPoints.end(), kp.begin(), kp.end());
   }
+}
 
-  elapsedTime = vpTime::measureTimeMs() - t;
+/*!
+   Keep in each cell of a grid the keypoints with the highest responses, then
+   the best keypoints of the image if their number is limited. See
+   setDetectionGrid().
+
+   \param keyPoints : List of keypoints to filter.
+   \param imageSize : Size of the image where the keypoints were detected.
+ */
+void vpKeyPoint::gridFilter(std::vector<cv::KeyPoint> &keyPoints, const cv::Size &imageSize)
+{
+  const int cellSize = static_cast<int>(m_gridCellSize);
+  const int nbCellsX = (imageSize.width + cellSize - 1) / cellSize;
+  const int nbCellsY = (imageSize.height + cellSize - 1) / cellSize;
+  if (nbCellsX <= 0 || nbCellsY <= 0) {
+    return;
+  }
+
+  // Sort the keypoints by cell, and by decreasing response in a cell
+  std::vector<std::pair<int, size_t> > cells(keyPoints.size());
+  for (size_t i = 0; i < keyPoints.size(); i++) {
+    int cx = (std::min)((std::max)(static_cast<int>(keyPoints[i].pt.x) / cellSize, 0), nbCellsX - 1);
+    int cy = (std::min)((std::max)(static_cast<int>(keyPoints[i].pt.y) / cellSize, 0), nbCellsY - 1);
+    cells[i] = std::pair<int, size_t>(cy * nbCellsX + cx, i);
+  }
+  std::sort(cells.begin(), cells.end(), KeyPointCellLess(keyPoints));
+
+  std::vector<cv::KeyPoint> filteredKeyPoints;
+  filteredKeyPoints.reserve(keyPoints.size());
+  unsigned int nbInCell = 0;
+  for (size_t i = 0; i < cells.size(); i++) {
+    nbInCell = (i > 0 && cells[i].first == cells[i - 1].first) ? nbInCell + 1 : 1;
+    if (nbInCell <= m_gridMaxKeyPointsPerCell) {
+      filteredKeyPoints.push_back(keyPoints[cells[i].second]);
+    }
+  }
+
+  if (m_maxKeyPoints > 0 && filteredKeyPoints.size() > m_maxKeyPoints) {
+    std::nth_element(filteredKeyPoints.begin(), filteredKeyPoints.begin() + m_maxKeyPoints, filteredKeyPoints.end(),
+                     KeyPointResponseGreater());
+    filteredKeyPoints.resize(m_maxKeyPoints);
+  }
+
+  keyPoints.swap(filteredKeyPoints);
+}
+
+/*!
+   Update the detector and extractor instances of each thread, the first
+   thread using the shared instances of this object. The instances are kept
+   between the calls and created again only when the number of threads
+   changes or when the detectors or the extractors have been initialized
+   again. The parameters of the shared instances are copied when OpenCV is
+   able to serialize them.
+
+   \param nbThreads : Number of threads.
+ */
+void vpKeyPoint::updateThreadInstances(int nbThreads)
+{
+  const size_t nbInstances = (size_t)(std::max)(nbThreads, 1);
+  if (m_threadDetectors.size() == nbInstances && m_threadExtractors.size() == nbInstances) {
+    return;
+  }
+
+  // Build the new instances aside, the object is left unchanged if an exception is thrown
+  std::vector<std::map<std::string, cv::Ptr<cv::FeatureDetector> > > detectors(nbInstances);
+  std::vector<std::map<std::string, cv::Ptr<cv::DescriptorExtractor> > > extractors(nbInstances);
+  detectors[0] = m_detectors;
+  extractors[0] = m_extractors;
+
+  for (size_t i = 1; i < nbInstances; i++) {
+    for (std::map<std::string, cv::Ptr<cv::FeatureDetector> >::const_iterator it = m_detectors.begin();
+         it != m_detectors.end(); ++it) {
+      initDetector(it->first, detectors[i]);
+      copyAlgorithmParameters(*it->second, *detectors[i][it->first]);
+    }
+
+    for (std::map<std::string, cv::Ptr<cv::DescriptorExtractor> >::const_iterator it = m_extractors.begin();
+         it != m_extractors.end(); ++it) {
+      initExtractor(it->first, extractors[i]);
+      copyAlgorithmParameters(*it->second, *extractors[i][it->first]);
+    }
+  }
+
+  m_threadDetectors.swap(detectors);
+  m_threadExtractors.swap(extractors);
 }
 
 /*!
@@ -1912,10 +2157,29 @@ void vpKeyPoint::extract(const cv::Mat &matImg, std::vector<cv::KeyPoint> &keyPo
                          double &elapsedTime, std::vector<cv::Point3f> *trainPoints)
 {
   double t = vpTime::measureTimeMs();
+  computeDescriptors(m_extractors, matImg, keyPoints, descriptors, trainPoints);
+  elapsedTime = vpTime::measureTimeMs() - t;
+}
+
+/*!
+   Compute the descriptors with a given set of extractors.
+
+   \param extractors : Descriptor extractors.
+   \param matImg : Input image.
+   \param keyPoints : List of keypoints we want to extract their descriptors.
+   \param descriptors : Descriptors matrix with at each row the descriptors
+   values for each keypoint.
+   \param trainPoints : Pointer to the list of 3D train points, when a
+   keypoint cannot be extracted, we need to remove the corresponding 3D point.
+ */
+void vpKeyPoint::computeDescriptors(const std::map<std::string, cv::Ptr<cv::DescriptorExtractor> > &extractors,
+                                    const cv::Mat &matImg, std::vector<cv::KeyPoint> &keyPoints,
+                                    cv::Mat &descriptors, std::vector<cv::Point3f> *trainPoints)
+{
   bool first = true;
 
-  for (std::map<std::string, cv::Ptr<cv::DescriptorExtractor> >::const_iterator itd = m_extractors.begin();
-       itd != m_extractors.end(); ++itd) {
+  for (std::map<std::string, cv::Ptr<cv::DescriptorExtractor> >::const_iterator itd = extractors.begin();
+       itd != extractors.end(); ++itd) {
     if (first) {
       first = false;
       // Check if we have 3D object points information
@@ -2006,7 +2270,6 @@ void vpKeyPoint::extract(const cv::Mat &matImg, std::vector<cv::KeyPoint> &keyPo
   if (keyPoints.size() != (size_t)descriptors.rows) {
     std::cerr << "keyPoints.size() != (size_t) descriptors.rows" << std::endl;
   }
-  elapsedTime = vpTime::measureTimeMs() - t;
 }
 
 /*!
@@ -2247,11 +2510,25 @@ void vpKeyPoint::init()
    \param detectorName : Name of the detector (e.g FAST, SIFT, SURF, etc.).
  */
 void vpKeyPoint::initDetector(const std::string &detectorName)
+{
+  m_threadDetectors.clear();
+  initDetector(detectorName, m_detectors);
+}
+
+/*!
+   Create a keypoint detector based on its name and add it to a list of
+   detectors.
+
+   \param detectorName : Name of the detector (e.g FAST, SIFT, SURF, etc.).
+   \param detectors : List of detectors where the new detector is added.
+ */
+void vpKeyPoint::initDetector(const std::string &detectorName,
+                              std::map<std::string, cv::Ptr<cv::FeatureDetector> > &detectors)
 {
 #if (VISP_HAVE_OPENCV_VERSION < 0x030000)
-  m_detectors[detectorName] = cv::FeatureDetector::create(detectorName);
+  detectors[detectorName] = cv::FeatureDetector::create(detectorName);
 
-  if (m_detectors[detectorName] == NULL) {
+  if (detectors[detectorName] == NULL) {
     std::stringstream ss_msg;
     ss_msg << "Fail to initialize the detector: " << detectorName
            << " or it is not available in OpenCV version: " << std::hex << VISP_HAVE_OPENCV_VERSION << ".";
@@ -2271,10 +2548,10 @@ void vpKeyPoint::initDetector(const std::string &detectorName)
 #ifdef VISP_HAVE_OPENCV_XFEATURES2D
     cv::Ptr<cv::FeatureDetector> siftDetector = cv::xfeatures2d::SIFT::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = siftDetector;
+      detectors[detectorNameTmp] = siftDetector;
     } else {
       std::cerr << "You should not use SIFT with Pyramid feature detection!" << std::endl;
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(siftDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(siftDetector);
     }
 #else
     std::stringstream ss_msg;
@@ -2286,10 +2563,10 @@ void vpKeyPoint::initDetector(const std::string &detectorName)
 #ifdef VISP_HAVE_OPENCV_XFEATURES2D
     cv::Ptr<cv::FeatureDetector> surfDetector = cv::xfeatures2d::SURF::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = surfDetector;
+      detectors[detectorNameTmp] = surfDetector;
     } else {
       std::cerr << "You should not use SURF with Pyramid feature detection!" << std::endl;
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(surfDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(surfDetector);
     }
 #else
     std::stringstream ss_msg;
@@ -2300,70 +2577,70 @@ void vpKeyPoint::initDetector(const std::string &detectorName)
   } else if (detectorNameTmp == "FAST") {
     cv::Ptr<cv::FeatureDetector> fastDetector = cv::FastFeatureDetector::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = fastDetector;
+      detectors[detectorNameTmp] = fastDetector;
     } else {
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(fastDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(fastDetector);
     }
   } else if (detectorNameTmp == "MSER") {
     cv::Ptr<cv::FeatureDetector> fastDetector = cv::MSER::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = fastDetector;
+      detectors[detectorNameTmp] = fastDetector;
     } else {
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(fastDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(fastDetector);
     }
   } else if (detectorNameTmp == "ORB") {
     cv::Ptr<cv::FeatureDetector> orbDetector = cv::ORB::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = orbDetector;
+      detectors[detectorNameTmp] = orbDetector;
     } else {
       std::cerr << "You should not use ORB with Pyramid feature detection!" << std::endl;
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(orbDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(orbDetector);
     }
   } else if (detectorNameTmp == "BRISK") {
     cv::Ptr<cv::FeatureDetector> briskDetector = cv::BRISK::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = briskDetector;
+      detectors[detectorNameTmp] = briskDetector;
     } else {
       std::cerr << "You should not use BRISK with Pyramid feature detection!" << std::endl;
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(briskDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(briskDetector);
     }
   } else if (detectorNameTmp == "KAZE") {
     cv::Ptr<cv::FeatureDetector> kazeDetector = cv::KAZE::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = kazeDetector;
+      detectors[detectorNameTmp] = kazeDetector;
     } else {
       std::cerr << "You should not use KAZE with Pyramid feature detection!" << std::endl;
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(kazeDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(kazeDetector);
     }
   } else if (detectorNameTmp == "AKAZE") {
     cv::Ptr<cv::FeatureDetector> akazeDetector = cv::AKAZE::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = akazeDetector;
+      detectors[detectorNameTmp] = akazeDetector;
     } else {
       std::cerr << "You should not use AKAZE with Pyramid feature detection!" << std::endl;
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(akazeDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(akazeDetector);
     }
   } else if (detectorNameTmp == "GFTT") {
     cv::Ptr<cv::FeatureDetector> gfttDetector = cv::GFTTDetector::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = gfttDetector;
+      detectors[detectorNameTmp] = gfttDetector;
     } else {
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(gfttDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(gfttDetector);
     }
   } else if (detectorNameTmp == "SimpleBlob") {
     cv::Ptr<cv::FeatureDetector> simpleBlobDetector = cv::SimpleBlobDetector::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = simpleBlobDetector;
+      detectors[detectorNameTmp] = simpleBlobDetector;
     } else {
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(simpleBlobDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(simpleBlobDetector);
     }
   } else if (detectorNameTmp == "STAR") {
 #ifdef VISP_HAVE_OPENCV_XFEATURES2D
     cv::Ptr<cv::FeatureDetector> starDetector = cv::xfeatures2d::StarDetector::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = starDetector;
+      detectors[detectorNameTmp] = starDetector;
     } else {
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(starDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(starDetector);
     }
 #else
     std::stringstream ss_msg;
@@ -2374,19 +2651,19 @@ void vpKeyPoint::initDetector(const std::string &detectorName)
   } else if (detectorNameTmp == "AGAST") {
     cv::Ptr<cv::FeatureDetector> agastDetector = cv::AgastFeatureDetector::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = agastDetector;
+      detectors[detectorNameTmp] = agastDetector;
     } else {
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(agastDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(agastDetector);
     }
   } else if (detectorNameTmp == "MSD") {
 #if (VISP_HAVE_OPENCV_VERSION >= 0x030100)
 #if defined(VISP_HAVE_OPENCV_XFEATURES2D)
     cv::Ptr<cv::FeatureDetector> msdDetector = cv::xfeatures2d::MSDDetector::create();
     if (!usePyramid) {
-      m_detectors[detectorNameTmp] = msdDetector;
+      detectors[detectorNameTmp] = msdDetector;
     } else {
       std::cerr << "You should not use MSD with Pyramid feature detection!" << std::endl;
-      m_detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(msdDetector);
+      detectors[detectorName] = cv::makePtr<PyramidAdaptedFeatureDetector>(msdDetector);
     }
 #else
     std::stringstream ss_msg;
@@ -2406,10 +2683,10 @@ void vpKeyPoint::initDetector(const std::string &detectorName)
   bool detectorInitialized = false;
   if (!usePyramid) {
     //if not null and to avoid warning C4800: forcing value to bool 'true' or 'false' (performance warning)
-    detectorInitialized = !m_detectors[detectorNameTmp].empty();
+    detectorInitialized = !detectors[detectorNameTmp].empty();
   } else {
     //if not null and to avoid warning C4800: forcing value to bool 'true' or 'false' (performance warning)
-    detectorInitialized = !m_detectors[detectorName].empty();
+    detectorInitialized = !detectors[detectorName].empty();
   }
 
   if (!detectorInitialized) {
@@ -2430,6 +2707,7 @@ void vpKeyPoint::initDetector(const std::string &detectorName)
  */
 void vpKeyPoint::initDetectors(const std::vector<std::string> &detectorNames)
 {
+  m_threadDetectors.clear();
   for (std::vector<std::string>::const_iterator it = detectorNames.begin(); it != detectorNames.end(); ++it) {
     initDetector(*it);
   }
@@ -2441,13 +2719,27 @@ void vpKeyPoint::initDetectors(const std::vector<std::string> &detectorNames)
    \param extractorName : Name of the extractor (e.g SIFT, SURF, ORB, etc.).
  */
 void vpKeyPoint::initExtractor(const std::string &extractorName)
+{
+  m_threadExtractors.clear();
+  initExtractor(extractorName, m_extractors);
+}
+
+/*!
+   Create a descriptor extractor based on its name and add it to a list of
+   extractors.
+
+   \param extractorName : Name of the extractor (e.g SIFT, SURF, ORB, etc.).
+   \param extractors : List of extractors where the new extractor is added.
+ */
+void vpKeyPoint::initExtractor(const std::string &extractorName,
+                               std::map<std::string, cv::Ptr<cv::DescriptorExtractor> > &extractors)
 {
 #if (VISP_HAVE_OPENCV_VERSION < 0x030000)
-  m_extractors[extractorName] = cv::DescriptorExtractor::create(extractorName);
+  extractors[extractorName] = cv::DescriptorExtractor::create(extractorName);
 #else
   if (extractorName == "SIFT") {
 #ifdef VISP_HAVE_OPENCV_XFEATURES2D
-    m_extractors[extractorName] = cv::xfeatures2d::SIFT::create();
+    extractors[extractorName] = cv::xfeatures2d::SIFT::create();
 #else
     std::stringstream ss_msg;
     ss_msg << "Fail to initialize the extractor: SIFT. OpenCV version  " << std::hex << VISP_HAVE_OPENCV_VERSION
@@ -2457,7 +2749,7 @@ void vpKeyPoint::initExtractor(const std::string &extractorName)
   } else if (extractorName == "SURF") {
 #ifdef VISP_HAVE_OPENCV_XFEATURES2D
     // Use extended set of SURF descriptors (128 instead of 64)
-    m_extractors[extractorName] = cv::xfeatures2d::SURF::create(100, 4, 3, true);
+    extractors[extractorName] = cv::xfeatures2d::SURF::create(100, 4, 3, true);
 #else
     std::stringstream ss_msg;
     ss_msg << "Fail to initialize the extractor: SURF. OpenCV version  " << std::hex << VISP_HAVE_OPENCV_VERSION
@@ -2465,12 +2757,12 @@ void vpKeyPoint::initExtractor(const std::string &extractorName)
     throw vpException(vpException::fatalError, ss_msg.str());
 #endif
   } else if (extractorName == "ORB") {
-    m_extractors[extractorName] = cv::ORB::create();
+    extractors[extractorName] = cv::ORB::create();
   } else if (extractorName == "BRISK") {
-    m_extractors[extractorName] = cv::BRISK::create();
+    extractors[extractorName] = cv::BRISK::create();
   } else if (extractorName == "FREAK") {
 #ifdef VISP_HAVE_OPENCV_XFEATURES2D
-    m_extractors[extractorName] = cv::xfeatures2d::FREAK::create();
+    extractors[extractorName] = cv::xfeatures2d::FREAK::create();
 #else
     std::stringstream ss_msg;
     ss_msg << "Fail to initialize the extractor: " << extractorName << ". OpenCV version " << std::hex
@@ -2479,7 +2771,7 @@ void vpKeyPoint::initExtractor(const std::string &extractorName)
 #endif
   } else if (extractorName == "BRIEF") {
 #ifdef VISP_HAVE_OPENCV_XFEATURES2D
-    m_extractors[extractorName] = cv::xfeatures2d::BriefDescriptorExtractor::create();
+    extractors[extractorName] = cv::xfeatures2d::BriefDescriptorExtractor::create();
 #else
     std::stringstream ss_msg;
     ss_msg << "Fail to initialize the extractor: " << extractorName << ". OpenCV version " << std::hex
@@ -2487,12 +2779,12 @@ void vpKeyPoint::initExtractor(const std::string &extractorName)
     throw vpException(vpException::fatalError, ss_msg.str());
 #endif
   } else if (extractorName == "KAZE") {
-    m_extractors[extractorName] = cv::KAZE::create();
+    extractors[extractorName] = cv::KAZE::create();
   } else if (extractorName == "AKAZE") {
-    m_extractors[extractorName] = cv::AKAZE::create();
+    extractors[extractorName] = cv::AKAZE::create();
   } else if (extractorName == "DAISY") {
 #ifdef VISP_HAVE_OPENCV_XFEATURES2D
-    m_extractors[extractorName] = cv::xfeatures2d::DAISY::create();
+    extractors[extractorName] = cv::xfeatures2d::DAISY::create();
 #else
     std::stringstream ss_msg;
     ss_msg << "Fail to initialize the extractor: " << extractorName << ". OpenCV version " << std::hex
@@ -2501,7 +2793,7 @@ void vpKeyPoint::initExtractor(const std::string &extractorName)
 #endif
   } else if (extractorName == "LATCH") {
 #ifdef VISP_HAVE_OPENCV_XFEATURES2D
-    m_extractors[extractorName] = cv::xfeatures2d::LATCH::create();
+    extractors[extractorName] = cv::xfeatures2d::LATCH::create();
 #else
     std::stringstream ss_msg;
     ss_msg << "Fail to initialize the extractor: " << extractorName << ". OpenCV version " << std::hex
@@ -2510,7 +2802,7 @@ void vpKeyPoint::initExtractor(const std::string &extractorName)
 #endif
   } else if (extractorName == "LUCID") {
 #ifdef VISP_HAVE_OPENCV_XFEATURES2D
-    //    m_extractors[extractorName] = cv::xfeatures2d::LUCID::create(1, 2);
+    //    extractors[extractorName] = cv::xfeatures2d::LUCID::create(1, 2);
     // Not possible currently, need a color image
     throw vpException(vpException::badValue, "Not possible currently as it needs a color image.");
 #else
@@ -2522,7 +2814,7 @@ void vpKeyPoint::initExtractor(const std::string &extractorName)
   } else if (extractorName == "VGG") {
 #if (VISP_HAVE_OPENCV_VERSION >= 0x030200)
 #if defined(VISP_HAVE_OPENCV_XFEATURES2D)
-    m_extractors[extractorName] = cv::xfeatures2d::VGG::create();
+    extractors[extractorName] = cv::xfeatures2d::VGG::create();
 #else
     std::stringstream ss_msg;
     ss_msg << "Fail to initialize the extractor: " << extractorName << ". OpenCV version " << std::hex
@@ -2538,7 +2830,7 @@ void vpKeyPoint::initExtractor(const std::string &extractorName)
   } else if (extractorName == "BoostDesc") {
 #if (VISP_HAVE_OPENCV_VERSION >= 0x030200)
 #if defined(VISP_HAVE_OPENCV_XFEATURES2D)
-    m_extractors[extractorName] = cv::xfeatures2d::BoostDesc::create();
+    extractors[extractorName] = cv::xfeatures2d::BoostDesc::create();
 #else
     std::stringstream ss_msg;
     ss_msg << "Fail to initialize the extractor: " << extractorName << ". OpenCV version " << std::hex
@@ -2556,7 +2848,7 @@ void vpKeyPoint::initExtractor(const std::string &extractorName)
   }
 #endif
 
-  if (!m_extractors[extractorName]) { //if null
+  if (!extractors[extractorName]) { //if null
     std::stringstream ss_msg;
     ss_msg << "Fail to initialize the extractor: " << extractorName
            << " or it is not available in OpenCV version: " << std::hex << VISP_HAVE_OPENCV_VERSION << ".";
@@ -2566,7 +2858,7 @@ void vpKeyPoint::initExtractor(const std::string &extractorName)
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
   if (extractorName == "SURF") {
     // Use extended set of SURF descriptors (128 instead of 64)
-    m_extractors[extractorName]->set("extended", 1);
+    extractors[extractorName]->set("extended", 1);
   }
 #endif
 }
@@ -2579,6 +2871,7 @@ void vpKeyPoint::initExtractor(const std::string &extractorName)
  */
 void vpKeyPoint::initExtractors(const std::vector<std::string> &extractorNames)
 {
+  m_threadExtractors.clear();
   for (std::vector<std::string>::const_iterator it = extractorNames.begin(); it != extractorNames.end(); ++it) {
     initExtractor(*it);
   }
@@ -2693,9 +2986,20 @@ void vpKeyPoint::initMatcher(const std::string &matcherName)
       m_matcher = new cv::FlannBasedMatcher(new cv::flann::KDTreeIndexParams());
 #endif
     }
+  } else if (matcherName == "vpBruteForce-Hamming" || matcherName == "vpMultiIndex-Hamming") {
+    if (!m_extractors.empty() && descriptorType != CV_8U) {
+      throw vpException(vpException::badValue, "The %s matcher can only be used with binary descriptors",
+                        matcherName.c_str());
+    }
+
+    // The OpenCV matcher is kept to match the train descriptors to the query descriptors
+    m_matcher = cv::DescriptorMatcher::create("BruteForce-Hamming");
+    m_hammingMatcher = vpHammingMatcher(matcherName == "vpBruteForce-Hamming" ? vpHammingMatcher::BRUTE_FORCE
+                                                                              : vpHammingMatcher::MULTI_INDEX_HASHING);
   } else {
     m_matcher = cv::DescriptorMatcher::create(matcherName);
   }
+  m_useHammingMatcher = (matcherName == "vpBruteForce-Hamming" || matcherName == "vpMultiIndex-Hamming");
 
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
   if (m_matcher != NULL && !m_useKnn && matcherName == "BruteForce") {
@@ -2711,6 +3015,29 @@ void vpKeyPoint::initMatcher(const std::string &matcherName)
   }
 }
 
+/*!
+   Add the train descriptors to the matcher.
+ */
+void vpKeyPoint::trainMatcher()
+{
+  m_matcher->clear();
+  m_matcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+
+  if (m_useHammingMatcher) {
+    if (m_trainDescriptors.empty()) {
+      m_hammingMatcher.clear();
+    } else {
+      if (m_trainDescriptors.depth() != CV_8U) {
+        throw vpException(vpException::badValue, "The %s matcher can only be used with binary descriptors",
+                          m_matcherName.c_str());
+      }
+      m_hammingMatcher.train(m_trainDescriptors.data, (unsigned int)m_trainDescriptors.rows,
+                             (unsigned int)(m_trainDescriptors.cols * m_trainDescriptors.elemSize()),
+                             m_trainDescriptors.step[0]);
+    }
+  }
+}
+
 /*!
    Insert a reference image and a current image side-by-side.
 
@@ -2905,6 +3232,8 @@ void vpKeyPoint::loadConfigFile(const std::string &configFile)
     m_extractorNames.clear();
     m_detectors.clear();
     m_extractors.clear();
+    m_threadDetectors.clear();
+    m_threadExtractors.clear();
 
     std::cout << " *********** Parsing XML for configuration for vpKeyPoint "
                  "************ "
@@ -2981,6 +3310,7 @@ void vpKeyPoint::loadLearningData(const std::string &filename, const bool binary
     m_trainPoints.clear();
     m_mapOfImageId.clear();
     m_mapOfImages.clear();
+    m_learningDatabaseLocation = vpLearningDatabaseLocation();
   } else {
     // In append case, find the max index of keypoint class Id
     for (std::map<int, int>::const_iterator it = m_mapOfImageId.begin(); it != m_mapOfImageId.end(); ++it) {
@@ -3352,8 +3682,7 @@ void vpKeyPoint::loadLearningData(const std::string &filename, const bool binary
   vpConvert::convertFromOpenCV(this->m_trainPoints, m_trainVpPoints);
 
   // Add train descriptors in matcher object
-  m_matcher->clear();
-  m_matcher->add(std::vector<cv::Mat>(1, m_trainDescriptors));
+  trainMatcher();
 
   // Set _reference_computed to true as we load a learning file
   _reference_computed = true;
@@ -3362,6 +3691,383 @@ void vpKeyPoint::loadLearningData(const std::string &filename, const bool binary
   m_currentImageId = (int)m_mapOfImages.size();
 }
 
+namespace
+{
+// Learning database file layout, see vpKeyPoint::saveLearningDatabase()
+const char learningDatabaseMagic[8] = {'V', 'P', 'K', 'P', 'D', 'B', '\0', '\0'};
+const int learningDatabaseVersion = 1;
+const int learningDatabaseByteOrderMark = 0x01020304;
+const size_t learningDatabaseAlignment = 64;
+const int learningDatabaseMinCapacity = 1024;
+
+struct LearningDatabaseHeader {
+  char magic[8];
+  int version;
+  int byteOrderMark;
+  int have3DInfo;
+  int descriptorType;
+  int descriptorCols;
+  int descriptorRowBytes;
+  int nbKeyPoints;
+  int capacity;
+  int nbImages;
+  int nbIndexEntries;
+  int maxClassId;
+  int maxImageId;
+  int reserved[2];
+};
+
+struct LearningDatabaseKeyPoint {
+  float u, v, size, angle, response;
+  int octave, class_id, image_id;
+};
+
+// Run of consecutive keypoints sharing the same class id and image id
+struct LearningDatabaseIndexEntry {
+  int class_id, image_id, first, count;
+};
+
+inline size_t alignLearningDatabaseOffset(size_t offset)
+{
+  return (offset + learningDatabaseAlignment - 1) / learningDatabaseAlignment * learningDatabaseAlignment;
+}
+
+// Offsets of the keypoints, 3D points, descriptors and tables sections, that only depend on the capacity
+void learningDatabaseLayout(const LearningDatabaseHeader &header, size_t &keyPointsOffset, size_t &pointsOffset,
+                            size_t &descriptorsOffset, size_t &tablesOffset)
+{
+  const size_t capacity = (size_t)header.capacity;
+  keyPointsOffset = alignLearningDatabaseOffset(sizeof(LearningDatabaseHeader));
+  pointsOffset = alignLearningDatabaseOffset(keyPointsOffset + capacity * sizeof(LearningDatabaseKeyPoint));
+  descriptorsOffset =
+      alignLearningDatabaseOffset(pointsOffset + (header.have3DInfo ? capacity * 3 * sizeof(float) : 0));
+  tablesOffset = alignLearningDatabaseOffset(descriptorsOffset + capacity * (size_t)header.descriptorRowBytes);
+}
+
+void checkLearningDatabaseHeader(const LearningDatabaseHeader &header, const std::string &filename)
+{
+  if (std::memcmp(header.magic, learningDatabaseMagic, sizeof(learningDatabaseMagic)) != 0) {
+    throw vpException(vpException::ioError, "%s is not a learning database", filename.c_str());
+  }
+  if (header.version != learningDatabaseVersion) {
+    throw vpException(vpException::ioError, "Unsupported learning database version %d in %s", header.version,
+                      filename.c_str());
+  }
+  if (header.byteOrderMark != learningDatabaseByteOrderMark) {
+    throw vpException(vpException::ioError, "Learning database %s was written with a different byte order",
+                      filename.c_str());
+  }
+  if (header.nbKeyPoints < 0 || header.nbKeyPoints > header.capacity || header.nbImages < 0 ||
+      header.nbIndexEntries < 0 || header.nbIndexEntries > header.nbKeyPoints) {
+    throw vpException(vpException::ioError, "Corrupted learning database %s", filename.c_str());
+  }
+
+  // The descriptors are accessed in place with a cv::Mat of single channel rows
+  const int depth = CV_MAT_DEPTH(header.descriptorType);
+  if (header.descriptorType != CV_MAKETYPE(depth, 1) || depth > CV_64F || header.descriptorCols <= 0 ||
+      header.descriptorRowBytes < 0 ||
+      (uint64_t)header.descriptorRowBytes < (uint64_t)header.descriptorCols * CV_ELEM_SIZE(header.descriptorType)) {
+    throw vpException(vpException::ioError, "Corrupted descriptors in the learning database %s", filename.c_str());
+  }
+
+  // The sections must be addressable, learningDatabaseLayout() computes their offsets with size_t
+  const uint64_t capacitySize = (uint64_t)header.capacity * (sizeof(LearningDatabaseKeyPoint) + 3 * sizeof(float) +
+                                                               (uint64_t)header.descriptorRowBytes);
+  if (capacitySize + 5 * learningDatabaseAlignment > (uint64_t)(std::numeric_limits<size_t>::max)()) {
+    throw vpException(vpException::ioError, "Learning database %s is too large", filename.c_str());
+  }
+}
+
+// Read the index of the keypoints and the table of training images stored at the end of a learning database
+void readLearningDatabaseTables(const char *data, size_t size, const LearningDatabaseHeader &header,
+                                std::vector<LearningDatabaseIndexEntry> &index,
+                                std::map<int, std::string> &mapOfImgPath)
+{
+  const size_t indexSize = (size_t)header.nbIndexEntries * sizeof(LearningDatabaseIndexEntry);
+  if (indexSize > size) {
+    throw vpException(vpException::ioError, "Corrupted index of the learning database");
+  }
+  index.resize((size_t)header.nbIndexEntries);
+  if (!index.empty()) {
+    std::memcpy(&index[0], data, indexSize);
+  }
+  int next = 0;
+  for (size_t i = 0; i < index.size(); i++) {
+    if (index[i].first != next || index[i].count <= 0 || index[i].count > header.nbKeyPoints - next) {
+      throw vpException(vpException::ioError, "Corrupted index of the learning database");
+    }
+    next += index[i].count;
+  }
+  if (next != header.nbKeyPoints) {
+    throw vpException(vpException::ioError, "Corrupted index of the learning database");
+  }
+
+  size_t offset = indexSize;
+  for (int i = 0; i < header.nbImages; i++) {
+    int id = 0, length = 0;
+    if (offset + 2 * sizeof(int) > size) {
+      throw vpException(vpException::ioError, "Corrupted table of training images in the learning database");
+    }
+    std::memcpy(&id, data + offset, sizeof(int));
+    std::memcpy(&length, data + offset + sizeof(int), sizeof(int));
+    offset += 2 * sizeof(int);
+    if (length < 0 || offset + (size_t)length > size) {
+      throw vpException(vpException::ioError, "Corrupted table of training images in the learning database");
+    }
+    mapOfImgPath[id] = std::string(data + offset, (size_t)length);
+    offset += (size_t)length;
+  }
+}
+}
+
+vpKeyPoint::vpLearningDatabaseMemory::~vpLearningDatabaseMemory()
+{
+  if (m_data != NULL) {
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+    if (m_mapped) {
+      munmap(m_data, m_size);
+    } else {
+      delete[] m_data;
+    }
+#else
+    delete[] m_data;
+#endif
+  }
+}
+
+/*!
+  Load a learning database saved with saveLearningDatabase().
+
+  On Unix-like systems the file is memory mapped and the train descriptors
+  directly point to the mapped memory, so that loading a database of
+  millions of descriptors does not copy them. The mapping is private: the
+  file is never modified through the train descriptors. On other systems the
+  file is read at once.
+
+  \param filename : Path of the learning database.
+  \param append : If true, append the loaded data to the current train data.
+  The train descriptors are then copied.
+
+  \warning The matrix returned by getTrainDescriptors() may share the memory
+  of the database, it is only valid while this object, or a copy of it, is
+  alive and no other database is loaded.
+*/
+void vpKeyPoint::loadLearningDatabase(const std::string &filename, const bool append)
+{
+  readLearningDatabase(filename, NULL, append);
+}
+
+/*!
+  Load from a learning database saved with saveLearningDatabase() only the
+  keypoints of some reference views. The index of the database gives the
+  range of keypoints of each training image id, so that the other keypoints
+  are never read. The selected descriptors are copied.
+
+  \param filename : Path of the learning database.
+  \param imageIds : Ids in the database of the training images of the
+  reference views to load.
+  \param append : If true, append the loaded data to the current train data.
+*/
+void vpKeyPoint::loadLearningDatabase(const std::string &filename, const std::vector<int> &imageIds,
+                                      const bool append)
+{
+  readLearningDatabase(filename, &imageIds, append);
+}
+
+void vpKeyPoint::readLearningDatabase(const std::string &filename, const std::vector<int> *imageIds,
+                                      const bool append)
+{
+  cv::Ptr<vpLearningDatabaseMemory> memory = cv::Ptr<vpLearningDatabaseMemory>(new vpLearningDatabaseMemory);
+
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__))) // UNIX
+  int fd = open(filename.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw vpException(vpException::ioError, "Cannot open the learning database %s", filename.c_str());
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(LearningDatabaseHeader)) {
+    close(fd);
+    throw vpException(vpException::ioError, "%s is not a learning database", filename.c_str());
+  }
+  memory->m_size = (size_t)st.st_size;
+  void *addr = mmap(NULL, memory->m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (addr == MAP_FAILED) {
+    throw vpException(vpException::ioError, "Cannot map the learning database %s", filename.c_str());
+  }
+  memory->m_data = (char *)addr;
+  memory->m_mapped = true;
+#else
+  std::ifstream file(filename.c_str(), std::ifstream::binary);
+  if (!file.is_open()) {
+    throw vpException(vpException::ioError, "Cannot open the learning database %s", filename.c_str());
+  }
+  file.seekg(0, std::ios::end);
+  memory->m_size = (size_t)file.tellg();
+  file.seekg(0, std::ios::beg);
+  if (memory->m_size < sizeof(LearningDatabaseHeader)) {
+    throw vpException(vpException::ioError, "%s is not a learning database", filename.c_str());
+  }
+  memory->m_data = new char[memory->m_size];
+  if (!file.read(memory->m_data, (std::streamsize)memory->m_size)) {
+    throw vpException(vpException::ioError, "Cannot read the learning database %s", filename.c_str());
+  }
+#endif
+
+  LearningDatabaseHeader header;
+  std::memcpy(&header, memory->m_data, sizeof(header));
+  checkLearningDatabaseHeader(header, filename);
+
+  size_t keyPointsOffset, pointsOffset, descriptorsOffset, tablesOffset;
+  learningDatabaseLayout(header, keyPointsOffset, pointsOffset, descriptorsOffset, tablesOffset);
+  if (memory->m_size < tablesOffset) {
+    throw vpException(vpException::ioError, "Truncated learning database %s", filename.c_str());
+  }
+
+  // Index of the keypoints and training images
+  std::vector<LearningDatabaseIndexEntry> index;
+  std::map<int, std::string> mapOfImgPath;
+  readLearningDatabaseTables(memory->m_data + tablesOffset, memory->m_size - tablesOffset, header, index,
+                             mapOfImgPath);
+
+  // Ranges of keypoints to load
+  std::vector<cv::Range> ranges;
+  if (imageIds == NULL) {
+    if (header.nbKeyPoints > 0) {
+      ranges.push_back(cv::Range(0, header.nbKeyPoints));
+    }
+  } else {
+    for (std::vector<LearningDatabaseIndexEntry>::const_iterator it = index.begin(); it != index.end(); ++it) {
+      if (std::find(imageIds->begin(), imageIds->end(), it->image_id) == imageIds->end()) {
+        continue;
+      }
+      if (!ranges.empty() && ranges.back().end == it->first) {
+        ranges.back().end += it->count;
+      } else {
+        ranges.push_back(cv::Range(it->first, it->first + it->count));
+      }
+    }
+    for (std::map<int, std::string>::iterator it = mapOfImgPath.begin(); it != mapOfImgPath.end();) {
+      if (std::find(imageIds->begin(), imageIds->end(), it->first) == imageIds->end()) {
+        mapOfImgPath.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  const bool wasEmpty = m_trainKeyPoints.empty();
+  int startClassId = 0;
+  int startImageId = 0;
+  if (!append) {
+    m_trainKeyPoints.clear();
+    m_trainPoints.clear();
+    m_mapOfImageId.clear();
+    m_mapOfImages.clear();
+  } else {
+    // In append case, find the max index of keypoint class Id and of images Id
+    for (std::map<int, int>::const_iterator it = m_mapOfImageId.begin(); it != m_mapOfImageId.end(); ++it) {
+      startClassId = (std::max)(startClassId, it->first);
+    }
+    for (std::map<int, vpImage<unsigned char> >::const_iterator it = m_mapOfImages.begin(); it != m_mapOfImages.end();
+         ++it) {
+      startImageId = (std::max)(startImageId, it->first);
+    }
+  }
+
+  // Training images
+#ifdef VISP_HAVE_MODULE_IO
+  std::string parent = vpIoTools::getParent(filename);
+  if (!parent.empty()) {
+    parent += "/";
+  }
+  for (std::map<int, std::string>::const_iterator it = mapOfImgPath.begin(); it != mapOfImgPath.end(); ++it) {
+    vpImage<unsigned char> I;
+    if (vpIoTools::isAbsolutePathname(it->second)) {
+      vpImageIo::read(I, it->second);
+    } else {
+      vpImageIo::read(I, parent + it->second);
+    }
+    m_mapOfImages[it->first + startImageId] = I;
+  }
+#else
+  if (!mapOfImgPath.empty()) {
+    std::cout << "Warning: The learning database contains image data that will "
+                 "not be loaded as visp_io module "
+                 "is not available !"
+              << std::endl;
+  }
+#endif
+
+  // Keypoints and 3D points
+  const float *points = (const float *)(memory->m_data + pointsOffset);
+  for (std::vector<cv::Range>::const_iterator it = ranges.begin(); it != ranges.end(); ++it) {
+    for (int i = it->start; i < it->end; i++) {
+      LearningDatabaseKeyPoint kp;
+      std::memcpy(&kp, memory->m_data + keyPointsOffset + (size_t)i * sizeof(LearningDatabaseKeyPoint), sizeof(kp));
+      m_trainKeyPoints.push_back(cv::KeyPoint(cv::Point2f(kp.u, kp.v), kp.size, kp.angle, kp.response, kp.octave,
+                                              kp.class_id + startClassId));
+#ifdef VISP_HAVE_MODULE_IO
+      if (kp.image_id != -1) {
+        m_mapOfImageId[m_trainKeyPoints.back().class_id] = kp.image_id + startImageId;
+      }
+#endif
+      if (header.have3DInfo) {
+        m_trainPoints.push_back(cv::Point3f(points[3 * i], points[3 * i + 1], points[3 * i + 2]));
+      }
+    }
+  }
+
+  // Descriptors, without copy when the whole database is loaded
+  cv::Mat allDescriptors(header.nbKeyPoints, header.descriptorCols, header.descriptorType,
+                         memory->m_data + descriptorsOffset, (size_t)header.descriptorRowBytes);
+  cv::Mat descriptors;
+  if (imageIds == NULL) {
+    descriptors = allDescriptors;
+  } else {
+    for (std::vector<cv::Range>::const_iterator it = ranges.begin(); it != ranges.end(); ++it) {
+      descriptors.push_back(allDescriptors.rowRange(*it));
+    }
+  }
+  if (!append || m_trainDescriptors.empty()) {
+    m_trainDescriptors = descriptors;
+    if (imageIds == NULL) {
+      m_learningDatabase = memory;
+    } else {
+      m_learningDatabase.release();
+    }
+  } else if (!descriptors.empty()) {
+    cv::vconcat(m_trainDescriptors, descriptors, m_trainDescriptors);
+  }
+
+  // Remember where the train keypoints are stored when they all come from this database
+  if (!append || wasEmpty) {
+    m_learningDatabaseLocation = vpLearningDatabaseLocation();
+    if (imageIds == NULL) {
+      m_learningDatabaseLocation.m_filename = filename;
+      m_learningDatabaseLocation.m_size = header.nbKeyPoints;
+      m_learningDatabaseLocation.m_classIdOffset = -startClassId;
+      m_learningDatabaseLocation.m_imageIdOffset = -startImageId;
+    }
+  }
+
+  // Convert OpenCV type to ViSP type for compatibility
+  vpConvert::convertFromOpenCV(m_trainKeyPoints, referenceImagePointsList);
+  vpConvert::convertFromOpenCV(this->m_trainPoints, m_trainVpPoints);
+
+  // Add train descriptors in matcher object
+  trainMatcher();
+
+  // Set _reference_computed to true as we load a learning file
+  _reference_computed = true;
+
+  // Set m_currentImageId after the ids of the loaded views, even when their images are not saved
+  m_currentImageId = (int)m_mapOfImages.size();
+  for (std::map<int, int>::const_iterator it = m_mapOfImageId.begin(); it != m_mapOfImageId.end(); ++it) {
+    m_currentImageId = (std::max)(m_currentImageId, it->second);
+  }
+}
+
 /*!
    Match keypoints based on distance between their descriptors.
 
@@ -3375,7 +4081,36 @@ void vpKeyPoint::match(const cv::Mat &trainDescriptors, const cv::Mat &queryDesc
 {
   double t = vpTime::measureTimeMs();
 
-  if (m_useKnn) {
+  if (m_useHammingMatcher && !m_useMatchTrainToQuery) {
+    if (m_hammingMatcher.getNbTrainDescriptors() > 0 &&
+        (queryDescriptors.depth() != CV_8U ||
+         queryDescriptors.cols * (int)queryDescriptors.elemSize() != (int)m_hammingMatcher.getDescriptorSize())) {
+      throw vpException(vpException::badValue, "The query descriptors do not match the binary train descriptors");
+    }
+
+    // With knn, the search of a query can stop as soon as the ratio test succeeds
+    m_hammingMatcher.setRatioThreshold(m_useKnn ? m_matchingRatioThreshold : 0.);
+    std::vector<vpHammingMatcher::vpHammingMatch> hammingMatches;
+    m_hammingMatcher.match(queryDescriptors.data, (unsigned int)queryDescriptors.rows, queryDescriptors.step[0],
+                           hammingMatches);
+
+    matches.clear();
+    m_knnMatches.clear();
+    for (size_t i = 0; i < hammingMatches.size(); i++) {
+      const vpHammingMatcher::vpHammingMatch &m = hammingMatches[i];
+      if (m.trainIdx < 0) {
+        continue;
+      }
+      if (m_useKnn) {
+        std::vector<cv::DMatch> knn(1, cv::DMatch((int)i, m.trainIdx, (float)m.distance));
+        if (m.secondTrainIdx >= 0) {
+          knn.push_back(cv::DMatch((int)i, m.secondTrainIdx, (float)m.secondDistance));
+        }
+        m_knnMatches.push_back(knn);
+      }
+      matches.push_back(cv::DMatch((int)i, m.trainIdx, (float)m.distance));
+    }
+  } else if (m_useKnn) {
     m_knnMatches.clear();
 
     if (m_useMatchTrainToQuery) {
@@ -3422,6 +4157,116 @@ void vpKeyPoint::match(const cv::Mat &trainDescriptors, const cv::Mat &queryDesc
   elapsedTime = vpTime::measureTimeMs() - t;
 }
 
+/*!
+   Match the query keypoints only with the train keypoints whose 3D points are
+   projected close to them with the pose of the previous image, see
+   setGuidedMatching().
+
+   \param cam : Camera parameters.
+   \param height : Image height.
+   \param width : Image width.
+   \param matches : Output list of matches, the knn matches are also updated
+   when needed.
+   \param elapsedTime : Elapsed time.
+ */
+void vpKeyPoint::matchGuided(const vpCameraParameters &cam, const unsigned int height, const unsigned int width,
+                             std::vector<cv::DMatch> &matches, double &elapsedTime)
+{
+  double t = vpTime::measureTimeMs();
+  matches.clear();
+  m_knnMatches.clear();
+
+  // Project the train 3D points and sort them in a grid whose cell size is the search radius
+  const double radius = (std::max)(m_guidedMatchingRadius, 1.0);
+  const int nbCellsX = (std::max)(1, (int)std::ceil(width / radius));
+  const int nbCellsY = (std::max)(1, (int)std::ceil(height / radius));
+  const vpHomogeneousMatrix &cMo = m_guidedMatchingPose;
+  std::vector<float> projU(m_trainPoints.size()), projV(m_trainPoints.size());
+  std::vector<int> cellOfTrainPoint(m_trainPoints.size(), -1);
+  std::vector<unsigned int> cellOffsets((size_t)(nbCellsX * nbCellsY + 1), 0);
+  for (size_t i = 0; i < m_trainPoints.size(); i++) {
+    const cv::Point3f &P = m_trainPoints[i];
+    double X = cMo[0][0] * P.x + cMo[0][1] * P.y + cMo[0][2] * P.z + cMo[0][3];
+    double Y = cMo[1][0] * P.x + cMo[1][1] * P.y + cMo[1][2] * P.z + cMo[1][3];
+    double Z = cMo[2][0] * P.x + cMo[2][1] * P.y + cMo[2][2] * P.z + cMo[2][3];
+    if (Z <= 0) {
+      continue;
+    }
+
+    double u = 0, v = 0;
+    vpMeterPixelConversion::convertPoint(cam, X / Z, Y / Z, u, v);
+    if (u < -radius || v < -radius || u >= width + radius || v >= height + radius) {
+      continue;
+    }
+    projU[i] = (float)u;
+    projV[i] = (float)v;
+    int cx = (std::min)((std::max)((int)(u / radius), 0), nbCellsX - 1);
+    int cy = (std::min)((std::max)((int)(v / radius), 0), nbCellsY - 1);
+    cellOfTrainPoint[i] = cy * nbCellsX + cx;
+    cellOffsets[(size_t)cellOfTrainPoint[i] + 1]++;
+  }
+  for (size_t i = 1; i < cellOffsets.size(); i++) {
+    cellOffsets[i] += cellOffsets[i - 1];
+  }
+  std::vector<unsigned int> cellTrainIds(cellOffsets.back());
+  std::vector<unsigned int> cursor(cellOffsets.begin(), cellOffsets.end() - 1);
+  for (size_t i = 0; i < cellOfTrainPoint.size(); i++) {
+    if (cellOfTrainPoint[i] >= 0) {
+      cellTrainIds[cursor[(size_t)cellOfTrainPoint[i]]++] = (unsigned int)i;
+    }
+  }
+
+  // Compare each query descriptor with the train descriptors projected in its neighborhood
+  const int normType = descriptorNormType(m_matcherName, m_trainDescriptors.depth());
+  const float squaredRadius = (float)(radius * radius);
+  const float maxDist = (std::numeric_limits<float>::max)();
+  for (size_t q = 0; q < m_queryKeyPoints.size(); q++) {
+    const cv::Point2f &pt = m_queryKeyPoints[q].pt;
+    const int cx = (int)std::floor(pt.x / radius), cy = (int)std::floor(pt.y / radius);
+    int bestIdx = -1, secondIdx = -1;
+    float bestDist = maxDist, secondDist = maxDist;
+
+    for (int y = (std::max)(cy - 1, 0); y <= (std::min)(cy + 1, nbCellsY - 1); y++) {
+      for (int x = (std::max)(cx - 1, 0); x <= (std::min)(cx + 1, nbCellsX - 1); x++) {
+        const size_t cell = (size_t)(y * nbCellsX + x);
+        for (unsigned int k = cellOffsets[cell]; k < cellOffsets[cell + 1]; k++) {
+          const unsigned int i = cellTrainIds[k];
+          const float du = projU[i] - pt.x, dv = projV[i] - pt.y;
+          if (du * du + dv * dv > squaredRadius) {
+            continue;
+          }
+
+          float dist = (float)cv::norm(m_queryDescriptors.row((int)q), m_trainDescriptors.row((int)i), normType);
+          if (dist < bestDist) {
+            secondIdx = bestIdx;
+            secondDist = bestDist;
+            bestIdx = (int)i;
+            bestDist = dist;
+          } else if (dist < secondDist) {
+            secondIdx = (int)i;
+            secondDist = dist;
+          }
+        }
+      }
+    }
+
+    if (bestIdx >= 0) {
+      matches.push_back(cv::DMatch((int)q, bestIdx, bestDist));
+      if (m_useKnn) {
+        // As with a knn matching against a single train descriptor, a query keypoint without a second candidate
+        // in its search region only has one neighbor and is rejected by filterMatches()
+        std::vector<cv::DMatch> knn(1, matches.back());
+        if (secondIdx >= 0) {
+          knn.push_back(cv::DMatch((int)q, secondIdx, secondDist));
+        }
+        m_knnMatches.push_back(knn);
+      }
+    }
+  }
+
+  elapsedTime = vpTime::measureTimeMs() - t;
+}
+
 /*!
    Match keypoints detected in the image with those built in the reference
    list.
@@ -3673,9 +4518,52 @@ bool vpKeyPoint::matchPoint(const vpImage<unsigned char> &I, const vpCameraParam
     extract(I, m_queryKeyPoints, m_queryDescriptors, m_extractionTime);
   }
 
-  match(m_trainDescriptors, m_queryDescriptors, m_matches, m_matchingTime);
+  elapsedTime = m_detectionTime + m_extractionTime;
 
-  elapsedTime = m_detectionTime + m_extractionTime + m_matchingTime;
+  const bool guidedMatching = m_useGuidedMatching && m_guidedMatchingPoseValid &&
+                              m_trainPoints.size() == (size_t)m_trainDescriptors.rows;
+  bool res = matchQueryAndComputePose(cam, I.getHeight(), I.getWidth(), guidedMatching, cMo, error, elapsedTime, func);
+  if (guidedMatching && !res) {
+    // The previous pose is lost, match the same query descriptors with all the train keypoints
+    res = matchQueryAndComputePose(cam, I.getHeight(), I.getWidth(), false, cMo, error, elapsedTime, func);
+  }
+
+  if (res) {
+    m_guidedMatchingPose = cMo;
+  }
+  m_guidedMatchingPoseValid = res;
+
+  return res;
+}
+
+/*!
+   Match the query descriptors of the current image with the train
+   descriptors, filter the matches and compute the pose.
+
+   \param cam : Camera parameters.
+   \param height : Image height.
+   \param width : Image width.
+   \param guidedMatching : If true, only match the query keypoints with the
+   train keypoints projected close to them with the guided matching pose.
+   \param cMo : Homogeneous matrix between the object frame and the camera frame.
+   \param error : Reprojection mean square error (in pixel) between the
+   2D points and the projection of the 3D points with the estimated pose.
+   \param elapsedTime : Time to which the matching and pose estimation times are added.
+   \param func : Function pointer to filter the pose in Ransac pose estimation.
+   \return True if the pose estimation is OK, false otherwise.
+ */
+bool vpKeyPoint::matchQueryAndComputePose(const vpCameraParameters &cam, const unsigned int height,
+                                          const unsigned int width, const bool guidedMatching,
+                                          vpHomogeneousMatrix &cMo, double &error, double &elapsedTime,
+                                          bool (*func)(const vpHomogeneousMatrix &))
+{
+  if (guidedMatching) {
+    matchGuided(cam, height, width, m_matches, m_matchingTime);
+  } else {
+    match(m_trainDescriptors, m_queryDescriptors, m_matches, m_matchingTime);
+  }
+
+  elapsedTime += m_matchingTime;
 
   if (m_filterType != noFilterMatching) {
     m_queryFilteredKeyPoints.clear();
@@ -4114,10 +5002,21 @@ void vpKeyPoint::detectExtractAffine(const vpImage<unsigned char> &I,
     listOfAffineI->resize(listOfAffineParams.size());
   }
 
+  // Each thread uses its own detectors and extractors, that may not be thread safe
+  int nbThreads = 1;
+#ifdef VISP_HAVE_OPENMP
+  nbThreads = (std::min)(omp_get_max_threads(), static_cast<int>(listOfAffineParams.size()));
+#endif
+  updateThreadInstances(nbThreads);
+
 #ifdef VISP_HAVE_OPENMP
-#pragma omp parallel for
+#pragma omp parallel for schedule(dynamic) num_threads(nbThreads)
 #endif
   for (int cpt = 0; cpt < static_cast<int>(listOfAffineParams.size()); cpt++) {
+    int threadId = 0;
+#ifdef VISP_HAVE_OPENMP
+    threadId = omp_get_thread_num();
+#endif
     std::vector<cv::KeyPoint> keypoints;
     cv::Mat descriptors;
 
@@ -4142,15 +5041,12 @@ void vpKeyPoint::detectExtractAffine(const vpImage<unsigned char> &I,
     cv::waitKey(0);
 #endif
 
-    for (std::map<std::string, cv::Ptr<cv::FeatureDetector> >::const_iterator it = m_detectors.begin();
-         it != m_detectors.end(); ++it) {
-      std::vector<cv::KeyPoint> kp;
-      it->second->detect(timg, kp, mask);
-      keypoints.insert(keypoints.end(), kp.begin(), kp.end());
+    detectKeyPoints(m_threadDetectors[(size_t)threadId], timg, keypoints, mask);
+    if (m_gridCellSize > 0) {
+      gridFilter(keypoints, timg.size());
     }
 
-    double elapsedTime;
-    extract(timg, keypoints, descriptors, elapsedTime);
+    computeDescriptors(m_threadExtractors[(size_t)threadId], timg, keypoints, descriptors, NULL);
 
     for (size_t i = 0; i < keypoints.size(); i++) {
       cv::Point3f kpt(keypoints[i].pt.x, keypoints[i].pt.y, 1.f);
@@ -4182,14 +5078,24 @@ void vpKeyPoint::reset()
   m_detectionMethod = detectionScore;
   m_detectionScore = 0.15;
   m_detectionThreshold = 100.0;
+  m_detectionTileOverlap = 32;
+  m_detectionTilesX = 1;
+  m_detectionTilesY = 1;
   m_detectionTime = 0.0;
   m_detectorNames.clear();
   m_detectors.clear();
   m_extractionTime = 0.0;
   m_extractorNames.clear();
   m_extractors.clear();
+  m_threadDetectors.clear();
+  m_threadExtractors.clear();
   m_filteredMatches.clear();
   m_filterType = ratioDistanceThreshold;
+  m_gridCellSize = 0;
+  m_gridMaxKeyPointsPerCell = 0;
+  m_guidedMatchingPose.eye();
+  m_guidedMatchingPoseValid = false;
+  m_guidedMatchingRadius = 20.0;
   m_imageFormat = jpgImageFormat;
   m_knnMatches.clear();
   m_mapOfImageId.clear();
@@ -4201,6 +5107,7 @@ void vpKeyPoint::reset()
   m_matchingRatioThreshold = 0.85;
   m_matchingTime = 0.0;
   m_matchRansacKeyPointsToPoints.clear();
+  m_maxKeyPoints = 0;
   m_nbRansacIterations = 200;
   m_nbRansacMinInlierCount = 100;
   m_objectFilteredPoints.clear();
@@ -4221,10 +5128,14 @@ void vpKeyPoint::reset()
   m_trainPoints.clear();
   m_trainVpPoints.clear();
   m_useAffineDetection = false;
+  m_learningDatabase.release();
+  m_learningDatabaseLocation = vpLearningDatabaseLocation();
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020400 && VISP_HAVE_OPENCV_VERSION < 0x030000)
   m_useBruteForceCrossCheck = true;
 #endif
   m_useConsensusPercentage = false;
+  m_useGuidedMatching = false;
+  m_useHammingMatcher = false;
   m_useKnn = true; // as m_filterType == ratioDistanceThreshold
   m_useMatchTrainToQuery = false;
   m_useRansacVVS = true;
@@ -4571,6 +5482,308 @@ void vpKeyPoint::saveLearningData(const std::string &filename, bool binaryMode,
   }
 }
 
+/*!
+  Save the learning data in a versioned binary database that can be memory
+  mapped by loadLearningDatabase().
+
+  The file starts with a 64 bytes header followed by fixed size sections, each
+  aligned on 64 bytes: the keypoints, the 3D points if any, the descriptors
+  stored row after row in a contiguous block, and finally the index of the
+  keypoints and the table of training images. The index lists the runs of
+  consecutive keypoints that share the same class id and training image id,
+  so that the keypoints of some reference views can be loaded without reading
+  the others, see loadLearningDatabase(const std::string &, const std::vector<int> &, const bool).
+
+  The sections are allocated for a capacity larger than the number of
+  keypoints, so that new reference views can be appended without moving the
+  data already stored: the cost of an append only depends on the size of the
+  new data. When the capacity is exceeded the database content is moved in
+  sections of a doubled capacity. Values are stored in the native byte order,
+  which is checked at loading.
+
+  \param filename : Path of the learning database.
+  \param append : If true and the file exists, the train data are appended to
+  the database. When the first train keypoints are already stored at the end
+  of this database, because they were loaded from it or saved in it, only the
+  following ones are written. Otherwise all the train data are appended, with
+  class and image ids shifted after the ones of the database, as done by
+  loadLearningDatabase() in append mode.
+  \param saveTrainingImages : If true, save also the training images on disk,
+  next to the database.
+*/
+void vpKeyPoint::saveLearningDatabase(const std::string &filename, const bool append, const bool saveTrainingImages)
+{
+  const int nbKeyPoints = (int)m_trainKeyPoints.size();
+  const bool have3DInfo = !m_trainPoints.empty();
+  if (have3DInfo && m_trainPoints.size() != m_trainKeyPoints.size()) {
+    throw vpException(vpException::fatalError, "List of keypoints and list of 3D points have different size !");
+  }
+  if (m_trainDescriptors.rows != nbKeyPoints) {
+    throw vpException(vpException::fatalError, "List of keypoints and train descriptors have different size !");
+  }
+  if (m_trainDescriptors.empty()) {
+    throw vpException(vpException::badValue, "No train descriptors to save in the learning database %s",
+                      filename.c_str());
+  }
+
+  std::string parent = vpIoTools::getParent(filename);
+  if (!parent.empty()) {
+    vpIoTools::makeDirectory(parent);
+  }
+
+  LearningDatabaseHeader header;
+  std::vector<LearningDatabaseIndexEntry> index;
+  std::map<int, std::string> mapOfImgPath;
+  size_t keyPointsOffset, pointsOffset, descriptorsOffset, tablesOffset;
+  int first = 0;         // Index of the first train keypoint to write
+  int classIdOffset = 0; // Offsets from the ids of the train data to the ids in the database
+  int imageIdOffset = 0;
+  const bool rewrite = !append || !vpIoTools::checkFilename(filename);
+
+  std::fstream file;
+  if (!rewrite) {
+    file.open(filename.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+    if (!file.is_open() || !file.read((char *)&header, sizeof(header))) {
+      throw vpException(vpException::ioError, "Cannot read the learning database %s", filename.c_str());
+    }
+    checkLearningDatabaseHeader(header, filename);
+    if (header.descriptorType != m_trainDescriptors.type() || header.descriptorCols != m_trainDescriptors.cols ||
+        (header.have3DInfo != 0) != have3DInfo) {
+      throw vpException(vpException::badValue, "The train data are not compatible with the learning database %s",
+                        filename.c_str());
+    }
+
+    learningDatabaseLayout(header, keyPointsOffset, pointsOffset, descriptorsOffset, tablesOffset);
+    file.seekg(0, std::ios::end);
+    size_t fileSize = (size_t)file.tellg();
+    if (fileSize < tablesOffset) {
+      throw vpException(vpException::ioError, "Truncated learning database %s", filename.c_str());
+    }
+    std::vector<char> tables(fileSize - tablesOffset);
+    file.seekg((std::streamoff)tablesOffset, std::ios::beg);
+    if (!tables.empty() && !file.read(&tables[0], (std::streamsize)tables.size())) {
+      throw vpException(vpException::ioError, "Cannot read the learning database %s", filename.c_str());
+    }
+    readLearningDatabaseTables(tables.empty() ? NULL : &tables[0], tables.size(), header, index, mapOfImgPath);
+
+    const vpLearningDatabaseLocation &location = m_learningDatabaseLocation;
+    if (location.m_filename == filename && location.m_first + location.m_size == header.nbKeyPoints &&
+        location.m_size <= nbKeyPoints) {
+      // The first train keypoints are the last ones of the database, only write the next ones
+      first = location.m_size;
+      classIdOffset = location.m_classIdOffset;
+      imageIdOffset = location.m_imageIdOffset;
+    } else {
+      classIdOffset = header.maxClassId;
+      imageIdOffset = header.maxImageId;
+    }
+
+    if (header.nbKeyPoints + nbKeyPoints - first > header.capacity) {
+      // Not enough room left, move the database content in sections of a larger capacity
+      const size_t nbStored = (size_t)header.nbKeyPoints;
+      const size_t rowBytes = (size_t)header.descriptorRowBytes;
+      std::vector<char> keyPoints(nbStored * sizeof(LearningDatabaseKeyPoint));
+      std::vector<char> points(header.have3DInfo ? nbStored * 3 * sizeof(float) : 0);
+      std::vector<char> descriptors(nbStored * rowBytes);
+      if (nbStored > 0) {
+        file.seekg((std::streamoff)keyPointsOffset, std::ios::beg);
+        file.read(&keyPoints[0], (std::streamsize)keyPoints.size());
+        if (!points.empty()) {
+          file.seekg((std::streamoff)pointsOffset, std::ios::beg);
+          file.read(&points[0], (std::streamsize)points.size());
+        }
+        file.seekg((std::streamoff)descriptorsOffset, std::ios::beg);
+        file.read(&descriptors[0], (std::streamsize)descriptors.size());
+        if (!file) {
+          throw vpException(vpException::ioError, "Cannot read the learning database %s", filename.c_str());
+        }
+      }
+      file.close();
+
+      // Truncating a file that is still mapped would invalidate the train descriptors
+      if (!m_learningDatabase.empty() && m_trainDescriptors.data >= (uchar *)m_learningDatabase->m_data &&
+          m_trainDescriptors.data < (uchar *)m_learningDatabase->m_data + m_learningDatabase->m_size) {
+        m_trainDescriptors = m_trainDescriptors.clone();
+        trainMatcher();
+        m_learningDatabase.release();
+      }
+
+      header.capacity = (std::max)(2 * header.capacity, header.nbKeyPoints + nbKeyPoints - first);
+      learningDatabaseLayout(header, keyPointsOffset, pointsOffset, descriptorsOffset, tablesOffset);
+      file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!file.is_open()) {
+        throw vpException(vpException::ioError, "Cannot create the learning database %s", filename.c_str());
+      }
+      if (nbStored > 0) {
+        file.seekp((std::streamoff)keyPointsOffset, std::ios::beg);
+        file.write(&keyPoints[0], (std::streamsize)keyPoints.size());
+        if (!points.empty()) {
+          file.seekp((std::streamoff)pointsOffset, std::ios::beg);
+          file.write(&points[0], (std::streamsize)points.size());
+        }
+        file.seekp((std::streamoff)descriptorsOffset, std::ios::beg);
+        file.write(&descriptors[0], (std::streamsize)descriptors.size());
+      }
+    }
+  } else {
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, learningDatabaseMagic, sizeof(learningDatabaseMagic));
+    header.version = learningDatabaseVersion;
+    header.byteOrderMark = learningDatabaseByteOrderMark;
+    header.have3DInfo = have3DInfo ? 1 : 0;
+    header.descriptorType = m_trainDescriptors.type();
+    header.descriptorCols = m_trainDescriptors.cols;
+    header.descriptorRowBytes = (int)(m_trainDescriptors.cols * m_trainDescriptors.elemSize());
+    header.capacity = (std::max)(learningDatabaseMinCapacity, nbKeyPoints + nbKeyPoints / 2);
+    learningDatabaseLayout(header, keyPointsOffset, pointsOffset, descriptorsOffset, tablesOffset);
+
+    // Truncating a file that is still mapped would invalidate the train descriptors
+    if (!m_learningDatabase.empty() && m_trainDescriptors.data >= (uchar *)m_learningDatabase->m_data &&
+        m_trainDescriptors.data < (uchar *)m_learningDatabase->m_data + m_learningDatabase->m_size) {
+      m_trainDescriptors = m_trainDescriptors.clone();
+      trainMatcher();
+      m_learningDatabase.release();
+    }
+
+    file.open(filename.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+      throw vpException(vpException::ioError, "Cannot create the learning database %s", filename.c_str());
+    }
+  }
+
+  // Save the training images that are not yet referenced by the database
+  if (saveTrainingImages) {
+#ifdef VISP_HAVE_MODULE_IO
+    for (std::map<int, vpImage<unsigned char> >::const_iterator it = m_mapOfImages.begin(); it != m_mapOfImages.end();
+         ++it) {
+      const int imageId = it->first + imageIdOffset;
+      if (mapOfImgPath.find(imageId) != mapOfImgPath.end()) {
+        continue;
+      }
+
+      std::stringstream ss;
+      ss << "train_image_" << std::setfill('0') << std::setw(3) << imageId;
+      switch (m_imageFormat) {
+      case jpgImageFormat:
+        ss << ".jpg";
+        break;
+
+      case ppmImageFormat:
+        ss << ".ppm";
+        break;
+
+      case pgmImageFormat:
+        ss << ".pgm";
+        break;
+
+      case pngImageFormat:
+      default:
+        ss << ".png";
+        break;
+      }
+
+      mapOfImgPath[imageId] = ss.str();
+      header.maxImageId = (std::max)(header.maxImageId, imageId);
+      vpImageIo::write(it->second, parent + (!parent.empty() ? "/" : "") + ss.str());
+    }
+#else
+    std::cout << "Warning: in vpKeyPoint::saveLearningDatabase() training images "
+                 "are not saved because "
+                 "visp_io module is not available !"
+              << std::endl;
+#endif
+  }
+
+  // Keypoints, written after the ones of the database
+  const int position = header.nbKeyPoints;
+  if (nbKeyPoints > first) {
+    std::vector<LearningDatabaseKeyPoint> keyPoints((size_t)(nbKeyPoints - first));
+    for (int i = first; i < nbKeyPoints; i++) {
+      const cv::KeyPoint &kp = m_trainKeyPoints[(size_t)i];
+      LearningDatabaseKeyPoint &record = keyPoints[(size_t)(i - first)];
+      record.u = kp.pt.x;
+      record.v = kp.pt.y;
+      record.size = kp.size;
+      record.angle = kp.angle;
+      record.response = kp.response;
+      record.octave = kp.octave;
+      record.class_id = kp.class_id + classIdOffset;
+      record.image_id = -1;
+      std::map<int, int>::const_iterator it_findImgId = m_mapOfImageId.find(kp.class_id);
+      if (it_findImgId != m_mapOfImageId.end()) {
+        record.image_id = it_findImgId->second + imageIdOffset;
+        header.maxImageId = (std::max)(header.maxImageId, record.image_id);
+      }
+      header.maxClassId = (std::max)(header.maxClassId, record.class_id);
+
+      // Extend the index
+      const int dbIndex = position + i - first;
+      if (!index.empty() && index.back().class_id == record.class_id && index.back().image_id == record.image_id) {
+        index.back().count++;
+      } else {
+        LearningDatabaseIndexEntry entry;
+        entry.class_id = record.class_id;
+        entry.image_id = record.image_id;
+        entry.first = dbIndex;
+        entry.count = 1;
+        index.push_back(entry);
+      }
+    }
+    file.seekp((std::streamoff)(keyPointsOffset + (size_t)position * sizeof(LearningDatabaseKeyPoint)),
+               std::ios::beg);
+    file.write((const char *)&keyPoints[0], (std::streamsize)(keyPoints.size() * sizeof(LearningDatabaseKeyPoint)));
+
+    // 3D points
+    if (have3DInfo) {
+      std::vector<float> points(3 * (size_t)(nbKeyPoints - first));
+      for (int i = first; i < nbKeyPoints; i++) {
+        const cv::Point3f &pt = m_trainPoints[(size_t)i];
+        points[3 * (size_t)(i - first)] = pt.x;
+        points[3 * (size_t)(i - first) + 1] = pt.y;
+        points[3 * (size_t)(i - first) + 2] = pt.z;
+      }
+      file.seekp((std::streamoff)(pointsOffset + (size_t)position * 3 * sizeof(float)), std::ios::beg);
+      file.write((const char *)&points[0], (std::streamsize)(points.size() * sizeof(float)));
+    }
+
+    // Descriptors
+    file.seekp((std::streamoff)(descriptorsOffset + (size_t)position * (size_t)header.descriptorRowBytes),
+               std::ios::beg);
+    for (int i = first; i < nbKeyPoints; i++) {
+      file.write(m_trainDescriptors.ptr<char>(i), header.descriptorRowBytes);
+    }
+  }
+
+  // Index and table of training images, always at the end of the file
+  file.seekp((std::streamoff)tablesOffset, std::ios::beg);
+  if (!index.empty()) {
+    file.write((const char *)&index[0], (std::streamsize)(index.size() * sizeof(LearningDatabaseIndexEntry)));
+  }
+  for (std::map<int, std::string>::const_iterator it = mapOfImgPath.begin(); it != mapOfImgPath.end(); ++it) {
+    int id = it->first, length = (int)it->second.length();
+    file.write((const char *)&id, sizeof(id));
+    file.write((const char *)&length, sizeof(length));
+    file.write(it->second.c_str(), length);
+  }
+
+  header.nbKeyPoints = position + nbKeyPoints - first;
+  header.nbImages = (int)mapOfImgPath.size();
+  header.nbIndexEntries = (int)index.size();
+  file.seekp(0, std::ios::beg);
+  file.write((const char *)&header, sizeof(header));
+
+  if (!file) {
+    throw vpException(vpException::ioError, "Cannot write the learning database %s", filename.c_str());
+  }
+
+  // The train keypoints are now the last ones of the database
+  m_learningDatabaseLocation.m_filename = filename;
+  m_learningDatabaseLocation.m_first = position - first;
+  m_learningDatabaseLocation.m_size = nbKeyPoints;
+  m_learningDatabaseLocation.m_classIdOffset = classIdOffset;
+  m_learningDatabaseLocation.m_imageIdOffset = imageIdOffset;
+}
+
 #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x030000)
 // From OpenCV 2.4.11 source code.
 struct KeypointResponseGreaterThanThreshold {
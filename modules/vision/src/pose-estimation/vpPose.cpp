@@ -80,7 +80,9 @@ void vpPose::init()
   ransacThreshold = 0.0001;
   distanceToPlaneForCoplanarityTest = 0.001;
   ransacFlag = NO_FILTER;
+  ransacHypothesisMethod = DEMENTHON;
   listOfPoints.clear();
+  pointArrays.clear();
   useParallelRansac = false;
   nbParallelRansacThreads = 0;
   vvsEpsilon = 1e-8;
@@ -94,8 +96,8 @@ void vpPose::init()
 vpPose::vpPose()
   : npt(0), listP(), residual(0), lambda(0.25), vvsIterMax(200), c3d(), computeCovariance(false), covarianceMatrix(),
     ransacNbInlierConsensus(4), ransacMaxTrials(1000), ransacInliers(), ransacInlierIndex(), ransacThreshold(0.0001),
-    distanceToPlaneForCoplanarityTest(0.001), ransacFlag(vpPose::NO_FILTER), listOfPoints(),
-    useParallelRansac(false),
+    distanceToPlaneForCoplanarityTest(0.001), ransacFlag(vpPose::NO_FILTER), ransacHypothesisMethod(vpPose::DEMENTHON),
+    listOfPoints(), pointArrays(), useParallelRansac(false),
     nbParallelRansacThreads(0), // 0 means that we use C++11 (if available) to get the number of threads
     vvsEpsilon(1e-8)
 {
@@ -123,6 +125,7 @@ void vpPose::clearPoint()
 {
   listP.clear();
   listOfPoints.clear();
+  pointArrays.clear();
   npt = 0;
 }
 
@@ -138,6 +141,7 @@ void vpPose::addPoint(const vpPoint &newP)
 {
   listP.push_back(newP);
   listOfPoints.push_back(newP);
+  pointArrays.push_back(newP);
   npt++;
 }
 
@@ -153,6 +157,9 @@ void vpPose::addPoints(const std::vector<vpPoint> &lP)
 {
   listP.insert(listP.end(), lP.begin(), lP.end());
   listOfPoints.insert(listOfPoints.end(), lP.begin(), lP.end());
+  for (std::vector<vpPoint>::const_iterator it = lP.begin(); it != lP.end(); ++it) {
+    pointArrays.push_back(*it);
+  }
   npt = (unsigned int)listP.size();
 }
 
@@ -323,16 +330,21 @@ bool vpPose::coplanar(int &coplanar_plane_type)
 */
 double vpPose::computeResidual(const vpHomogeneousMatrix &cMo) const
 {
-  double squared_error = 0;
-  vpPoint P;
-  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-    P = *it;
-    double x = P.get_x();
-    double y = P.get_y();
+  unsigned int nb = (unsigned int)listP.size();
+  std::vector<double> oX(nb), oY(nb), oZ(nb), x(nb), y(nb);
+  unsigned int k = 0;
+  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it, k++) {
+    oX[k] = it->get_oX();
+    oY[k] = it->get_oY();
+    oZ[k] = it->get_oZ();
+  }
 
-    P.track(cMo);
+  vpPoint::projectPoints(cMo, nb, oX.data(), oY.data(), oZ.data(), x.data(), y.data());
 
-    squared_error += vpMath::sqr(x - P.get_x()) + vpMath::sqr(y - P.get_y());
+  double squared_error = 0;
+  k = 0;
+  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it, k++) {
+    squared_error += vpMath::sqr(it->get_x() - x[k]) + vpMath::sqr(it->get_y() - y[k]);
   }
   return (squared_error);
 }
@@ -357,6 +369,11 @@ double vpPose::computeResidual(const vpHomogeneousMatrix &cMo) const
   - vpPose::LAGRANGE_VIRTUAL_VS: Non linear virtual visual servoing approach
   initialized by Lagrange approach
   - vpPose::RANSAC: Robust Ransac aproach (doesn't need an initialization)
+  - vpPose::P3P: Closed-form solution computed from three of the points, the
+  other points being used to select the right solution
+  - vpPose::EPNP: Non iterative EPnP approach (non coplanar points only)
+  - vpPose::IPPE: Infinitesimal plane-based pose estimation (coplanar points
+  only)
 
 */
 bool vpPose::computePose(vpPoseMethodType method, vpHomogeneousMatrix &cMo, bool (*func)(const vpHomogeneousMatrix &))
@@ -427,6 +444,27 @@ bool vpPose::computePose(vpPoseMethodType method, vpHomogeneousMatrix &cMo, bool
     }
       return poseRansac(cMo, func);
     break;
+  case P3P:
+    poseP3P(cMo);
+    break;
+  case EPNP: {
+    int coplanar_plane_type = 0;
+    if (coplanar(coplanar_plane_type)) {
+      throw(vpPoseException(vpPoseException::notEnoughPointError,
+                            "EPnP method cannot be used in that case "
+                            "(points are coplanar)"));
+    }
+    poseEPnP(cMo);
+  } break;
+  case IPPE: {
+    int coplanar_plane_type = 0;
+    if (!coplanar(coplanar_plane_type) || coplanar_plane_type == 4) {
+      throw(vpPoseException(vpPoseException::notEnoughPointError,
+                            "IPPE method cannot be used in that case "
+                            "(points are not coplanar or are collinear)"));
+    }
+    poseIPPE(cMo);
+  } break;
   case LOWE:
   case VIRTUAL_VS:
     break;
@@ -436,6 +474,9 @@ bool vpPose::computePose(vpPoseMethodType method, vpHomogeneousMatrix &cMo, bool
   case LAGRANGE:
   case DEMENTHON:
   case RANSAC:
+  case P3P:
+  case EPNP:
+  case IPPE:
     break;
   case VIRTUAL_VS:
   case LAGRANGE_VIRTUAL_VS:
@@ -0,0 +1,372 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pose computation with the EPnP algorithm.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpPoseEPnP.cpp
+  \brief Non-iterative pose estimation from n points (EPnP).
+*/
+
+#include <cmath>
+#include <limits>
+
+#include <visp3/core/vpMath.h>
+#include <visp3/vision/vpPose.h>
+#include <visp3/vision/vpPoseException.h>
+
+namespace
+{
+// Index of the two control points involved in each of the six distance constraints
+const unsigned int epnpPairs[6][2] = {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}};
+
+// Gauss-Newton refinement of the betas minimizing the error on the distances between control points
+void gaussNewton(const vpMatrix &L, const vpColVector &rho, double betas[4])
+{
+  vpMatrix A(6, 4);
+  vpColVector b(6);
+  for (unsigned int iter = 0; iter < 5; iter++) {
+    for (unsigned int i = 0; i < 6; i++) {
+      const double *l = L[i];
+      A[i][0] = 2 * l[0] * betas[0] + l[1] * betas[1] + l[3] * betas[2] + l[6] * betas[3];
+      A[i][1] = l[1] * betas[0] + 2 * l[2] * betas[1] + l[4] * betas[2] + l[7] * betas[3];
+      A[i][2] = l[3] * betas[0] + l[4] * betas[1] + 2 * l[5] * betas[2] + l[8] * betas[3];
+      A[i][3] = l[6] * betas[0] + l[7] * betas[1] + l[8] * betas[2] + 2 * l[9] * betas[3];
+
+      b[i] = rho[i] - (l[0] * betas[0] * betas[0] + l[1] * betas[0] * betas[1] + l[2] * betas[1] * betas[1] +
+                       l[3] * betas[0] * betas[2] + l[4] * betas[1] * betas[2] + l[5] * betas[2] * betas[2] +
+                       l[6] * betas[0] * betas[3] + l[7] * betas[1] * betas[3] + l[8] * betas[2] * betas[3] +
+                       l[9] * betas[3] * betas[3]);
+    }
+
+    vpColVector dx = A.pseudoInverse(1e-10) * b;
+    for (unsigned int i = 0; i < 4; i++) {
+      betas[i] += dx[i];
+    }
+  }
+}
+
+// Least-squares solution of the distance constraints restricted to some of the products of betas
+vpColVector solveBetas(const vpMatrix &L, const vpColVector &rho, const unsigned int *columns, unsigned int n)
+{
+  vpMatrix Lr(6, n);
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = 0; j < n; j++) {
+      Lr[i][j] = L[i][columns[j]];
+    }
+  }
+  return Lr.pseudoInverse(1e-10) * rho;
+}
+}
+
+/*!
+  Compute the pose from n >= 4 non coplanar points using the Efficient
+  Perspective-n-Point algorithm described in Lepetit, Moreno-Noguer and Fua,
+  "EPnP: An accurate O(n) solution to the PnP problem", IJCV 2009.
+
+  The points are expressed as a weighted sum of four virtual control points
+  whose coordinates in the camera frame are a linear combination of the null
+  space vectors of a 2n x 12 system. The combination weights are estimated
+  for a null space of dimension 1, 2 and 3, refined by Gauss-Newton, and the
+  pose with the lowest reprojection error is kept.
+
+  \param n : Number of points.
+  \param oX, oY, oZ : Coordinates of the points in the object frame.
+  \param x, y : Normalized coordinates of the points in the image plane.
+  \param cMo : Estimated pose.
+
+  \return false if the pose cannot be estimated, when there are less than 4
+  points or when the points are coplanar.
+
+  \sa poseEPnP()
+*/
+bool vpPose::computeEPnP(unsigned int n, const double *oX, const double *oY, const double *oZ, const double *x,
+                         const double *y, vpHomogeneousMatrix &cMo)
+{
+  if (n < 4) {
+    return false;
+  }
+
+  // The first control point is the centroid of the points, the other ones
+  // are along the principal directions of the points
+  double cw[4][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+  for (unsigned int i = 0; i < n; i++) {
+    cw[0][0] += oX[i];
+    cw[0][1] += oY[i];
+    cw[0][2] += oZ[i];
+  }
+  for (unsigned int k = 0; k < 3; k++) {
+    cw[0][k] /= n;
+  }
+
+  vpMatrix PW0tPW0(3, 3, 0.0);
+  for (unsigned int i = 0; i < n; i++) {
+    const double d[3] = {oX[i] - cw[0][0], oY[i] - cw[0][1], oZ[i] - cw[0][2]};
+    for (unsigned int r = 0; r < 3; r++) {
+      for (unsigned int c = 0; c < 3; c++) {
+        PW0tPW0[r][c] += d[r] * d[c];
+      }
+    }
+  }
+  vpColVector dc;
+  vpMatrix V;
+  PW0tPW0.svd(dc, V); // PW0tPW0 is replaced by the principal directions
+  if (dc[2] <= 1e-10 * dc[0]) {
+    // Coplanar points
+    return false;
+  }
+  for (unsigned int j = 1; j < 4; j++) {
+    const double k = std::sqrt(dc[j - 1] / n);
+    for (unsigned int r = 0; r < 3; r++) {
+      cw[j][r] = cw[0][r] + k * PW0tPW0[r][j - 1];
+    }
+  }
+
+  // Barycentric coordinates of the points with respect to the control points
+  vpMatrix CC(3, 3);
+  for (unsigned int r = 0; r < 3; r++) {
+    for (unsigned int c = 0; c < 3; c++) {
+      CC[r][c] = cw[c + 1][r] - cw[0][r];
+    }
+  }
+  vpMatrix CC_inv = CC.inverseByLU();
+
+  vpMatrix alphas(n, 4);
+  vpMatrix M(2 * n, 12, 0.0);
+  for (unsigned int i = 0; i < n; i++) {
+    const double d[3] = {oX[i] - cw[0][0], oY[i] - cw[0][1], oZ[i] - cw[0][2]};
+    double *a = alphas[i];
+    a[0] = 1.0;
+    for (unsigned int j = 1; j < 4; j++) {
+      a[j] = CC_inv[j - 1][0] * d[0] + CC_inv[j - 1][1] * d[1] + CC_inv[j - 1][2] * d[2];
+      a[0] -= a[j];
+    }
+
+    double *m1 = M[2 * i];
+    double *m2 = M[2 * i + 1];
+    for (unsigned int j = 0; j < 4; j++) {
+      m1[3 * j] = a[j];
+      m1[3 * j + 2] = -a[j] * x[i];
+      m2[3 * j + 1] = a[j];
+      m2[3 * j + 2] = -a[j] * y[i];
+    }
+  }
+
+  // Null space of M, the last right singular vectors
+  vpMatrix MtM = M.AtA();
+  vpColVector w;
+  vpMatrix Ut;
+  MtM.svd(w, Ut);
+  double v[4][12];
+  for (unsigned int k = 0; k < 4; k++) {
+    for (unsigned int r = 0; r < 12; r++) {
+      v[k][r] = Ut[r][11 - k];
+    }
+  }
+
+  // Distance constraints between the control points: L betas_products = rho
+  vpMatrix L(6, 10);
+  vpColVector rho(6);
+  for (unsigned int i = 0; i < 6; i++) {
+    const unsigned int a = epnpPairs[i][0], b = epnpPairs[i][1];
+    double dv[4][3];
+    for (unsigned int k = 0; k < 4; k++) {
+      for (unsigned int r = 0; r < 3; r++) {
+        dv[k][r] = v[k][3 * a + r] - v[k][3 * b + r];
+      }
+    }
+
+    unsigned int col = 0;
+    for (unsigned int k2 = 0; k2 < 4; k2++) {
+      for (unsigned int k1 = 0; k1 <= k2; k1++) {
+        const double dot = dv[k1][0] * dv[k2][0] + dv[k1][1] * dv[k2][1] + dv[k1][2] * dv[k2][2];
+        L[i][col++] = (k1 == k2) ? dot : 2 * dot;
+      }
+    }
+
+    rho[i] = vpMath::sqr(cw[a][0] - cw[b][0]) + vpMath::sqr(cw[a][1] - cw[b][1]) + vpMath::sqr(cw[a][2] - cw[b][2]);
+  }
+
+  double betas[3][4];
+
+  // Null space of dimension 1: betas products [B11 B12 B13 B14]
+  {
+    const unsigned int columns[4] = {0, 1, 3, 6};
+    vpColVector B = solveBetas(L, rho, columns, 4);
+    double sign = (B[0] < 0) ? -1.0 : 1.0;
+    betas[0][0] = std::sqrt(std::fabs(B[0]));
+    for (unsigned int k = 1; k < 4; k++) {
+      betas[0][k] = (betas[0][0] > 0) ? sign * B[k] / betas[0][0] : 0.0;
+    }
+  }
+
+  // Null space of dimension 2: betas products [B11 B12 B22]
+  {
+    const unsigned int columns[3] = {0, 1, 2};
+    vpColVector B = solveBetas(L, rho, columns, 3);
+    betas[1][0] = std::sqrt(std::fabs(B[0]));
+    betas[1][1] = (B[0] * B[2] > 0) ? std::sqrt(std::fabs(B[2])) : 0.0;
+    if (B[1] < 0) {
+      betas[1][0] = -betas[1][0];
+    }
+    betas[1][2] = betas[1][3] = 0.0;
+  }
+
+  // Null space of dimension 3: betas products [B11 B12 B22 B13 B23]
+  {
+    const unsigned int columns[5] = {0, 1, 2, 3, 4};
+    vpColVector B = solveBetas(L, rho, columns, 5);
+    betas[2][0] = std::sqrt(std::fabs(B[0]));
+    betas[2][1] = (B[0] * B[2] > 0) ? std::sqrt(std::fabs(B[2])) : 0.0;
+    if (B[1] < 0) {
+      betas[2][0] = -betas[2][0];
+    }
+    betas[2][2] = (std::fabs(betas[2][0]) > 0) ? B[3] / betas[2][0] : 0.0;
+    betas[2][3] = 0.0;
+  }
+
+  double err_min = std::numeric_limits<double>::max();
+  bool found = false;
+  for (unsigned int s = 0; s < 3; s++) {
+    gaussNewton(L, rho, betas[s]);
+
+    // Control points and points in the camera frame
+    double cc[4][3];
+    for (unsigned int j = 0; j < 4; j++) {
+      for (unsigned int r = 0; r < 3; r++) {
+        cc[j][r] = betas[s][0] * v[0][3 * j + r] + betas[s][1] * v[1][3 * j + r] + betas[s][2] * v[2][3 * j + r] +
+                   betas[s][3] * v[3][3 * j + r];
+      }
+    }
+
+    vpMatrix pcs(n, 3);
+    for (unsigned int i = 0; i < n; i++) {
+      for (unsigned int r = 0; r < 3; r++) {
+        pcs[i][r] = alphas[i][0] * cc[0][r] + alphas[i][1] * cc[1][r] + alphas[i][2] * cc[2][r] +
+                    alphas[i][3] * cc[3][r];
+      }
+    }
+    if (pcs[0][2] < 0) {
+      pcs = -pcs;
+    }
+
+    // Absolute orientation between the points in the object and camera frames
+    double pc0[3] = {0, 0, 0}, pw0[3] = {0, 0, 0};
+    for (unsigned int i = 0; i < n; i++) {
+      pc0[0] += pcs[i][0];
+      pc0[1] += pcs[i][1];
+      pc0[2] += pcs[i][2];
+      pw0[0] += oX[i];
+      pw0[1] += oY[i];
+      pw0[2] += oZ[i];
+    }
+    for (unsigned int r = 0; r < 3; r++) {
+      pc0[r] /= n;
+      pw0[r] /= n;
+    }
+
+    vpMatrix ABt(3, 3, 0.0);
+    for (unsigned int i = 0; i < n; i++) {
+      const double a[3] = {pcs[i][0] - pc0[0], pcs[i][1] - pc0[1], pcs[i][2] - pc0[2]};
+      const double b[3] = {oX[i] - pw0[0], oY[i] - pw0[1], oZ[i] - pw0[2]};
+      for (unsigned int r = 0; r < 3; r++) {
+        for (unsigned int c = 0; c < 3; c++) {
+          ABt[r][c] += a[r] * b[c];
+        }
+      }
+    }
+    vpColVector abt_w;
+    vpMatrix abt_v;
+    ABt.svd(abt_w, abt_v); // ABt is replaced by U
+    vpMatrix R = ABt * abt_v.t();
+    if (R.det() < 0) {
+      for (unsigned int r = 0; r < 3; r++) {
+        ABt[r][2] = -ABt[r][2];
+      }
+      R = ABt * abt_v.t();
+    }
+
+    vpHomogeneousMatrix cMo_s;
+    for (unsigned int r = 0; r < 3; r++) {
+      for (unsigned int c = 0; c < 3; c++) {
+        cMo_s[r][c] = R[r][c];
+      }
+      cMo_s[r][3] = pc0[r] - (R[r][0] * pw0[0] + R[r][1] * pw0[1] + R[r][2] * pw0[2]);
+    }
+
+    // Reprojection error
+    double err = 0;
+    for (unsigned int i = 0; i < n; i++) {
+      const double X = cMo_s[0][0] * oX[i] + cMo_s[0][1] * oY[i] + cMo_s[0][2] * oZ[i] + cMo_s[0][3];
+      const double Y = cMo_s[1][0] * oX[i] + cMo_s[1][1] * oY[i] + cMo_s[1][2] * oZ[i] + cMo_s[1][3];
+      const double Z = cMo_s[2][0] * oX[i] + cMo_s[2][1] * oY[i] + cMo_s[2][2] * oZ[i] + cMo_s[2][3];
+      err += vpMath::sqr(X / Z - x[i]) + vpMath::sqr(Y / Z - y[i]);
+    }
+
+    if (!vpMath::isNaN(err) && err < err_min) {
+      err_min = err;
+      cMo = cMo_s;
+      found = true;
+    }
+  }
+
+  return found;
+}
+
+/*!
+  Compute the pose from all the points using the EPnP algorithm.
+  \sa computeEPnP()
+
+  \param cMo : Estimated pose. No assumption is made on its initial value.
+
+  \exception vpPoseException::notEnoughPointError : Less than 4 points, or
+  coplanar points. In the latter case use IPPE instead.
+*/
+void vpPose::poseEPnP(vpHomogeneousMatrix &cMo)
+{
+  std::vector<double> oX(npt), oY(npt), oZ(npt), x(npt), y(npt);
+  unsigned int i = 0;
+  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it, i++) {
+    oX[i] = it->get_oX();
+    oY[i] = it->get_oY();
+    oZ[i] = it->get_oZ();
+    x[i] = it->get_x();
+    y[i] = it->get_y();
+  }
+
+  if (npt < 4 || !computeEPnP(npt, &oX[0], &oY[0], &oZ[0], &x[0], &y[0], cMo)) {
+    throw(vpPoseException(vpPoseException::notEnoughPointError,
+                          "EPnP method cannot be used in that case "
+                          "(at least 4 non coplanar points are required)"));
+  }
+}
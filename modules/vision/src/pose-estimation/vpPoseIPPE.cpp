@@ -0,0 +1,282 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pose computation from planar points with the IPPE algorithm.
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpPoseIPPE.cpp
+  \brief Infinitesimal plane-based pose estimation (IPPE).
+*/
+
+#include <cmath>
+#include <limits>
+
+#include <visp3/core/vpMath.h>
+#include <visp3/vision/vpHomography.h>
+#include <visp3/vision/vpPose.h>
+#include <visp3/vision/vpPoseException.h>
+
+/*!
+  Compute the two poses that are consistent with n >= 4 coplanar points
+  using the Infinitesimal Plane-based Pose Estimation algorithm described in
+  Collins and Bartoli, "Infinitesimal plane-based pose estimation", IJCV 2014.
+
+  The homography between the plane of the object and the image plane is
+  estimated first. The rotation is then recovered in closed form from the
+  Jacobian of the homography at the centroid of the points, which leaves a
+  two-fold ambiguity. For each of the two rotations the translation is
+  estimated by linear least squares.
+
+  \param n : Number of points.
+  \param oX, oY, oZ : Coordinates of the points in the object frame. The
+  points are expected to be coplanar.
+  \param x, y : Normalized coordinates of the points in the image plane.
+  \param cMo : The two poses, sorted by increasing reprojection error.
+
+  \return The number of solutions stored in \e cMo: 2, or 0 if the pose
+  cannot be estimated.
+
+  \sa poseIPPE()
+*/
+unsigned int vpPose::computeIPPE(unsigned int n, const double *oX, const double *oY, const double *oZ,
+                                 const double *x, const double *y, vpHomogeneousMatrix cMo[2])
+{
+  if (n < 4) {
+    return 0;
+  }
+
+  // Frame attached to the plane of the points, centered on their centroid
+  double c[3] = {0, 0, 0};
+  for (unsigned int i = 0; i < n; i++) {
+    c[0] += oX[i];
+    c[1] += oY[i];
+    c[2] += oZ[i];
+  }
+  for (unsigned int k = 0; k < 3; k++) {
+    c[k] /= n;
+  }
+
+  vpMatrix PtP(3, 3, 0.0);
+  for (unsigned int i = 0; i < n; i++) {
+    const double d[3] = {oX[i] - c[0], oY[i] - c[1], oZ[i] - c[2]};
+    for (unsigned int r = 0; r < 3; r++) {
+      for (unsigned int k = 0; k < 3; k++) {
+        PtP[r][k] += d[r] * d[k];
+      }
+    }
+  }
+  vpColVector sv;
+  vpMatrix V;
+  PtP.svd(sv, V); // PtP is replaced by the principal directions
+  if (sv[1] <= std::numeric_limits<double>::epsilon() * sv[0]) {
+    // Collinear points
+    return 0;
+  }
+
+  // pRo: rows are the axes of the plane frame, the third one is the normal
+  double pRo[3][3];
+  for (unsigned int k = 0; k < 3; k++) {
+    pRo[0][k] = PtP[k][0];
+    pRo[1][k] = PtP[k][1];
+  }
+  pRo[2][0] = pRo[0][1] * pRo[1][2] - pRo[0][2] * pRo[1][1];
+  pRo[2][1] = pRo[0][2] * pRo[1][0] - pRo[0][0] * pRo[1][2];
+  pRo[2][2] = pRo[0][0] * pRo[1][1] - pRo[0][1] * pRo[1][0];
+
+  std::vector<double> xp(n), yp(n), xa(x, x + n), ya(y, y + n);
+  for (unsigned int i = 0; i < n; i++) {
+    const double d[3] = {oX[i] - c[0], oY[i] - c[1], oZ[i] - c[2]};
+    xp[i] = pRo[0][0] * d[0] + pRo[0][1] * d[1] + pRo[0][2] * d[2];
+    yp[i] = pRo[1][0] * d[0] + pRo[1][1] * d[1] + pRo[1][2] * d[2];
+  }
+
+  vpHomography H;
+  try {
+    vpHomography::DLT(xp, yp, xa, ya, H, true);
+  } catch (...) {
+    return 0;
+  }
+  if (std::fabs(H[2][2]) < std::numeric_limits<double>::epsilon()) {
+    return 0;
+  }
+  H /= H[2][2];
+
+  // Image of the centroid and Jacobian of the homography at the centroid
+  const double v[2] = {H[0][2], H[1][2]};
+  const double J[2][2] = {{H[0][0] - H[2][0] * H[0][2], H[0][1] - H[2][1] * H[0][2]},
+                          {H[1][0] - H[2][0] * H[1][2], H[1][1] - H[2][1] * H[1][2]}};
+
+  // Rotation Rv that aligns the optical axis with the line of sight of the centroid
+  double Rv[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
+  const double t = std::sqrt(v[0] * v[0] + v[1] * v[1]);
+  if (t > std::numeric_limits<double>::epsilon()) {
+    const double s = std::sqrt(t * t + 1.0);
+    const double costh = 1.0 / s;
+    const double sinth = t / s;
+    const double K[3][3] = {{0, 0, v[0] / t}, {0, 0, v[1] / t}, {-v[0] / t, -v[1] / t, 0}};
+    for (unsigned int r = 0; r < 3; r++) {
+      for (unsigned int k = 0; k < 3; k++) {
+        const double K2 = K[r][0] * K[0][k] + K[r][1] * K[1][k] + K[r][2] * K[2][k];
+        Rv[r][k] += sinth * K[r][k] + (1.0 - costh) * K2;
+      }
+    }
+  }
+
+  // A = B^-1 J with B = [I2 | -v] Rv[:, 0:2]
+  const double b00 = Rv[0][0] - v[0] * Rv[2][0], b01 = Rv[0][1] - v[0] * Rv[2][1];
+  const double b10 = Rv[1][0] - v[1] * Rv[2][0], b11 = Rv[1][1] - v[1] * Rv[2][1];
+  const double det = b00 * b11 - b01 * b10;
+  if (std::fabs(det) < std::numeric_limits<double>::epsilon()) {
+    return 0;
+  }
+  const double a00 = (b11 * J[0][0] - b01 * J[1][0]) / det, a01 = (b11 * J[0][1] - b01 * J[1][1]) / det;
+  const double a10 = (-b10 * J[0][0] + b00 * J[1][0]) / det, a11 = (-b10 * J[0][1] + b00 * J[1][1]) / det;
+
+  // Largest singular value of A
+  const double ata00 = a00 * a00 + a10 * a10, ata01 = a00 * a01 + a10 * a11, ata11 = a01 * a01 + a11 * a11;
+  const double gamma = std::sqrt(0.5 * (ata00 + ata11 + std::sqrt(vpMath::sqr(ata00 - ata11) + 4.0 * ata01 * ata01)));
+  if (gamma < std::numeric_limits<double>::epsilon()) {
+    return 0;
+  }
+
+  // Upper-left 2x2 block of the rotation and the two completions of its third row
+  const double r00 = a00 / gamma, r01 = a01 / gamma, r10 = a10 / gamma, r11 = a11 / gamma;
+  const double b0 = std::sqrt((std::max)(0.0, 1.0 - r00 * r00 - r10 * r10));
+  double b1 = std::sqrt((std::max)(0.0, 1.0 - r01 * r01 - r11 * r11));
+  if (-r00 * r01 - r10 * r11 < 0) {
+    b1 = -b1;
+  }
+
+  double err[2];
+  for (unsigned int sol = 0; sol < 2; sol++) {
+    const double sign = (sol == 0) ? 1.0 : -1.0;
+    const double col0[3] = {r00, r10, sign * b0};
+    const double col1[3] = {r01, r11, sign * b1};
+    const double col2[3] = {col0[1] * col1[2] - col0[2] * col1[1], col0[2] * col1[0] - col0[0] * col1[2],
+                            col0[0] * col1[1] - col0[1] * col1[0]};
+
+    // cRp = Rv [col0 col1 col2]
+    double cRp[3][3];
+    for (unsigned int r = 0; r < 3; r++) {
+      cRp[r][0] = Rv[r][0] * col0[0] + Rv[r][1] * col0[1] + Rv[r][2] * col0[2];
+      cRp[r][1] = Rv[r][0] * col1[0] + Rv[r][1] * col1[1] + Rv[r][2] * col1[2];
+      cRp[r][2] = Rv[r][0] * col2[0] + Rv[r][1] * col2[1] + Rv[r][2] * col2[2];
+    }
+
+    // Translation by least squares on [1 0 -x ; 0 1 -y] t = [x Zr - Xr ; y Zr - Yr]
+    double AtA[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}}, Atb[3] = {0, 0, 0};
+    for (unsigned int i = 0; i < n; i++) {
+      const double Xr = cRp[0][0] * xp[i] + cRp[0][1] * yp[i];
+      const double Yr = cRp[1][0] * xp[i] + cRp[1][1] * yp[i];
+      const double Zr = cRp[2][0] * xp[i] + cRp[2][1] * yp[i];
+      const double bx = x[i] * Zr - Xr, by = y[i] * Zr - Yr;
+
+      AtA[0][0] += 1.0;
+      AtA[0][2] -= x[i];
+      AtA[1][1] += 1.0;
+      AtA[1][2] -= y[i];
+      AtA[2][2] += x[i] * x[i] + y[i] * y[i];
+      Atb[0] += bx;
+      Atb[1] += by;
+      Atb[2] -= x[i] * bx + y[i] * by;
+    }
+    AtA[2][0] = AtA[0][2];
+    AtA[2][1] = AtA[1][2];
+
+    vpMatrix M(3, 3);
+    vpColVector b(3);
+    for (unsigned int r = 0; r < 3; r++) {
+      for (unsigned int k = 0; k < 3; k++) {
+        M[r][k] = AtA[r][k];
+      }
+      b[r] = Atb[r];
+    }
+    vpColVector cTp = M.inverseByLU() * b;
+
+    // cMo = cMp pMo with pMo = [pRo | -pRo c]
+    vpHomogeneousMatrix &cMo_s = cMo[sol];
+    for (unsigned int r = 0; r < 3; r++) {
+      for (unsigned int k = 0; k < 3; k++) {
+        cMo_s[r][k] = cRp[r][0] * pRo[0][k] + cRp[r][1] * pRo[1][k] + cRp[r][2] * pRo[2][k];
+      }
+      cMo_s[r][3] = cTp[r] - (cMo_s[r][0] * c[0] + cMo_s[r][1] * c[1] + cMo_s[r][2] * c[2]);
+    }
+
+    err[sol] = 0;
+    for (unsigned int i = 0; i < n; i++) {
+      const double X = cMo_s[0][0] * oX[i] + cMo_s[0][1] * oY[i] + cMo_s[0][2] * oZ[i] + cMo_s[0][3];
+      const double Y = cMo_s[1][0] * oX[i] + cMo_s[1][1] * oY[i] + cMo_s[1][2] * oZ[i] + cMo_s[1][3];
+      const double Z = cMo_s[2][0] * oX[i] + cMo_s[2][1] * oY[i] + cMo_s[2][2] * oZ[i] + cMo_s[2][3];
+      err[sol] += vpMath::sqr(X / Z - x[i]) + vpMath::sqr(Y / Z - y[i]);
+    }
+  }
+
+  if (err[1] < err[0]) {
+    vpHomogeneousMatrix tmp = cMo[0];
+    cMo[0] = cMo[1];
+    cMo[1] = tmp;
+  }
+
+  return 2;
+}
+
+/*!
+  Compute the pose from coplanar points using the IPPE algorithm and keep
+  the solution with the lowest reprojection error.
+  \sa computeIPPE()
+
+  \param cMo : Estimated pose. No assumption is made on its initial value.
+
+  \exception vpPoseException::notEnoughPointError : Less than 4 points, or
+  the pose cannot be estimated (collinear points).
+*/
+void vpPose::poseIPPE(vpHomogeneousMatrix &cMo)
+{
+  std::vector<double> oX(npt), oY(npt), oZ(npt), x(npt), y(npt);
+  unsigned int i = 0;
+  for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it, i++) {
+    oX[i] = it->get_oX();
+    oY[i] = it->get_oY();
+    oZ[i] = it->get_oZ();
+    x[i] = it->get_x();
+    y[i] = it->get_y();
+  }
+
+  vpHomogeneousMatrix solutions[2];
+  if (npt < 4 || computeIPPE(npt, &oX[0], &oY[0], &oZ[0], &x[0], &y[0], solutions) == 0) {
+    throw(vpPoseException(vpPoseException::notEnoughPointError,
+                          "IPPE method cannot be used in that case "
+                          "(at least 4 non collinear points are required)"));
+  }
+  cMo = solutions[0];
+}
@@ -0,0 +1,375 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Pose computation from three points (P3P).
+ *
+ *****************************************************************************/
+
+/*!
+  \file vpPoseP3P.cpp
+  \brief Closed-form pose estimation from three points.
+*/
+
+#include <cmath>
+#include <limits>
+
+#include <visp3/core/vpMath.h>
+#include <visp3/vision/vpPose.h>
+#include <visp3/vision/vpPoseException.h>
+
+namespace
+{
+// Cubic root of a possibly negative value
+double cubicRoot(double x) { return (x < 0.0) ? -std::pow(-x, 1.0 / 3.0) : std::pow(x, 1.0 / 3.0); }
+
+// Largest real root of x^3 + b x^2 + c x + d
+double largestCubicRoot(double b, double c, double d)
+{
+  // Depressed cubic t^3 + p t + q with x = t - b/3
+  const double p = c - b * b / 3.0;
+  const double q = 2.0 * b * b * b / 27.0 - b * c / 3.0 + d;
+  const double disc = q * q / 4.0 + p * p * p / 27.0;
+
+  double t;
+  if (disc > 0.0) {
+    const double sq = std::sqrt(disc);
+    t = cubicRoot(-q / 2.0 + sq) + cubicRoot(-q / 2.0 - sq);
+  } else {
+    // Three real roots, the trigonometric solution with k = 0 is the largest
+    const double r = std::sqrt(-p / 3.0);
+    double arg = (r > 0.0) ? -q / (2.0 * r * r * r) : 0.0;
+    arg = (std::max)(-1.0, (std::min)(1.0, arg));
+    t = 2.0 * r * std::cos(std::acos(arg) / 3.0);
+  }
+
+  return t - b / 3.0;
+}
+
+// Real roots of the quartic a[0] x^4 + a[1] x^3 + a[2] x^2 + a[3] x + a[4] using Ferrari's method
+unsigned int solveQuartic(const double a[5], double roots[4])
+{
+  if (std::fabs(a[0]) < std::numeric_limits<double>::epsilon()) {
+    return 0;
+  }
+
+  const double b = a[1] / a[0], c = a[2] / a[0], d = a[3] / a[0], e = a[4] / a[0];
+
+  // Depressed quartic t^4 + p t^2 + q t + r with x = t - b/4
+  const double b2 = b * b;
+  const double p = c - 3.0 * b2 / 8.0;
+  const double q = d - b * c / 2.0 + b2 * b / 8.0;
+  const double r = e - b * d / 4.0 + b2 * c / 16.0 - 3.0 * b2 * b2 / 256.0;
+
+  unsigned int nbRoots = 0;
+  if (std::fabs(q) < 1e-12) {
+    // Biquadratic equation in t^2
+    const double disc = p * p - 4.0 * r;
+    if (disc >= 0.0) {
+      const double sq = std::sqrt(disc);
+      const double z[2] = {(-p + sq) / 2.0, (-p - sq) / 2.0};
+      for (unsigned int i = 0; i < 2; i++) {
+        if (z[i] >= 0.0) {
+          roots[nbRoots++] = std::sqrt(z[i]);
+          roots[nbRoots++] = -std::sqrt(z[i]);
+        }
+      }
+    }
+  } else {
+    // Resolvent cubic m^3 + p m^2 + (p^2/4 - r) m - q^2/8 that always has a positive root
+    const double m = largestCubicRoot(p, p * p / 4.0 - r, -q * q / 8.0);
+    if (m <= 0.0) {
+      return 0;
+    }
+
+    // The quartic factorizes in t^2 -+ s t + (p/2 + m +- q/(2s))
+    const double s = std::sqrt(2.0 * m);
+    const double c0[2] = {p / 2.0 + m + q / (2.0 * s), p / 2.0 + m - q / (2.0 * s)};
+    const double c1[2] = {-s, s};
+    for (unsigned int i = 0; i < 2; i++) {
+      const double disc = c1[i] * c1[i] - 4.0 * c0[i];
+      if (disc >= 0.0) {
+        const double sq = std::sqrt(disc);
+        roots[nbRoots++] = (-c1[i] + sq) / 2.0;
+        roots[nbRoots++] = (-c1[i] - sq) / 2.0;
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < nbRoots; i++) {
+    double x = roots[i] - b / 4.0;
+
+    // Polish the root with a few Newton iterations on the original polynomial
+    for (unsigned int iter = 0; iter < 2; iter++) {
+      const double f = (((x + b) * x + c) * x + d) * x + e;
+      const double df = ((4.0 * x + 3.0 * b) * x + 2.0 * c) * x + d;
+      if (std::fabs(df) > std::numeric_limits<double>::epsilon()) {
+        x -= f / df;
+      }
+    }
+    roots[i] = x;
+  }
+
+  return nbRoots;
+}
+
+// Orthonormal frame attached to a triangle, stored column-wise: first axis
+// along P1P2, third axis normal to the triangle. Returns false if the points
+// are collinear.
+bool triangleFrame(const double P[3][3], double F[3][3])
+{
+  double e1[3], e3[3], e2[3], u[3];
+  for (unsigned int i = 0; i < 3; i++) {
+    e1[i] = P[1][i] - P[0][i];
+    u[i] = P[2][i] - P[0][i];
+  }
+  e3[0] = e1[1] * u[2] - e1[2] * u[1];
+  e3[1] = e1[2] * u[0] - e1[0] * u[2];
+  e3[2] = e1[0] * u[1] - e1[1] * u[0];
+
+  const double n1 = std::sqrt(e1[0] * e1[0] + e1[1] * e1[1] + e1[2] * e1[2]);
+  const double n3 = std::sqrt(e3[0] * e3[0] + e3[1] * e3[1] + e3[2] * e3[2]);
+  if (n1 < std::numeric_limits<double>::epsilon() || n3 < std::numeric_limits<double>::epsilon() * n1) {
+    return false;
+  }
+
+  for (unsigned int i = 0; i < 3; i++) {
+    e1[i] /= n1;
+    e3[i] /= n3;
+  }
+  e2[0] = e3[1] * e1[2] - e3[2] * e1[1];
+  e2[1] = e3[2] * e1[0] - e3[0] * e1[2];
+  e2[2] = e3[0] * e1[1] - e3[1] * e1[0];
+
+  for (unsigned int i = 0; i < 3; i++) {
+    F[i][0] = e1[i];
+    F[i][1] = e2[i];
+    F[i][2] = e3[i];
+  }
+
+  return true;
+}
+}
+
+/*!
+  Compute the poses that are consistent with three 2D-3D point
+  correspondences using Grunert's closed-form solution of the
+  perspective-three-point problem, as reviewed in Haralick et al.,
+  "Review and analysis of solutions of the three point perspective pose
+  estimation problem", IJCV 1994.
+
+  \param oX, oY, oZ : Coordinates of the three points in the object frame.
+  \param x, y : Normalized coordinates of the three points in the image plane.
+  \param cMo : Up to four poses that project the three points on their image
+  coordinates.
+
+  \return The number of solutions stored in \e cMo. 0 is returned when the
+  configuration is degenerate, for example if the points are collinear.
+
+  \sa poseP3P()
+*/
+unsigned int vpPose::computeP3P(const double *oX, const double *oY, const double *oZ, const double *x,
+                                const double *y, vpHomogeneousMatrix cMo[4])
+{
+  // Unit vectors along the lines of sight
+  double j[3][3];
+  for (unsigned int i = 0; i < 3; i++) {
+    const double norm = std::sqrt(x[i] * x[i] + y[i] * y[i] + 1.0);
+    j[i][0] = x[i] / norm;
+    j[i][1] = y[i] / norm;
+    j[i][2] = 1.0 / norm;
+  }
+
+  const double a2 = vpMath::sqr(oX[1] - oX[2]) + vpMath::sqr(oY[1] - oY[2]) + vpMath::sqr(oZ[1] - oZ[2]);
+  const double b2 = vpMath::sqr(oX[0] - oX[2]) + vpMath::sqr(oY[0] - oY[2]) + vpMath::sqr(oZ[0] - oZ[2]);
+  const double c2 = vpMath::sqr(oX[0] - oX[1]) + vpMath::sqr(oY[0] - oY[1]) + vpMath::sqr(oZ[0] - oZ[1]);
+  if (b2 < std::numeric_limits<double>::epsilon()) {
+    return 0;
+  }
+
+  const double cos_alpha = j[1][0] * j[2][0] + j[1][1] * j[2][1] + j[1][2] * j[2][2];
+  const double cos_beta = j[0][0] * j[2][0] + j[0][1] * j[2][1] + j[0][2] * j[2][2];
+  const double cos_gamma = j[0][0] * j[1][0] + j[0][1] * j[1][1] + j[0][2] * j[1][2];
+
+  // With s2 = u s1 and s3 = v s1 the distances of the points to the camera,
+  // u = N(v) / D(v) and the law of cosines gives
+  // N^2 - 2 cos_gamma N D + Q D^2 = 0, a quartic in v
+  const double A = (a2 - c2) / b2, C = c2 / b2;
+  const double N[3] = {1.0 + A, -2.0 * A * cos_beta, A - 1.0};  // ascending powers of v
+  const double D[2] = {2.0 * cos_gamma, -2.0 * cos_alpha};
+  const double Q[3] = {1.0 - C, 2.0 * C * cos_beta, -C};
+
+  double poly[5] = {0.0, 0.0, 0.0, 0.0, 0.0}; // ascending powers of v
+  for (unsigned int i = 0; i < 3; i++) {
+    for (unsigned int k = 0; k < 3; k++) {
+      poly[i + k] += N[i] * N[k];
+    }
+    for (unsigned int k = 0; k < 2; k++) {
+      poly[i + k] -= 2.0 * cos_gamma * N[i] * D[k];
+    }
+  }
+  const double D2[3] = {D[0] * D[0], 2.0 * D[0] * D[1], D[1] * D[1]};
+  for (unsigned int i = 0; i < 3; i++) {
+    for (unsigned int k = 0; k < 3; k++) {
+      poly[i + k] += Q[i] * D2[k];
+    }
+  }
+
+  const double coeffs[5] = {poly[4], poly[3], poly[2], poly[1], poly[0]};
+  double roots[4];
+  const unsigned int nbRoots = solveQuartic(coeffs, roots);
+
+  double Pw[3][3], Fw[3][3];
+  for (unsigned int i = 0; i < 3; i++) {
+    Pw[i][0] = oX[i];
+    Pw[i][1] = oY[i];
+    Pw[i][2] = oZ[i];
+  }
+  if (!triangleFrame(Pw, Fw)) {
+    return 0;
+  }
+
+  unsigned int nbSolutions = 0;
+  for (unsigned int r = 0; r < nbRoots; r++) {
+    const double v = roots[r];
+    const double den = D[0] + D[1] * v;
+    const double t = 1.0 + v * v - 2.0 * v * cos_beta;
+    if (std::fabs(den) < std::numeric_limits<double>::epsilon() || t <= 0.0) {
+      continue;
+    }
+
+    const double u = (N[0] + (N[1] + N[2] * v) * v) / den;
+    const double s1 = std::sqrt(b2 / t);
+    const double s[3] = {s1, u * s1, v * s1};
+    if (s[1] <= 0.0 || s[2] <= 0.0) {
+      continue;
+    }
+
+    double Pc[3][3], Fc[3][3];
+    for (unsigned int i = 0; i < 3; i++) {
+      for (unsigned int k = 0; k < 3; k++) {
+        Pc[i][k] = s[i] * j[i][k];
+      }
+    }
+    if (!triangleFrame(Pc, Fc)) {
+      continue;
+    }
+
+    // The rotation maps the object frame of the triangle on its camera frame
+    vpHomogeneousMatrix &M = cMo[nbSolutions];
+    for (unsigned int i = 0; i < 3; i++) {
+      for (unsigned int k = 0; k < 3; k++) {
+        M[i][k] = Fc[i][0] * Fw[k][0] + Fc[i][1] * Fw[k][1] + Fc[i][2] * Fw[k][2];
+      }
+    }
+    for (unsigned int i = 0; i < 3; i++) {
+      M[i][3] = Pc[0][i] - (M[i][0] * Pw[0][0] + M[i][1] * Pw[0][1] + M[i][2] * Pw[0][2]);
+    }
+    nbSolutions++;
+  }
+
+  return nbSolutions;
+}
+
+/*!
+  Compute the pose from three of the points using computeP3P() and keep,
+  among the up to four solutions, the one that minimizes the residual over
+  all the points. To limit the sensitivity to noise, the three points are
+  chosen to span a large triangle.
+
+  \param cMo : Estimated pose. No assumption is made on its initial value.
+
+  \exception vpPoseException::notEnoughPointError : Less than 4 points, or no
+  solution could be found (degenerate configuration).
+*/
+void vpPose::poseP3P(vpHomogeneousMatrix &cMo)
+{
+  if (npt < 4) {
+    throw(vpPoseException(vpPoseException::notEnoughPointError,
+                          "P3P method cannot be used in that case "
+                          "(at least 4 points are required). "
+                          "Not enough point (%d) to compute the pose  ",
+                          npt));
+  }
+
+  // Select the first point, the farthest point from it, and the farthest
+  // point from the line joining them
+  std::vector<vpPoint> points(listP.begin(), listP.end());
+  const vpPoint &P0 = points[0];
+  size_t i1 = 1, i2 = 2;
+  double dmax = 0.0;
+  for (size_t i = 1; i < points.size(); i++) {
+    double d = vpMath::sqr(points[i].get_oX() - P0.get_oX()) + vpMath::sqr(points[i].get_oY() - P0.get_oY()) +
+               vpMath::sqr(points[i].get_oZ() - P0.get_oZ());
+    if (d > dmax) {
+      dmax = d;
+      i1 = i;
+    }
+  }
+  const double ux = points[i1].get_oX() - P0.get_oX(), uy = points[i1].get_oY() - P0.get_oY(),
+               uz = points[i1].get_oZ() - P0.get_oZ();
+  dmax = 0.0;
+  for (size_t i = 1; i < points.size(); i++) {
+    const double wx = points[i].get_oX() - P0.get_oX(), wy = points[i].get_oY() - P0.get_oY(),
+                 wz = points[i].get_oZ() - P0.get_oZ();
+    double d = vpMath::sqr(uy * wz - uz * wy) + vpMath::sqr(uz * wx - ux * wz) + vpMath::sqr(ux * wy - uy * wx);
+    if (i != i1 && d > dmax) {
+      dmax = d;
+      i2 = i;
+    }
+  }
+
+  const size_t idx[3] = {0, i1, i2};
+  double oX[3], oY[3], oZ[3], x[3], y[3];
+  for (unsigned int i = 0; i < 3; i++) {
+    oX[i] = points[idx[i]].get_oX();
+    oY[i] = points[idx[i]].get_oY();
+    oZ[i] = points[idx[i]].get_oZ();
+    x[i] = points[idx[i]].get_x();
+    y[i] = points[idx[i]].get_y();
+  }
+
+  vpHomogeneousMatrix solutions[4];
+  unsigned int nbSolutions = computeP3P(oX, oY, oZ, x, y, solutions);
+  if (nbSolutions == 0) {
+    throw(vpPoseException(vpPoseException::notEnoughPointError,
+                          "P3P method cannot be used in that case "
+                          "(degenerate configuration)"));
+  }
+
+  double r_min = std::numeric_limits<double>::max();
+  for (unsigned int i = 0; i < nbSolutions; i++) {
+    double r = computeResidual(solutions[i]);
+    if (r < r_min) {
+      r_min = r;
+      cMo = solutions[i];
+    }
+  }
+}
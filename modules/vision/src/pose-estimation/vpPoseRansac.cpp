@@ -43,7 +43,7 @@
   \brief function used to estimate a pose using the Ransac algorithm
 */
 
-#include <algorithm> // std::count
+#include <algorithm> // std::fill
 #include <cmath>     // std::fabs
 #include <float.h>   // DBL_MAX
 #include <iostream>
@@ -104,25 +104,36 @@ struct CompareImagePointDegenerate {
     return false;
   }
 };
+}
 
-// std::find_if
-struct FindDegeneratePoint {
-  explicit FindDegeneratePoint(const vpPoint &pt) : m_pt(pt) {}
+/*!
+  Return true if the point at \e index is degenerate with one of the points
+  whose indexes are given, that is if their 3D coordinates or their 2D
+  coordinates are identical.
+*/
+bool vpPose::RansacFunctor::isDegenerate(unsigned int index, const std::vector<unsigned int> &indexes) const
+{
+  const double oX = m_uniquePoints.oX[index], oY = m_uniquePoints.oY[index], oZ = m_uniquePoints.oZ[index];
+  const double x = m_uniquePoints.x[index], y = m_uniquePoints.y[index];
 
-  bool operator()(const vpPoint &pt)
-  {
-    return ((std::fabs(m_pt.oP[0] - pt.oP[0]) < eps && std::fabs(m_pt.oP[1] - pt.oP[1]) < eps &&
-             std::fabs(m_pt.oP[2] - pt.oP[2]) < eps) ||
-            (std::fabs(m_pt.p[0] - pt.p[0]) < eps && std::fabs(m_pt.p[1] - pt.p[1]) < eps));
+  for (std::vector<unsigned int>::const_iterator it = indexes.begin(); it != indexes.end(); ++it) {
+    if ((std::fabs(oX - m_uniquePoints.oX[*it]) < eps && std::fabs(oY - m_uniquePoints.oY[*it]) < eps &&
+         std::fabs(oZ - m_uniquePoints.oZ[*it]) < eps) ||
+        (std::fabs(x - m_uniquePoints.x[*it]) < eps && std::fabs(y - m_uniquePoints.y[*it]) < eps)) {
+      return true;
+    }
   }
 
-  vpPoint m_pt;
-};
+  return false;
 }
 
 bool vpPose::RansacFunctor::poseRansacImpl()
 {
-  const unsigned int size = (unsigned int)m_listOfUniquePoints.size();
+  if (m_hypothesisMethod == vpPose::P3P || m_hypothesisMethod == vpPose::EPNP || m_hypothesisMethod == vpPose::IPPE) {
+    return poseRansacMinimalImpl();
+  }
+
+  const unsigned int size = (unsigned int)m_uniquePoints.size();
   const unsigned int nbMinRandom = 4;
   int nbTrials = 0;
 
@@ -130,34 +141,38 @@ bool vpPose::RansacFunctor::poseRansacImpl()
   srand(m_initial_seed);
 #endif
 
-  vpPoint p; // Point used to project using the estimated pose
+  // Buffers are allocated once, the RANSAC loop only fills them
+  m_curConsensus.reserve(size);
+  m_curRandoms.reserve(nbMinRandom);
+  m_usedPt.resize(size);
+  m_xProj.resize(size);
+  m_yProj.resize(size);
+
+  // Pose used to estimate the pose from the minimal sample sets
+  vpPose poseMin;
+  vpPoint pt;
+  vpHomogeneousMatrix cMo_lagrange, cMo_dementhon;
+  // Use a temporary variable because if not, the cMo passed in parameters
+  // will be modified when
+  // we compute the pose for the minimal sample sets but if the pose is not
+  // correct when we pass a function pointer we do not want to modify the
+  // cMo passed in parameters
+  vpHomogeneousMatrix cMo_tmp;
+
+  const double threshold2 = m_ransacThreshold * m_ransacThreshold;
 
   bool foundSolution = false;
   while (nbTrials < m_ransacMaxTrials && m_nbInliers < m_ransacNbInlierConsensus) {
-    // Hold the list of the index of the inliers (points in the consensus set)
-    std::vector<unsigned int> cur_consensus;
-    // Hold the list of the index of the outliers
-    std::vector<unsigned int> cur_outliers;
     // Hold the list of the index of the points randomly picked
-    std::vector<unsigned int> cur_randoms;
-    // Hold the list of the current inliers points to avoid to add a
-    // degenerate point if the flag is set
-    std::vector<vpPoint> cur_inliers;
-
-    vpHomogeneousMatrix cMo_lagrange, cMo_dementhon;
-    // Use a temporary variable because if not, the cMo passed in parameters
-    // will be modified when
-    // we compute the pose for the minimal sample sets but if the pose is not
-    // correct when we pass a function pointer we do not want to modify the
-    // cMo passed in parameters
-    vpHomogeneousMatrix cMo_tmp;
+    m_curRandoms.clear();
 
     // Vector of used points, initialized at false for all points
-    std::vector<bool> usedPt(size, false);
+    std::fill(m_usedPt.begin(), m_usedPt.end(), false);
+    unsigned int nbUsedPt = 0;
 
-    vpPose poseMin;
+    poseMin.clearPoint();
     for (unsigned int i = 0; i < nbMinRandom;) {
-      if ((size_t)std::count(usedPt.begin(), usedPt.end(), true) == usedPt.size()) {
+      if (nbUsedPt == size) {
         // All points was picked once, break otherwise we stay in an infinite loop
         break;
       }
@@ -169,7 +184,7 @@ bool vpPose::RansacFunctor::poseRansacImpl()
       unsigned int r_ = (unsigned int)rand_r(&m_initial_seed) % size;
 #endif
 
-      while (usedPt[r_]) {
+      while (m_usedPt[r_]) {
 // If already picked, pick another point randomly
 #if defined(_WIN32) && (defined(_MSC_VER) || defined(__MINGW32__)) || defined(ANDROID)
         r_ = (unsigned int)rand() % size;
@@ -178,20 +193,15 @@ bool vpPose::RansacFunctor::poseRansacImpl()
 #endif
       }
       // Mark this point as already picked
-      usedPt[r_] = true;
-      vpPoint pt = m_listOfUniquePoints[r_];
-
-      bool degenerate = false;
-      if (m_checkDegeneratePoints) {
-        if (std::find_if(poseMin.listOfPoints.begin(), poseMin.listOfPoints.end(), FindDegeneratePoint(pt)) !=
-            poseMin.listOfPoints.end()) {
-          degenerate = true;
-        }
-      }
+      m_usedPt[r_] = true;
+      nbUsedPt++;
 
-      if (!degenerate) {
+      if (!m_checkDegeneratePoints || !isDegenerate(r_, m_curRandoms)) {
+        pt.setWorldCoordinates(m_uniquePoints.oX[r_], m_uniquePoints.oY[r_], m_uniquePoints.oZ[r_]);
+        pt.set_x(m_uniquePoints.x[r_]);
+        pt.set_y(m_uniquePoints.y[r_]);
         poseMin.addPoint(pt);
-        cur_randoms.push_back(r_);
+        m_curRandoms.push_back(r_);
         // Increment the number of points picked
         i++;
       }
@@ -259,39 +269,27 @@ bool vpPose::RansacFunctor::poseRansacImpl()
       }
 
       if (isPoseValid && r < m_ransacThreshold) {
-        unsigned int nbInliersCur = 0;
-        unsigned int iter = 0;
-        for (std::vector<vpPoint>::const_iterator it = m_listOfUniquePoints.begin(); it != m_listOfUniquePoints.end();
-             ++it, iter++) {
-          p.setWorldCoordinates(it->get_oX(), it->get_oY(), it->get_oZ());
-          p.track(m_cMo);
-
-          double error = sqrt(vpMath::sqr(p.get_x() - it->get_x()) + vpMath::sqr(p.get_y() - it->get_y()));
-          if (error < m_ransacThreshold) {
-            bool degenerate = false;
-            if (m_checkDegeneratePoints) {
-              if (std::find_if(cur_inliers.begin(), cur_inliers.end(), FindDegeneratePoint(*it)) != cur_inliers.end()) {
-                degenerate = true;
-              }
-            }
-
-            if (!degenerate) {
-              // the point is considered as inlier if the error is below the
-              // threshold
-              nbInliersCur++;
-              cur_consensus.push_back(iter);
-              cur_inliers.push_back(*it);
-            } else {
-              cur_outliers.push_back(iter);
-            }
-          } else {
-            cur_outliers.push_back(iter);
+        // Hold the list of the index of the inliers (points in the consensus set)
+        m_curConsensus.clear();
+
+        // Project all the points at once using the estimated pose
+        vpPoint::projectPoints(m_cMo, size, &m_uniquePoints.oX[0], &m_uniquePoints.oY[0], &m_uniquePoints.oZ[0],
+                               &m_xProj[0], &m_yProj[0]);
+
+        for (unsigned int iter = 0; iter < size; iter++) {
+          double error2 = vpMath::sqr(m_xProj[iter] - m_uniquePoints.x[iter]) +
+                          vpMath::sqr(m_yProj[iter] - m_uniquePoints.y[iter]);
+          // the point is considered as inlier if the error is below the
+          // threshold and if it is not degenerate with a previous inlier
+          if (error2 < threshold2 && (!m_checkDegeneratePoints || !isDegenerate(iter, m_curConsensus))) {
+            m_curConsensus.push_back(iter);
           }
         }
 
+        unsigned int nbInliersCur = (unsigned int)m_curConsensus.size();
         if (nbInliersCur > m_nbInliers) {
           foundSolution = true;
-          m_best_consensus = cur_consensus;
+          m_best_consensus = m_curConsensus;
           m_nbInliers = nbInliersCur;
         }
 
@@ -316,6 +314,176 @@ bool vpPose::RansacFunctor::poseRansacImpl()
   return foundSolution;
 }
 
+/*!
+  RANSAC loop where the pose hypotheses are computed with a closed-form
+  solver (P3P, EPnP or IPPE) from a minimal sample. Each of the solutions of
+  the solver is scored against all the points, and the number of trials is
+  reduced as soon as the inlier ratio of the best consensus set ensures with
+  a probability of 0.99 that an outlier free sample has been drawn.
+*/
+bool vpPose::RansacFunctor::poseRansacMinimalImpl()
+{
+  const unsigned int size = (unsigned int)m_uniquePoints.size();
+  const unsigned int maxSampleSize = 5;
+  unsigned int sampleSize = 4;
+  if (m_hypothesisMethod == vpPose::P3P) {
+    sampleSize = 3;
+  } else if (m_hypothesisMethod == vpPose::EPNP) {
+    // EPnP is more stable with an overdetermined sample
+    sampleSize = (std::min)(maxSampleSize, size);
+  }
+  if (size < sampleSize) {
+    return false;
+  }
+
+#if defined(_WIN32) && (defined(_MSC_VER) || defined(__MINGW32__))
+  srand(m_initial_seed);
+#endif
+
+  m_curConsensus.reserve(size);
+  m_curRandoms.reserve(sampleSize);
+  m_usedPt.resize(size);
+  m_xProj.resize(size);
+  m_yProj.resize(size);
+
+  double oX[maxSampleSize], oY[maxSampleSize], oZ[maxSampleSize], x[maxSampleSize], y[maxSampleSize];
+  vpHomogeneousMatrix hypotheses[4];
+  const double threshold2 = m_ransacThreshold * m_ransacThreshold;
+  const double probability = 0.99;
+
+  int maxTrials = m_ransacMaxTrials;
+  int nbTrials = 0;
+  bool foundSolution = false;
+  while (nbTrials < maxTrials && m_nbInliers < m_ransacNbInlierConsensus) {
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+    if (m_abort) {
+      // Another thread reached the consensus
+      break;
+    }
+#endif
+    nbTrials++;
+
+    m_curRandoms.clear();
+    std::fill(m_usedPt.begin(), m_usedPt.end(), false);
+    unsigned int nbUsedPt = 0;
+    while (m_curRandoms.size() < sampleSize && nbUsedPt < size) {
+#if defined(_WIN32) && (defined(_MSC_VER) || defined(__MINGW32__)) || defined(ANDROID)
+      unsigned int r_ = (unsigned int)rand() % size;
+#else
+      unsigned int r_ = (unsigned int)rand_r(&m_initial_seed) % size;
+#endif
+      if (m_usedPt[r_]) {
+        continue;
+      }
+      m_usedPt[r_] = true;
+      nbUsedPt++;
+
+      if (!m_checkDegeneratePoints || !isDegenerate(r_, m_curRandoms)) {
+        const unsigned int i = (unsigned int)m_curRandoms.size();
+        oX[i] = m_uniquePoints.oX[r_];
+        oY[i] = m_uniquePoints.oY[r_];
+        oZ[i] = m_uniquePoints.oZ[r_];
+        x[i] = m_uniquePoints.x[r_];
+        y[i] = m_uniquePoints.y[r_];
+        m_curRandoms.push_back(r_);
+      }
+    }
+
+    if (m_curRandoms.size() < sampleSize) {
+      continue;
+    }
+
+    unsigned int nbHypotheses = 0;
+    if (m_hypothesisMethod == vpPose::P3P) {
+      nbHypotheses = vpPose::computeP3P(oX, oY, oZ, x, y, hypotheses);
+    } else if (m_hypothesisMethod == vpPose::EPNP) {
+      nbHypotheses = vpPose::computeEPnP(sampleSize, oX, oY, oZ, x, y, hypotheses[0]) ? 1 : 0;
+    } else {
+      nbHypotheses = vpPose::computeIPPE(sampleSize, oX, oY, oZ, x, y, hypotheses);
+    }
+
+    for (unsigned int h = 0; h < nbHypotheses; h++) {
+      // Filter the pose using some criterion (orientation angles,
+      // translations, etc.)
+      if (m_func != NULL && !m_func(hypotheses[h])) {
+        continue;
+      }
+
+      m_curConsensus.clear();
+      vpPoint::projectPoints(hypotheses[h], size, &m_uniquePoints.oX[0], &m_uniquePoints.oY[0],
+                             &m_uniquePoints.oZ[0], &m_xProj[0], &m_yProj[0]);
+      for (unsigned int iter = 0; iter < size; iter++) {
+        double error2 = vpMath::sqr(m_xProj[iter] - m_uniquePoints.x[iter]) +
+                        vpMath::sqr(m_yProj[iter] - m_uniquePoints.y[iter]);
+        if (error2 < threshold2 && (!m_checkDegeneratePoints || !isDegenerate(iter, m_curConsensus))) {
+          m_curConsensus.push_back(iter);
+        }
+      }
+
+      if (m_curConsensus.size() > m_nbInliers) {
+        foundSolution = true;
+        m_nbInliers = (unsigned int)m_curConsensus.size();
+        m_best_consensus = m_curConsensus;
+        m_best_cMo = hypotheses[h];
+        m_cMo = hypotheses[h];
+
+        // Adaptive number of trials from the current inlier ratio
+        int nbTrialsNeeded =
+            vpPose::computeRansacIterations(probability, 1.0 - m_nbInliers / (double)size, (int)sampleSize, maxTrials);
+        if (nbTrialsNeeded > 0 && nbTrialsNeeded < maxTrials) {
+          maxTrials = nbTrialsNeeded;
+        }
+      }
+    }
+  }
+
+#ifdef VISP_HAVE_CPP11_COMPATIBILITY
+  if (m_nbInliers >= m_ransacNbInlierConsensus)
+    m_abort = true;
+#endif
+
+  return foundSolution;
+}
+
+/*!
+  Set the method used to compute the pose hypotheses in the RANSAC.
+
+  \param method : One of the following methods:
+  - vpPose::DEMENTHON (default) or vpPose::LAGRANGE: a pose is computed from
+  samples of 4 points with both Lagrange and Dementhon approaches and the one
+  with the lowest residual is kept.
+  - vpPose::P3P: up to four poses are computed from samples of 3 points.
+  - vpPose::EPNP: a pose is computed from samples of 5 points, the scene must
+  not be planar.
+  - vpPose::IPPE: two poses are computed from samples of 4 points, the scene
+  must be planar.
+
+  With P3P, EPNP or IPPE, the number of trials set with setRansacMaxTrials()
+  is an upper bound: the RANSAC stops as soon as the inlier ratio of the best
+  consensus set ensures with a probability of 0.99 that an outlier free sample
+  has been drawn. The final pose is then refined with the virtual visual
+  servoing approach on the consensus set, initialized with the best pose
+  hypothesis.
+
+  \exception vpException::badValue : If the method cannot be used to compute
+  the RANSAC hypotheses.
+*/
+void vpPose::setRansacHypothesisMethod(const vpPoseMethodType &method)
+{
+  switch (method) {
+  case LAGRANGE:
+  case DEMENTHON:
+  case P3P:
+  case EPNP:
+  case IPPE:
+    ransacHypothesisMethod = method;
+    break;
+  default:
+    throw(vpException(vpException::badValue, "Method %d cannot be used to compute the RANSAC hypotheses",
+                      (int)method));
+  }
+}
+
 /*!
   Compute the pose using the Ransac approach.
 
@@ -337,11 +505,18 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(const vpHomogeneo
     std::cerr << "You should not modify vpPose::listP!" << std::endl;
     listOfPoints = std::vector<vpPoint>(listP.begin(), listP.end());
   }
+  if (pointArrays.size() != listOfPoints.size()) {
+    pointArrays.clear();
+    for (std::vector<vpPoint>::const_iterator it = listOfPoints.begin(); it != listOfPoints.end(); ++it) {
+      pointArrays.push_back(*it);
+    }
+  }
 
   ransacInliers.clear();
   ransacInlierIndex.clear();
 
   std::vector<unsigned int> best_consensus;
+  vpHomogeneousMatrix best_cMo;
   unsigned int nbInliers = 0;
 
   vpHomogeneousMatrix cMo_lagrange, cMo_dementhon;
@@ -350,8 +525,11 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(const vpHomogeneo
     throw(vpPoseException(vpPoseException::notInitializedError, "Not enough point to compute the pose"));
   }
 
-  std::vector<vpPoint> listOfUniquePoints;
-  std::map<size_t, size_t> mapOfUniquePointIndex;
+  // Points used by the RANSAC threads, stored in contiguous arrays, and
+  // index of each of them in listOfPoints
+  PointArrays prefilteredPoints;
+  const PointArrays *uniquePoints = &pointArrays;
+  std::vector<unsigned int> uniqueIndex;
 
   // Get RANSAC flags
   bool prefilterDegeneratePoints = ransacFlag == PREFILTER_DEGENERATE_POINTS;
@@ -374,22 +552,20 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(const vpHomogeneo
       if (filterImagePointMap.find(it->first) == filterImagePointMap.end()) {
         filterImagePointMap[it->first] = it->second;
 
-        listOfUniquePoints.push_back(it->first);
-        mapOfUniquePointIndex[listOfUniquePoints.size() - 1] = it->second;
+        prefilteredPoints.push_back(it->first);
+        uniqueIndex.push_back((unsigned int)it->second);
       }
     }
+    uniquePoints = &prefilteredPoints;
   } else {
-    // No prefiltering
-    listOfUniquePoints = listOfPoints;
-
-    size_t index_pt = 0;
-    for (std::vector<vpPoint>::const_iterator it_pt = listOfPoints.begin(); it_pt != listOfPoints.end();
-         ++it_pt, index_pt++) {
-      mapOfUniquePointIndex[index_pt] = index_pt;
+    // No prefiltering, the threads share the arrays of vpPose
+    uniqueIndex.resize(listOfPoints.size());
+    for (size_t i = 0; i < uniqueIndex.size(); i++) {
+      uniqueIndex[i] = (unsigned int)i;
     }
   }
 
-  if (listOfUniquePoints.size() < 4) {
+  if (uniquePoints->size() < 4) {
     throw(vpPoseException(vpPoseException::notInitializedError, "Not enough point to compute the pose"));
   }
 
@@ -427,11 +603,11 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(const vpHomogeneo
       unsigned int initial_seed = (unsigned int)i; //((unsigned int) time(NULL) ^ i);
       if (i < (size_t)nthreads - 1) {
         ransacWorkers.emplace_back(cMo, ransacNbInlierConsensus, splitTrials, ransacThreshold, initial_seed,
-                                   checkDegeneratePoints, listOfUniquePoints, func, abort);
+                                   checkDegeneratePoints, *uniquePoints, ransacHypothesisMethod, func, abort);
       } else {
         int maxTrialsRemainder = ransacMaxTrials - splitTrials * (nbThreads - 1);
         ransacWorkers.emplace_back(cMo, ransacNbInlierConsensus, maxTrialsRemainder, ransacThreshold, initial_seed,
-                                   checkDegeneratePoints, listOfUniquePoints, func, abort);
+                                   checkDegeneratePoints, *uniquePoints, ransacHypothesisMethod, func, abort);
       }
     }
 
@@ -452,6 +628,7 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(const vpHomogeneo
         if (worker.getBestConsensus().size() > best_consensus_size) {
           nbInliers = worker.getNbInliers();
           best_consensus = worker.getBestConsensus();
+          best_cMo = worker.getBestPose();
           best_consensus_size = worker.getBestConsensus().size();
         }
       }
@@ -465,7 +642,7 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(const vpHomogeneo
     std::atomic<bool> abort{false};
 #endif
     RansacFunctor sequentialRansac(cMo, ransacNbInlierConsensus, ransacMaxTrials, ransacThreshold, 0,
-                                   checkDegeneratePoints, listOfUniquePoints, func
+                                   checkDegeneratePoints, *uniquePoints, ransacHypothesisMethod, func
                                #ifdef VISP_HAVE_CPP11_COMPATIBILITY
                                    , abort
                                #endif
@@ -476,6 +653,7 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(const vpHomogeneo
     if (foundSolution) {
       nbInliers = sequentialRansac.getNbInliers();
       best_consensus = sequentialRansac.getBestConsensus();
+      best_cMo = sequentialRansac.getBestPose();
     }
   }
 
@@ -510,7 +688,7 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(const vpHomogeneo
       // with VVS pose estimation
       vpPose pose;
       for (size_t i = 0; i < best_consensus.size(); i++) {
-        vpPoint pt = listOfUniquePoints[best_consensus[i]];
+        vpPoint pt = listOfPoints[uniqueIndex[best_consensus[i]]];
 
         pose.addPoint(pt);
         ransacInliers.push_back(pt);
@@ -519,9 +697,13 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(const vpHomogeneo
       // Update the list of inlier index
       for (std::vector<unsigned int>::const_iterator it_index = best_consensus.begin();
            it_index != best_consensus.end(); ++it_index) {
-        ransacInlierIndex.push_back((unsigned int)mapOfUniquePointIndex[*it_index]);
+        ransacInlierIndex.push_back(uniqueIndex[*it_index]);
       }
 
+      // With a minimal solver, the best hypothesis initializes the refinement
+      bool initFromHypothesis = (ransacHypothesisMethod == P3P || ransacHypothesisMethod == EPNP ||
+                                 ransacHypothesisMethod == IPPE);
+
       // Flags set if pose computation is OK
       bool is_valid_lagrange = false;
       bool is_valid_dementhon = false;
@@ -530,31 +712,35 @@ bool vpPose::poseRansac(vpHomogeneousMatrix &cMo, bool (*func)(const vpHomogeneo
       double r_lagrange = DBL_MAX;
       double r_dementhon = DBL_MAX;
 
-      try {
-        pose.computePose(vpPose::LAGRANGE, cMo_lagrange);
-        r_lagrange = pose.computeResidual(cMo_lagrange);
-        is_valid_lagrange = true;
-      } catch (...) { }
-
-      try {
-        pose.computePose(vpPose::DEMENTHON, cMo_dementhon);
-        r_dementhon = pose.computeResidual(cMo_dementhon);
-        is_valid_dementhon = true;
-      } catch (...) { }
-
-      // If residual returned is not a number (NAN), set valid to false
-      if (vpMath::isNaN(r_lagrange)) {
-        is_valid_lagrange = false;
-        r_lagrange = DBL_MAX;
-      }
+      if (!initFromHypothesis) {
+        try {
+          pose.computePose(vpPose::LAGRANGE, cMo_lagrange);
+          r_lagrange = pose.computeResidual(cMo_lagrange);
+          is_valid_lagrange = true;
+        } catch (...) { }
+
+        try {
+          pose.computePose(vpPose::DEMENTHON, cMo_dementhon);
+          r_dementhon = pose.computeResidual(cMo_dementhon);
+          is_valid_dementhon = true;
+        } catch (...) { }
+
+        // If residual returned is not a number (NAN), set valid to false
+        if (vpMath::isNaN(r_lagrange)) {
+          is_valid_lagrange = false;
+          r_lagrange = DBL_MAX;
+        }
 
-      if (vpMath::isNaN(r_dementhon)) {
-        is_valid_dementhon = false;
-        r_dementhon = DBL_MAX;
+        if (vpMath::isNaN(r_dementhon)) {
+          is_valid_dementhon = false;
+          r_dementhon = DBL_MAX;
+        }
       }
 
-      if (is_valid_lagrange || is_valid_dementhon) {
-        if (r_lagrange < r_dementhon) {
+      if (initFromHypothesis || is_valid_lagrange || is_valid_dementhon) {
+        if (initFromHypothesis) {
+          cMo = best_cMo;
+        } else if (r_lagrange < r_dementhon) {
           cMo = cMo_lagrange;
         } else {
           cMo = cMo_dementhon;
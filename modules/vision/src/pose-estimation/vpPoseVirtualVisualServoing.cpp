@@ -70,16 +70,17 @@ void vpPose::poseVirtualVS(vpHomogeneousMatrix &cMo)
     vpColVector sd(2 * nb), s(2 * nb);
     vpColVector v;
 
-    vpPoint P;
-    std::list<vpPoint> lP;
+    // 3D model points stored contiguously and projected all at once
+    std::vector<double> oX(nb), oY(nb), oZ(nb), x(nb), y(nb), Z(nb);
 
     // create sd
     unsigned int k = 0;
     for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-      P = *it;
-      sd[2 * k] = P.get_x();
-      sd[2 * k + 1] = P.get_y();
-      lP.push_back(P);
+      sd[2 * k] = it->get_x();
+      sd[2 * k + 1] = it->get_y();
+      oX[k] = it->get_oX();
+      oY[k] = it->get_oY();
+      oZ[k] = it->get_oZ();
       k++;
     }
 
@@ -90,33 +91,27 @@ void vpPose::poseVirtualVS(vpHomogeneousMatrix &cMo)
     while (std::fabs(residu_1 - r) > vvsEpsilon) {
       residu_1 = r;
 
+      // forward projection of the 3D model for a given pose
+      vpPoint::projectPoints(cMo, nb, oX.data(), oY.data(), oZ.data(), x.data(), y.data(), Z.data());
+
       // Compute the interaction matrix and the error
-      k = 0;
-      for (std::list<vpPoint>::const_iterator it = lP.begin(); it != lP.end(); ++it) {
-        P = *it;
-        // forward projection of the 3D model for a given pose
-        // change frame coordinates
-        // perspective projection
-        P.track(cMo);
-
-        double x = s[2 * k] = P.get_x(); /* point projected from cMo */
-        double y = s[2 * k + 1] = P.get_y();
-        double Z = P.get_Z();
-        L[2 * k][0] = -1 / Z;
+      for (k = 0; k < nb; k++) {
+        double x_ = s[2 * k] = x[k]; /* point projected from cMo */
+        double y_ = s[2 * k + 1] = y[k];
+        double Z_ = Z[k];
+        L[2 * k][0] = -1 / Z_;
         L[2 * k][1] = 0;
-        L[2 * k][2] = x / Z;
-        L[2 * k][3] = x * y;
-        L[2 * k][4] = -(1 + x * x);
-        L[2 * k][5] = y;
+        L[2 * k][2] = x_ / Z_;
+        L[2 * k][3] = x_ * y_;
+        L[2 * k][4] = -(1 + x_ * x_);
+        L[2 * k][5] = y_;
 
         L[2 * k + 1][0] = 0;
-        L[2 * k + 1][1] = -1 / Z;
-        L[2 * k + 1][2] = y / Z;
-        L[2 * k + 1][3] = 1 + y * y;
-        L[2 * k + 1][4] = -x * y;
-        L[2 * k + 1][5] = -x;
-
-        k += 1;
+        L[2 * k + 1][1] = -1 / Z_;
+        L[2 * k + 1][2] = y_ / Z_;
+        L[2 * k + 1][3] = 1 + y_ * y_;
+        L[2 * k + 1][4] = -x_ * y_;
+        L[2 * k + 1][5] = -x_;
       }
       err = s - sd;
 
@@ -177,17 +172,17 @@ void vpPose::poseVirtualVSrobust(vpHomogeneousMatrix &cMo)
     vpColVector sd(2 * nb), s(2 * nb);
     vpColVector v;
 
-    listP.front();
-    vpPoint P;
-    std::list<vpPoint> lP;
+    // 3D model points stored contiguously and projected all at once
+    std::vector<double> oX(nb), oY(nb), oZ(nb), x(nb), y(nb), Z(nb);
 
     // create sd
     unsigned int k_ = 0;
     for (std::list<vpPoint>::const_iterator it = listP.begin(); it != listP.end(); ++it) {
-      P = *it;
-      sd[2 * k_] = P.get_x();
-      sd[2 * k_ + 1] = P.get_y();
-      lP.push_back(P);
+      sd[2 * k_] = it->get_x();
+      sd[2 * k_ + 1] = it->get_y();
+      oX[k_] = it->get_oX();
+      oY[k_] = it->get_oY();
+      oZ[k_] = it->get_oZ();
       k_++;
     }
     int iter = 0;
@@ -200,33 +195,27 @@ void vpPose::poseVirtualVSrobust(vpHomogeneousMatrix &cMo)
     while (std::fabs((residu_1 - r) * 1e12) > std::numeric_limits<double>::epsilon()) {
       residu_1 = r;
 
+      // forward projection of the 3D model for a given pose
+      vpPoint::projectPoints(cMo, nb, oX.data(), oY.data(), oZ.data(), x.data(), y.data(), Z.data());
+
       // Compute the interaction matrix and the error
-      k_ = 0;
-      for (std::list<vpPoint>::const_iterator it = lP.begin(); it != lP.end(); ++it) {
-        P = *it;
-        // forward projection of the 3D model for a given pose
-        // change frame coordinates
-        // perspective projection
-        P.track(cMo);
-
-        double x = s[2 * k_] = P.get_x(); // point projected from cMo
-        double y = s[2 * k_ + 1] = P.get_y();
-        double Z = P.get_Z();
-        L[2 * k_][0] = -1 / Z;
+      for (k_ = 0; k_ < nb; k_++) {
+        double x_ = s[2 * k_] = x[k_]; // point projected from cMo
+        double y_ = s[2 * k_ + 1] = y[k_];
+        double Z_ = Z[k_];
+        L[2 * k_][0] = -1 / Z_;
         L[2 * k_][1] = 0;
-        L[2 * k_][2] = x / Z;
-        L[2 * k_][3] = x * y;
-        L[2 * k_][4] = -(1 + x * x);
-        L[2 * k_][5] = y;
+        L[2 * k_][2] = x_ / Z_;
+        L[2 * k_][3] = x_ * y_;
+        L[2 * k_][4] = -(1 + x_ * x_);
+        L[2 * k_][5] = y_;
 
         L[2 * k_ + 1][0] = 0;
-        L[2 * k_ + 1][1] = -1 / Z;
-        L[2 * k_ + 1][2] = y / Z;
-        L[2 * k_ + 1][3] = 1 + y * y;
-        L[2 * k_ + 1][4] = -x * y;
-        L[2 * k_ + 1][5] = -x;
-
-        k_++;
+        L[2 * k_ + 1][1] = -1 / Z_;
+        L[2 * k_ + 1][2] = y_ / Z_;
+        L[2 * k_ + 1][3] = 1 + y_ * y_;
+        L[2 * k_ + 1][4] = -x_ * y_;
+        L[2 * k_ + 1][5] = -x_;
       }
       error = s - sd;
 
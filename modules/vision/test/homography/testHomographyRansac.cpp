@@ -0,0 +1,137 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the robust homography estimation using RANSAC.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testHomographyRansac.cpp
+
+  Test the sequential and the parallel homography estimation using RANSAC
+  with synthetic matches corrupted by outliers.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/vision/vpHomography.h>
+
+namespace
+{
+bool checkRansac(const std::vector<double> &xb, const std::vector<double> &yb, const std::vector<double> &xa,
+                 const std::vector<double> &ya, const std::vector<bool> &isInlier, const vpHomography &aHb_true,
+                 bool useParallelRansac)
+{
+  vpHomography aHb;
+  std::vector<bool> inliers;
+  double residual = 0;
+  const unsigned int nbInliersConsensus = (unsigned int)(0.6 * xb.size());
+  if (!vpHomography::ransac(xb, yb, xa, ya, aHb, inliers, residual, nbInliersConsensus, 1e-3, true,
+                            useParallelRansac)) {
+    std::cerr << "RANSAC failed" << std::endl;
+    return false;
+  }
+
+  for (size_t i = 0; i < inliers.size(); i++) {
+    if (isInlier[i] && !inliers[i]) {
+      std::cerr << "Point " << i << " should be an inlier" << std::endl;
+      return false;
+    }
+  }
+
+  for (unsigned int i = 0; i < 3; i++) {
+    for (unsigned int j = 0; j < 3; j++) {
+      if (!vpMath::equal(aHb[i][j], aHb_true[i][j], 1e-6)) {
+        std::cerr << "Bad homography:\n" << aHb << "\ninstead of:\n" << aHb_true << std::endl;
+        return false;
+      }
+    }
+  }
+
+  std::cout << "Residual: " << residual << std::endl;
+  return residual < 1e-6;
+}
+}
+
+int main()
+{
+  vpHomography aHb_true;
+  aHb_true[0][0] = 1.1;
+  aHb_true[0][1] = 0.05;
+  aHb_true[0][2] = 0.02;
+  aHb_true[1][0] = -0.08;
+  aHb_true[1][1] = 0.95;
+  aHb_true[1][2] = -0.01;
+  aHb_true[2][0] = 0.1;
+  aHb_true[2][1] = -0.05;
+  aHb_true[2][2] = 1;
+
+  // 70% of inliers, the outliers are far from their true location
+  vpUniRand random(42);
+  const unsigned int n = 200;
+  std::vector<double> xb(n), yb(n), xa(n), ya(n);
+  std::vector<bool> isInlier(n);
+  for (unsigned int i = 0; i < n; i++) {
+    xb[i] = random() - 0.5;
+    yb[i] = random() - 0.5;
+    double w = aHb_true[2][0] * xb[i] + aHb_true[2][1] * yb[i] + aHb_true[2][2];
+    xa[i] = (aHb_true[0][0] * xb[i] + aHb_true[0][1] * yb[i] + aHb_true[0][2]) / w;
+    ya[i] = (aHb_true[1][0] * xb[i] + aHb_true[1][1] * yb[i] + aHb_true[1][2]) / w;
+
+    isInlier[i] = (i % 10) < 7;
+    if (!isInlier[i]) {
+      xa[i] += 0.05 + 0.2 * random();
+      ya[i] -= 0.05 + 0.2 * random();
+    }
+  }
+
+  try {
+    std::cout << "Sequential RANSAC" << std::endl;
+    if (!checkRansac(xb, yb, xa, ya, isInlier, aHb_true, false)) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "Parallel RANSAC" << std::endl;
+    if (!checkRansac(xb, yb, xa, ya, isInlier, aHb_true, true)) {
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testHomographyRansac is ok!" << std::endl;
+  return EXIT_SUCCESS;
+}
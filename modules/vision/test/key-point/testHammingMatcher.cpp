@@ -0,0 +1,178 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Match binary descriptors with vpHammingMatcher and compare with an
+ * exhaustive search.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testHammingMatcher.cpp
+
+  Match binary descriptors with vpHammingMatcher and compare with an
+  exhaustive search.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpUniRand.h>
+#include <visp3/vision/vpHammingMatcher.h>
+
+namespace
+{
+void naiveMatch(const std::vector<unsigned char> &train, const std::vector<unsigned char> &query, unsigned int size,
+                std::vector<vpHammingMatcher::vpHammingMatch> &matches)
+{
+  const unsigned int nbTrain = (unsigned int)(train.size() / size);
+  matches.resize(query.size() / size);
+  for (size_t q = 0; q < matches.size(); q++) {
+    vpHammingMatcher::vpHammingMatch &m = matches[q];
+    m.trainIdx = m.secondTrainIdx = -1;
+    m.distance = m.secondDistance = 100000;
+    for (unsigned int i = 0; i < nbTrain; i++) {
+      unsigned int dist = vpHammingMatcher::distance(&query[q * size], &train[i * size], size);
+      if (dist < m.distance) {
+        m.secondTrainIdx = m.trainIdx;
+        m.secondDistance = m.distance;
+        m.trainIdx = (int)i;
+        m.distance = dist;
+      } else if (dist < m.secondDistance) {
+        m.secondTrainIdx = (int)i;
+        m.secondDistance = dist;
+      }
+    }
+  }
+}
+
+bool compareMatches(const std::vector<vpHammingMatcher::vpHammingMatch> &ref,
+                    const std::vector<vpHammingMatcher::vpHammingMatch> &matches, bool exactSecond,
+                    const std::string &name)
+{
+  if (ref.size() != matches.size()) {
+    std::cerr << name << ": bad number of matches" << std::endl;
+    return false;
+  }
+  for (size_t i = 0; i < ref.size(); i++) {
+    if (ref[i].distance != matches[i].distance || matches[i].secondDistance < ref[i].secondDistance ||
+        (exactSecond && ref[i].secondDistance != matches[i].secondDistance)) {
+      std::cerr << name << ": bad match for query " << i << ": " << matches[i].distance << " / "
+                << matches[i].secondDistance << " instead of " << ref[i].distance << " / " << ref[i].secondDistance
+                << std::endl;
+      return false;
+    }
+    if (ref[i].distance < ref[i].secondDistance && ref[i].trainIdx != matches[i].trainIdx) {
+      std::cerr << name << ": bad train index for query " << i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  vpUniRand rng;
+  // ORB like and BRISK like descriptor sizes, a size with words after the 256 bits blocks, and an odd size
+  const unsigned int sizes[4] = {32, 64, 48, 13};
+  const unsigned int nbTrain = 3000, nbQuery = 300;
+
+  for (unsigned int s = 0; s < 4; s++) {
+    const unsigned int size = sizes[s];
+    std::vector<unsigned char> train(nbTrain * size), query(nbQuery * size);
+    for (size_t i = 0; i < train.size(); i++) {
+      train[i] = (unsigned char)(rng() * 256);
+    }
+    // Half of the queries are noisy copies of train descriptors, the others are random
+    for (unsigned int q = 0; q < nbQuery; q++) {
+      if (q % 2 == 0) {
+        unsigned int idx = (unsigned int)(rng() * nbTrain) % nbTrain;
+        for (unsigned int k = 0; k < size; k++) {
+          query[q * size + k] = train[idx * size + k];
+        }
+        for (unsigned int k = 0; k < size / 4; k++) {
+          unsigned int bit = (unsigned int)(rng() * size * 8) % (size * 8);
+          query[q * size + bit / 8] ^= (unsigned char)(1 << (bit % 8));
+        }
+      } else {
+        for (unsigned int k = 0; k < size; k++) {
+          query[q * size + k] = (unsigned char)(rng() * 256);
+        }
+      }
+    }
+
+    std::vector<vpHammingMatcher::vpHammingMatch> ref, matches;
+    naiveMatch(train, query, size, ref);
+
+    vpHammingMatcher matcher;
+    matcher.train(&train[0], nbTrain, size);
+    matcher.match(&query[0], nbQuery, size, matches);
+    if (!compareMatches(ref, matches, true, "Brute force")) {
+      return EXIT_FAILURE;
+    }
+
+    // Exact multi-index hashing
+    matcher.setIndexType(vpHammingMatcher::MULTI_INDEX_HASHING);
+    matcher.setMaxSearchRadius(16);
+    matcher.match(&query[0], nbQuery, 0, matches);
+    if (!compareMatches(ref, matches, true, "Multi-index hashing")) {
+      return EXIT_FAILURE;
+    }
+
+    // Early exit with the ratio test: only the accepted matches are compared
+    const double ratio = 0.8;
+    matcher.setRatioThreshold(ratio);
+    matcher.setMaxSearchRadius(2);
+    matcher.match(&query[0], nbQuery, 0, matches);
+    unsigned int nbAccepted = 0;
+    for (unsigned int q = 0; q < nbQuery; q++) {
+      bool accepted = ref[q].distance < ratio * ref[q].secondDistance;
+      bool matchAccepted = matches[q].distance < ratio * matches[q].secondDistance;
+      if (accepted) {
+        nbAccepted++;
+        if (!matchAccepted || matches[q].trainIdx != ref[q].trainIdx) {
+          std::cerr << "Ratio test: query " << q << " should be matched with " << ref[q].trainIdx << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+    std::cout << "Descriptor size " << size << ": " << nbAccepted << " matches accepted by the ratio test"
+              << std::endl;
+    if (nbAccepted < nbQuery / 2) {
+      std::cerr << "The noisy copies should be accepted by the ratio test" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  std::cout << "testHammingMatcher is ok!" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,162 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the guided matching of vpKeyPoint with the pose of the previous image.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testKeyPointGuidedMatching.cpp
+
+  Compute the pose of a textured plane with vpKeyPoint::matchPoint(), then
+  with the guided matching from the previous pose, and from a wrong pose that
+  makes the guided matching fail.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020301)
+
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/vision/vpKeyPoint.h>
+
+namespace
+{
+bool checkPose(const vpHomogeneousMatrix &cMo, const vpHomogeneousMatrix &cMo_ref, const std::string &name)
+{
+  vpHomogeneousMatrix cdMc = cMo_ref * cMo.inverse();
+  double t = cdMc.getTranslationVector().frobeniusNorm();
+  double theta = vpThetaUVector(cdMc.getRotationMatrix()).frobeniusNorm();
+  if (t > 0.005 || theta > vpMath::rad(1)) {
+    std::cerr << name << ": bad pose, translation error " << t << " m, rotation error " << vpMath::deg(theta)
+              << " deg" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    // Textured plane seen from the front at 1 meter
+    vpUniRand rng;
+    vpImage<unsigned char> I(480, 640, 128);
+    for (unsigned int n = 0; n < 300; n++) {
+      unsigned int top = (unsigned int)(rng() * I.getHeight()), left = (unsigned int)(rng() * I.getWidth());
+      unsigned int height = 5 + (unsigned int)(rng() * 40), width = 5 + (unsigned int)(rng() * 40);
+      unsigned char value = (unsigned char)(rng() * 256);
+      for (unsigned int i = top; i < (std::min)(top + height, I.getHeight()); i++) {
+        for (unsigned int j = left; j < (std::min)(left + width, I.getWidth()); j++) {
+          I[i][j] = value;
+        }
+      }
+    }
+    vpCameraParameters cam(600, 600, 320, 240);
+    vpHomogeneousMatrix cMo_ref(0, 0, 1, 0, 0, 0);
+
+    // Reference keypoints on the plane Z = 0 of the object frame
+    vpKeyPoint keypoint("ORB", "ORB", "BruteForce-Hamming");
+    std::vector<cv::KeyPoint> trainKeyPoints;
+    keypoint.detect(I, trainKeyPoints);
+    std::vector<cv::Point3f> points3f;
+    for (size_t i = 0; i < trainKeyPoints.size(); i++) {
+      double x = 0, y = 0;
+      vpPixelMeterConversion::convertPoint(cam, trainKeyPoints[i].pt.x, trainKeyPoints[i].pt.y, x, y);
+      points3f.push_back(cv::Point3f((float)x, (float)y, 0.f));
+    }
+    keypoint.buildReference(I, trainKeyPoints, points3f);
+    keypoint.getTrainKeyPoints(trainKeyPoints);
+
+    // Matching with all the train keypoints
+    vpHomogeneousMatrix cMo;
+    if (!keypoint.matchPoint(I, cam, cMo) || !checkPose(cMo, cMo_ref, "Full matching")) {
+      return EXIT_FAILURE;
+    }
+
+    // Guided matching from the previous pose: each accepted query keypoint has at least two train keypoints in
+    // its search region, its own one and another one for the ratio test
+    const double radius = 20;
+    keypoint.setGuidedMatching(true, radius);
+    if (!keypoint.matchPoint(I, cam, cMo) || !checkPose(cMo, cMo_ref, "Guided matching")) {
+      return EXIT_FAILURE;
+    }
+    std::vector<cv::KeyPoint> queryKeyPoints;
+    keypoint.getQueryKeyPoints(queryKeyPoints);
+    std::vector<cv::DMatch> matches = keypoint.getMatches();
+    std::cout << matches.size() << " matches with the guided matching" << std::endl;
+    for (size_t i = 0; i < matches.size(); i++) {
+      const cv::Point2f &pt = queryKeyPoints[(size_t)matches[i].queryIdx].pt;
+      const cv::Point2f &trainPt = trainKeyPoints[(size_t)matches[i].trainIdx].pt;
+      unsigned int nbCandidates = 0;
+      for (size_t j = 0; j < trainKeyPoints.size(); j++) {
+        const cv::Point2f d = trainKeyPoints[j].pt - pt;
+        if (d.x * d.x + d.y * d.y <= (radius + 1) * (radius + 1)) {
+          nbCandidates++;
+        }
+      }
+      const cv::Point2f d = trainPt - pt;
+      if (d.x * d.x + d.y * d.y > (radius + 1) * (radius + 1) || nbCandidates < 2) {
+        std::cerr << "Guided matching: query keypoint " << pt << " matched with " << trainPt << " among "
+                  << nbCandidates << " candidates" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // A wrong previous pose makes the guided matching fail, the query descriptors are then matched with all the
+    // train keypoints
+    keypoint.setGuidedMatchingPose(vpHomogeneousMatrix(0.2, 0.1, 1, 0, 0, vpMath::rad(20)));
+    if (!keypoint.matchPoint(I, cam, cMo) || !checkPose(cMo, cMo_ref, "Lost guided matching")) {
+      return EXIT_FAILURE;
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testKeyPointGuidedMatching is ok!" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cerr << "You need OpenCV library." << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,206 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Save, append and load a vpKeyPoint learning database.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testKeyPointLearningDatabase.cpp
+
+  Save reference views in a learning database, append views to it, and check
+  that loading the whole database or some views gives back the train data.
+*/
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020301)
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/vision/vpKeyPoint.h>
+
+namespace
+{
+// Random reference view, without detection
+struct View {
+  View(vpUniRand &rng, int nbKeyPoints) : keyPoints(), descriptors(nbKeyPoints, 32, CV_8U), points()
+  {
+    for (int i = 0; i < nbKeyPoints; i++) {
+      keyPoints.push_back(cv::KeyPoint(cv::Point2f((float)(rng() * 640), (float)(rng() * 480)), 7.f,
+                                       (float)(rng() * 360), (float)rng(), 0));
+      points.push_back(cv::Point3f((float)rng(), (float)rng(), 1.f));
+      for (int j = 0; j < descriptors.cols; j++) {
+        descriptors.at<uchar>(i, j) = (uchar)(rng() * 256);
+      }
+    }
+  }
+
+  std::vector<cv::KeyPoint> keyPoints;
+  cv::Mat descriptors;
+  std::vector<cv::Point3f> points;
+};
+
+// Check that the train data of keypoint from index start are the ones of the view, with the given class id
+bool checkView(const vpKeyPoint &keypoint, size_t start, const View &view, int class_id, const std::string &name)
+{
+  std::vector<cv::KeyPoint> keyPoints;
+  std::vector<cv::Point3f> points;
+  keypoint.getTrainKeyPoints(keyPoints);
+  keypoint.getTrainPoints(points);
+  cv::Mat descriptors = keypoint.getTrainDescriptors();
+  if (keyPoints.size() < start + view.keyPoints.size() || points.size() != keyPoints.size() ||
+      descriptors.rows != (int)keyPoints.size()) {
+    std::cerr << name << ": bad number of train keypoints" << std::endl;
+    return false;
+  }
+
+  for (size_t i = 0; i < view.keyPoints.size(); i++) {
+    const cv::KeyPoint &kp = keyPoints[start + i];
+    const cv::Point3f &pt = points[start + i];
+    if (kp.pt != view.keyPoints[i].pt || kp.angle != view.keyPoints[i].angle ||
+        kp.response != view.keyPoints[i].response || kp.class_id != class_id || pt != view.points[i] ||
+        cv::norm(descriptors.row((int)(start + i)), view.descriptors.row((int)i), cv::NORM_HAMMING) != 0) {
+      std::cerr << name << ": bad train keypoint " << start + i << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+#if defined(_WIN32)
+    std::string opath = "C:/temp";
+#else
+    std::string opath = "/tmp";
+#endif
+    std::string username;
+    vpIoTools::getUserName(username);
+    opath = vpIoTools::createFilePath(vpIoTools::createFilePath(opath, username), "testKeyPointLearningDatabase");
+    vpIoTools::makeDirectory(opath);
+    std::string filename = vpIoTools::createFilePath(opath, "database.bin");
+
+    vpUniRand rng;
+    vpImage<unsigned char> I(480, 640, 0);
+    // The last view exceeds the initial capacity of the database
+    View view1(rng, 50), view2(rng, 40), view3(rng, 1500), view4(rng, 30);
+
+    // Save a view, then append a second one: only the new keypoints are written
+    vpKeyPoint keypoint;
+    keypoint.buildReference(I, view1.keyPoints, view1.descriptors, view1.points, false, 1);
+    keypoint.saveLearningDatabase(filename, false, false);
+    keypoint.buildReference(I, view2.keyPoints, view2.descriptors, view2.points, true, 2);
+    keypoint.saveLearningDatabase(filename, true, false);
+
+    // Append train data that do not come from the database, class ids are shifted after the ones of the database
+    vpKeyPoint other;
+    other.buildReference(I, view3.keyPoints, view3.descriptors, view3.points, false, 1);
+    other.saveLearningDatabase(filename, true, false);
+
+    vpKeyPoint loaded;
+    loaded.loadLearningDatabase(filename);
+    if (!checkView(loaded, 0, view1, 1, "Load") || !checkView(loaded, 50, view2, 2, "Load") ||
+        !checkView(loaded, 90, view3, 3, "Load")) {
+      return EXIT_FAILURE;
+    }
+
+    // Append a view to the loaded database
+    loaded.buildReference(I, view4.keyPoints, view4.descriptors, view4.points, true, 4);
+    loaded.saveLearningDatabase(filename, true, false);
+
+    vpKeyPoint reloaded;
+    reloaded.loadLearningDatabase(filename);
+    if (!checkView(reloaded, 0, view1, 1, "Reload") || !checkView(reloaded, 1590, view4, 4, "Reload")) {
+      return EXIT_FAILURE;
+    }
+    if (reloaded.getTrainDescriptors().rows != 1620) {
+      std::cerr << "Reload: bad number of train keypoints" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Load only the second and the last views with the index of the database
+    std::vector<int> imageIds;
+    imageIds.push_back(2);
+    imageIds.push_back(4);
+    vpKeyPoint selected;
+    selected.loadLearningDatabase(filename, imageIds);
+    if (!checkView(selected, 0, view2, 2, "Selection") || !checkView(selected, 40, view4, 4, "Selection") ||
+        selected.getTrainDescriptors().rows != 70) {
+      return EXIT_FAILURE;
+    }
+
+    // A header whose descriptor rows are too small for the descriptors is rejected, with the row size stored
+    // after the magic number and four int fields
+    {
+      std::fstream file(filename.c_str(), std::ios::in | std::ios::out | std::ios::binary);
+      const int rowBytes = 0, cols = 1 << 20;
+      file.seekp(8 + 4 * sizeof(int));
+      file.write((const char *)&cols, sizeof(cols));
+      file.write((const char *)&rowBytes, sizeof(rowBytes));
+    }
+    bool rejected = false;
+    try {
+      vpKeyPoint corrupted;
+      corrupted.loadLearningDatabase(filename);
+    } catch (const vpException &) {
+      rejected = true;
+    }
+    if (!rejected) {
+      std::cerr << "Corrupted descriptors size not detected" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpIoTools::remove(opath);
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testKeyPointLearningDatabase is ok!" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cerr << "You need OpenCV library." << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,223 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the tiled keypoint detection of vpKeyPoint with the detection on
+ * the whole image, and check the grid filtering.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testKeyPointTiledDetection.cpp
+
+  Check that the keypoints detected by tiles with vpKeyPoint::setDetectionTiles()
+  are the ones detected on the whole image, and that
+  vpKeyPoint::setDetectionGrid() keeps the strongest keypoints of each cell.
+*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+
+#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020301)
+
+#include <visp3/core/vpUniRand.h>
+#include <visp3/vision/vpKeyPoint.h>
+
+namespace
+{
+bool keyPointLess(const cv::KeyPoint &kp1, const cv::KeyPoint &kp2)
+{
+  if (kp1.pt.y != kp2.pt.y) {
+    return kp1.pt.y < kp2.pt.y;
+  }
+  if (kp1.pt.x != kp2.pt.x) {
+    return kp1.pt.x < kp2.pt.x;
+  }
+  return kp1.response < kp2.response;
+}
+
+bool compareKeyPoints(std::vector<cv::KeyPoint> ref, std::vector<cv::KeyPoint> keyPoints, const std::string &name)
+{
+  std::sort(ref.begin(), ref.end(), keyPointLess);
+  std::sort(keyPoints.begin(), keyPoints.end(), keyPointLess);
+  if (ref.size() != keyPoints.size()) {
+    std::cerr << name << ": " << keyPoints.size() << " keypoints instead of " << ref.size() << std::endl;
+    return false;
+  }
+  for (size_t i = 0; i < ref.size(); i++) {
+    if (ref[i].pt != keyPoints[i].pt || ref[i].response != keyPoints[i].response) {
+      std::cerr << name << ": keypoint " << i << " at " << keyPoints[i].pt << " instead of " << ref[i].pt
+                << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Check that each cell keeps at most maxPerCell keypoints, the strongest ones of the cell
+bool checkGrid(const std::vector<cv::KeyPoint> &all, const std::vector<cv::KeyPoint> &keyPoints, int cellSize,
+               unsigned int maxPerCell)
+{
+  std::map<std::pair<int, int>, std::vector<float> > allResponses, responses;
+  for (size_t i = 0; i < all.size(); i++) {
+    allResponses[std::make_pair((int)all[i].pt.x / cellSize, (int)all[i].pt.y / cellSize)].push_back(
+        all[i].response);
+  }
+  for (size_t i = 0; i < keyPoints.size(); i++) {
+    responses[std::make_pair((int)keyPoints[i].pt.x / cellSize, (int)keyPoints[i].pt.y / cellSize)].push_back(
+        keyPoints[i].response);
+  }
+
+  for (std::map<std::pair<int, int>, std::vector<float> >::iterator it = allResponses.begin();
+       it != allResponses.end(); ++it) {
+    std::vector<float> &cellAll = it->second;
+    std::vector<float> &cell = responses[it->first];
+    std::sort(cellAll.begin(), cellAll.end(), std::greater<float>());
+    std::sort(cell.begin(), cell.end(), std::greater<float>());
+    size_t expected = (std::min)(cellAll.size(), (size_t)maxPerCell);
+    if (cell.size() != expected) {
+      std::cerr << "Grid: " << cell.size() << " keypoints in cell (" << it->first.first << ", " << it->first.second
+                << ") instead of " << expected << std::endl;
+      return false;
+    }
+    for (size_t i = 0; i < cell.size(); i++) {
+      if (cell[i] != cellAll[i]) {
+        std::cerr << "Grid: a stronger keypoint is dropped in cell (" << it->first.first << ", "
+                  << it->first.second << ")" << std::endl;
+        return false;
+      }
+    }
+  }
+  if (responses.size() != allResponses.size()) {
+    std::cerr << "Grid: keypoints out of the detected ones" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    // Random rectangles give corners everywhere, also on the tile borders
+    vpUniRand rng;
+    vpImage<unsigned char> I(480, 640, 128);
+    for (unsigned int n = 0; n < 300; n++) {
+      unsigned int top = (unsigned int)(rng() * I.getHeight()), left = (unsigned int)(rng() * I.getWidth());
+      unsigned int height = 5 + (unsigned int)(rng() * 40), width = 5 + (unsigned int)(rng() * 40);
+      unsigned char value = (unsigned char)(rng() * 256);
+      for (unsigned int i = top; i < (std::min)(top + height, I.getHeight()); i++) {
+        for (unsigned int j = left; j < (std::min)(left + width, I.getWidth()); j++) {
+          I[i][j] = value;
+        }
+      }
+    }
+
+    // FAST only depends on a small neighborhood, the tiles must give the same keypoints as the whole image
+    vpKeyPoint keypoint("FAST", "ORB", "BruteForce-Hamming");
+    std::vector<cv::KeyPoint> ref, keyPoints;
+    keypoint.detect(I, ref);
+    std::cout << ref.size() << " keypoints detected on the whole image" << std::endl;
+    if (ref.size() < 500) {
+      std::cerr << "Not enough keypoints in the test image" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    keypoint.setDetectionTiles(3, 2);
+    keypoint.detect(I, keyPoints);
+    if (!compareKeyPoints(ref, keyPoints, "3x2 tiles")) {
+      return EXIT_FAILURE;
+    }
+
+    keypoint.setDetectionTiles(7, 5, 16);
+    keypoint.detect(I, keyPoints);
+    if (!compareKeyPoints(ref, keyPoints, "7x5 tiles")) {
+      return EXIT_FAILURE;
+    }
+
+    // The detectors of the threads are kept for the next detections
+    keypoint.detect(I, keyPoints);
+    if (!compareKeyPoints(ref, keyPoints, "7x5 tiles, second detection")) {
+      return EXIT_FAILURE;
+    }
+
+    // Grid filtering, on tiles and on the whole image
+    const unsigned int cellSize = 32, maxPerCell = 2;
+    keypoint.setDetectionGrid(cellSize, maxPerCell);
+    keypoint.detect(I, keyPoints);
+    if (!checkGrid(ref, keyPoints, (int)cellSize, maxPerCell)) {
+      return EXIT_FAILURE;
+    }
+    std::vector<cv::KeyPoint> gridKeyPoints = keyPoints;
+
+    keypoint.setDetectionTiles(1, 1);
+    keypoint.detect(I, keyPoints);
+    if (!compareKeyPoints(gridKeyPoints, keyPoints, "Grid without tiles")) {
+      return EXIT_FAILURE;
+    }
+
+    // Global limit after the grid filtering
+    const unsigned int maxKeyPoints = 100;
+    keypoint.setDetectionGrid(cellSize, maxPerCell, maxKeyPoints);
+    keypoint.detect(I, keyPoints);
+    if (keyPoints.size() != (std::min)((size_t)maxKeyPoints, gridKeyPoints.size())) {
+      std::cerr << "Grid: " << keyPoints.size() << " keypoints kept instead of " << maxKeyPoints << std::endl;
+      return EXIT_FAILURE;
+    }
+    std::sort(gridKeyPoints.begin(), gridKeyPoints.end(), keyPointLess);
+    for (size_t i = 0; i < keyPoints.size(); i++) {
+      if (!std::binary_search(gridKeyPoints.begin(), gridKeyPoints.end(), keyPoints[i], keyPointLess)) {
+        std::cerr << "Grid: keypoint " << keyPoints[i].pt << " is not kept by the grid" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "testKeyPointTiledDetection is ok!" << std::endl;
+  return EXIT_SUCCESS;
+}
+#else
+int main()
+{
+  std::cerr << "You need OpenCV library." << std::endl;
+
+  return EXIT_SUCCESS;
+}
+
+#endif
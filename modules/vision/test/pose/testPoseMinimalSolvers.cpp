@@ -0,0 +1,189 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compute the pose with the P3P, EPnP and IPPE minimal solvers, alone and
+ * within the RANSAC.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPoseMinimalSolvers.cpp
+
+  Compute the pose with the P3P, EPnP and IPPE minimal solvers, alone and
+  within the RANSAC.
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpPoint.h>
+#include <visp3/core/vpUniRand.h>
+#include <visp3/vision/vpPose.h>
+
+namespace
+{
+bool comparePoses(const vpHomogeneousMatrix &cMo_ref, const vpHomogeneousMatrix &cMo, double eps)
+{
+  for (unsigned int i = 0; i < 3; i++) {
+    for (unsigned int j = 0; j < 4; j++) {
+      if (std::fabs(cMo_ref[i][j] - cMo[i][j]) > eps) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+std::vector<vpPoint> generatePoints(const vpHomogeneousMatrix &cMo, unsigned int n, bool planar, vpUniRand &rng)
+{
+  std::vector<vpPoint> points;
+  for (unsigned int i = 0; i < n; i++) {
+    vpPoint pt(0.4 * rng() - 0.2, 0.4 * rng() - 0.2, planar ? 0.0 : 0.4 * rng() - 0.2);
+    pt.project(cMo);
+    points.push_back(pt);
+  }
+  return points;
+}
+
+bool testMethod(vpPose::vpPoseMethodType method, const std::string &name, bool planar)
+{
+  vpUniRand rng(42);
+  const vpHomogeneousMatrix cMo_ref(0.05, -0.1, 1.0, vpMath::rad(10), vpMath::rad(-20), vpMath::rad(30));
+
+  vpPose pose;
+  pose.addPoints(generatePoints(cMo_ref, 10, planar, rng));
+
+  vpHomogeneousMatrix cMo;
+  pose.computePose(method, cMo);
+  if (!comparePoses(cMo_ref, cMo, 1e-6)) {
+    std::cerr << name << " failed:\n" << cMo << "\ninstead of:\n" << cMo_ref << std::endl;
+    return false;
+  }
+  std::cout << name << " ok" << std::endl;
+  return true;
+}
+
+bool testRansac(vpPose::vpPoseMethodType method, const std::string &name, bool planar)
+{
+  vpUniRand rng(17);
+  const vpHomogeneousMatrix cMo_ref(-0.05, 0.02, 0.8, vpMath::rad(-15), vpMath::rad(25), vpMath::rad(5));
+
+  const unsigned int nbInliers = 70, nbOutliers = 30;
+  std::vector<vpPoint> points = generatePoints(cMo_ref, nbInliers + nbOutliers, planar, rng);
+  for (unsigned int i = nbInliers; i < points.size(); i++) {
+    points[i].set_x(points[i].get_x() + 0.1 * rng() + 0.05);
+    points[i].set_y(points[i].get_y() - 0.1 * rng() - 0.05);
+  }
+
+  vpPose pose;
+  pose.addPoints(points);
+  pose.setRansacHypothesisMethod(method);
+  pose.setRansacThreshold(0.001);
+  pose.setRansacNbInliersToReachConsensus(nbInliers);
+  pose.setRansacMaxTrials(1000);
+
+  vpHomogeneousMatrix cMo;
+  if (!pose.computePose(vpPose::RANSAC, cMo)) {
+    std::cerr << "RANSAC with " << name << " failed to find a solution" << std::endl;
+    return false;
+  }
+  if (pose.getRansacNbInliers() != nbInliers || !comparePoses(cMo_ref, cMo, 1e-6)) {
+    std::cerr << "RANSAC with " << name << " found " << pose.getRansacNbInliers() << " inliers and:\n"
+              << cMo << "\ninstead of:\n"
+              << cMo_ref << std::endl;
+    return false;
+  }
+  std::vector<unsigned int> inlierIndex = pose.getRansacInlierIndex();
+  for (size_t i = 0; i < inlierIndex.size(); i++) {
+    if (inlierIndex[i] >= nbInliers) {
+      std::cerr << "RANSAC with " << name << " selected outlier " << inlierIndex[i] << std::endl;
+      return false;
+    }
+  }
+  std::cout << "RANSAC with " << name << " ok" << std::endl;
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    bool ok = true;
+    ok = testMethod(vpPose::P3P, "P3P non planar", false) && ok;
+    ok = testMethod(vpPose::P3P, "P3P planar", true) && ok;
+    ok = testMethod(vpPose::EPNP, "EPnP", false) && ok;
+    ok = testMethod(vpPose::IPPE, "IPPE", true) && ok;
+
+    // Each solution of the P3P must reproject the three points exactly
+    {
+      const vpHomogeneousMatrix cMo_ref(0.1, 0.1, 1.2, vpMath::rad(40), vpMath::rad(10), vpMath::rad(-60));
+      const double oX[3] = {0.1, -0.1, 0.05}, oY[3] = {0.0, 0.1, -0.15}, oZ[3] = {0.02, 0.0, 0.1};
+      double x[3], y[3];
+      vpPoint::projectPoints(cMo_ref, 3, oX, oY, oZ, x, y);
+
+      vpHomogeneousMatrix solutions[4];
+      unsigned int nbSolutions = vpPose::computeP3P(oX, oY, oZ, x, y, solutions);
+      bool found = false;
+      for (unsigned int i = 0; i < nbSolutions; i++) {
+        double xs[3], ys[3];
+        vpPoint::projectPoints(solutions[i], 3, oX, oY, oZ, xs, ys);
+        for (unsigned int j = 0; j < 3; j++) {
+          if (std::fabs(xs[j] - x[j]) > 1e-9 || std::fabs(ys[j] - y[j]) > 1e-9) {
+            std::cerr << "P3P solution " << i << " does not reproject point " << j << std::endl;
+            ok = false;
+          }
+        }
+        found = found || comparePoses(cMo_ref, solutions[i], 1e-9);
+      }
+      if (!found) {
+        std::cerr << "P3P did not find the reference pose among " << nbSolutions << " solutions" << std::endl;
+        ok = false;
+      }
+    }
+
+    ok = testRansac(vpPose::DEMENTHON, "Lagrange and Dementhon", false) && ok;
+    ok = testRansac(vpPose::P3P, "P3P", false) && ok;
+    ok = testRansac(vpPose::EPNP, "EPnP", false) && ok;
+    ok = testRansac(vpPose::IPPE, "IPPE", true) && ok;
+
+    if (!ok) {
+      return EXIT_FAILURE;
+    }
+    std::cout << "testPoseMinimalSolvers is ok!" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -39,8 +39,11 @@
 #ifndef vpFeatureLuminance_h
 #define vpFeatureLuminance_h
 
+#include <vector>
+
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpRect.h>
 #include <visp3/visual_features/vpBasicFeature.h>
 
 /*!
@@ -74,6 +77,28 @@ public:
   \brief Class that defines the image luminance visual feature
 
   For more details see \cite Collewet08c.
+
+  By default all the pixels inside the image border are used as features, so
+  that the feature dimension is close to the image size. A sparse mode allows
+  to keep only a subset of pixels, given by a mask, a region of interest or
+  selected from the image gradient magnitude using
+  selectHighGradientPixels(). In that case the selected pixels are stored
+  contiguously and the interaction matrix is computed in single precision
+  using SSE2 when available. The current and desired features must use the
+  same selection:
+
+  \code
+  vpFeatureLuminance sId, sI;
+  sId.init(Id.getHeight(), Id.getWidth(), Z);
+  sId.setCameraParameters(cam);
+  sId.selectHighGradientPixels(Id, 10.);
+  sId.buildFrom(Id);
+
+  sI.init(I.getHeight(), I.getWidth(), Z);
+  sI.setCameraParameters(cam);
+  sI.setSelectedPixels(sId.getSelectedPixels());
+  sI.buildFrom(I);
+  \endcode
 */
 
 class VISP_EXPORT vpFeatureLuminance : public vpBasicFeature
@@ -94,6 +119,15 @@ protected:
   vpLuminance *pixInfo;
   int firstTimeIn;
 
+  //! True when only a subset of the pixels is used as features
+  bool m_sparse;
+  //! Index (row * nbc + column) of the selected pixels in sparse mode
+  std::vector<unsigned int> m_pixIndexes;
+  //! Normalized coordinates of the selected pixels in sparse mode
+  std::vector<float> m_x, m_y;
+  //! Gradient of the selected pixels in sparse mode
+  std::vector<float> m_Ix, m_Iy;
+
 public:
   vpFeatureLuminance();
   vpFeatureLuminance(const vpFeatureLuminance &f);
@@ -109,6 +143,16 @@ public:
 
   vpFeatureLuminance *duplicate() const;
 
+  /*!
+    Return the indexes (row * width + column) of the pixels used as features
+    when the sparse mode is enabled.
+  */
+  inline const std::vector<unsigned int> &getSelectedPixels() const { return m_pixIndexes; }
+  /*!
+    Return true when only a subset of the image pixels is used as features.
+  */
+  inline bool isSparse() const { return m_sparse; }
+
   vpColVector error(const vpBasicFeature &s_star, const unsigned int select = FEATURE_ALL);
   void error(const vpBasicFeature &s_star, vpColVector &e);
   //! Compute the error between a visual features and zero
@@ -125,9 +169,19 @@ public:
 
   void print(const unsigned int select = FEATURE_ALL) const;
 
+  void resetSelection();
+  unsigned int selectHighGradientPixels(const vpImage<unsigned char> &I, double gradientThreshold);
+
   void setCameraParameters(vpCameraParameters &_cam);
+  void setMask(const vpImage<bool> &mask);
+  void setRegionOfInterest(const vpRect &roi);
+  void setSelectedPixels(const std::vector<unsigned int> &indexes);
   void set_Z(const double Z);
 
+private:
+  void checkInitialized() const;
+  void initSparse();
+
 public:
   vpCameraParameters cam;
 };
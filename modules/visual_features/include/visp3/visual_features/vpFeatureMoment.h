@@ -220,6 +220,8 @@ public:
                unsigned int thickness = 1) const;
 
   int getDimension(unsigned int select = FEATURE_ALL) const;
+  virtual std::vector<const char *> getFeatureDependencies() const;
+  virtual std::vector<const char *> getMomentDependencies() const;
   void init(void);
   vpMatrix interaction(const unsigned int select = FEATURE_ALL);
   void linkTo(vpFeatureMomentDatabase &featureMoments);
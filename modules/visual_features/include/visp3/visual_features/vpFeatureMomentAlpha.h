@@ -98,6 +98,8 @@ public:
   }
 
   void compute_interaction();
+  std::vector<const char *> getFeatureDependencies() const;
+  std::vector<const char *> getMomentDependencies() const;
   /*!
     associated moment name
     */
@@ -182,6 +184,8 @@ public:
   }
 
   void compute_interaction();
+  std::vector<const char *> getFeatureDependencies() const;
+  std::vector<const char *> getMomentDependencies() const;
   /*!
     Associated moment name.
     */
@@ -79,6 +79,7 @@ public:
   }
 
   void compute_interaction();
+  std::vector<const char *> getMomentDependencies() const;
   /*!
     associated moment name
     */
@@ -101,6 +101,8 @@ public:
   {
   }
   void compute_interaction();
+  std::vector<const char *> getFeatureDependencies() const;
+  std::vector<const char *> getMomentDependencies() const;
   /*!
     associated moment name
     */
@@ -196,6 +198,8 @@ public:
   {
   }
   void compute_interaction();
+  std::vector<const char *> getFeatureDependencies() const;
+  std::vector<const char *> getMomentDependencies() const;
   /*!
     associated moment name
     */
@@ -113,6 +113,8 @@ public:
   {
   }
   void compute_interaction();
+  std::vector<const char *> getFeatureDependencies() const;
+  std::vector<const char *> getMomentDependencies() const;
   /*!
     associated moment name
     */
@@ -254,6 +256,8 @@ public:
   }
 
   void compute_interaction();
+  std::vector<const char *> getFeatureDependencies() const;
+  std::vector<const char *> getMomentDependencies() const;
   /*!
     associated moment name
     */
@@ -91,6 +91,8 @@ public:
   vpFeatureMomentCentered(vpMomentDatabase &moments, double A, double B, double C,
                           vpFeatureMomentDatabase *featureMoments = NULL);
   void compute_interaction();
+  std::vector<const char *> getFeatureDependencies() const;
+  std::vector<const char *> getMomentDependencies() const;
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
   /* Add function due to pure virtual definition in vpBasicFeature.h */
@@ -47,6 +47,7 @@
 #include <cstring>
 #include <iostream>
 #include <map>
+#include <vector>
 #include <visp3/core/vpConfig.h>
 
 class vpFeatureMoment;
@@ -153,6 +154,22 @@ int main()
 
   return 0;
 }
+\endcode
+
+  Each feature declares the features and the moments it depends on with
+vpFeatureMoment::getFeatureDependencies() and
+vpFeatureMoment::getMomentDependencies(). When only some features are used,
+for example by a vpServo task, the moments and the features they need can be
+computed alone and in the right order:
+\code
+    std::vector<const char *> features;
+    features.push_back("vpFeatureMomentCInvariant");
+    std::vector<const char *> moments = fmdb.getMomentDependencies(features);
+
+    // at each iteration
+    obj.fromVector(vec_p);
+    mdb.compute(obj, moments);         // computes bm, gc, mc and ci
+    fmdb.update(features, 0., 0., 1.); // updates fmb and fmc, then fci
 \endcode
 */
 class VISP_EXPORT vpFeatureMomentDatabase
@@ -164,6 +181,9 @@ private:
   };
   std::map<const char *, vpFeatureMoment *, cmp_str> featureMomentsDataBase;
   void add(vpFeatureMoment &featureMoment, char *name);
+  unsigned int sortByDependencies(vpFeatureMoment *featureMoment, std::map<const vpFeatureMoment *, int> &levels,
+                                  std::vector<std::vector<vpFeatureMoment *> > &stages) const;
+  void update(const std::vector<std::vector<vpFeatureMoment *> > &stages, double A, double B, double C);
 
 public:
   /*!
@@ -174,6 +194,8 @@ public:
     Virtual destructor that does nothing.
   */
   virtual ~vpFeatureMomentDatabase() {}
+  std::vector<const char *> getMomentDependencies(const std::vector<const char *> &names) const;
+  void update(const std::vector<const char *> &names, double A = 0.0, double B = 0.0, double C = 1.0);
   virtual void updateAll(double A = 0.0, double B = 0.0, double C = 1.0);
 
   vpFeatureMoment &get(const char *type, bool &found);
@@ -168,6 +168,8 @@ public:
   {
   }
   void compute_interaction();
+  std::vector<const char *> getFeatureDependencies() const;
+  std::vector<const char *> getMomentDependencies() const;
   /*!
     Associated moment name.
   */
@@ -239,6 +241,8 @@ public:
   {
   }
   void compute_interaction();
+  std::vector<const char *> getFeatureDependencies() const;
+  std::vector<const char *> getMomentDependencies() const;
   /*!
     Associated moment name.
   */
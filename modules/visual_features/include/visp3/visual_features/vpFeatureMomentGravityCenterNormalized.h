@@ -110,6 +110,8 @@ public:
   {
   }
   void compute_interaction();
+  std::vector<const char *> getFeatureDependencies() const;
+  std::vector<const char *> getMomentDependencies() const;
   /*!
     associated moment name
     */
@@ -261,6 +263,8 @@ public:
   {
   }
   void compute_interaction();
+  std::vector<const char *> getFeatureDependencies() const;
+  std::vector<const char *> getMomentDependencies() const;
   /*!
     associated moment name
     */
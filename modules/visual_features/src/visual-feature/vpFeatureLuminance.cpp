@@ -36,16 +36,25 @@
  *
  *****************************************************************************/
 
+#include <algorithm>
+
+#include <visp3/core/vpCPUFeatures.h>
 #include <visp3/core/vpDisplay.h>
 #include <visp3/core/vpException.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpImageConvert.h>
 #include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpMath.h>
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpPixelMeterConversion.h>
 
 #include <visp3/visual_features/vpFeatureLuminance.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VISP_HAVE_SSE2 1
+#endif
+
 /*!
   \file vpFeatureLuminance.cpp
   \brief Class that defines the image luminance visual feature
@@ -92,13 +101,22 @@ void vpFeatureLuminance::init(unsigned int _nbr, unsigned int _nbc, double _Z)
 
   pixInfo = new vpLuminance[dim_s];
 
+  m_sparse = false;
+  m_pixIndexes.clear();
+  m_x.clear();
+  m_y.clear();
+  m_Ix.clear();
+  m_Iy.clear();
+
   Z = _Z;
 }
 
 /*!
   Default constructor that build a visual feature.
 */
-vpFeatureLuminance::vpFeatureLuminance() : Z(1), nbr(0), nbc(0), bord(10), pixInfo(NULL), firstTimeIn(0), cam()
+vpFeatureLuminance::vpFeatureLuminance()
+  : Z(1), nbr(0), nbc(0), bord(10), pixInfo(NULL), firstTimeIn(0), m_sparse(false), m_pixIndexes(), m_x(), m_y(),
+    m_Ix(), m_Iy(), cam()
 {
   nbParameters = 1;
   dim_s = 0;
@@ -111,7 +129,8 @@ vpFeatureLuminance::vpFeatureLuminance() : Z(1), nbr(0), nbc(0), bord(10), pixIn
  Copy constructor.
  */
 vpFeatureLuminance::vpFeatureLuminance(const vpFeatureLuminance &f)
-  : vpBasicFeature(f), Z(1), nbr(0), nbc(0), bord(10), pixInfo(NULL), firstTimeIn(0), cam()
+  : vpBasicFeature(f), Z(1), nbr(0), nbc(0), bord(10), pixInfo(NULL), firstTimeIn(0), m_sparse(false),
+    m_pixIndexes(), m_x(), m_y(), m_Ix(), m_Iy(), cam()
 {
   *this = f;
 }
@@ -127,10 +146,18 @@ vpFeatureLuminance &vpFeatureLuminance::operator=(const vpFeatureLuminance &f)
   bord = f.bord;
   firstTimeIn = f.firstTimeIn;
   cam = f.cam;
+  m_sparse = f.m_sparse;
+  m_pixIndexes = f.m_pixIndexes;
+  m_x = f.m_x;
+  m_y = f.m_y;
+  m_Ix = f.m_Ix;
+  m_Iy = f.m_Iy;
   if (pixInfo)
     delete[] pixInfo;
-  pixInfo = new vpLuminance[dim_s];
-  for (unsigned int i = 0; i < dim_s; i++)
+  // In sparse mode dim_s is lower than the number of pixels stored in pixInfo
+  unsigned int nbPixInfo = (nbr > 2 * bord && nbc > 2 * bord) ? (nbr - 2 * bord) * (nbc - 2 * bord) : 0;
+  pixInfo = new vpLuminance[nbPixInfo];
+  for (unsigned int i = 0; i < nbPixInfo; i++)
     pixInfo[i] = f.pixInfo[i];
   return (*this);
 }
@@ -179,6 +206,28 @@ void vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
   double px = cam.get_px();
   double py = cam.get_py();
 
+  if (m_sparse) {
+    if (firstTimeIn == 0) {
+      firstTimeIn = 1;
+      for (size_t k = 0; k < m_pixIndexes.size(); k++) {
+        double x = 0, y = 0;
+        vpPixelMeterConversion::convertPoint(cam, m_pixIndexes[k] % nbc, m_pixIndexes[k] / nbc, x, y);
+        m_x[k] = static_cast<float>(x);
+        m_y[k] = static_cast<float>(y);
+      }
+    }
+
+    const unsigned char *bitmap = I.bitmap;
+    for (unsigned int k = 0; k < dim_s; k++) {
+      unsigned int i = m_pixIndexes[k] / nbc;
+      unsigned int j = m_pixIndexes[k] % nbc;
+      m_Ix[k] = static_cast<float>(px * vpImageFilter::derivativeFilterX(I, i, j));
+      m_Iy[k] = static_cast<float>(py * vpImageFilter::derivativeFilterY(I, i, j));
+      s[k] = bitmap[m_pixIndexes[k]];
+    }
+    return;
+  }
+
   if (firstTimeIn == 0) {
     firstTimeIn = 1;
     l = 0;
@@ -225,7 +274,57 @@ void vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
 */
 void vpFeatureLuminance::interaction(vpMatrix &L)
 {
-  L.resize(dim_s, 6);
+  L.resize(dim_s, 6, false, false);
+
+  if (m_sparse) {
+    const float Zinv = static_cast<float>(1 / Z);
+    unsigned int m = 0;
+#if VISP_HAVE_SSE2
+    if (vpCPUFeatures::checkSSE2() && dim_s >= 4) {
+      const __m128 v_Zinv = _mm_set1_ps(Zinv);
+      const __m128 v_one = _mm_set1_ps(1.0f);
+      const __m128 v_zero = _mm_setzero_ps();
+      float Lk[6][4];
+      for (; m <= dim_s - 4; m += 4) {
+        __m128 v_Ix = _mm_loadu_ps(&m_Ix[m]);
+        __m128 v_Iy = _mm_loadu_ps(&m_Iy[m]);
+        __m128 v_x = _mm_loadu_ps(&m_x[m]);
+        __m128 v_y = _mm_loadu_ps(&m_y[m]);
+        __m128 v_xy = _mm_mul_ps(v_x, v_y);
+
+        _mm_storeu_ps(Lk[0], _mm_mul_ps(v_Ix, v_Zinv));
+        _mm_storeu_ps(Lk[1], _mm_mul_ps(v_Iy, v_Zinv));
+        _mm_storeu_ps(Lk[2], _mm_sub_ps(v_zero, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(v_x, v_Ix), _mm_mul_ps(v_y, v_Iy)),
+                                                            v_Zinv)));
+        _mm_storeu_ps(Lk[3], _mm_sub_ps(v_zero, _mm_add_ps(_mm_mul_ps(v_Ix, v_xy),
+                                                            _mm_mul_ps(_mm_add_ps(v_one, _mm_mul_ps(v_y, v_y)), v_Iy))));
+        _mm_storeu_ps(Lk[4], _mm_add_ps(_mm_mul_ps(_mm_add_ps(v_one, _mm_mul_ps(v_x, v_x)), v_Ix), _mm_mul_ps(v_Iy, v_xy)));
+        _mm_storeu_ps(Lk[5], _mm_sub_ps(_mm_mul_ps(v_Iy, v_x), _mm_mul_ps(v_Ix, v_y)));
+
+        for (unsigned int k = 0; k < 4; k++) {
+          double *Lm = L[m + k];
+          for (unsigned int c = 0; c < 6; c++) {
+            Lm[c] = Lk[c][k];
+          }
+        }
+      }
+    }
+#endif
+    for (; m < dim_s; m++) {
+      float Ix = m_Ix[m];
+      float Iy = m_Iy[m];
+      float x = m_x[m];
+      float y = m_y[m];
+
+      L[m][0] = Ix * Zinv;
+      L[m][1] = Iy * Zinv;
+      L[m][2] = -(x * Ix + y * Iy) * Zinv;
+      L[m][3] = -Ix * x * y - (1 + y * y) * Iy;
+      L[m][4] = (1 + x * x) * Ix + Iy * x * y;
+      L[m][5] = Iy * x - Ix * y;
+    }
+    return;
+  }
 
   for (unsigned int m = 0; m < L.getRows(); m++) {
     double Ix = pixInfo[m].Ix;
@@ -267,10 +366,35 @@ vpMatrix vpFeatureLuminance::interaction(const unsigned int /* select */)
 */
 void vpFeatureLuminance::error(const vpBasicFeature &s_star, vpColVector &e)
 {
-  e.resize(dim_s);
+  if (s_star.getDimension() != dim_s) {
+    throw vpException(vpException::dimensionError,
+                      "Cannot compute luminance error: current (%d) and desired (%d) features dimensions differ", dim_s,
+                      s_star.getDimension());
+  }
 
-  for (unsigned int i = 0; i < dim_s; i++) {
-    e[i] = s[i] - s_star[i];
+  e.resize(dim_s, false);
+
+  const vpFeatureLuminance *s_star_lum = dynamic_cast<const vpFeatureLuminance *>(&s_star);
+  if (s_star_lum == NULL) {
+    for (unsigned int i = 0; i < dim_s; i++) {
+      e[i] = s[i] - s_star[i];
+    }
+    return;
+  }
+
+  const double *cur = s.data;
+  const double *des = s_star_lum->s.data;
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  if (vpCPUFeatures::checkSSE2() && dim_s >= 4) {
+    for (; i <= dim_s - 4; i += 4) {
+      _mm_storeu_pd(e.data + i, _mm_sub_pd(_mm_loadu_pd(cur + i), _mm_loadu_pd(des + i)));
+      _mm_storeu_pd(e.data + i + 2, _mm_sub_pd(_mm_loadu_pd(cur + i + 2), _mm_loadu_pd(des + i + 2)));
+    }
+  }
+#endif
+  for (; i < dim_s; i++) {
+    e[i] = cur[i] - des[i];
   }
 }
 
@@ -291,6 +415,184 @@ vpColVector vpFeatureLuminance::error(const vpBasicFeature &s_star, const unsign
   return e;
 }
 
+/*!
+  Allocate the contiguous buffers used in sparse mode once the selected
+  pixels are known and update the feature dimension.
+*/
+void vpFeatureLuminance::initSparse()
+{
+  m_sparse = true;
+  dim_s = static_cast<unsigned int>(m_pixIndexes.size());
+  s.resize(dim_s);
+  m_x.resize(dim_s);
+  m_y.resize(dim_s);
+  m_Ix.resize(dim_s);
+  m_Iy.resize(dim_s);
+
+  // Force normalized coordinates update in buildFrom()
+  firstTimeIn = 0;
+}
+
+/*!
+  Go back to the default dense mode where all the pixels inside the image
+  border are used as features.
+*/
+void vpFeatureLuminance::resetSelection()
+{
+  if (!m_sparse) {
+    return;
+  }
+  init(nbr, nbc, Z);
+}
+
+/*!
+  Throw a vpException::notInitialized exception when the image size is not
+  set with init(), the pixel selection being meaningless.
+*/
+void vpFeatureLuminance::checkInitialized() const
+{
+  if (nbr == 0 || nbc == 0) {
+    throw vpException(vpException::notInitialized, "The luminance feature is not initialized, call init() first");
+  }
+}
+
+/*!
+  Use as features only the pixels where \e mask is true. Pixels inside the
+  image border are never selected.
+
+  \param mask : Mask with the same size as the image used in init().
+
+  \sa setRegionOfInterest(), selectHighGradientPixels()
+*/
+void vpFeatureLuminance::setMask(const vpImage<bool> &mask)
+{
+  checkInitialized();
+  if (mask.getHeight() != nbr || mask.getWidth() != nbc) {
+    throw vpException(vpException::dimensionError, "Mask size (%dx%d) differs from the feature image size (%dx%d)",
+                      mask.getWidth(), mask.getHeight(), nbc, nbr);
+  }
+
+  // Image area inside the border, empty when the image is smaller than the border
+  const unsigned int iEnd = nbr > bord ? nbr - bord : 0, jEnd = nbc > bord ? nbc - bord : 0;
+  m_pixIndexes.clear();
+  for (unsigned int i = bord; i < iEnd; i++) {
+    for (unsigned int j = bord; j < jEnd; j++) {
+      if (mask[i][j]) {
+        m_pixIndexes.push_back(i * nbc + j);
+      }
+    }
+  }
+
+  initSparse();
+}
+
+/*!
+  Use as features only the pixels inside the region of interest \e roi. The
+  region is clipped to the image area located inside the border.
+
+  \param roi : Region of interest in pixel coordinates.
+
+  \sa setMask(), selectHighGradientPixels()
+*/
+void vpFeatureLuminance::setRegionOfInterest(const vpRect &roi)
+{
+  checkInitialized();
+
+  int i_min = std::max<int>(static_cast<int>(bord), vpMath::round(roi.getTop()));
+  int i_max = std::min<int>(static_cast<int>(nbr) - static_cast<int>(bord) - 1, vpMath::round(roi.getBottom()));
+  int j_min = std::max<int>(static_cast<int>(bord), vpMath::round(roi.getLeft()));
+  int j_max = std::min<int>(static_cast<int>(nbc) - static_cast<int>(bord) - 1, vpMath::round(roi.getRight()));
+
+  m_pixIndexes.clear();
+  for (int i = i_min; i <= i_max; i++) {
+    for (int j = j_min; j <= j_max; j++) {
+      m_pixIndexes.push_back(static_cast<unsigned int>(i) * nbc + static_cast<unsigned int>(j));
+    }
+  }
+
+  initSparse();
+}
+
+/*!
+  Use as features the pixels given by their index in the image.
+
+  \param indexes : Pixel indexes computed as row * width + column, typically
+  obtained from getSelectedPixels() on the desired feature. Each pixel has to
+  be located inside the image border.
+*/
+void vpFeatureLuminance::setSelectedPixels(const std::vector<unsigned int> &indexes)
+{
+  checkInitialized();
+
+  for (size_t k = 0; k < indexes.size(); k++) {
+    unsigned int i = indexes[k] / nbc;
+    unsigned int j = indexes[k] % nbc;
+    if (i < bord || i + bord >= nbr || j < bord || j + bord >= nbc) {
+      throw vpException(vpException::badValue, "Pixel (%d, %d) is outside the area delimited by the border", i, j);
+    }
+  }
+
+  m_pixIndexes = indexes;
+  initSparse();
+}
+
+/*!
+  Keep as features only the pixels where the image gradient magnitude is
+  greater or equal to \e gradientThreshold. When a selection was already
+  set with setMask(), setRegionOfInterest() or setSelectedPixels(), only the
+  previously selected pixels are considered.
+
+  Low gradient pixels do not contribute to the interaction matrix, so that
+  discarding them drastically reduces the feature dimension without changing
+  much the control law.
+
+  \param I : Image used to compute the gradient, usually the desired image.
+  \param gradientThreshold : Threshold on the gradient magnitude (in
+  gray level unit per pixel).
+
+  \return The number of selected pixels.
+*/
+unsigned int vpFeatureLuminance::selectHighGradientPixels(const vpImage<unsigned char> &I, double gradientThreshold)
+{
+  checkInitialized();
+  if (I.getHeight() != nbr || I.getWidth() != nbc) {
+    throw vpException(vpException::dimensionError, "Image size (%dx%d) differs from the feature image size (%dx%d)",
+                      I.getWidth(), I.getHeight(), nbc, nbr);
+  }
+
+  const double threshold2 = gradientThreshold * gradientThreshold;
+  std::vector<unsigned int> selected;
+
+  if (m_sparse) {
+    selected.reserve(m_pixIndexes.size());
+    for (size_t k = 0; k < m_pixIndexes.size(); k++) {
+      unsigned int i = m_pixIndexes[k] / nbc;
+      unsigned int j = m_pixIndexes[k] % nbc;
+      double Ix = vpImageFilter::derivativeFilterX(I, i, j);
+      double Iy = vpImageFilter::derivativeFilterY(I, i, j);
+      if (Ix * Ix + Iy * Iy >= threshold2) {
+        selected.push_back(m_pixIndexes[k]);
+      }
+    }
+  } else {
+    const unsigned int iEnd = nbr > bord ? nbr - bord : 0, jEnd = nbc > bord ? nbc - bord : 0;
+    for (unsigned int i = bord; i < iEnd; i++) {
+      for (unsigned int j = bord; j < jEnd; j++) {
+        double Ix = vpImageFilter::derivativeFilterX(I, i, j);
+        double Iy = vpImageFilter::derivativeFilterY(I, i, j);
+        if (Ix * Ix + Iy * Iy >= threshold2) {
+          selected.push_back(i * nbc + j);
+        }
+      }
+    }
+  }
+
+  m_pixIndexes.swap(selected);
+  initSparse();
+
+  return dim_s;
+}
+
 /*!
 
   Not implemented.
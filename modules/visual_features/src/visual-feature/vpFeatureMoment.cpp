@@ -93,6 +93,28 @@ int vpFeatureMoment::getDimension(unsigned int select) const
   return dim;
 }
 
+/*!
+  Returns the names of the features of the feature database whose interaction
+  matrices are read by compute_interaction(). vpFeatureMomentDatabase uses them
+  to update each feature after the features it depends on.
+
+  The default implementation returns no dependency.
+*/
+std::vector<const char *> vpFeatureMoment::getFeatureDependencies() const { return std::vector<const char *>(); }
+
+/*!
+  Returns the names of the moments of the moment database read by update()
+  and compute_interaction(). See
+  vpFeatureMomentDatabase::getMomentDependencies().
+
+  The default implementation returns the moment associated to the feature,
+  see momentName().
+*/
+std::vector<const char *> vpFeatureMoment::getMomentDependencies() const
+{
+  return std::vector<const char *>(1, momentName());
+}
+
 /*!
   Outputs the content of the feature: it's corresponding selected moments.
 */
@@ -181,3 +181,38 @@ vpColVector vpFeatureMomentAlpha::error(const vpBasicFeature &s_star, const unsi
   return e;
 }
 #endif
+
+/*!
+  Names of the features whose interaction matrices are used to compute the
+  interaction matrix of this feature.
+*/
+std::vector<const char *> vpFeatureMomentAlpha::getFeatureDependencies() const
+{
+#ifdef VISP_MOMENTS_COMBINE_MATRICES
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpFeatureMomentCentered");
+  return dependencies;
+#else
+  return std::vector<const char *>();
+#endif
+}
+
+/*!
+  Names of the moments used to compute this feature and its interaction
+  matrix.
+*/
+std::vector<const char *> vpFeatureMomentAlpha::getMomentDependencies() const
+{
+#ifdef VISP_MOMENTS_COMBINE_MATRICES
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentAlpha");
+  dependencies.push_back("vpMomentCentered");
+  return dependencies;
+#else
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentAlpha");
+  dependencies.push_back("vpMomentCentered");
+  dependencies.push_back("vpMomentGravityCenter");
+  return dependencies;
+#endif
+}
@@ -102,3 +102,15 @@ void vpFeatureMomentArea::compute_interaction()
     interaction_matrices[0][0][5] = 0.;
   }
 }
+
+/*!
+  Names of the moments used to compute this feature and its interaction
+  matrix.
+*/
+std::vector<const char *> vpFeatureMomentArea::getMomentDependencies() const
+{
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentArea");
+  dependencies.push_back("vpMomentGravityCenter");
+  return dependencies;
+}
@@ -204,3 +204,39 @@ void vpFeatureMomentAreaNormalized::compute_interaction()
 }
 
 #endif
+
+/*!
+  Names of the features whose interaction matrices are used to compute the
+  interaction matrix of this feature.
+*/
+std::vector<const char *> vpFeatureMomentAreaNormalized::getFeatureDependencies() const
+{
+#ifdef VISP_MOMENTS_COMBINE_MATRICES
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpFeatureMomentBasic");
+  dependencies.push_back("vpFeatureMomentCentered");
+  return dependencies;
+#else
+  return std::vector<const char *>();
+#endif
+}
+
+/*!
+  Names of the moments used to compute this feature and its interaction
+  matrix.
+*/
+std::vector<const char *> vpFeatureMomentAreaNormalized::getMomentDependencies() const
+{
+#ifdef VISP_MOMENTS_COMBINE_MATRICES
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentAreaNormalized");
+  dependencies.push_back("vpMomentCentered");
+  return dependencies;
+#else
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentAreaNormalized");
+  dependencies.push_back("vpMomentCentered");
+  dependencies.push_back("vpMomentGravityCenter");
+  return dependencies;
+#endif
+}
@@ -726,3 +726,27 @@ std::ostream &operator<<(std::ostream &os, const vpFeatureMomentCInvariant &feat
   return os;
 }
 #endif
+
+/*!
+  Names of the features whose interaction matrices are used to compute the
+  interaction matrix of this feature.
+*/
+std::vector<const char *> vpFeatureMomentCInvariant::getFeatureDependencies() const
+{
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpFeatureMomentCentered");
+  dependencies.push_back("vpFeatureMomentBasic");
+  return dependencies;
+}
+
+/*!
+  Names of the moments used to compute this feature and its interaction
+  matrix.
+*/
+std::vector<const char *> vpFeatureMomentCInvariant::getMomentDependencies() const
+{
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentCInvariant");
+  dependencies.push_back("vpMomentCentered");
+  return dependencies;
+}
@@ -337,3 +337,39 @@ std::ostream &operator<<(std::ostream &os, const vpFeatureMomentCentered &mu)
   }
   return os;
 }
+
+/*!
+  Names of the features whose interaction matrices are used to compute the
+  interaction matrix of this feature.
+*/
+std::vector<const char *> vpFeatureMomentCentered::getFeatureDependencies() const
+{
+#ifdef VISP_MOMENTS_COMBINE_MATRICES
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpFeatureMomentGravityCenter");
+  dependencies.push_back("vpFeatureMomentBasic");
+  return dependencies;
+#else
+  return std::vector<const char *>();
+#endif
+}
+
+/*!
+  Names of the moments used to compute this feature and its interaction
+  matrix.
+*/
+std::vector<const char *> vpFeatureMomentCentered::getMomentDependencies() const
+{
+#ifdef VISP_MOMENTS_COMBINE_MATRICES
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentCentered");
+  dependencies.push_back("vpMomentGravityCenter");
+  dependencies.push_back("vpMomentBasic");
+  return dependencies;
+#else
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentCentered");
+  dependencies.push_back("vpMomentGravityCenter");
+  return dependencies;
+#endif
+}
@@ -36,9 +36,11 @@
  *
  *****************************************************************************/
 
+#include <algorithm>
 #include <iostream>
 #include <typeinfo>
 #include <visp3/core/vpConfig.h>
+#include <visp3/core/vpException.h>
 #include <visp3/visual_features/vpFeatureMoment.h>
 #include <visp3/visual_features/vpFeatureMomentDatabase.h>
 
@@ -71,7 +73,170 @@ vpFeatureMoment &vpFeatureMomentDatabase::get(const char *type, bool &found)
 }
 
 /*!
-  Update all moment features in the database with plane coefficients
+  Adds \e featureMoment to the update stage following the stages of the
+  features of the database it depends on (see
+  vpFeatureMoment::getFeatureDependencies()). Features of the same stage do
+  not depend on each other. Dependencies that are not in the database are
+  ignored: the feature reports them itself when updated.
+
+  \param featureMoment : Feature to add.
+  \param levels : Stage index plus one of the features already visited, or -1
+  while visiting their dependencies.
+  \param stages : Features grouped by update stage.
+
+  \return The stage of the feature.
+*/
+unsigned int vpFeatureMomentDatabase::sortByDependencies(vpFeatureMoment *featureMoment,
+                                                         std::map<const vpFeatureMoment *, int> &levels,
+                                                         std::vector<std::vector<vpFeatureMoment *> > &stages) const
+{
+  int &level = levels[featureMoment];
+  if (level > 0) {
+    return static_cast<unsigned int>(level - 1);
+  }
+  if (level < 0) {
+    throw vpException(vpException::fatalError, "Cyclic dependency involving feature %s", featureMoment->name());
+  }
+  level = -1;
+
+  unsigned int stage = 0;
+  std::vector<const char *> dependencies = featureMoment->getFeatureDependencies();
+  for (size_t i = 0; i < dependencies.size(); i++) {
+    std::map<const char *, vpFeatureMoment *, vpFeatureMomentDatabase::cmp_str>::const_iterator it =
+        featureMomentsDataBase.find(dependencies[i]);
+    if (it != featureMomentsDataBase.end()) {
+      stage = std::max(stage, sortByDependencies(it->second, levels, stages) + 1);
+    }
+  }
+
+  level = static_cast<int>(stage) + 1;
+  if (stages.size() <= stage) {
+    stages.resize(stage + 1);
+  }
+  stages[stage].push_back(featureMoment);
+
+  return stage;
+}
+
+/*!
+  Updates the features stage after stage. The features of a stage are
+  independent and are updated in parallel when OpenMP is available.
+*/
+void vpFeatureMomentDatabase::update(const std::vector<std::vector<vpFeatureMoment *> > &stages, double A, double B,
+                                     double C)
+{
+  for (size_t i = 0; i < stages.size(); i++) {
+    const std::vector<vpFeatureMoment *> &featureMoments = stages[i];
+#ifdef VISP_HAVE_OPENMP
+    bool failed = false;
+    vpException exception(vpException::fatalError);
+#pragma omp parallel for if (featureMoments.size() > 1)
+    for (int j = 0; j < (int)featureMoments.size(); j++) {
+      try {
+        featureMoments[(size_t)j]->update(A, B, C);
+      } catch (const vpException &e) {
+#pragma omp critical
+        {
+          if (!failed) {
+            failed = true;
+            exception = e;
+          }
+        }
+      }
+    }
+    if (failed) {
+      throw exception;
+    }
+#else
+    for (size_t j = 0; j < featureMoments.size(); j++) {
+      featureMoments[j]->update(A, B, C);
+    }
+#endif
+  }
+}
+
+/*!
+  Returns the names of the moments needed to update the features \e names and
+  the features they depend on. Computing these moments with
+  vpMomentDatabase::compute() before calling update() avoids computing moments
+  that are not used.
+
+  \param names : Names of the features.
+
+  \exception vpException::notInitialized : If one of the features is not in
+  the database.
+*/
+std::vector<const char *> vpFeatureMomentDatabase::getMomentDependencies(const std::vector<const char *> &names) const
+{
+  std::map<const vpFeatureMoment *, int> levels;
+  std::vector<std::vector<vpFeatureMoment *> > stages;
+  for (size_t i = 0; i < names.size(); i++) {
+    std::map<const char *, vpFeatureMoment *, vpFeatureMomentDatabase::cmp_str>::const_iterator it =
+        featureMomentsDataBase.find(names[i]);
+    if (it == featureMomentsDataBase.end()) {
+      throw vpException(vpException::notInitialized, "Feature %s not found in the database", names[i]);
+    }
+    sortByDependencies(it->second, levels, stages);
+  }
+
+  std::map<const char *, bool, vpFeatureMomentDatabase::cmp_str> added;
+  std::vector<const char *> momentNames;
+  for (size_t i = 0; i < stages.size(); i++) {
+    for (size_t j = 0; j < stages[i].size(); j++) {
+      std::vector<const char *> dependencies = stages[i][j]->getMomentDependencies();
+      for (size_t k = 0; k < dependencies.size(); k++) {
+        if (added.insert(std::pair<const char *, bool>(dependencies[k], true)).second) {
+          momentNames.push_back(dependencies[k]);
+        }
+      }
+    }
+  }
+
+  return momentNames;
+}
+
+/*!
+  Updates the features \e names with plane coefficients, as well as the
+  features they depend on. The other features of the database are not updated.
+  Each feature is updated after the features it depends on, and independent
+  features are updated in parallel when OpenMP is available.
+
+  The moments used by the features must be computed before, see
+  getMomentDependencies().
+
+  \param names : Names of the features to update, for example the features
+  used by a vpServo task.
+  \param A : first plane coefficient for a plane equation of the following
+  type Ax+By+C=1/Z
+  \param B : second plane coefficient for a plane equation of the following
+  type Ax+By+C=1/Z
+  \param C : third plane coefficient for a plane equation of the following
+  type Ax+By+C=1/Z
+
+  \exception vpException::notInitialized : If one of the features is not in
+  the database.
+*/
+void vpFeatureMomentDatabase::update(const std::vector<const char *> &names, double A, double B, double C)
+{
+  std::map<const vpFeatureMoment *, int> levels;
+  std::vector<std::vector<vpFeatureMoment *> > stages;
+  for (size_t i = 0; i < names.size(); i++) {
+    std::map<const char *, vpFeatureMoment *, vpFeatureMomentDatabase::cmp_str>::const_iterator it =
+        featureMomentsDataBase.find(names[i]);
+    if (it == featureMomentsDataBase.end()) {
+      throw vpException(vpException::notInitialized, "Feature %s not found in the database", names[i]);
+    }
+    sortByDependencies(it->second, levels, stages);
+  }
+
+  update(stages, A, B, C);
+}
+
+/*!
+  Update all moment features in the database with plane coefficients. Each
+  feature is updated after the features it depends on, and independent
+  features are updated in parallel when OpenMP is available.
+
   \param A : first plane coefficient for a plane equation of the following
   type Ax+By+C=1/Z \param B : second plane coefficient for a plane equation of
   the following type Ax+By+C=1/Z \param C : third plane coefficient for a
@@ -79,23 +244,14 @@ vpFeatureMoment &vpFeatureMomentDatabase::get(const char *type, bool &found)
 */
 void vpFeatureMomentDatabase::updateAll(double A, double B, double C)
 {
+  std::map<const vpFeatureMoment *, int> levels;
+  std::vector<std::vector<vpFeatureMoment *> > stages;
   std::map<const char *, vpFeatureMoment *, vpFeatureMomentDatabase::cmp_str>::const_iterator itr;
-#ifdef VISP_HAVE_OPENMP
-  std::vector<vpFeatureMoment *> values;
-  values.reserve(featureMomentsDataBase.size());
   for (itr = featureMomentsDataBase.begin(); itr != featureMomentsDataBase.end(); ++itr) {
-    values.push_back((*itr).second);
-  }
-#pragma omp parallel for shared(A, B, C)
-  for (int i = 0; i < (int)values.size(); i++) {
-    unsigned int i_ = static_cast<unsigned int>(i);
-    values[i_]->update(A, B, C);
+    sortByDependencies(itr->second, levels, stages);
   }
-#else
-  for (itr = featureMomentsDataBase.begin(); itr != featureMomentsDataBase.end(); ++itr) {
-    (*itr).second->update(A, B, C);
-  }
-#endif
+
+  update(stages, A, B, C);
 }
 
 /*
@@ -161,3 +161,36 @@ void vpFeatureMomentGravityCenter::compute_interaction()
 }
 
 #endif
+
+/*!
+  Names of the features whose interaction matrices are used to compute the
+  interaction matrix of this feature.
+*/
+std::vector<const char *> vpFeatureMomentGravityCenter::getFeatureDependencies() const
+{
+#ifdef VISP_MOMENTS_COMBINE_MATRICES
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpFeatureMomentBasic");
+  return dependencies;
+#else
+  return std::vector<const char *>();
+#endif
+}
+
+/*!
+  Names of the moments used to compute this feature and its interaction
+  matrix.
+*/
+std::vector<const char *> vpFeatureMomentGravityCenter::getMomentDependencies() const
+{
+#ifdef VISP_MOMENTS_COMBINE_MATRICES
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentGravityCenter");
+  return dependencies;
+#else
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentGravityCenter");
+  dependencies.push_back("vpMomentCentered");
+  return dependencies;
+#endif
+}
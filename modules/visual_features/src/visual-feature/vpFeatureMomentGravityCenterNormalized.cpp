@@ -227,3 +227,41 @@ void vpFeatureMomentGravityCenterNormalized::compute_interaction()
   interaction_matrices[1][0][WZ] = -Xn;
 }
 #endif
+
+/*!
+  Names of the features whose interaction matrices are used to compute the
+  interaction matrix of this feature.
+*/
+std::vector<const char *> vpFeatureMomentGravityCenterNormalized::getFeatureDependencies() const
+{
+#ifdef VISP_MOMENTS_COMBINE_MATRICES
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpFeatureMomentGravityCenter");
+  dependencies.push_back("vpFeatureMomentAreaNormalized");
+  return dependencies;
+#else
+  return std::vector<const char *>();
+#endif
+}
+
+/*!
+  Names of the moments used to compute this feature and its interaction
+  matrix.
+*/
+std::vector<const char *> vpFeatureMomentGravityCenterNormalized::getMomentDependencies() const
+{
+#ifdef VISP_MOMENTS_COMBINE_MATRICES
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentGravityCenterNormalized");
+  dependencies.push_back("vpMomentAreaNormalized");
+  dependencies.push_back("vpMomentGravityCenter");
+  return dependencies;
+#else
+  std::vector<const char *> dependencies;
+  dependencies.push_back("vpMomentGravityCenterNormalized");
+  dependencies.push_back("vpMomentCentered");
+  dependencies.push_back("vpMomentGravityCenter");
+  dependencies.push_back("vpMomentAreaNormalized");
+  return dependencies;
+#endif
+}
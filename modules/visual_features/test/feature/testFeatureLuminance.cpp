@@ -0,0 +1,163 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test luminance feature sparse mode against the dense one.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testFeatureLuminance.cpp
+
+  Check that the luminance feature built on a subset of pixels gives the same
+  interaction matrix rows and error than the dense feature.
+*/
+
+#include <algorithm>
+#include <iostream>
+
+#include <visp3/core/vpMath.h>
+#include <visp3/visual_features/vpFeatureLuminance.h>
+
+namespace
+{
+void buildImage(vpImage<unsigned char> &I, double phase)
+{
+  for (unsigned int i = 0; i < I.getHeight(); i++) {
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      I[i][j] = static_cast<unsigned char>(127.5 + 100 * sin(0.1 * i + phase) * cos(0.07 * j));
+    }
+  }
+}
+}
+
+int main()
+{
+  try {
+    const unsigned int h = 60, w = 80;
+    vpImage<unsigned char> I(h, w), Id(h, w);
+    buildImage(I, 0.3);
+    buildImage(Id, 0.);
+
+    vpCameraParameters cam(100, 100, w / 2., h / 2.);
+
+    vpFeatureLuminance sI, sId;
+    sI.init(h, w, 1.);
+    sI.setCameraParameters(cam);
+    sId.init(h, w, 1.);
+    sId.setCameraParameters(cam);
+    sI.buildFrom(I);
+    sId.buildFrom(Id);
+
+    vpMatrix L;
+    sI.interaction(L);
+    vpColVector e;
+    sI.error(sId, e);
+
+    vpFeatureLuminance sI_sparse, sId_sparse;
+    sId_sparse.init(h, w, 1.);
+    sId_sparse.setCameraParameters(cam);
+    unsigned int nbSelected = sId_sparse.selectHighGradientPixels(Id, 5.);
+    if (nbSelected == 0 || nbSelected >= sId.getDimension()) {
+      std::cerr << "Bad number of selected pixels: " << nbSelected << std::endl;
+      return EXIT_FAILURE;
+    }
+    sId_sparse.buildFrom(Id);
+
+    sI_sparse.init(h, w, 1.);
+    sI_sparse.setCameraParameters(cam);
+    sI_sparse.setSelectedPixels(sId_sparse.getSelectedPixels());
+    sI_sparse.buildFrom(I);
+
+    vpMatrix L_sparse;
+    sI_sparse.interaction(L_sparse);
+    vpColVector e_sparse;
+    sI_sparse.error(sId_sparse, e_sparse);
+
+    std::cout << "Dense dimension: " << sI.getDimension() << " ; sparse dimension: " << sI_sparse.getDimension()
+              << std::endl;
+
+    const unsigned int bord = 10;
+    const std::vector<unsigned int> &indexes = sI_sparse.getSelectedPixels();
+    for (size_t k = 0; k < indexes.size(); k++) {
+      unsigned int i = indexes[k] / w, j = indexes[k] % w;
+      unsigned int l = (i - bord) * (w - 2 * bord) + (j - bord);
+      if (!vpMath::equal(e[l], e_sparse[(unsigned int)k], 1e-9)) {
+        std::cerr << "Error mismatch at pixel " << i << " " << j << std::endl;
+        return EXIT_FAILURE;
+      }
+      for (unsigned int c = 0; c < 6; c++) {
+        double tol = 1e-4 * std::max(1., std::fabs(L[l][c]));
+        if (!vpMath::equal(L[l][c], L_sparse[(unsigned int)k][c], tol)) {
+          std::cerr << "Interaction matrix mismatch at pixel " << i << " " << j << ": " << L[l][c]
+                    << " != " << L_sparse[(unsigned int)k][c] << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    vpFeatureLuminance sI_roi;
+    sI_roi.init(h, w, 1.);
+    sI_roi.setCameraParameters(cam);
+    sI_roi.setRegionOfInterest(vpRect(0, 0, w, h));
+    if (sI_roi.getDimension() != sI.getDimension()) {
+      std::cerr << "Bad region of interest dimension: " << sI_roi.getDimension() << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The pixels cannot be selected before init()
+    for (int method = 0; method < 4; method++) {
+      vpFeatureLuminance sI_uninit;
+      try {
+        if (method == 0) {
+          sI_uninit.setMask(vpImage<bool>());
+        } else if (method == 1) {
+          sI_uninit.setRegionOfInterest(vpRect(0, 0, w, h));
+        } else if (method == 2) {
+          sI_uninit.setSelectedPixels(std::vector<unsigned int>(1, 0));
+        } else {
+          sI_uninit.selectHighGradientPixels(vpImage<unsigned char>(), 5.);
+        }
+        std::cerr << "No exception when selecting the pixels before init()" << std::endl;
+        return EXIT_FAILURE;
+      } catch (vpException &e) {
+        if (e.getCode() != vpException::notInitialized) {
+          throw;
+        }
+      }
+    }
+
+    std::cout << "testFeatureLuminance is ok" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
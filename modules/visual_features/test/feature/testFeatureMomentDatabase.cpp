@@ -0,0 +1,185 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the dependency ordered update of moments and moment features.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testFeatureMomentDatabase.cpp
+
+  Check that computing only the moments and the features used by a task, or
+  all the features in dependency order, gives the same values and interaction
+  matrices as the sequential update of vpMomentCommon and
+  vpFeatureMomentCommon.
+*/
+
+#include <algorithm>
+#include <iostream>
+
+#include <visp3/core/vpMomentCommon.h>
+#include <visp3/core/vpMomentObject.h>
+#include <visp3/core/vpPoint.h>
+#include <visp3/visual_features/vpFeatureMomentCommon.h>
+
+namespace
+{
+void buildObject(vpMomentObject &obj)
+{
+  double x[5] = {0.2, 0.25, -0.1, -0.2, 0.05};
+  double y[5] = {-0.1, 0.15, 0.2, -0.05, -0.2};
+
+  std::vector<vpPoint> points;
+  for (unsigned int i = 0; i < 5; i++) {
+    vpPoint p;
+    p.set_x(x[i]);
+    p.set_y(y[i]);
+    points.push_back(p);
+  }
+  // Close the polygon
+  points.push_back(points.front());
+
+  obj.setType(vpMomentObject::DENSE_POLYGON);
+  obj.fromVector(points);
+}
+
+bool check(const char *name, const vpColVector &s, const vpColVector &s_ref, const vpMatrix &L, const vpMatrix &L_ref)
+{
+  if (s.size() != s_ref.size() || L.getRows() != L_ref.getRows() || L.getCols() != L_ref.getCols()) {
+    std::cerr << "Dimension mismatch for " << name << std::endl;
+    return false;
+  }
+  for (unsigned int i = 0; i < s.size(); i++) {
+    if (!vpMath::equal(s[i], s_ref[i], 1e-12 * std::max(1., std::fabs(s_ref[i])))) {
+      std::cerr << "Value mismatch for " << name << ": " << s[i] << " != " << s_ref[i] << std::endl;
+      return false;
+    }
+  }
+  for (unsigned int i = 0; i < L.getRows(); i++) {
+    for (unsigned int j = 0; j < L.getCols(); j++) {
+      if (!vpMath::equal(L[i][j], L_ref[i][j], 1e-12 * std::max(1., std::fabs(L_ref[i][j])))) {
+        std::cerr << "Interaction matrix mismatch for " << name << ": " << L[i][j] << " != " << L_ref[i][j]
+                  << std::endl;
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool checkFeature(vpFeatureMoment &feature, vpFeatureMoment &reference)
+{
+  return check(feature.name(), feature.get_s(), reference.get_s(), feature.interaction(), reference.interaction());
+}
+
+// Basic and centered moment features give access to the interaction matrix of each moment
+template <class Type> vpMatrix stackInteractions(const Type &feature, unsigned int order)
+{
+  vpMatrix L;
+  for (unsigned int i = 0; i <= order; i++) {
+    for (unsigned int j = 0; i + j <= order; j++) {
+      L.stack(feature.interaction(i, j));
+    }
+  }
+  return L;
+}
+
+template <class Type> bool checkMomentFeature(Type &feature, Type &reference, unsigned int order)
+{
+  return check(feature.name(), feature.get_s(), reference.get_s(), stackInteractions(feature, order),
+               stackInteractions(reference, order));
+}
+}
+
+int main()
+{
+  try {
+    vpMomentObject obj(6);
+    buildObject(obj);
+
+    const double A = 0.1, B = -0.05, C = 1.2;
+    const double surface = vpMomentCommon::getSurface(obj), alpha = vpMomentCommon::getAlpha(obj);
+    const std::vector<double> mu3 = vpMomentCommon::getMu3(obj);
+
+    // Reference: sequential update of all the moments and features
+    vpMomentCommon moments_ref(surface, mu3, alpha, 1.);
+    vpFeatureMomentCommon features_ref(moments_ref);
+    moments_ref.updateAll(obj);
+    features_ref.updateAll(A, B, C);
+
+    // Only the moments and the features used by a task
+    vpMomentCommon moments(surface, mu3, alpha, 1.);
+    vpFeatureMomentCommon features(moments);
+    std::vector<const char *> names;
+    names.push_back("vpFeatureMomentGravityCenterNormalized");
+    names.push_back("vpFeatureMomentAreaNormalized");
+    names.push_back("vpFeatureMomentCInvariant");
+    names.push_back("vpFeatureMomentAlpha");
+    std::vector<const char *> momentNames = features.getMomentDependencies(names);
+    std::cout << "Moments needed by the task:";
+    for (size_t i = 0; i < momentNames.size(); i++) {
+      std::cout << " " << momentNames[i];
+    }
+    std::cout << std::endl;
+
+    moments.compute(obj, momentNames);
+    features.update(names, A, B, C);
+    if (!checkFeature(features.getFeatureGravityNormalized(), features_ref.getFeatureGravityNormalized()) ||
+        !checkFeature(features.getFeatureAn(), features_ref.getFeatureAn()) ||
+        !checkFeature(features.getFeatureCInvariant(), features_ref.getFeatureCInvariant()) ||
+        !checkFeature(features.getFeatureAlpha(), features_ref.getFeatureAlpha())) {
+      return EXIT_FAILURE;
+    }
+
+    // All the moments and features in dependency order
+    vpMomentCommon moments_all(surface, mu3, alpha, 1.);
+    vpFeatureMomentCommon features_all(moments_all);
+    moments_all.computeAll(obj);
+    features_all.vpFeatureMomentDatabase::updateAll(A, B, C);
+    if (!checkMomentFeature(features_all.getFeatureMomentBasic(), features_ref.getFeatureMomentBasic(), 5) ||
+        !checkFeature(features_all.getFeatureGravityCenter(), features_ref.getFeatureGravityCenter()) ||
+        !checkMomentFeature(features_all.getFeatureCentered(), features_ref.getFeatureCentered(), 5) ||
+        !checkFeature(features_all.getFeatureGravityNormalized(), features_ref.getFeatureGravityNormalized()) ||
+        !checkFeature(features_all.getFeatureAn(), features_ref.getFeatureAn()) ||
+        !checkFeature(features_all.getFeatureCInvariant(), features_ref.getFeatureCInvariant()) ||
+        !checkFeature(features_all.getFeatureAlpha(), features_ref.getFeatureAlpha()) ||
+        !checkFeature(features_all.getFeatureArea(), features_ref.getFeatureArea())) {
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testFeatureMomentDatabase is ok" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -203,8 +203,15 @@ public:
   typedef enum {
     TRANSPOSE,     /*!< In the control law (see vpServo::vpServoType), uses the
                       transpose instead of the pseudo inverse. */
-    PSEUDO_INVERSE /*!< In the control law (see vpServo::vpServoType), uses
+    PSEUDO_INVERSE, /*!< In the control law (see vpServo::vpServoType), uses
                       the pseudo inverse. */
+    NORMAL_EQUATIONS /*!< In the control law (see vpServo::vpServoType),
+                      solves the normal equations \f${\bf J}^\top {\bf J}
+                      {\bf e}_1 = {\bf J}^\top {\bf e}\f$ with a Cholesky
+                      factorization instead of computing the pseudo inverse by
+                      SVD. This is much faster when the task dimension is large
+                      (dense visual features). When the task Jacobian is rank
+                      deficient, the pseudo inverse is used instead. */
   } vpServoInversionType;
 
   typedef enum {
@@ -313,6 +320,8 @@ error vector is updated after a call of computeError() or computeControlLaw().
      Get task singular values.
 
      \return Singular values that relies on the task jacobian pseudo inverse.
+     These values are not updated when the control law was computed by
+     solving the normal equations (see vpServo::NORMAL_EQUATIONS).
      */
   inline vpColVector getTaskSingularValues() const { return sv; }
 
@@ -539,6 +548,8 @@ protected:
    */
   void computeProjectionOperators();
 
+  bool computeNormalEquationsTask();
+
 public:
   //! Interaction matrix
   vpMatrix L;
@@ -674,6 +685,16 @@ protected:
   //! A diag matrix used to determine which are the degrees of freedom that
   //! are controlled in the camera frame
   vpMatrix cJc;
+
+  //! Normal matrix \f${\bf J_1}^\top {\bf J_1}\f$ used with
+  //! vpServo::NORMAL_EQUATIONS inversion type
+  vpMatrix J1tJ1;
+  //! Vector \f${\bf J_1}^\top {\bf e}\f$ used with
+  //! vpServo::NORMAL_EQUATIONS inversion type
+  vpColVector J1te;
+  //! True when J1p was not updated since the last control law was
+  //! computed by solving the normal equations
+  bool J1pOutdated;
 };
 
 #endif
@@ -40,6 +40,8 @@
 
 #include <visp3/vs/vpServo.h>
 
+#include <algorithm>
+#include <limits>
 #include <sstream>
 
 // Exception
@@ -72,7 +74,8 @@ vpServo::vpServo()
     interactionMatrixType(DESIRED), inversionType(PSEUDO_INVERSE), cVe(), init_cVe(false), cVf(), init_cVf(false),
     fVe(), init_fVe(false), eJe(), init_eJe(false), fJe(), init_fJe(false), errorComputed(false),
     interactionMatrixComputed(false), dim_task(0), taskWasKilled(false), forceInteractionMatrixComputation(false),
-    WpW(), I_WpW(), P(), sv(), mu(4.), e1_initial(), iscJcIdentity(true), cJc(6, 6)
+    WpW(), I_WpW(), P(), sv(), mu(4.), e1_initial(), iscJcIdentity(true), cJc(6, 6), J1tJ1(), J1te(),
+    J1pOutdated(false)
 {
   cJc.eye();
 }
@@ -97,7 +100,7 @@ vpServo::vpServo(vpServoType servo_type)
     inversionType(PSEUDO_INVERSE), cVe(), init_cVe(false), cVf(), init_cVf(false), fVe(), init_fVe(false), eJe(),
     init_eJe(false), fJe(), init_fJe(false), errorComputed(false), interactionMatrixComputed(false), dim_task(0),
     taskWasKilled(false), forceInteractionMatrixComputation(false), WpW(), I_WpW(), P(), sv(), mu(4), e1_initial(),
-    iscJcIdentity(true), cJc(6, 6)
+    iscJcIdentity(true), cJc(6, 6), J1tJ1(), J1te(), J1pOutdated(false)
 {
   cJc.eye();
 }
@@ -1000,39 +1003,44 @@ vpColVector vpServo::computeControlLaw()
     vpMatrix imJ1t, imJ1;
     bool imageComputed = false;
 
-    if (inversionType == PSEUDO_INVERSE) {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
+    if (inversionType == NORMAL_EQUATIONS && computeNormalEquationsTask()) {
+      // Full rank task Jacobian: e1 and WpW are updated without SVD
+    } else {
+      J1pOutdated = false;
+      if (inversionType == PSEUDO_INVERSE || inversionType == NORMAL_EQUATIONS) {
+        rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
 
-      imageComputed = true;
-    } else
-      J1p = J1.t();
+        imageComputed = true;
+      } else
+        J1p = J1.t();
 
-    if (rankJ1 == J1.getCols()) {
-      /* if no degrees of freedom remains (rank J1 = ndof)
-       WpW = I, multiply by WpW is useless
-    */
-      e1 = J1p * error; // primary task
+      if (rankJ1 == J1.getCols()) {
+        /* if no degrees of freedom remains (rank J1 = ndof)
+         WpW = I, multiply by WpW is useless
+      */
+        e1 = J1p * error; // primary task
 
-      WpW.eye(J1.getCols(), J1.getCols());
-    } else {
-      if (imageComputed != true) {
-        vpMatrix Jtmp;
-        // image of J1 is computed to allows the computation
-        // of the projection operator
-        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
-      }
-      WpW = imJ1t * imJ1t.t();
+        WpW.eye(J1.getCols(), J1.getCols());
+      } else {
+        if (imageComputed != true) {
+          vpMatrix Jtmp;
+          // image of J1 is computed to allows the computation
+          // of the projection operator
+          rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
+        }
+        WpW = imJ1t * imJ1t.t();
 
 #ifdef DEBUG
-      std::cout << "rank J1: " << rankJ1 << std::endl;
-      imJ1t.print(std::cout, 10, "imJ1t");
-      imJ1.print(std::cout, 10, "imJ1");
+        std::cout << "rank J1: " << rankJ1 << std::endl;
+        imJ1t.print(std::cout, 10, "imJ1t");
+        imJ1.print(std::cout, 10, "imJ1");
 
-      WpW.print(std::cout, 10, "WpW");
-      J1.print(std::cout, 10, "J1");
-      J1p.print(std::cout, 10, "J1p");
+        WpW.print(std::cout, 10, "WpW");
+        J1.print(std::cout, 10, "J1");
+        J1p.print(std::cout, 10, "J1p");
 #endif
-      e1 = WpW * J1p * error;
+        e1 = WpW * J1p * error;
+      }
     }
     e = -lambda(e1) * e1;
 
@@ -1150,39 +1158,44 @@ vpColVector vpServo::computeControlLaw(double t)
     vpMatrix imJ1t, imJ1;
     bool imageComputed = false;
 
-    if (inversionType == PSEUDO_INVERSE) {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
+    if (inversionType == NORMAL_EQUATIONS && computeNormalEquationsTask()) {
+      // Full rank task Jacobian: e1 and WpW are updated without SVD
+    } else {
+      J1pOutdated = false;
+      if (inversionType == PSEUDO_INVERSE || inversionType == NORMAL_EQUATIONS) {
+        rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
 
-      imageComputed = true;
-    } else
-      J1p = J1.t();
+        imageComputed = true;
+      } else
+        J1p = J1.t();
 
-    if (rankJ1 == J1.getCols()) {
-      /* if no degrees of freedom remains (rank J1 = ndof)
-       WpW = I, multiply by WpW is useless
-    */
-      e1 = J1p * error; // primary task
+      if (rankJ1 == J1.getCols()) {
+        /* if no degrees of freedom remains (rank J1 = ndof)
+         WpW = I, multiply by WpW is useless
+      */
+        e1 = J1p * error; // primary task
 
-      WpW.eye(J1.getCols(), J1.getCols());
-    } else {
-      if (imageComputed != true) {
-        vpMatrix Jtmp;
-        // image of J1 is computed to allows the computation
-        // of the projection operator
-        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
-      }
-      WpW = imJ1t * imJ1t.t();
+        WpW.eye(J1.getCols(), J1.getCols());
+      } else {
+        if (imageComputed != true) {
+          vpMatrix Jtmp;
+          // image of J1 is computed to allows the computation
+          // of the projection operator
+          rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
+        }
+        WpW = imJ1t * imJ1t.t();
 
 #ifdef DEBUG
-      std::cout << "rank J1 " << rankJ1 << std::endl;
-      std::cout << "imJ1t" << std::endl << imJ1t;
-      std::cout << "imJ1" << std::endl << imJ1;
+        std::cout << "rank J1 " << rankJ1 << std::endl;
+        std::cout << "imJ1t" << std::endl << imJ1t;
+        std::cout << "imJ1" << std::endl << imJ1;
 
-      std::cout << "WpW" << std::endl << WpW;
-      std::cout << "J1" << std::endl << J1;
-      std::cout << "J1p" << std::endl << J1p;
+        std::cout << "WpW" << std::endl << WpW;
+        std::cout << "J1" << std::endl << J1;
+        std::cout << "J1p" << std::endl << J1p;
 #endif
-      e1 = WpW * J1p * error;
+        e1 = WpW * J1p * error;
+      }
     }
 
     // memorize the initial e1 value if the function is called the first time
@@ -1310,39 +1323,44 @@ vpColVector vpServo::computeControlLaw(double t, const vpColVector &e_dot_init)
     vpMatrix imJ1t, imJ1;
     bool imageComputed = false;
 
-    if (inversionType == PSEUDO_INVERSE) {
-      rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
+    if (inversionType == NORMAL_EQUATIONS && computeNormalEquationsTask()) {
+      // Full rank task Jacobian: e1 and WpW are updated without SVD
+    } else {
+      J1pOutdated = false;
+      if (inversionType == PSEUDO_INVERSE || inversionType == NORMAL_EQUATIONS) {
+        rankJ1 = J1.pseudoInverse(J1p, sv, 1e-6, imJ1, imJ1t);
 
-      imageComputed = true;
-    } else
-      J1p = J1.t();
+        imageComputed = true;
+      } else
+        J1p = J1.t();
 
-    if (rankJ1 == J1.getCols()) {
-      /* if no degrees of freedom remains (rank J1 = ndof)
-       WpW = I, multiply by WpW is useless
-    */
-      e1 = J1p * error; // primary task
+      if (rankJ1 == J1.getCols()) {
+        /* if no degrees of freedom remains (rank J1 = ndof)
+         WpW = I, multiply by WpW is useless
+      */
+        e1 = J1p * error; // primary task
 
-      WpW.eye(J1.getCols(), J1.getCols());
-    } else {
-      if (imageComputed != true) {
-        vpMatrix Jtmp;
-        // image of J1 is computed to allows the computation
-        // of the projection operator
-        rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
-      }
-      WpW = imJ1t * imJ1t.t();
+        WpW.eye(J1.getCols(), J1.getCols());
+      } else {
+        if (imageComputed != true) {
+          vpMatrix Jtmp;
+          // image of J1 is computed to allows the computation
+          // of the projection operator
+          rankJ1 = J1.pseudoInverse(Jtmp, sv, 1e-6, imJ1, imJ1t);
+        }
+        WpW = imJ1t * imJ1t.t();
 
 #ifdef DEBUG
-      std::cout << "rank J1 " << rankJ1 << std::endl;
-      std::cout << "imJ1t" << std::endl << imJ1t;
-      std::cout << "imJ1" << std::endl << imJ1;
+        std::cout << "rank J1 " << rankJ1 << std::endl;
+        std::cout << "imJ1t" << std::endl << imJ1t;
+        std::cout << "imJ1" << std::endl << imJ1;
 
-      std::cout << "WpW" << std::endl << WpW;
-      std::cout << "J1" << std::endl << J1;
-      std::cout << "J1p" << std::endl << J1p;
+        std::cout << "WpW" << std::endl << WpW;
+        std::cout << "J1" << std::endl << J1;
+        std::cout << "J1p" << std::endl << J1p;
 #endif
-      e1 = WpW * J1p * error;
+        e1 = WpW * J1p * error;
+      }
     }
 
     // memorize the initial e1 value if the function is called the first time
@@ -1396,21 +1414,112 @@ void vpServo::computeProjectionOperators()
   else
     sig = 0.0;
 
-  vpMatrix J1t = J1.transpose();
-
-  double pp = (error.t() * (J1 * J1t) * error);
+  // Since J1^T e e^T J1 = (J1^T e)(J1^T e)^T, only the n-dimension vector
+  // J1^T e is needed. This avoids to build dim_task x dim_task matrices.
+  vpColVector J1t_e(n, 0.);
+  for (unsigned int i = 0; i < J1.getRows(); i++) {
+    const double *J1_i = J1[i];
+    double e_i = error[i];
+    for (unsigned int j = 0; j < n; j++) {
+      J1t_e[j] += J1_i[j] * e_i;
+    }
+  }
 
-  vpMatrix ee_t(n, n);
-  ee_t = error * error.t();
+  double pp = J1t_e.sumSquare();
 
   vpMatrix P_norm_e(n, n);
-  P_norm_e = I - (1.0 / pp) * J1t * ee_t * J1;
+  P_norm_e = I - (1.0 / pp) * J1t_e * J1t_e.t();
 
   P = sig * P_norm_e + (1 - sig) * I_WpW;
 
   return;
 }
 
+/*!
+  Compute the primary task \f${\bf e}_1 = ({\bf J}_1^\top {\bf J}_1)^{-1}
+  {\bf J}_1^\top {\bf e}\f$ by solving the normal equations with a
+  Cholesky factorization. Only the n x n normal matrix is factorized, so that
+  the cost is linear with the task dimension and no SVD of the task Jacobian
+  is needed.
+
+  \return true if the task Jacobian has full rank and \f${\bf e}_1\f$ and
+  \f${\bf W^+W}\f$ were updated, false when a rank deficiency is detected.
+  In that case the caller has to use the pseudo inverse.
+*/
+bool vpServo::computeNormalEquationsTask()
+{
+  unsigned int n = J1.getCols();
+  if (n == 0 || J1.getRows() < n) {
+    return false;
+  }
+
+  J1.AtA(J1tJ1);
+
+  J1te.resize(n, false);
+  J1te = 0;
+  for (unsigned int i = 0; i < J1.getRows(); i++) {
+    const double *J1_i = J1[i];
+    double e_i = error[i];
+    for (unsigned int j = 0; j < n; j++) {
+      J1te[j] += J1_i[j] * e_i;
+    }
+  }
+
+  // In place Cholesky factorization J1^T J1 = R R^T, R stored in the lower
+  // part. Singular values of J1 below 1e-6 times the largest one, as used
+  // with the pseudo inverse, correspond to pivots below 1e-12 times the
+  // largest diagonal element of J1^T J1.
+  double max_diag = 0.;
+  for (unsigned int i = 0; i < n; i++) {
+    max_diag = std::max(max_diag, J1tJ1[i][i]);
+  }
+  double threshold = 1e-12 * max_diag;
+  if (max_diag <= std::numeric_limits<double>::epsilon()) {
+    return false;
+  }
+
+  for (unsigned int j = 0; j < n; j++) {
+    double d = J1tJ1[j][j];
+    for (unsigned int k = 0; k < j; k++) {
+      d -= J1tJ1[j][k] * J1tJ1[j][k];
+    }
+    if (d <= threshold) {
+      return false;
+    }
+    J1tJ1[j][j] = sqrt(d);
+    for (unsigned int i = j + 1; i < n; i++) {
+      double v = J1tJ1[i][j];
+      for (unsigned int k = 0; k < j; k++) {
+        v -= J1tJ1[i][k] * J1tJ1[j][k];
+      }
+      J1tJ1[i][j] = v / J1tJ1[j][j];
+    }
+  }
+
+  // Forward and backward substitutions
+  e1.resize(n, false);
+  for (unsigned int i = 0; i < n; i++) {
+    double v = J1te[i];
+    for (unsigned int k = 0; k < i; k++) {
+      v -= J1tJ1[i][k] * e1[k];
+    }
+    e1[i] = v / J1tJ1[i][i];
+  }
+  for (unsigned int i = n; i-- > 0;) {
+    double v = e1[i];
+    for (unsigned int k = i + 1; k < n; k++) {
+      v -= J1tJ1[k][i] * e1[k];
+    }
+    e1[i] = v / J1tJ1[i][i];
+  }
+
+  rankJ1 = n;
+  WpW.eye(n, n);
+  J1pOutdated = true;
+
+  return true;
+}
+
 /*!
   Compute and return the secondary task vector according to the classic
   projection operator \f${\bf I-W^+W}\f$ (see equation(7) in the paper
@@ -1806,7 +1915,14 @@ computeControlLaw().
 
  \sa getTaskJacobian()
  */
-vpMatrix vpServo::getTaskJacobianPseudoInverse() const { return J1p; }
+vpMatrix vpServo::getTaskJacobianPseudoInverse() const
+{
+  if (J1pOutdated) {
+    // The control law was computed without the pseudo inverse
+    return J1.pseudoInverse(1e-6);
+  }
+  return J1p;
+}
 /*!
    Return the rank of the task jacobian. The rank is updated after a call of
 computeControlLaw().
@@ -0,0 +1,161 @@
+/****************************************************************************
+ *
+ * ViSP, open source Visual Servoing Platform software.
+ * Copyright (C) 2005 - 2019 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Compare the control law obtained by solving the normal equations with
+ * the one obtained with the pseudo inverse.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testServoNormalEquations.cpp
+
+  Check that vpServo::NORMAL_EQUATIONS inversion type gives the same velocity
+  than vpServo::PSEUDO_INVERSE, for a full rank task and for rank deficient
+  ones where the pseudo inverse is used as fallback: a task with less rows than
+  columns, and a task with more rows than columns where the Cholesky
+  factorization detects the rank loss.
+*/
+
+#include <iostream>
+#include <vector>
+
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpPoint.h>
+#include <visp3/visual_features/vpFeatureBuilder.h>
+#include <visp3/visual_features/vpFeaturePoint.h>
+#include <visp3/vs/vpServo.h>
+
+namespace
+{
+// Each point of the task is given by its index among 4 points, so that a
+// point can be used twice
+vpColVector computeVelocity(const vpHomogeneousMatrix &cMo, const vpHomogeneousMatrix &cdMo,
+                            const std::vector<unsigned int> &indexes, vpServo::vpServoInversionType inversionType,
+                            unsigned int &rank)
+{
+  vpPoint point[4];
+  point[0].setWorldCoordinates(-0.1, -0.1, 0);
+  point[1].setWorldCoordinates(0.1, -0.1, 0);
+  point[2].setWorldCoordinates(0.1, 0.1, 0);
+  point[3].setWorldCoordinates(-0.1, 0.1, 0);
+
+  std::vector<vpFeaturePoint> p(indexes.size()), pd(indexes.size());
+  vpServo task;
+  task.setServo(vpServo::EYEINHAND_CAMERA);
+  task.setInteractionMatrixType(vpServo::CURRENT, inversionType);
+  task.setLambda(0.5);
+
+  for (unsigned int i = 0; i < indexes.size(); i++) {
+    vpPoint &P = point[indexes[i]];
+    P.track(cdMo);
+    vpFeatureBuilder::create(pd[i], P);
+    P.track(cMo);
+    vpFeatureBuilder::create(p[i], P);
+    task.addFeature(p[i], pd[i]);
+  }
+
+  vpColVector v;
+  // Run a few iterations to check that internal buffers are reused safely
+  for (unsigned int iter = 0; iter < 3; iter++) {
+    v = task.computeControlLaw();
+  }
+  rank = task.getTaskRank();
+  task.kill();
+
+  return v;
+}
+
+bool compare(const vpColVector &v1, const vpColVector &v2)
+{
+  if (v1.size() != v2.size()) {
+    return false;
+  }
+  for (unsigned int i = 0; i < v1.size(); i++) {
+    if (!vpMath::equal(v1[i], v2[i], 1e-8)) {
+      return false;
+    }
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    vpHomogeneousMatrix cdMo(0, 0, 0.75, 0, 0, 0);
+    vpHomogeneousMatrix cMo(0.15, -0.1, 1., vpMath::rad(10), vpMath::rad(-10), vpMath::rad(50));
+
+    // Full rank task: 4 points
+    unsigned int rank_svd, rank_normal;
+    std::vector<unsigned int> indexes;
+    for (unsigned int i = 0; i < 4; i++) {
+      indexes.push_back(i);
+    }
+    vpColVector v_svd = computeVelocity(cMo, cdMo, indexes, vpServo::PSEUDO_INVERSE, rank_svd);
+    vpColVector v_normal = computeVelocity(cMo, cdMo, indexes, vpServo::NORMAL_EQUATIONS, rank_normal);
+    std::cout << "Pseudo inverse velocity: " << v_svd.t() << std::endl;
+    std::cout << "Normal equations velocity: " << v_normal.t() << std::endl;
+    if (!compare(v_svd, v_normal) || rank_normal != 6) {
+      std::cerr << "Velocities differ for the full rank task" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Rank deficient task with less rows than columns: 2 points
+    indexes.resize(2);
+    v_svd = computeVelocity(cMo, cdMo, indexes, vpServo::PSEUDO_INVERSE, rank_svd);
+    v_normal = computeVelocity(cMo, cdMo, indexes, vpServo::NORMAL_EQUATIONS, rank_normal);
+    if (!compare(v_svd, v_normal) || rank_normal != rank_svd) {
+      std::cerr << "Velocities differ for the rank deficient task" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Rank deficient task with more rows than columns: the 2 points are used
+    // twice, giving pairs of identical rows in the 8 x 6 task Jacobian
+    indexes.push_back(0);
+    indexes.push_back(1);
+    v_svd = computeVelocity(cMo, cdMo, indexes, vpServo::PSEUDO_INVERSE, rank_svd);
+    v_normal = computeVelocity(cMo, cdMo, indexes, vpServo::NORMAL_EQUATIONS, rank_normal);
+    std::cout << "Tall rank deficient task of rank " << rank_svd << std::endl;
+    std::cout << "Pseudo inverse velocity: " << v_svd.t() << std::endl;
+    std::cout << "Normal equations velocity: " << v_normal.t() << std::endl;
+    if (rank_svd != 4 || rank_normal != rank_svd || !compare(v_svd, v_normal)) {
+      std::cerr << "Velocities differ for the tall rank deficient task" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "testServoNormalEquations is ok" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}